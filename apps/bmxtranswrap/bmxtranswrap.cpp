@@ -74,6 +74,7 @@
 #include <bmx/as10/AS10RDD9Validator.h>
 #include <bmx/apps/AppMCALabelHelper.h>
 #include <bmx/apps/AppMXFFileFactory.h>
+#include <bmx/apps/AppGrowingFileWatcher.h>
 #include <bmx/apps/AppUtils.h>
 #include <bmx/apps/AS11Helper.h>
 #include <bmx/apps/AS10Helper.h>
@@ -93,6 +94,8 @@ using namespace mxfpp;
 
 #define DEFAULT_ST436_MANIFEST_COUNT    2
 
+#define MAX_OPEN_THREADS    16
+
 
 typedef struct
 {
@@ -327,6 +330,41 @@ static void write_anc_samples(OutputTrack *output_track, Frame *frame, set<ANCDa
     output_track->WriteSamples(0, anc_buffer.GetBytes(), anc_buffer.GetSize(), 1);
 }
 
+static void write_wave_samples(WaveWriter *wave_clip, const vector<OutputTrack*> &output_tracks,
+                               vector<const unsigned char*> &track_data)
+{
+    // write the samples for all tracks together if every track has the same number of samples. Otherwise,
+    // e.g. when skipping precharge or when tracks have unequal duration, write the samples per track
+    bool write_all_tracks = (output_tracks.size() == wave_clip->GetNumTracks() &&
+                             !wave_clip->HaveBufferedSamples());
+    uint32_t num_samples = 0;
+    size_t i;
+    if (write_all_tracks) {
+        track_data.resize(output_tracks.size());
+        for (i = 0; i < output_tracks.size(); i++) {
+            OutputTrack *output_track = output_tracks[i];
+            if (!output_track->HaveHeldSamples() ||
+                (i > 0 && output_track->GetHeldNumSamples() != num_samples))
+            {
+                write_all_tracks = false;
+                break;
+            }
+            num_samples = output_track->GetHeldNumSamples();
+            track_data[output_track->GetClipTrack()->GetWaveTrack()->GetTrackIndex()] =
+                output_track->GetHeldSamples();
+        }
+    }
+
+    if (write_all_tracks) {
+        wave_clip->WriteSamples(&track_data[0], num_samples);
+        for (i = 0; i < output_tracks.size(); i++)
+            output_tracks[i]->ClearHeldSamples();
+    } else {
+        for (i = 0; i < output_tracks.size(); i++)
+            output_tracks[i]->WriteHeldSamples();
+    }
+}
+
 static void disable_tracks(MXFReader *reader, const set<size_t> &track_indexes,
                            bool disable_audio, bool disable_video, bool disable_data)
 {
@@ -424,8 +462,13 @@ static void usage(const char *cmd)
     printf("  --gf-delay <sec>        Set the delay (in seconds) between a failure to read and a retry. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
     printf("  --gf-rate <factor>      Limit the read rate to realtime rate x <factor> after a read failure. The default is %f\n", DEFAULT_GF_RATE_AFTER_FAIL);
     printf("                          <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    printf("  --gf-follow             Wait for the growing file to be extended before retrying a failed read, rather than sleeping for the --gf-delay\n");
+    printf("                          The file is watched using inotify on Linux and otherwise its size is polled\n");
+    printf("                          --gf-delay sets the maximum wait and a retry is only counted if the file did not grow in that time\n");
     printf(" --disable-indexing-file   Use this option to stop the reader creating an index of the partitions and essence positions in the file up front\n");
     printf("                           This option can be used to avoid indexing files containing many partitions\n");
+    printf(" --index-cache             Read and write a '<filename>.bmxidx' sidecar cache of the file's partitions and index tables\n");
+    printf("                           This option speeds up re-opening large files that have many partitions or index entries\n");
     if (mxf_http_is_supported()) {
         printf(" --http-min-read <bytes>\n");
         printf("                          Set the minimum number of bytes to read when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_MIN_READ);
@@ -442,6 +485,12 @@ static void usage(const char *cmd)
     printf("  --mmap-file             Use memory-mapped file I/O for the MXF files\n");
     printf("                          Note: this may reduce file I/O performance and was found to be slower over network drives\n");
 #endif
+#else
+    printf("  --seq-scan              Set the sequential scan hint for optimizing file caching whilst reading. Requires --pread-file\n");
+    printf("  --mmap-file             Use memory-mapped file I/O for the input MXF files. Frames reference the mapped data\n");
+    printf("                          --pread-file is used instead for growing files and output files\n");
+    printf("  --pread-file            Use positioned read/write file I/O with background read-ahead for the MXF files\n");
+    printf("  --read-ahead <bytes>    Set the read-ahead window size used by --pread-file. The default is %u\n", MXF_POSIX_DEFAULT_READ_AHEAD_SIZE);
 #endif
     printf("  --avcihead <format> <file> <offset>\n");
     printf("                          Default AVC-Intra sequence header data (512 bytes) to use when the input file does not have it\n");
@@ -614,6 +663,8 @@ static void usage(const char *cmd)
     printf("    --body-part             Create separate body partitions for essence data\n");
     printf("                            and don't create separate body partitions for index table segments\n");
     printf("    --repeat-index          Repeat the index table segments in the footer partition\n");
+    printf("    --spill-index           Keep completed VBE index table segments in a temporary file rather than in memory until they are written\n");
+    printf("    --pipelined-write       Write the file in a separate I/O thread, overlapping essence processing with file writes\n");
     printf("    --clip-wrap             Use clip wrapping for a single sound track\n");
     printf("    --mp-track-num          Use the material package track number property to define a track order. By default the track number is set to 0\n");
     printf("    --aes-3                 Use AES-3 audio mapping\n");
@@ -895,6 +946,8 @@ int main(int argc, const char** argv)
     bool min_part = false;
     bool body_part = false;
     bool repeat_index = false;
+    bool spill_index = false;
+    bool pipelined_write = false;
     bool cbe_index_duration_0 = false;
     bool op1a_clip_wrap = false;
     bool realtime = false;
@@ -903,7 +956,9 @@ int main(int argc, const char** argv)
     unsigned int gf_retries = DEFAULT_GF_RETRIES;
     float gf_retry_delay = DEFAULT_GF_RETRY_DELAY;
     float gf_rate_after_fail = DEFAULT_GF_RATE_AFTER_FAIL;
+    bool gf_follow = false;
     bool enable_indexing_file = true;
+    bool enable_index_cache = false;
     bool product_info_set = false;
     string company_name;
     string product_name;
@@ -930,8 +985,12 @@ int main(int argc, const char** argv)
     uint32_t http_min_read = DEFAULT_HTTP_MIN_READ;
     bool http_enable_seek = true;
     bool mp_track_num = false;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool use_mmap_file = false;
+#endif
+#if !defined(_WIN32)
+    bool use_pread_file = false;
+    uint32_t read_ahead_size = 0;
 #endif
     vector<EmbedXMLInfo> embed_xml;
     EmbedXMLInfo next_embed_xml;
@@ -1235,6 +1294,11 @@ int main(int argc, const char** argv)
         {
             growing_file = true;
         }
+        else if (strcmp(argv[cmdln_index], "--gf-follow") == 0)
+        {
+            gf_follow = true;
+            growing_file = true;
+        }
         else if (strcmp(argv[cmdln_index], "--gf-retries") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -1290,6 +1354,10 @@ int main(int argc, const char** argv)
         {
             enable_indexing_file = false;
         }
+        else if (strcmp(argv[cmdln_index], "--index-cache") == 0)
+        {
+            enable_index_cache = true;
+        }
         else if (strcmp(argv[cmdln_index], "--http-min-read") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -1352,6 +1420,36 @@ int main(int argc, const char** argv)
             use_mmap_file = true;
         }
 #endif
+#else
+        else if (strcmp(argv[cmdln_index], "--seq-scan") == 0)
+        {
+            input_file_flags |= MXF_POSIX_FLAG_SEQUENTIAL_SCAN;
+        }
+        else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
+        {
+            use_mmap_file = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--pread-file") == 0)
+        {
+            use_pread_file = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (!parse_int(argv[cmdln_index + 1], &uvalue) || uvalue == 0)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            read_ahead_size = uvalue;
+            cmdln_index++;
+        }
 #endif
         else if (strcmp(argv[cmdln_index], "--avcihead") == 0)
         {
@@ -2346,6 +2444,14 @@ int main(int argc, const char** argv)
         {
             repeat_index = true;
         }
+        else if (strcmp(argv[cmdln_index], "--spill-index") == 0)
+        {
+            spill_index = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--pipelined-write") == 0)
+        {
+            pipelined_write = true;
+        }
         else if (strcmp(argv[cmdln_index], "--cbe-index-duration-0") == 0)
         {
             cbe_index_duration_0 = true;
@@ -2924,13 +3030,31 @@ int main(int argc, const char** argv)
             file_factory.SetRWInterleave(rw_interleave_size);
         file_factory.SetHTTPMinReadSize(http_min_read);
         file_factory.SetHTTPEnableSeek(http_enable_seek);
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(_WIN32)
+        if (use_mmap_file && growing_file) {
+            // accessing mapped data after a growing file has been truncated results in a SIGBUS
+            log_warn("Using --pread-file instead of --mmap-file for growing files\n");
+            use_mmap_file = false;
+            use_pread_file = true;
+        }
+#endif
+#if !defined(__MINGW32__)
         file_factory.SetUseMMapFile(use_mmap_file);
 #endif
+#if !defined(_WIN32)
+        file_factory.SetUsePReadFile(use_pread_file);
+        file_factory.SetReadAheadSize(read_ahead_size);
+#endif
+
+        // the read/write interleaver is shared by all files and so the inputs are opened one at a time
+        uint32_t open_threads = 1;
+        if (!rw_interleave)
+            open_threads = (uint32_t)min(input_filenames.size(), (size_t)MAX_OPEN_THREADS);
 
         if (use_group_reader && input_filenames.size() > 1) {
             MXFGroupReader *group_reader = new MXFGroupReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> grp_file_readers;
+            vector<string> grp_filenames;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *grp_file_reader = new MXFFileReader();
@@ -2938,15 +3062,21 @@ int main(int argc, const char** argv)
                 grp_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 grp_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
                 grp_file_reader->SetEnableIndexFile(enable_indexing_file);
-                result = grp_file_reader->Open(input_filenames[i]);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                grp_file_reader->SetEnableIndexCache(enable_index_cache);
+                grp_file_readers.push_back(grp_file_reader);
+                grp_filenames.push_back(input_filenames[i]);
+            }
+            vector<MXFFileReader::OpenResult> results;
+            MXFFileReader::OpenConcurrent(grp_file_readers, grp_filenames, 0, open_threads, &results);
+            for (i = 0; i < grp_file_readers.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", input_filenames[i],
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(grp_file_reader, disable_track_indexes[i],
+                disable_tracks(grp_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                group_reader->AddReader(grp_file_reader);
+                group_reader->AddReader(grp_file_readers[i]);
             }
             if (!group_reader->Finalize())
                 throw false;
@@ -2954,7 +3084,8 @@ int main(int argc, const char** argv)
             reader = group_reader;
         } else if (input_filenames.size() > 1) {
             MXFSequenceReader *seq_reader = new MXFSequenceReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> seq_file_readers;
+            vector<string> seq_filenames;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *seq_file_reader = new MXFFileReader();
@@ -2962,15 +3093,21 @@ int main(int argc, const char** argv)
                 seq_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 seq_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
                 seq_file_reader->SetEnableIndexFile(enable_indexing_file);
-                result = seq_file_reader->Open(input_filenames[i]);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                seq_file_reader->SetEnableIndexCache(enable_index_cache);
+                seq_file_readers.push_back(seq_file_reader);
+                seq_filenames.push_back(input_filenames[i]);
+            }
+            vector<MXFFileReader::OpenResult> results;
+            MXFFileReader::OpenConcurrent(seq_file_readers, seq_filenames, 0, open_threads, &results);
+            for (i = 0; i < seq_file_readers.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", input_filenames[i],
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(seq_file_reader, disable_track_indexes[i],
+                disable_tracks(seq_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                seq_reader->AddReader(seq_file_reader);
+                seq_reader->AddReader(seq_file_readers[i]);
             }
             if (!seq_reader->Finalize(false, keep_input_order))
                 throw false;
@@ -2983,6 +3120,7 @@ int main(int argc, const char** argv)
             file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
             file_reader->SetST436ManifestFrameCount(st436_manifest_count);
             file_reader->SetEnableIndexFile(enable_indexing_file);
+            file_reader->SetEnableIndexCache(enable_index_cache);
             if (pass_dm && clip_sub_type == AS11_CLIP_SUB_TYPE)
                 AS11Info::RegisterExtensions(file_reader->GetHeaderMetadata());
             if (pass_dm && clip_sub_type == AS10_CLIP_SUB_TYPE)
@@ -3700,6 +3838,10 @@ int main(int argc, const char** argv)
 
             if (repeat_index)
                 op1a_clip->SetRepeatIndexTable(true);
+            if (spill_index)
+                op1a_clip->SetSpillIndexTable(true);
+            if (pipelined_write)
+                op1a_clip->SetPipelinedWrite(true);
             if (op1a_index_follows)
                 op1a_clip->SetIndexFollowsEssence(true);
 
@@ -3898,6 +4040,10 @@ int main(int argc, const char** argv)
                 }
             }
 
+            // the Wave samples are written for all tracks together in write_wave_samples
+            if (clip_type == CW_WAVE_CLIP_TYPE)
+                output_track->SetHoldSamples(true);
+
             output_tracks.push_back(output_track);
         }
 
@@ -4595,6 +4741,20 @@ int main(int argc, const char** argv)
         bool gf_read_failure = false;
         int64_t gf_failure_num_read = 0;
         uint32_t gf_failure_start = 0;
+        // wait for the input files to grow instead of sleeping after a failed read
+        // stdin and HTTP inputs can't be watched
+        AppGrowingFileWatcher gf_watcher;
+        if (gf_follow) {
+            size_t i;
+            for (i = 0; i < input_filenames.size(); i++) {
+                if (input_filenames[i][0] && !mxf_http_is_url(input_filenames[i]))
+                    gf_watcher.AddFile(input_filenames[i]);
+            }
+            if (gf_watcher.GetNumFiles() == 0) {
+                log_warn("Ignoring --gf-follow because none of the input files can be watched\n");
+                gf_follow = false;
+            }
+        }
 
 
         // create clip file(s) and write samples
@@ -4612,11 +4772,17 @@ int main(int argc, const char** argv)
         int64_t container_duration;
         int64_t prev_container_duration = -1;
         bmx::ByteArray sound_buffer;
+        vector<const unsigned char*> wave_track_data;
         while (read_duration < 0 || total_read < read_duration) {
             uint32_t num_read = read_samples(reader, sample_sequence, &sample_sequence_offset, max_samples_per_read);
             if (num_read == 0) {
                 if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries)
                     break;
+                if (gf_follow) {
+                    if (!gf_watcher.WaitForGrowth((uint32_t)(gf_retry_delay * 1000)))
+                        gf_retry_count++;
+                    continue;
+                }
                 gf_retry_count++;
                 gf_read_failure = true;
                 if (gf_retry_delay > 0.0) {
@@ -4695,10 +4861,10 @@ int main(int argc, const char** argv)
                 BMX_ASSERT(frame);
 
                 if (clip_type == CW_AVID_CLIP_TYPE && convert_ess_marks) {
-                    const vector<FrameMetadata*> *metadata = frame->GetMetadata(SDTI_CP_PACKAGE_METADATA_FMETA_ID);
-                    if (metadata && !metadata->empty()) {
-                        const SDTICPPackageMetadata *pkg_metadata =
-                            dynamic_cast<const SDTICPPackageMetadata*>((*metadata)[0]);
+                    const SDTICPPackageMetadata *pkg_metadata =
+                        dynamic_cast<const SDTICPPackageMetadata*>(
+                            frame->FindMetadata(SDTI_CP_PACKAGE_METADATA_FMETA_NUM_ID));
+                    if (pkg_metadata) {
                         if (!pkg_metadata->mEssenceMark.empty()) {
                             AvidLocator locator;
                             locator.position = frame->position - (read_start + precharge);
@@ -4799,6 +4965,9 @@ int main(int argc, const char** argv)
                 }
             }
 
+            if (clip_type == CW_WAVE_CLIP_TYPE)
+                write_wave_samples(clip->GetWaveClip(), output_tracks, wave_track_data);
+
 
             if (rdd6_filename) {
                 // expecting last track to be RDD-6 from an XML file
@@ -262,23 +262,22 @@ void APPInfoOutput::CompleteEventTimecodes()
             break;
         }
 
-        const vector<FrameMetadata*> *metadata = frame->GetMetadata(SYSTEM_SCHEME_1_FMETA_ID);
-        if (!metadata) {
+        if (!frame->FindMetadata(SYSTEM_SCHEME_1_FMETA_NUM_ID)) {
             log_warn("System Scheme 1 metadata not present in frame\n");
             break;
         }
 
-        for (i = 0; i < metadata->size(); i++) {
-            const SystemScheme1Metadata *ss1_meta =
-                dynamic_cast<const SystemScheme1Metadata*>((*metadata)[i]);
-
+        const SystemScheme1Metadata *ss1_meta;
+        for (i = 0; (ss1_meta = dynamic_cast<const SystemScheme1Metadata*>(
+                        frame->FindMetadata(SYSTEM_SCHEME_1_FMETA_NUM_ID, i))) != 0; i++)
+        {
             if (ss1_meta->GetType() == SystemScheme1Metadata::TIMECODE_ARRAY) {
                 const SS1TimecodeArray *tc_array = dynamic_cast<const SS1TimecodeArray*>(ss1_meta);
                 AddEventTimecodes(position, tc_array->GetVITC(), tc_array->GetLTC());
                 break;
             }
         }
-        if (i >= metadata->size()) {
+        if (!ss1_meta) {
             log_warn("System Scheme 1 timecode array metadata not present in frame\n");
             break;
         }
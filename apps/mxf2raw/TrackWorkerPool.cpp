@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TrackWorkerPool.h"
+
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+TrackWorkerPool::TrackWorkerPool(TrackFrameProcessor *processor, size_t num_tracks, uint32_t num_threads,
+                                 size_t max_frames_per_track)
+{
+    BMX_CHECK(num_threads > 0 && max_frames_per_track > 0);
+
+    mProcessor = processor;
+    mMaxFramesPerTrack = max_frames_per_track;
+    mQueuedFrames = 0;
+    mStop = false;
+
+    mTrackQueues.resize(num_tracks);
+    size_t i;
+    for (i = 0; i < mTrackQueues.size(); i++)
+        mTrackQueues[i].scheduled = false;
+
+    // the destructor doesn't run if the constructor throws and so the started workers are stopped here,
+    // because destroying a joinable thread terminates the process
+    try
+    {
+        mWorkers.reserve(num_threads);
+        uint32_t t;
+        for (t = 0; t < num_threads; t++)
+            mWorkers.emplace_back(&TrackWorkerPool::ProcessTracks, this);
+    }
+    catch (...)
+    {
+        StopWorkers();
+        throw;
+    }
+}
+
+TrackWorkerPool::~TrackWorkerPool()
+{
+    StopWorkers();
+
+    size_t i;
+    for (i = 0; i < mTrackQueues.size(); i++) {
+        size_t f;
+        for (f = 0; f < mTrackQueues[i].frames.size(); f++)
+            delete mTrackQueues[i].frames[f];
+    }
+}
+
+void TrackWorkerPool::StopWorkers()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+        mCond.notify_all();
+    }
+    size_t i;
+    for (i = 0; i < mWorkers.size(); i++)
+        mWorkers[i].join();
+}
+
+void TrackWorkerPool::Submit(size_t track_index, Frame *frame)
+{
+    BMX_ASSERT(track_index < mTrackQueues.size());
+
+    TrackQueue &track_queue = mTrackQueues[track_index];
+
+    unique_lock<mutex> lock(mMutex);
+    while (!mException && track_queue.frames.size() >= mMaxFramesPerTrack)
+        mCond.wait(lock);
+    if (mException) {
+        delete frame;
+        CheckException();
+    }
+
+    track_queue.frames.push_back(frame);
+    mQueuedFrames++;
+    if (!track_queue.scheduled) {
+        track_queue.scheduled = true;
+        mScheduledTracks.push_back(track_index);
+        mCond.notify_all();
+    }
+}
+
+void TrackWorkerPool::Finish()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (mQueuedFrames > 0)
+        mCond.wait(lock);
+    CheckException();
+}
+
+void TrackWorkerPool::ProcessTracks()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && mScheduledTracks.empty())
+            mCond.wait(lock);
+        if (mStop)
+            break;
+
+        // the track stays scheduled whilst its frame is processed so that no other worker takes the next frame
+        size_t track_index = mScheduledTracks.front();
+        mScheduledTracks.pop_front();
+        TrackQueue &track_queue = mTrackQueues[track_index];
+        Frame *frame = track_queue.frames.front();
+        track_queue.frames.pop_front();
+        bool failed = (bool)mException;
+        lock.unlock();
+
+        exception_ptr process_exception;
+        if (!failed) {
+            try
+            {
+                mProcessor->ProcessFrame(track_index, frame);
+            }
+            catch (...)
+            {
+                process_exception = current_exception();
+            }
+        }
+        delete frame;
+
+        lock.lock();
+        if (process_exception && !mException)
+            mException = process_exception;
+        if (track_queue.frames.empty())
+            track_queue.scheduled = false;
+        else
+            mScheduledTracks.push_back(track_index);
+        mQueuedFrames--;
+        mCond.notify_all();
+    }
+}
+
+void TrackWorkerPool::CheckException()
+{
+    // called with the mutex locked
+    if (mException) {
+        exception_ptr ex = mException;
+        rethrow_exception(ex);
+    }
+}
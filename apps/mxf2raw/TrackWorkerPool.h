@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TRACK_WORKER_POOL_H_
+#define TRACK_WORKER_POOL_H_
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+#include <bmx/frame/Frame.h>
+
+
+class TrackFrameProcessor
+{
+public:
+    virtual ~TrackFrameProcessor() {}
+
+    virtual void ProcessFrame(size_t track_index, bmx::Frame *frame) = 0;
+};
+
+
+// The TrackWorkerPool passes frames to a TrackFrameProcessor in a pool of worker threads.
+// Frames of different tracks are processed concurrently and the frames of a track are processed
+// one at a time in the order they were submitted. At most max_frames_per_track frames are queued
+// for each track; Submit blocks until the track's worker has taken a frame from a full queue.
+// The first exception thrown by the processor is rethrown by Submit or Finish and the remaining
+// frames are then discarded.
+
+class TrackWorkerPool
+{
+public:
+    TrackWorkerPool(TrackFrameProcessor *processor, size_t num_tracks, uint32_t num_threads,
+                    size_t max_frames_per_track);
+    ~TrackWorkerPool();
+
+    void Submit(size_t track_index, bmx::Frame *frame);  // takes ownership of frame; blocks if the queue is full
+    void Finish();                                       // waits until all submitted frames are processed
+
+private:
+    typedef struct
+    {
+        std::deque<bmx::Frame*> frames;
+        bool scheduled;
+    } TrackQueue;
+
+private:
+    void ProcessTracks();
+    void CheckException();
+    void StopWorkers();
+
+private:
+    TrackFrameProcessor *mProcessor;
+    size_t mMaxFramesPerTrack;
+    size_t mQueuedFrames;
+    std::vector<TrackQueue> mTrackQueues;
+    std::deque<size_t> mScheduledTracks;
+    bool mStop;
+    std::exception_ptr mException;
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::vector<std::thread> mWorkers;
+};
+
+
+#endif
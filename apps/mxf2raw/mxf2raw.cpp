@@ -46,8 +46,11 @@
 #include <fcntl.h>
 #endif
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <memory>
+#include <mutex>
 
 #include <bmx/mxf_reader/MXFFileReader.h>
 #include <bmx/mxf_reader/MXFGroupReader.h>
@@ -67,6 +70,7 @@
 #include <bmx/Version.h>
 #include <bmx/apps/AppUtils.h>
 #include <bmx/apps/AppMXFFileFactory.h>
+#include <bmx/apps/AppGrowingFileWatcher.h>
 #include <bmx/apps/AppTextInfoWriter.h>
 #include <bmx/apps/AppXMLInfoWriter.h>
 #include <bmx/apps/ADMCHNATextFileHelper.h>
@@ -75,6 +79,7 @@
 #include "APPInfoOutput.h"
 #include "AvidInfoOutput.h"
 #include "OutputFileManager.h"
+#include "TrackWorkerPool.h"
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
@@ -89,6 +94,10 @@ using namespace mxfpp;
 
 #define DEFAULT_ST436_MANIFEST_COUNT    2
 
+#define MAX_OPEN_THREADS    16
+
+#define MAX_TRACK_QUEUED_FRAMES     8
+
 #define CHECK_FPRINTF(fname, pr)                                                                    \
     do {                                                                                            \
         if (pr < 0) {                                                                               \
@@ -123,6 +132,7 @@ typedef struct
 {
     vector<LogMessage> messages;
     vlog2_func vlog2;
+    mutex log_mutex;
 } LogData;
 
 typedef struct
@@ -294,6 +304,9 @@ static void mxf2raw_vlog2(LogLevel level, const char *source, const char *format
     if (level < LOG_LEVEL)
         return;
 
+    // messages can be logged from the file open and track worker threads
+    lock_guard<mutex> lock(LOG_DATA.log_mutex);
+
     char message[1024];
     bmx_vsnprintf(message, sizeof(message), format, p_arg);
 
@@ -1368,6 +1381,82 @@ static void write_data(FILE *file, const string &filename, const unsigned char *
     CHECK_WRITE(data, size)
 }
 
+class TrackOutputProcessor : public TrackFrameProcessor
+{
+public:
+    TrackOutputProcessor(MXFReader *reader, vector<vector<Checksum> > *track_checksums,
+                         OutputFileManager *output_file_manager, const set<MXFDataDefEnum> &wrap_klv_mask,
+                         bool deinterleave)
+    {
+        mTrackChecksums = track_checksums;
+        mOutputFileManager = output_file_manager;
+        mWrapKLVMask = wrap_klv_mask;
+        mDeinterleave = deinterleave;
+
+        // a separate sound buffer for each track allows the tracks to be processed concurrently
+        size_t i;
+        for (i = 0; i < reader->GetNumTrackReaders(); i++)
+            mTrackInfos.push_back(reader->GetTrackReader(i)->GetTrackInfo());
+        mSoundBuffers.resize(mTrackInfos.size());
+    }
+
+    virtual void ProcessFrame(size_t track_index, Frame *frame)
+    {
+        if (!mTrackChecksums->empty()) {
+            vector<Checksum> &checksums = (*mTrackChecksums)[track_index];
+            size_t m;
+            for (m = 0; m < checksums.size(); m++)
+                checksums[m].Update(frame->GetBytes(), frame->GetSize());
+        }
+
+        if (mOutputFileManager) {
+            const MXFTrackInfo *track_info = mTrackInfos[track_index];
+            bool wrap_klv = (mWrapKLVMask.find(track_info->data_def) != mWrapKLVMask.end());
+            FILE *file;
+            string filename;
+            const MXFSoundTrackInfo *sound_info = dynamic_cast<const MXFSoundTrackInfo*>(track_info);
+            if (sound_info && mDeinterleave && sound_info->channel_count > 1 &&
+                sound_info->essence_type != MGA && sound_info->essence_type != MGA_SADM)
+            {
+                bmx::ByteArray &sound_buffer = mSoundBuffers[track_index];
+                sound_buffer.Allocate(frame->GetSize()); // more than enough
+                uint32_t c;
+                for (c = 0; c < sound_info->channel_count; c++) {
+                    if (sound_info->essence_type == D10_AES3_PCM) {
+                        convert_aes3_to_pcm(frame->GetBytes(), frame->GetSize(), false,
+                                            sound_info->bits_per_sample, c,
+                                            sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
+                        sound_buffer.SetSize(sound_info->block_align / sound_info->channel_count *
+                                                get_aes3_sample_count(frame->GetBytes(), frame->GetSize()));
+                    } else {
+                        deinterleave_audio(frame->GetBytes(), frame->GetSize(),
+                                           sound_info->bits_per_sample, sound_info->channel_count, c,
+                                           sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
+                        sound_buffer.SetSize(frame->GetSize() / sound_info->channel_count);
+                    }
+                    mOutputFileManager->GetTrackFile(track_index, c, &file, &filename);
+                    write_data(file, filename,
+                               sound_buffer.GetBytes(), sound_buffer.GetSize(),
+                               wrap_klv, &frame->element_key);
+                }
+            } else if (track_info->essence_type != TIMED_TEXT) {  // timed text is written at the end
+                mOutputFileManager->GetTrackFile(track_index, &file, &filename);
+                write_data(file, filename,
+                           frame->GetBytes(), frame->GetSize(),
+                           wrap_klv, &frame->element_key);
+            }
+        }
+    }
+
+private:
+    vector<vector<Checksum> > *mTrackChecksums;
+    OutputFileManager *mOutputFileManager;
+    set<MXFDataDefEnum> mWrapKLVMask;
+    bool mDeinterleave;
+    vector<const MXFTrackInfo*> mTrackInfos;
+    vector<bmx::ByteArray> mSoundBuffers;
+};
+
 static bool update_rdd6_xml(Frame *frame, RDD6MetadataFrame *rdd6_frame, vector<string> *cumulative_desc_chars,
                             vector<bool> *have_start, vector<bool> *have_end, bool *descriptions_complete)
 {
@@ -1467,10 +1556,9 @@ static void write_timecodes(MXFReader *reader, Frame *frame, FILE *tc_file)
     Timecode sys_item_user_tc;
     const SS1TimecodeArray *ss1_timecodes = 0;
 
-    const vector<FrameMetadata*> *metadata = frame->GetMetadata(SDTI_CP_SYSTEM_METADATA_FMETA_ID);
-    if (metadata && !metadata->empty()) {
-        const SDTICPSystemMetadata *sdticp_meta = dynamic_cast<const SDTICPSystemMetadata*>((*metadata)[0]);
-
+    const SDTICPSystemMetadata *sdticp_meta =
+        dynamic_cast<const SDTICPSystemMetadata*>(frame->FindMetadata(SDTI_CP_SYSTEM_METADATA_FMETA_NUM_ID));
+    if (sdticp_meta) {
         if (sdticp_meta->mHaveCreationTimecode) {
             sys_item_creation_tc = decode_smpte_timecode(sdticp_meta->mCPRate,
                                                          sdticp_meta->mCreationTimecode.bytes,
@@ -1484,15 +1572,14 @@ static void write_timecodes(MXFReader *reader, Frame *frame, FILE *tc_file)
             have_sys_item_user_tc = true;
         }
     }
-    metadata = frame->GetMetadata(SYSTEM_SCHEME_1_FMETA_ID);
-    if (metadata) {
-        size_t i;
-        for (i = 0; i < metadata->size(); i++) {
-            const SystemScheme1Metadata *ss1_meta = dynamic_cast<const SystemScheme1Metadata*>((*metadata)[i]);
-            if (ss1_meta->GetType() == SystemScheme1Metadata::TIMECODE_ARRAY) {
-                ss1_timecodes = dynamic_cast<const SS1TimecodeArray*>(ss1_meta);
-                break;
-            }
+    const SystemScheme1Metadata *ss1_meta;
+    size_t m;
+    for (m = 0; (ss1_meta = dynamic_cast<const SystemScheme1Metadata*>(
+                    frame->FindMetadata(SYSTEM_SCHEME_1_FMETA_NUM_ID, m))) != 0; m++)
+    {
+        if (ss1_meta->GetType() == SystemScheme1Metadata::TIMECODE_ARRAY) {
+            ss1_timecodes = dynamic_cast<const SS1TimecodeArray*>(ss1_meta);
+            break;
         }
     }
 
@@ -1771,20 +1858,35 @@ static void usage(const char *cmd)
     printf(" --noro                Don't include roll-out frames\n");
     printf(" --rt <factor>         Read at realtime rate x <factor>, where <factor> is a floating point value\n");
     printf("                       <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    printf(" --track-threads <count>\n");
+    printf("                       Calculate track checksums, de-interleave sound and write essence files in a pool of <count> threads\n");
+    printf("                       The tracks are processed concurrently whilst the main thread reads the next frames\n");
 #if defined(_WIN32)
     printf(" --no-seq-scan         Do not set the sequential scan hint for optimizing file caching\n");
 #if !defined(__MINGW32__)
     printf(" --mmap-file           Use memory-mapped file I/O for the MXF files\n");
     printf("                       Note: this may reduce file I/O performance and was found to be slower over network drives\n");
 #endif
+#else
+    printf(" --no-seq-scan         Do not set the sequential scan hint for optimizing file caching. Applies to --pread-file\n");
+    printf(" --mmap-file           Use memory-mapped file I/O for the MXF files. Frames reference the mapped data\n");
+    printf("                       --pread-file is used instead for growing files\n");
+    printf(" --pread-file          Use positioned read file I/O with background read-ahead for the MXF files\n");
+    printf(" --read-ahead <bytes>  Set the read-ahead window size used by --pread-file. The default is %u\n", MXF_POSIX_DEFAULT_READ_AHEAD_SIZE);
 #endif
     printf(" --gf                  Support growing files. Retry reading a frame when it fails\n");
     printf(" --gf-retries <max>    Set the maximum times to retry reading a frame. The default is %u.\n", DEFAULT_GF_RETRIES);
     printf(" --gf-delay <sec>      Set the delay (in seconds) between a failure to read and a retry. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
     printf(" --gf-rate <factor>    Limit the read rate to realtime rate x <factor> after a read failure. The default is %f\n", DEFAULT_GF_RATE_AFTER_FAIL);
     printf("                       <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    printf(" --gf-follow           Wait for the growing file to be extended before retrying a failed read, rather than sleeping for the --gf-delay\n");
+    printf("                       The file is watched using inotify on Linux and otherwise its size is polled\n");
+    printf("                       --gf-delay sets the maximum wait and a retry is only counted if the file did not grow in that time\n");
     printf(" --disable-indexing-file   Use this option to stop the reader creating an index of the partitions and essence positions in the file up front\n");
     printf("                           This option can be used to avoid indexing files containing many partitions\n");
+    printf(" --index-cache             Read and write a '<filename>.bmxidx' sidecar cache of the file's partitions and index tables\n");
+    printf("                           This option speeds up re-opening large files that have many partitions or index entries\n");
+    printf(" --header-arena            Allocate the header metadata sets and items from an arena that is released in one go\n");
     if (mxf_http_is_supported()) {
         printf(" --http-min-read <bytes>\n");
         printf("                       Set the minimum number of bytes to read when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_MIN_READ);
@@ -1858,20 +1960,28 @@ int main(int argc, const char** argv)
 #if defined(_WIN32)
     int file_flags = MXF_WIN32_FLAG_SEQUENTIAL_SCAN;
 #else
-    int file_flags = 0;
+    int file_flags = MXF_POSIX_FLAG_SEQUENTIAL_SCAN;
 #endif
     bool realtime = false;
     float rt_factor = 1.0;
+    uint32_t track_threads = 0;
     bool growing_file = false;
     unsigned int gf_retries = DEFAULT_GF_RETRIES;
     float gf_retry_delay = DEFAULT_GF_RETRY_DELAY;
     float gf_rate_after_fail = DEFAULT_GF_RATE_AFTER_FAIL;
+    bool gf_follow = false;
     bool enable_indexing_file = true;
+    bool enable_index_cache = false;
+    bool use_header_arena = false;
     uint32_t http_min_read = DEFAULT_HTTP_MIN_READ;
     bool http_enable_seek = true;
     ChecksumType checkum_type;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool use_mmap_file = false;
+#endif
+#if !defined(_WIN32)
+    bool use_pread_file = false;
+    uint32_t read_ahead_size = 0;
 #endif
     const char *text_output_prefix = 0;
     const char *wave_chunks_output_prefix = 0;
@@ -2287,6 +2397,22 @@ int main(int argc, const char** argv)
             realtime = true;
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--track-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &track_threads) != 1 || track_threads == 0)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
 #if defined(_WIN32)
         else if (strcmp(argv[cmdln_index], "--no-seq-scan") == 0)
         {
@@ -2298,11 +2424,46 @@ int main(int argc, const char** argv)
             use_mmap_file = true;
         }
 #endif
+#else
+        else if (strcmp(argv[cmdln_index], "--no-seq-scan") == 0)
+        {
+            file_flags &= ~MXF_POSIX_FLAG_SEQUENTIAL_SCAN;
+        }
+        else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
+        {
+            use_mmap_file = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--pread-file") == 0)
+        {
+            use_pread_file = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (!parse_int(argv[cmdln_index + 1], &uvalue) || uvalue == 0)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            read_ahead_size = uvalue;
+            cmdln_index++;
+        }
 #endif
         else if (strcmp(argv[cmdln_index], "--gf") == 0)
         {
             growing_file = true;
         }
+        else if (strcmp(argv[cmdln_index], "--gf-follow") == 0)
+        {
+            gf_follow = true;
+            growing_file = true;
+        }
         else if (strcmp(argv[cmdln_index], "--gf-retries") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2358,6 +2519,14 @@ int main(int argc, const char** argv)
         {
             enable_indexing_file = false;
         }
+        else if (strcmp(argv[cmdln_index], "--index-cache") == 0)
+        {
+            enable_index_cache = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--header-arena") == 0)
+        {
+            use_header_arena = true;
+        }
         else if (strcmp(argv[cmdln_index], "--text-out") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2593,14 +2762,28 @@ int main(int argc, const char** argv)
         file_factory.SetInputFlags(file_flags);
         file_factory.SetHTTPMinReadSize(http_min_read);
         file_factory.SetHTTPEnableSeek(http_enable_seek);
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(_WIN32)
+        if (use_mmap_file && growing_file) {
+            // accessing mapped data after a growing file has been truncated results in a SIGBUS
+            log_warn("Using --pread-file instead of --mmap-file for growing files\n");
+            use_mmap_file = false;
+            use_pread_file = true;
+        }
+#endif
+#if !defined(__MINGW32__)
         file_factory.SetUseMMapFile(use_mmap_file);
 #endif
+#if !defined(_WIN32)
+        file_factory.SetUsePReadFile(use_pread_file);
+        file_factory.SetReadAheadSize(read_ahead_size);
+#endif
 
         int input_open_flags = do_parse_read && !do_ess_read ? MXFFileReader::MXF_MODE_PARSE_ONLY : 0;
+        uint32_t open_threads = (uint32_t)min(input_filenames.size(), (size_t)MAX_OPEN_THREADS);
         if (use_group_reader && input_filenames.size() > 1) {
             MXFGroupReader *group_reader = new MXFGroupReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> grp_file_readers;
+            vector<string> grp_filenames;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *grp_file_reader = new MXFFileReader();
@@ -2608,15 +2791,22 @@ int main(int argc, const char** argv)
                 grp_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 grp_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
                 grp_file_reader->SetEnableIndexFile(enable_indexing_file);
-                result = grp_file_reader->Open(input_filenames[i], input_open_flags);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                grp_file_reader->SetEnableIndexCache(enable_index_cache);
+                grp_file_reader->SetUseHeaderMetadataArena(use_header_arena);
+                grp_file_readers.push_back(grp_file_reader);
+                grp_filenames.push_back(input_filenames[i]);
+            }
+            vector<MXFFileReader::OpenResult> results;
+            MXFFileReader::OpenConcurrent(grp_file_readers, grp_filenames, input_open_flags, open_threads, &results);
+            for (i = 0; i < grp_file_readers.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[i]),
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(grp_file_reader, disable_track_indexes[i],
+                disable_tracks(grp_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                group_reader->AddReader(grp_file_reader);
+                group_reader->AddReader(grp_file_readers[i]);
             }
             if (!group_reader->Finalize())
                 throw false;
@@ -2624,7 +2814,8 @@ int main(int argc, const char** argv)
             reader = group_reader;
         } else if (input_filenames.size() > 1) {
             MXFSequenceReader *seq_reader = new MXFSequenceReader();
-            MXFFileReader::OpenResult result;
+            vector<MXFFileReader*> seq_file_readers;
+            vector<string> seq_filenames;
             size_t i;
             for (i = 0; i < input_filenames.size(); i++) {
                 MXFFileReader *seq_file_reader = new MXFFileReader();
@@ -2632,15 +2823,22 @@ int main(int argc, const char** argv)
                 seq_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 seq_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
                 seq_file_reader->SetEnableIndexFile(enable_indexing_file);
-                result = seq_file_reader->Open(input_filenames[i], input_open_flags);
-                if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                seq_file_reader->SetEnableIndexCache(enable_index_cache);
+                seq_file_reader->SetUseHeaderMetadataArena(use_header_arena);
+                seq_file_readers.push_back(seq_file_reader);
+                seq_filenames.push_back(input_filenames[i]);
+            }
+            vector<MXFFileReader::OpenResult> results;
+            MXFFileReader::OpenConcurrent(seq_file_readers, seq_filenames, input_open_flags, open_threads, &results);
+            for (i = 0; i < seq_file_readers.size(); i++) {
+                if (results[i] != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[i]),
-                              MXFFileReader::ResultToString(result).c_str());
+                              MXFFileReader::ResultToString(results[i]).c_str());
                     throw false;
                 }
-                disable_tracks(seq_file_reader, disable_track_indexes[i],
+                disable_tracks(seq_file_readers[i], disable_track_indexes[i],
                                disable_audio[i], disable_video[i], disable_data[i]);
-                seq_reader->AddReader(seq_file_reader);
+                seq_reader->AddReader(seq_file_readers[i]);
             }
             if (!seq_reader->Finalize(false, keep_input_order))
                 throw false;
@@ -2653,6 +2851,8 @@ int main(int argc, const char** argv)
             file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
             file_reader->SetST436ManifestFrameCount(st436_manifest_count);
             file_reader->SetEnableIndexFile(enable_indexing_file);
+            file_reader->SetEnableIndexCache(enable_index_cache);
+            file_reader->SetUseHeaderMetadataArena(use_header_arena);
             if (do_as11_info)
                 as11_register_extensions(file_reader);
             if (do_as10_info)
@@ -2886,6 +3086,17 @@ int main(int argc, const char** argv)
                 }
             }
 
+            // track checksums and essence output are done in the track processor, possibly in a worker pool
+            TrackOutputProcessor track_processor(reader, &track_checksums,
+                                                 (ess_output_prefix ? &output_file_manager : 0),
+                                                 wrap_klv_mask, deinterleave);
+            bool have_track_processing = (!track_checksums.empty() || ess_output_prefix);
+            unique_ptr<TrackWorkerPool> track_worker_pool;
+            if (have_track_processing && track_threads > 0) {
+                track_worker_pool.reset(new TrackWorkerPool(&track_processor, reader->GetNumTrackReaders(),
+                                                            track_threads, MAX_TRACK_QUEUED_FRAMES));
+            }
+
             // choose number of samples to read in one go
             uint32_t max_samples_per_read = 1;
             if (!have_video && edit_rate == SAMPLING_RATE_48K)
@@ -2901,9 +3112,22 @@ int main(int argc, const char** argv)
             bool gf_read_failure = false;
             int64_t gf_failure_num_read = 0;
             uint32_t gf_failure_start = 0;
+            // wait for the input files to grow instead of sleeping after a failed read
+            // stdin and HTTP inputs can't be watched
+            AppGrowingFileWatcher gf_watcher;
+            if (gf_follow) {
+                size_t i;
+                for (i = 0; i < input_filenames.size(); i++) {
+                    if (input_filenames[i][0] && !mxf_http_is_url(input_filenames[i]))
+                        gf_watcher.AddFile(input_filenames[i]);
+                }
+                if (gf_watcher.GetNumFiles() == 0) {
+                    log_warn("Ignoring --gf-follow because none of the input files can be watched\n");
+                    gf_follow = false;
+                }
+            }
 
             // read data
-            bmx::ByteArray sound_buffer;
             int64_t total_num_read = 0;
             while (true)
             {
@@ -2911,6 +3135,11 @@ int main(int argc, const char** argv)
                 if (num_read == 0) {
                     if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries)
                         break;
+                    if (gf_follow) {
+                        if (!gf_watcher.WaitForGrowth((uint32_t)(gf_retry_delay * 1000)))
+                            gf_retry_count++;
+                        continue;
+                    }
                     gf_retry_count++;
                     gf_read_failure = true;
                     if (gf_retry_delay > 0.0) {
@@ -2941,40 +3170,32 @@ int main(int argc, const char** argv)
                             continue;
                         }
 
-                        if (!track_checksums.empty()) {
+                        if (check_app_crc32 || app_crc32_file) {
+                            const SystemScheme1Metadata *ss1_meta;
                             size_t m;
-                            for (m = 0; m < track_checksums[i].size(); m++)
-                                track_checksums[i][m].Update(frame->GetBytes(), frame->GetSize());
-                        }
+                            for (m = 0; (ss1_meta = dynamic_cast<const SystemScheme1Metadata*>(
+                                            frame->FindMetadata(SYSTEM_SCHEME_1_FMETA_NUM_ID, m))) != 0; m++)
+                            {
+                                if (ss1_meta->GetType() != SystemScheme1Metadata::APP_CHECKSUM)
+                                    continue;
 
-                        if (check_app_crc32 || app_crc32_file) {
-                            const vector<FrameMetadata*> *metadata = frame->GetMetadata(SYSTEM_SCHEME_1_FMETA_ID);
-                            if (metadata) {
-                                size_t m;
-                                for (m = 0; m < metadata->size(); m++) {
-                                    const SystemScheme1Metadata *ss1_meta =
-                                        dynamic_cast<const SystemScheme1Metadata*>((*metadata)[m]);
-                                    if (ss1_meta->GetType() != SystemScheme1Metadata::APP_CHECKSUM)
-                                        continue;
-
-                                    const SS1APPChecksum *checksum = dynamic_cast<const SS1APPChecksum*>(ss1_meta);
-
-                                    if (app_crc32_file)
-                                        crc32_data[i] = checksum->mCRC32;
-
-                                    if (check_app_crc32) {
-                                        uint32_t crc32;
-                                        crc32_init(&crc32);
-                                        crc32_update(&crc32, frame->GetBytes(), frame->GetSize());
-                                        crc32_final(&crc32);
-
-                                        if (crc32 != checksum->mCRC32)
-                                            track_crc32_data[i].error_count++;
-                                        track_crc32_data[i].check_count++;
-                                    }
-
-                                    break;
+                                const SS1APPChecksum *checksum = dynamic_cast<const SS1APPChecksum*>(ss1_meta);
+
+                                if (app_crc32_file)
+                                    crc32_data[i] = checksum->mCRC32;
+
+                                if (check_app_crc32) {
+                                    uint32_t crc32;
+                                    crc32_init(&crc32);
+                                    crc32_update(&crc32, frame->GetBytes(), frame->GetSize());
+                                    crc32_final(&crc32);
+
+                                    if (crc32 != checksum->mCRC32)
+                                        track_crc32_data[i].error_count++;
+                                    track_crc32_data[i].check_count++;
                                 }
+
+                                break;
                             }
                             if (check_app_crc32)
                                 track_crc32_data[i].total_read++;
@@ -2983,32 +3204,30 @@ int main(int argc, const char** argv)
                         if (!have_app_tc && file_reader &&
                             ((app_events_mask && extract_app_events_tc) || app_tc_file))
                         {
-                            const vector<FrameMetadata*> *metadata = frame->GetMetadata(SYSTEM_SCHEME_1_FMETA_ID);
-                            if (metadata) {
-                                size_t i;
-                                for (i = 0; i < metadata->size(); i++) {
-                                    const SystemScheme1Metadata *ss1_meta =
-                                        dynamic_cast<const SystemScheme1Metadata*>((*metadata)[i]);
-                                    if (ss1_meta->GetType() != SystemScheme1Metadata::TIMECODE_ARRAY)
-                                        continue;
-
-                                    const SS1TimecodeArray *tc_array = dynamic_cast<const SS1TimecodeArray*>(ss1_meta);
-                                    if (app_events_mask && extract_app_events_tc) {
-                                        app_output.AddEventTimecodes(frame->position, tc_array->GetVITC(),
-                                                                     tc_array->GetLTC());
-                                    }
-                                    if (app_tc_file) {
-                                        Timecode ctc(edit_rate, false, frame->position);
-                                        CHECK_FPRINTF(app_tc_filename,
-                                                      fprintf(app_tc_file, "C%s V%s L%s\n",
-                                                              get_timecode_string(ctc).c_str(),
-                                                              get_timecode_string(tc_array->GetVITC()).c_str(),
-                                                              get_timecode_string(tc_array->GetLTC()).c_str()));
-                                    }
-
-                                    have_app_tc = true;
-                                    break;
+                            const SystemScheme1Metadata *ss1_meta;
+                            size_t m;
+                            for (m = 0; (ss1_meta = dynamic_cast<const SystemScheme1Metadata*>(
+                                            frame->FindMetadata(SYSTEM_SCHEME_1_FMETA_NUM_ID, m))) != 0; m++)
+                            {
+                                if (ss1_meta->GetType() != SystemScheme1Metadata::TIMECODE_ARRAY)
+                                    continue;
+
+                                const SS1TimecodeArray *tc_array = dynamic_cast<const SS1TimecodeArray*>(ss1_meta);
+                                if (app_events_mask && extract_app_events_tc) {
+                                    app_output.AddEventTimecodes(frame->position, tc_array->GetVITC(),
+                                                                 tc_array->GetLTC());
+                                }
+                                if (app_tc_file) {
+                                    Timecode ctc(edit_rate, false, frame->position);
+                                    CHECK_FPRINTF(app_tc_filename,
+                                                  fprintf(app_tc_file, "C%s V%s L%s\n",
+                                                          get_timecode_string(ctc).c_str(),
+                                                          get_timecode_string(tc_array->GetVITC()).c_str(),
+                                                          get_timecode_string(tc_array->GetLTC()).c_str()));
                                 }
+
+                                have_app_tc = true;
+                                break;
                             }
                         }
 
@@ -3021,43 +3240,6 @@ int main(int argc, const char** argv)
                             write_index(info_writer, total_num_read - num_read, i, frame);
                         }
 
-                        if (ess_output_prefix) {
-                            FILE *file;
-                            string filename;
-                            const MXFSoundTrackInfo *sound_info = dynamic_cast<const MXFSoundTrackInfo*>(track_info);
-                            if (sound_info && deinterleave && sound_info->channel_count > 1 &&
-                                sound_info->essence_type != MGA && sound_info->essence_type != MGA_SADM)
-                            {
-                                sound_buffer.Allocate(frame->GetSize()); // more than enough
-                                uint32_t c;
-                                for (c = 0; c < sound_info->channel_count; c++) {
-                                    if (sound_info->essence_type == D10_AES3_PCM) {
-                                        convert_aes3_to_pcm(frame->GetBytes(), frame->GetSize(), false,
-                                                            sound_info->bits_per_sample, c,
-                                                            sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                        sound_buffer.SetSize(sound_info->block_align / sound_info->channel_count *
-                                                                get_aes3_sample_count(frame->GetBytes(), frame->GetSize()));
-                                    } else {
-                                        deinterleave_audio(frame->GetBytes(), frame->GetSize(),
-                                                           sound_info->bits_per_sample, sound_info->channel_count, c,
-                                                           sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                        sound_buffer.SetSize(frame->GetSize() / sound_info->channel_count);
-                                    }
-                                    output_file_manager.GetTrackFile(i, c, &file, &filename);
-                                    write_data(file, filename,
-                                               sound_buffer.GetBytes(), sound_buffer.GetSize(),
-                                               (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()),
-                                               &frame->element_key);
-                                }
-                            } else if (track_info->essence_type != TIMED_TEXT) {  // timed text is written at the end
-                                output_file_manager.GetTrackFile(i, &file, &filename);
-                                write_data(file, filename,
-                                           frame->GetBytes(), frame->GetSize(),
-                                           (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()),
-                                           &frame->element_key);
-                            }
-                        }
-
                         if (track_info->essence_type == ANC_DATA && rdd6_filename && !rdd6_failed && !rdd6_descriptions_complete) {
                             if ((last_rdd6_frame  < 0 && frame->position == rdd6_frame_min) ||
                                 (last_rdd6_frame >= 0 && frame->position <= rdd6_frame_max &&
@@ -3075,7 +3257,13 @@ int main(int argc, const char** argv)
                             }
                         }
 
-                        delete frame;
+                        if (track_worker_pool) {
+                            track_worker_pool->Submit(i, frame);
+                        } else {
+                            if (have_track_processing)
+                                track_processor.ProcessFrame(i, frame);
+                            delete frame;
+                        }
                     }
                 }
 
@@ -3101,6 +3289,9 @@ int main(int argc, const char** argv)
                 else if (realtime)
                     rt_sleep(rt_factor, rt_start, edit_rate, total_num_read);
             }
+            if (track_worker_pool)
+                track_worker_pool->Finish();
+
             if (reader->ReadError()) {
                 bmx::log(reader->IsComplete() ? ERROR_LOG : WARN_LOG,
                          "A read error occurred: %s\n", reader->ReadErrorMessage().c_str());
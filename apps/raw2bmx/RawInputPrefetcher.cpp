@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "RawInputPrefetcher.h"
+
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+RawInputSamples::RawInputSamples()
+{
+    read_num_samples = 0;
+    num_samples = 0;
+}
+
+RawInputSamples::~RawInputSamples()
+{
+    Clear();
+}
+
+void RawInputSamples::Clear()
+{
+    size_t i;
+    for (i = 0; i < frames.size(); i++)
+        delete frames[i];
+    frames.clear();
+
+    read_num_samples = 0;
+    num_samples = 0;
+    data.SetSize(0);
+}
+
+
+
+RawInputPrefetcher::RawInputPrefetcher(RawInput *input, ReadFunction read_function, uint32_t max_samples_per_read,
+                                       size_t queue_size)
+{
+    BMX_CHECK(queue_size > 0);
+
+    mInput = input;
+    mReadFunction = read_function;
+    mMaxSamplesPerRead = max_samples_per_read;
+    mStop = false;
+    mEnd = false;
+
+    // 1 extra for the samples popped by the writer
+    size_t i;
+    for (i = 0; i < queue_size + 1; i++) {
+        mSamples.push_back(new RawInputSamples());
+        mFreeSamples.push_back(mSamples.back());
+    }
+}
+
+RawInputPrefetcher::~RawInputPrefetcher()
+{
+    Stop();
+
+    size_t i;
+    for (i = 0; i < mSamples.size(); i++)
+        delete mSamples[i];
+}
+
+void RawInputPrefetcher::Start()
+{
+    BMX_ASSERT(!mThread.joinable());
+
+    mThread = thread(&RawInputPrefetcher::ReadSamples, this);
+}
+
+void RawInputPrefetcher::Stop()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+        mCond.notify_all();
+    }
+    if (mThread.joinable())
+        mThread.join();
+
+    while (!mQueue.empty()) {
+        mQueue.front()->Clear();
+        mFreeSamples.push_back(mQueue.front());
+        mQueue.pop_front();
+    }
+}
+
+RawInputSamples* RawInputPrefetcher::Pop()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (mQueue.empty() && !mEnd)
+        mCond.wait(lock);
+
+    if (mQueue.empty()) {
+        if (mException)
+            rethrow_exception(mException);
+        BMX_EXCEPTION(("Input samples requested after the end of the input"));
+    }
+
+    RawInputSamples *samples = mQueue.front();
+    mQueue.pop_front();
+    mCond.notify_all();
+
+    return samples;
+}
+
+void RawInputPrefetcher::Release(RawInputSamples *samples)
+{
+    samples->Clear();
+
+    lock_guard<mutex> lock(mMutex);
+    mFreeSamples.push_back(samples);
+    mCond.notify_all();
+}
+
+void RawInputPrefetcher::ReadSamples()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && mFreeSamples.empty())
+            mCond.wait(lock);
+        if (mStop)
+            break;
+
+        RawInputSamples *samples = mFreeSamples.back();
+        mFreeSamples.pop_back();
+        lock.unlock();
+
+        // exceptions are passed on to the writer thread in Pop()
+        exception_ptr read_exception;
+        try
+        {
+            mReadFunction(mInput, mMaxSamplesPerRead, samples);
+        }
+        catch (...)
+        {
+            read_exception = current_exception();
+        }
+
+        lock.lock();
+        if (read_exception) {
+            samples->Clear();
+            mFreeSamples.push_back(samples);
+            mException = read_exception;
+            mEnd = true;
+        } else {
+            mQueue.push_back(samples);
+            if (samples->read_num_samples == 0)
+                mEnd = true;
+        }
+        mCond.notify_all();
+
+        if (mEnd)
+            break;
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_RAW_INPUT_PREFETCHER_H_
+#define BMX_RAW_INPUT_PREFETCHER_H_
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+#include <bmx/ByteArray.h>
+#include <bmx/frame/Frame.h>
+
+typedef struct RawInput RawInput;
+
+
+namespace bmx
+{
+
+
+class RawInputSamples
+{
+public:
+    RawInputSamples();
+    ~RawInputSamples();
+
+    void Clear();
+
+public:
+    uint32_t read_num_samples;      // result of the read; 0 signals the end of the input
+    uint32_t num_samples;           // raw reader: number of samples in data
+    ByteArray data;                 // raw reader: copy of the sample data
+    std::vector<Frame*> frames;     // wave reader: frame for each track, owned by this object
+};
+
+
+// The RawInputPrefetcher reads samples from a single input in a separate thread and queues them
+// for the writer. Samples are read using the read function, which must only use the input's readers.
+// Those readers are owned by the prefetch thread until Stop() is called.
+
+class RawInputPrefetcher
+{
+public:
+    typedef void (*ReadFunction)(RawInput *input, uint32_t max_samples_per_read, RawInputSamples *samples);
+
+public:
+    RawInputPrefetcher(RawInput *input, ReadFunction read_function, uint32_t max_samples_per_read,
+                       size_t queue_size);
+    ~RawInputPrefetcher();
+
+    void Start();
+    void Stop();
+
+    RawInputSamples* Pop();                 // blocks until samples are available
+    void Release(RawInputSamples *samples); // returns popped samples
+
+private:
+    void ReadSamples();
+
+private:
+    RawInput *mInput;
+    ReadFunction mReadFunction;
+    uint32_t mMaxSamplesPerRead;
+
+    std::vector<RawInputSamples*> mSamples;
+    std::vector<RawInputSamples*> mFreeSamples;
+    std::deque<RawInputSamples*> mQueue;
+    bool mStop;
+    bool mEnd;
+    std::exception_ptr mException;
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::thread mThread;
+};
+
+
+};
+
+
+#endif
@@ -47,6 +47,7 @@
 #include <sstream>
 
 #include "RawInputTrack.h"
+#include "RawInputPrefetcher.h"
 #include "../writers/OutputTrack.h"
 #include "../writers/TrackMapper.h"
 #include <bmx/clip_writer/ClipWriter.h>
@@ -154,6 +155,8 @@ struct RawInput
     RawEssenceReader *raw_reader;
     WaveReader *wave_reader;
     uint32_t channel_count;
+    RawInputPrefetcher *prefetcher;
+    RawInputSamples *prefetch_samples;
     TimedTextManifestParser *timed_text_manifest;
 
     uint32_t sample_sequence[32];
@@ -269,6 +272,24 @@ static uint32_t read_samples(RawInput *input, uint32_t max_samples_per_read)
     }
 }
 
+static void prefetch_read_samples(RawInput *input, uint32_t max_samples_per_read, RawInputSamples *samples)
+{
+    samples->read_num_samples = read_samples(input, max_samples_per_read);
+    if (samples->read_num_samples == 0)
+        return;
+
+    // take a copy of the raw reader data and take ownership of the wave reader frames because the
+    // reader will have moved on by the time the writer uses them
+    if (input->raw_reader) {
+        samples->num_samples = input->raw_reader->GetNumSamples();
+        samples->data.CopyBytes(input->raw_reader->GetSampleData(), input->raw_reader->GetSampleDataSize());
+    } else {
+        uint32_t i;
+        for (i = 0; i < input->wave_reader->GetNumTracks(); i++)
+            samples->frames.push_back(input->wave_reader->GetTrack(i)->GetFrameBuffer()->GetLastFrame(true));
+    }
+}
+
 static bool open_raw_reader(RawInput *input)
 {
     if (input->raw_reader) {
@@ -337,11 +358,15 @@ static bool open_raw_reader(RawInput *input)
     return true;
 }
 
-static void open_wave_reader(RawInput *input)
+static void open_wave_reader(RawInput *input, bool use_mmap_file)
 {
     BMX_ASSERT(!input->wave_reader);
 
-    input->wave_reader = WaveReader::Open(WaveFileIO::OpenRead(input->filename), true);
+    WaveFileIO *wave_file = WaveFileIO::OpenRead(input->filename);
+    if (use_mmap_file && !wave_file->MapFile())
+        log_warn("Using file reads because wave file '%s' could not be memory-mapped\n", input->filename);
+
+    input->wave_reader = WaveReader::Open(wave_file, true);
     if (!input->wave_reader)
         BMX_EXCEPTION(("Failed to parse wave file '%s'", input->filename));
 }
@@ -390,6 +415,10 @@ static void init_input(RawInput *input)
 
 static void clear_input(RawInput *input)
 {
+    if (input->prefetcher && input->prefetch_samples)
+        input->prefetcher->Release(input->prefetch_samples);
+    delete input->prefetcher;
+    input->prefetcher = 0;
     delete input->raw_reader;
     delete input->wave_reader;
     delete input->filter;
@@ -460,6 +489,9 @@ static void usage(const char *cmd)
     printf("  --dur <frame>           Set the duration in frames in frame rate units. Default is minimum input duration\n");
     printf("  --rt <factor>           Wrap at realtime rate x <factor>, where <factor> is a floating point value\n");
     printf("                          <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    printf("  --prefetch <size>       Read each input in a separate thread, with up to <size> reads queued ahead of the writer\n");
+    printf("                          This allows reads from inputs with different latencies, e.g. network and local storage, to overlap\n");
+    printf("  --mmap-file             Use memory-mapped file I/O for the input Wave files\n");
     printf("  --avcihead <format> <file> <offset>\n");
     printf("                          Default AVC-Intra sequence header data (512 bytes) to use when the input file does not have it\n");
     printf("                          <format> is a comma separated list of one or more of the following integer values:\n");
@@ -538,6 +570,8 @@ static void usage(const char *cmd)
     printf("    --body-part             Create separate body partitions for essence data\n");
     printf("                            and don't create separate body partitions for index table segments\n");
     printf("    --repeat-index          Repeat the index table segments in the footer partition\n");
+    printf("    --spill-index           Keep completed VBE index table segments in a temporary file rather than in memory until they are written\n");
+    printf("    --pipelined-write       Write the file in a separate I/O thread, overlapping essence processing with file writes\n");
     printf("    --clip-wrap             Use clip wrapping for a single sound track\n");
     printf("    --mp-track-num          Use the material package track number property to define a track order. By default the track number is set to 0\n");
     printf("    --aes-3                 Use AES-3 audio mapping\n");
@@ -962,11 +996,15 @@ int main(int argc, const char** argv)
     bool min_part = false;
     bool body_part = false;
     bool repeat_index = false;
+    bool spill_index = false;
+    bool pipelined_write = false;
     bool op1a_clip_wrap = false;
     bool allow_no_avci_head = false;
     bool force_no_avci_head = false;
     bool realtime = false;
     float rt_factor = 1.0;
+    uint32_t prefetch_size = 0;
+    bool use_mmap_file = false;
     bool product_info_set = false;
     string company_name;
     string product_name;
@@ -1222,6 +1260,26 @@ int main(int argc, const char** argv)
             realtime = true;
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--prefetch") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &prefetch_size) != 1 || prefetch_size == 0)
+            {
+                usage_ref(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
+        {
+            use_mmap_file = true;
+        }
         else if (strcmp(argv[cmdln_index], "--avcihead") == 0)
         {
             if (cmdln_index + 3 >= argc)
@@ -1504,6 +1562,14 @@ int main(int argc, const char** argv)
         {
             repeat_index = true;
         }
+        else if (strcmp(argv[cmdln_index], "--spill-index") == 0)
+        {
+            spill_index = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--pipelined-write") == 0)
+        {
+            pipelined_write = true;
+        }
         else if (strcmp(argv[cmdln_index], "--mp-track-num") == 0)
         {
             mp_track_num = true;
@@ -4253,7 +4319,7 @@ int main(int argc, const char** argv)
 
             if (input->essence_type == WAVE_PCM) {
                 if (input->is_wave) {
-                    open_wave_reader(input);
+                    open_wave_reader(input, use_mmap_file);
                     BMX_ASSERT(input->wave_reader->GetNumTracks() > 0);
 
                     input->sampling_rate   = input->wave_reader->GetSamplingRate();
@@ -5120,6 +5186,10 @@ int main(int argc, const char** argv)
 
             if (repeat_index)
                 op1a_clip->SetRepeatIndexTable(true);
+            if (spill_index)
+                op1a_clip->SetSpillIndexTable(true);
+            if (pipelined_write)
+                op1a_clip->SetPipelinedWrite(true);
             if (op1a_index_follows)
                 op1a_clip->SetIndexFollowsEssence(true);
 
@@ -6139,6 +6209,20 @@ int main(int argc, const char** argv)
 
         clip->PrepareWrite();
 
+
+        // start reading inputs in separate threads
+
+        if (prefetch_size > 0) {
+            for (i = 0; i < inputs.size(); i++) {
+                RawInput *input = &inputs[i];
+                if (!input->disabled && input->essence_type != TIMED_TEXT) {
+                    input->prefetcher = new RawInputPrefetcher(input, prefetch_read_samples, max_samples_per_read,
+                                                               prefetch_size);
+                    input->prefetcher->Start();
+                }
+            }
+        }
+
         // write samples
         bmx::ByteArray pcm_buffer;
         int64_t total_read = 0;
@@ -6153,7 +6237,14 @@ int main(int argc, const char** argv)
             for (i = 0; i < inputs.size(); i++) {
                 RawInput *input = &inputs[i];
                 if (!input->disabled && input->essence_type != TIMED_TEXT) {
-                    num_samples = read_samples(input, max_samples_per_read);
+                    if (input->prefetcher) {
+                        if (input->prefetch_samples)
+                            input->prefetcher->Release(input->prefetch_samples);
+                        input->prefetch_samples = input->prefetcher->Pop();
+                        num_samples = input->prefetch_samples->read_num_samples;
+                    } else {
+                        num_samples = read_samples(input, max_samples_per_read);
+                    }
                     if (num_samples < min_num_samples) {
                         min_num_samples = num_samples;
                         if (min_num_samples == 0)
@@ -6182,25 +6273,39 @@ int main(int argc, const char** argv)
                     uint32_t input_channel_index = input_track->GetInputChannelIndex(k);
 
                     if (input->raw_reader) {
-                        num_samples = input->raw_reader->GetNumSamples();
+                        unsigned char *sample_data;
+                        uint32_t sample_data_size;
+                        if (input->prefetcher) {
+                            num_samples = input->prefetch_samples->num_samples;
+                            sample_data = input->prefetch_samples->data.GetBytes();
+                            sample_data_size = input->prefetch_samples->data.GetSize();
+                        } else {
+                            num_samples = input->raw_reader->GetNumSamples();
+                            sample_data = input->raw_reader->GetSampleData();
+                            sample_data_size = input->raw_reader->GetSampleDataSize();
+                        }
                         if (max_samples_per_read > 1 && num_samples > min_num_samples)
                             num_samples = min_num_samples;
                         if (input->essence_type == WAVE_PCM && input->channel_count > 1) {
-                            pcm_buffer.Allocate(input->raw_reader->GetSampleDataSize() / input->channel_count);
-                            deinterleave_audio(input->raw_reader->GetSampleData(), input->raw_reader->GetSampleDataSize(),
+                            pcm_buffer.Allocate(sample_data_size / input->channel_count);
+                            deinterleave_audio(sample_data, sample_data_size,
                                                input->bits_per_sample, input->channel_count, input_channel_index,
                                                pcm_buffer.GetBytes(), pcm_buffer.GetAllocatedSize());
-                            pcm_buffer.SetSize(input->raw_reader->GetSampleDataSize() / input->channel_count);
+                            pcm_buffer.SetSize(sample_data_size / input->channel_count);
                             output_track->WriteSamples(output_channel_index,
                                                        pcm_buffer.GetBytes(), pcm_buffer.GetSize(),
                                                        num_samples);
                         } else {
                             output_track->WriteSamples(output_channel_index,
-                                                       input->raw_reader->GetSampleData(), input->raw_reader->GetSampleDataSize(),
+                                                       sample_data, sample_data_size,
                                                        num_samples);
                         }
                     } else {
-                        Frame *frame = input->wave_reader->GetTrack(input_channel_index)->GetFrameBuffer()->GetLastFrame(false);
+                        Frame *frame;
+                        if (input->prefetcher)
+                            frame = input->prefetch_samples->frames[input_channel_index];
+                        else
+                            frame = input->wave_reader->GetTrack(input_channel_index)->GetFrameBuffer()->GetLastFrame(false);
                         BMX_ASSERT(frame);
                         num_samples = frame->num_samples;
                         if (max_samples_per_read > 1 && num_samples > min_num_samples)
@@ -6208,7 +6313,7 @@ int main(int argc, const char** argv)
                         output_track->WriteSamples(output_channel_index,
                                                    (unsigned char*)frame->GetBytes(), frame->GetSize(),
                                                    num_samples);
-                        // frames popped and deleted in read_samples()
+                        // frames popped and deleted in read_samples() or RawInputSamples::Clear()
                     }
 
                     if (convert_essence_type_to_data_def(input->essence_type) == MXF_SOUND_DDEF &&
@@ -6298,6 +6403,12 @@ int main(int argc, const char** argv)
     }
 
 
+    // stop any input threads that are still running after an error
+    size_t i;
+    for (i = 0; i < inputs.size(); i++)
+        delete inputs[i].prefetcher;
+
+
     if (log_filename)
         close_log_file();
 
@@ -81,6 +81,10 @@ OutputTrack::OutputTrack(ClipWriterTrack *clip_writer_track)
     mFilter = 0;
     mNumSamples = 0;
     mAvailableChannelCount = 0;
+    mHoldSamples = false;
+    mHeldData = 0;
+    mHeldSize = 0;
+    mHeldNumSamples = 0;
 }
 
 OutputTrack::~OutputTrack()
@@ -128,6 +132,11 @@ void OutputTrack::SetFilter(EssenceFilter *filter)
     mFilter = filter;
 }
 
+void OutputTrack::SetHoldSamples(bool enable)
+{
+    mHoldSamples = enable;
+}
+
 bool OutputTrack::IsSilenceTrack()
 {
     return mInputMaps.empty() && GetSoundInfo();
@@ -199,28 +208,7 @@ void OutputTrack::WriteSamples(uint32_t output_channel_index,
         output_size = input_size;
     }
 
-    if (mFilter) {
-        if (mFilter->SupportsInPlaceFilter()) {
-            mFilter->Filter(output_data, output_size);
-            mClipWriterTrack->WriteSamples(output_data, output_size, mNumSamples);
-        } else {
-            unsigned char *f_data = 0;
-            try
-            {
-                uint32_t f_size;
-                mFilter->Filter(output_data, output_size, &f_data, &f_size);
-                mClipWriterTrack->WriteSamples(f_data, f_size, mNumSamples);
-                delete [] f_data;
-            }
-            catch (...)
-            {
-                delete [] f_data;
-                throw;
-            }
-        }
-    } else {
-        mClipWriterTrack->WriteSamples(output_data, output_size, mNumSamples);
-    }
+    WriteOutputSamples(output_data, output_size, mNumSamples);
 
     mNumSamples = 0;
     mAvailableChannelCount = 0;
@@ -243,28 +231,7 @@ void OutputTrack::WriteSilenceSamples(uint32_t num_samples)
         mSampleBuffer.Allocate(frame_size); // will clear data
     mSampleBuffer.SetSize(frame_size);
 
-    if (mFilter) {
-        if (mFilter->SupportsInPlaceFilter()) {
-            mFilter->Filter(mSampleBuffer.GetBytes(), mSampleBuffer.GetSize());
-            mClipWriterTrack->WriteSamples(mSampleBuffer.GetBytes(), mSampleBuffer.GetSize(), num_samples);
-        } else {
-            unsigned char *f_data = 0;
-            try
-            {
-                uint32_t f_size;
-                mFilter->Filter(mSampleBuffer.GetBytes(), mSampleBuffer.GetSize(), &f_data, &f_size);
-                mClipWriterTrack->WriteSamples(f_data, f_size, num_samples);
-                delete [] f_data;
-            }
-            catch (...)
-            {
-                delete [] f_data;
-                throw;
-            }
-        }
-    } else {
-        mClipWriterTrack->WriteSamples(mSampleBuffer.GetBytes(), mSampleBuffer.GetSize(), num_samples);
-    }
+    WriteOutputSamples(mSampleBuffer.GetBytes(), mSampleBuffer.GetSize(), num_samples);
 }
 
 void OutputTrack::SkipPrecharge(int64_t num_read)
@@ -272,3 +239,57 @@ void OutputTrack::SkipPrecharge(int64_t num_read)
     BMX_ASSERT(mRemSkipPrecharge >= num_read);
     mRemSkipPrecharge -= num_read;
 }
+
+void OutputTrack::WriteHeldSamples()
+{
+    if (mHeldNumSamples == 0)
+        return;
+
+    mClipWriterTrack->WriteSamples(mHeldData, mHeldSize, mHeldNumSamples);
+    ClearHeldSamples();
+}
+
+void OutputTrack::ClearHeldSamples()
+{
+    mHeldData = 0;
+    mHeldSize = 0;
+    mHeldNumSamples = 0;
+}
+
+void OutputTrack::WriteOutputSamples(unsigned char *data, uint32_t size, uint32_t num_samples)
+{
+    unsigned char *f_data = 0;
+    try
+    {
+        if (mFilter) {
+            if (mFilter->SupportsInPlaceFilter()) {
+                mFilter->Filter(data, size);
+            } else {
+                mFilter->Filter(data, size, &f_data, &size);
+                data = f_data;
+            }
+        }
+
+        if (mHoldSamples) {
+            BMX_ASSERT(mHeldNumSamples == 0);
+            // the sample buffer is not modified until the next write and so doesn't need copying
+            if (data == mSampleBuffer.GetBytes()) {
+                mHeldData = data;
+            } else {
+                mHeldBuffer.CopyBytes(data, size);
+                mHeldData = mHeldBuffer.GetBytes();
+            }
+            mHeldSize = size;
+            mHeldNumSamples = num_samples;
+        } else {
+            mClipWriterTrack->WriteSamples(data, size, num_samples);
+        }
+
+        delete [] f_data;
+    }
+    catch (...)
+    {
+        delete [] f_data;
+        throw;
+    }
+}
@@ -79,6 +79,10 @@ public:
     void SetSkipPrecharge(int64_t precharge);
     void SetFilter(EssenceFilter *filter);
 
+    // Hold the output samples instead of writing them to the clip writer track, e.g. to write the
+    // samples for all Wave tracks together. The samples are held until written or cleared
+    void SetHoldSamples(bool enable);
+
 public:
     void WriteSamples(uint32_t output_channel_index, unsigned char *data, uint32_t size, uint32_t num_samples);
     void WritePaddingSamples(uint32_t output_channel_index, uint32_t num_samples);
@@ -87,6 +91,9 @@ public:
 
     void SkipPrecharge(int64_t num_read);
 
+    void WriteHeldSamples();
+    void ClearHeldSamples();
+
 public:
     typedef struct
     {
@@ -105,8 +112,15 @@ public:
     OutputTrackSoundInfo* GetSoundInfo();
     InputTrack* GetFirstInputTrack();
 
+    bool HaveHeldSamples()                  { return mHeldNumSamples > 0; }
+    const unsigned char* GetHeldSamples()   { return mHeldData; }
+    uint32_t GetHeldNumSamples()            { return mHeldNumSamples; }
+
     const std::map<uint32_t, InputMap>& GetInputMaps() const { return mInputMaps; }
 
+private:
+    void WriteOutputSamples(unsigned char *data, uint32_t size, uint32_t num_samples);
+
 private:
     ClipWriterTrack *mClipWriterTrack;
     std::map<uint32_t, InputMap> mInputMaps;
@@ -117,6 +131,11 @@ private:
     ByteArray mSampleBuffer;
     uint32_t mNumSamples;
     size_t mAvailableChannelCount;
+    bool mHoldSamples;
+    ByteArray mHeldBuffer;
+    const unsigned char *mHeldData;
+    uint32_t mHeldSize;
+    uint32_t mHeldNumSamples;
     OutputTrackSoundInfo mSoundInfo;
 };
 
@@ -0,0 +1,8 @@
+if(threads_link_lib)
+    return()
+endif()
+
+
+find_package(Threads REQUIRED)
+
+set(threads_link_lib Threads::Threads)
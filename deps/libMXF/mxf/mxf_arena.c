@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_macros.h>
+
+
+#define ARENA_ALIGNMENT     8
+#define ALIGN_SIZE(size)    (((size) + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1))
+#define BLOCK_HEADER_SIZE   ALIGN_SIZE(sizeof(MXFArenaBlock))
+
+
+static MXFArenaBlock* add_block(MXFArena *arena, size_t size, int atEnd)
+{
+    MXFArenaBlock *newBlock;
+    MXFArenaBlock *lastBlock;
+
+    newBlock = (MXFArenaBlock*)malloc(BLOCK_HEADER_SIZE + size);
+    if (!newBlock)
+    {
+        mxf_log_error("Failed to allocate %" PRIszt " byte arena block" LOG_LOC_FORMAT, size, LOG_LOC_PARAMS);
+        return NULL;
+    }
+    newBlock->next = NULL;
+    newBlock->size = size;
+    newBlock->used = 0;
+
+    /* the first block is the current block. Dedicated blocks for large allocations are added at the end so that
+       the current block stays in use */
+    if (atEnd && arena->blocks)
+    {
+        lastBlock = arena->blocks;
+        while (lastBlock->next)
+            lastBlock = lastBlock->next;
+        lastBlock->next = newBlock;
+    }
+    else
+    {
+        newBlock->next = arena->blocks;
+        arena->blocks = newBlock;
+    }
+
+    arena->allocatedSize += BLOCK_HEADER_SIZE + size;
+
+    return newBlock;
+}
+
+
+
+int mxf_create_arena(MXFArena **arena, size_t blockSize)
+{
+    MXFArena *newArena;
+
+    CHK_MALLOC_ORET(newArena, MXFArena);
+    memset(newArena, 0, sizeof(MXFArena));
+    newArena->blockSize = ALIGN_SIZE(blockSize == 0 ? MXF_ARENA_DEFAULT_BLOCK_SIZE : blockSize);
+
+    *arena = newArena;
+    return 1;
+}
+
+void mxf_free_arena(MXFArena **arena)
+{
+    MXFArenaBlock *block;
+    MXFArenaBlock *nextBlock;
+
+    if (!(*arena))
+        return;
+
+    block = (*arena)->blocks;
+    while (block) {
+        nextBlock = block->next;
+        free(block);
+        block = nextBlock;
+    }
+
+    SAFE_FREE(*arena);
+}
+
+void* mxf_arena_alloc(MXFArena *arena, size_t size)
+{
+    MXFArenaBlock *block;
+    void *result;
+
+    size = ALIGN_SIZE(size == 0 ? 1 : size);
+
+    if (size > arena->blockSize / 4)
+    {
+        block = add_block(arena, size, 1);
+    }
+    else
+    {
+        block = arena->blocks;
+        if (!block || block->used + size > block->size)
+            block = add_block(arena, arena->blockSize, 0);
+    }
+    if (!block)
+        return NULL;
+
+    result = (unsigned char*)block + BLOCK_HEADER_SIZE + block->used;
+    block->used += size;
+
+    return result;
+}
+
+size_t mxf_get_arena_allocated_size(MXFArena *arena)
+{
+    return arena->allocatedSize;
+}
+
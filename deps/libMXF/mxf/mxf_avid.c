@@ -547,6 +547,30 @@ fail:
     return 0;
 }
 
+int mxf_avid_read_lazy_header_metadata(MXFFile *mxfFile, int skipDataDefs, MXFHeaderMetadata *headerMetadata,
+                                       uint64_t headerByteCount, const mxfKey *key, uint8_t llen, uint64_t len)
+{
+    MXFAvidReadFilter readFilter;
+    memset(&readFilter, 0, sizeof(readFilter));
+
+    CHK_OFAIL(initialise_read_filter(&readFilter, skipDataDefs));
+
+    /* the filter is cleared on return and so it can't be called when the deferred sets are read. The
+       metadictionary and dictionary filters only act before a set is read and so it isn't needed */
+    CHK_OFAIL(readFilter.metaDictFilter.after_set_read == NULL && readFilter.dictFilter.after_set_read == NULL);
+    readFilter.filter.after_set_read = NULL;
+
+    CHK_OFAIL(mxf_read_lazy_header_metadata(mxfFile, &readFilter.filter, headerMetadata, headerByteCount,
+                                            key, llen, len));
+
+    clear_read_filter(&readFilter);
+    return 1;
+
+fail:
+    clear_read_filter(&readFilter);
+    return 0;
+}
+
 
 int mxf_avid_write_header_metadata(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata, MXFPartition *headerPartition)
 {
@@ -558,6 +582,8 @@ int mxf_avid_write_header_metadata(MXFFile *mxfFile, MXFHeaderMetadata *headerMe
     MXFAvidMetadataRoot root;
 
 
+    CHK_OFAIL(mxf_read_all_lazy_sets(headerMetadata));
+
     CHK_OFAIL(create_object_directory(&objectDirectory));
 
     initialise_root_set(&root);
@@ -76,6 +76,8 @@ int mxf_avid_load_extensions(MXFDataModel *dataModel);
 
 int mxf_avid_read_filtered_header_metadata(MXFFile *mxfFile, int skipDataDefs, MXFHeaderMetadata *headerMetadata,
                                            uint64_t headerByteCount, const mxfKey *key, uint8_t llen, uint64_t len);
+int mxf_avid_read_lazy_header_metadata(MXFFile *mxfFile, int skipDataDefs, MXFHeaderMetadata *headerMetadata,
+                                       uint64_t headerByteCount, const mxfKey *key, uint8_t llen, uint64_t len);
 
 int mxf_avid_write_header_metadata(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata, MXFPartition *headerPartition);
 
@@ -381,6 +381,57 @@ int64_t mxf_file_size(MXFFile *mxfFile)
     return mxfFile->size(mxfFile->sysData);
 }
 
+int mxf_file_read_ahead(MXFFile *mxfFile, int64_t offset, int64_t count)
+{
+    if (!mxfFile->read_ahead)
+        return 0;
+
+    return mxfFile->read_ahead(mxfFile->sysData, offset, count);
+}
+
+const uint8_t* mxf_file_map_data(MXFFile *mxfFile, int64_t offset, uint32_t count)
+{
+    if (!mxfFile->map_data)
+        return NULL;
+
+    return mxfFile->map_data(mxfFile->sysData, offset, count);
+}
+
+MXFFileMap* mxf_file_ref_map(MXFFile *mxfFile)
+{
+    if (!mxfFile->ref_map)
+        return NULL;
+
+    return mxfFile->ref_map(mxfFile->sysData);
+}
+
+void mxf_file_unref_map(MXFFileMap *map)
+{
+    if (map)
+        map->unref(map);
+}
+
+uint64_t mxf_file_write_vec(MXFFile *mxfFile, const MXFFileIOVec *vec, uint32_t count)
+{
+    uint64_t total = 0;
+    uint32_t i;
+
+    if (mxfFile->write_vec)
+        return mxfFile->write_vec(mxfFile->sysData, vec, count);
+
+    for (i = 0; i < count; i++) {
+        uint32_t numWrite;
+        if (vec[i].size == 0)
+            continue;
+        numWrite = mxfFile->write(mxfFile->sysData, vec[i].data, vec[i].size);
+        total += numWrite;
+        if (numWrite != vec[i].size)
+            break;
+    }
+
+    return total;
+}
+
 
 void mxf_file_set_min_llen(MXFFile *mxfFile, uint8_t llen)
 {
@@ -46,6 +46,20 @@ extern "C"
 
 typedef struct MXFFileSysData MXFFileSysData;
 
+/* a data segment in a gather write */
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t size;
+} MXFFileIOVec;
+
+/* A reference to mapped file data, returned by mxf_file_ref_map, that keeps the data returned by
+   mxf_file_map_data valid after the file is closed. Implementations embed it in their reference */
+typedef struct MXFFileMap
+{
+    void (*unref)(struct MXFFileMap *map);
+} MXFFileMap;
+
 typedef struct
 {
     /* MXF file implementations must set and implement these functions */
@@ -60,6 +74,15 @@ typedef struct
     int         (*is_seekable)  (MXFFileSysData *sysData);
     int64_t     (*size)         (MXFFileSysData *sysData);
 
+    /* MXF file implementations can optionally set these functions.
+       map_data returns a pointer to file data that remains valid until the file is closed, or until
+       the last reference returned by ref_map is released if that is later.
+       write_vec writes the segments in order and returns the total number of bytes written */
+    int         (*read_ahead)   (MXFFileSysData *sysData, int64_t offset, int64_t count);
+    const uint8_t* (*map_data)  (MXFFileSysData *sysData, int64_t offset, uint32_t count);
+    MXFFileMap*    (*ref_map)   (MXFFileSysData *sysData);
+    uint64_t    (*write_vec)    (MXFFileSysData *sysData, const MXFFileIOVec *vec, uint32_t count);
+
     /* private data for the MXF file implementation */
     void (*free_sys_data)(MXFFileSysData *sysData);
     MXFFileSysData *sysData;
@@ -92,6 +115,11 @@ int mxf_file_seek(MXFFile *mxfFile, int64_t offset, int whence);
 int64_t mxf_file_tell(MXFFile *mxfFile);
 int mxf_file_is_seekable(MXFFile *mxfFile);
 int64_t mxf_file_size(MXFFile *mxfFile);
+int mxf_file_read_ahead(MXFFile *mxfFile, int64_t offset, int64_t count);
+const uint8_t* mxf_file_map_data(MXFFile *mxfFile, int64_t offset, uint32_t count);
+MXFFileMap* mxf_file_ref_map(MXFFile *mxfFile);
+void mxf_file_unref_map(MXFFileMap *map);
+uint64_t mxf_file_write_vec(MXFFile *mxfFile, const MXFFileIOVec *vec, uint32_t count);
 
 
 void mxf_file_set_min_llen(MXFFile *mxfFile, uint8_t llen);
@@ -42,16 +42,47 @@
 #include <limits.h>
 
 #include <mxf/mxf.h>
+#include <mxf/mxf_memory_file.h>
 #include <mxf/mxf_macros.h>
 
 
+/* sets with more items than this get an item key index */
+#define ITEM_KEY_INDEX_THRESHOLD    8
+#define MIN_SET_UID_INDEX_SIZE      256
+#define SET_KEY_INDEX_SIZE          128
+
+
 
 static void free_metadata_item_value(MXFMetadataItem *item)
 {
-    SAFE_FREE(item->value);
+    if (item->isValueInArena)
+    {
+        item->value = NULL;
+        item->isValueInArena = 0;
+    }
+    else
+    {
+        SAFE_FREE(item->value);
+    }
     item->length = 0;
 }
 
+static int alloc_metadata_item_value(MXFMetadataItem *item, uint16_t len)
+{
+    if (item->set && item->set->arena)
+    {
+        CHK_ORET((item->value = (uint8_t*)mxf_arena_alloc(item->set->arena, len)) != NULL);
+        item->isValueInArena = 1;
+    }
+    else
+    {
+        CHK_MALLOC_ARRAY_ORET(item->value, uint8_t, len);
+        item->isValueInArena = 0;
+    }
+
+    return 1;
+}
+
 static void free_metadata_set_in_list(void *data)
 {
     MXFMetadataSet *set;
@@ -99,6 +130,509 @@ static int eq_pointer(void *data, void *info)
     return data == info;
 }
 
+
+/* FNV-1a hash of a 16 byte key or UUID, returning an index into a power of 2 sized table */
+static size_t hash_index(const void *keyOrUUID, size_t tableSize)
+{
+    const uint8_t *bytes = (const uint8_t*)keyOrUUID;
+    uint32_t hash = 2166136261U;
+    size_t i;
+
+    for (i = 0; i < 16; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+
+    return (size_t)hash & (tableSize - 1);
+}
+
+static size_t grow_index_size(size_t size, size_t minSize, size_t count)
+{
+    size_t newSize = (size == 0 ? minSize : size * 2);
+    while (newSize < count)
+    {
+        newSize *= 2;
+    }
+
+    return newSize;
+}
+
+static void add_item_to_key_index(MXFMetadataSet *set, MXFMetadataItem *item)
+{
+    MXFMetadataItem **itemPtr = &set->itemKeyIndex[hash_index(&item->key, set->itemKeyIndexSize)];
+
+    /* append to keep the first of any duplicate items first in the bucket, as in the items list */
+    while (*itemPtr != NULL)
+    {
+        itemPtr = &(*itemPtr)->nextInKeyIndex;
+    }
+    *itemPtr = item;
+    item->nextInKeyIndex = NULL;
+}
+
+static void remove_item_from_key_index(MXFMetadataSet *set, MXFMetadataItem *item)
+{
+    MXFMetadataItem **itemPtr = &set->itemKeyIndex[hash_index(&item->key, set->itemKeyIndexSize)];
+
+    while (*itemPtr != NULL && *itemPtr != item)
+    {
+        itemPtr = &(*itemPtr)->nextInKeyIndex;
+    }
+    if (*itemPtr != NULL)
+    {
+        *itemPtr = item->nextInKeyIndex;
+    }
+    item->nextInKeyIndex = NULL;
+}
+
+static int rebuild_item_key_index(MXFMetadataSet *set, size_t size)
+{
+    MXFMetadataItem **newIndex;
+    MXFListIterator iter;
+
+    newIndex = (MXFMetadataItem**)calloc(size, sizeof(MXFMetadataItem*));
+    if (newIndex == NULL)
+    {
+        return 0;
+    }
+
+    SAFE_FREE(set->itemKeyIndex);
+    set->itemKeyIndex = newIndex;
+    set->itemKeyIndexSize = size;
+
+    mxf_initialise_list_iter(&iter, &set->items);
+    while (mxf_next_list_iter_element(&iter))
+    {
+        add_item_to_key_index(set, (MXFMetadataItem*)mxf_get_iter_element(&iter));
+    }
+
+    return 1;
+}
+
+/* called after the item has been appended to the items list.
+   The index is an optimisation and so failing to (re-)allocate it is not an error; lookups fall back to the
+   list if there is no index and a full index is only less efficient */
+static void index_item(MXFMetadataSet *set, MXFMetadataItem *item)
+{
+    size_t numItems = mxf_get_list_length(&set->items);
+
+    if (set->itemKeyIndex == NULL && numItems <= ITEM_KEY_INDEX_THRESHOLD)
+    {
+        return;
+    }
+
+    if (set->itemKeyIndex == NULL || numItems > set->itemKeyIndexSize)
+    {
+        if (rebuild_item_key_index(set, grow_index_size(set->itemKeyIndexSize, 2 * ITEM_KEY_INDEX_THRESHOLD,
+                                                        numItems)))
+        {
+            return;
+        }
+        if (set->itemKeyIndex == NULL)
+        {
+            return;
+        }
+    }
+
+    add_item_to_key_index(set, item);
+}
+
+static void add_set_to_bucket(MXFSetIndexBucket *bucket, MXFMetadataSet *set, int uidIndex)
+{
+    if (uidIndex)
+    {
+        set->nextInUIDIndex = NULL;
+        if (bucket->last != NULL)
+        {
+            bucket->last->nextInUIDIndex = set;
+        }
+    }
+    else
+    {
+        set->nextInKeyIndex = NULL;
+        if (bucket->last != NULL)
+        {
+            bucket->last->nextInKeyIndex = set;
+        }
+    }
+    if (bucket->first == NULL)
+    {
+        bucket->first = set;
+    }
+    bucket->last = set;
+}
+
+static void remove_set_from_bucket(MXFSetIndexBucket *bucket, MXFMetadataSet *set, int uidIndex)
+{
+    MXFMetadataSet *prevSet = NULL;
+    MXFMetadataSet *bucketSet = bucket->first;
+    MXFMetadataSet *nextSet;
+
+    while (bucketSet != NULL && bucketSet != set)
+    {
+        prevSet = bucketSet;
+        bucketSet = (uidIndex ? bucketSet->nextInUIDIndex : bucketSet->nextInKeyIndex);
+    }
+    if (bucketSet == NULL)
+    {
+        return;
+    }
+
+    nextSet = (uidIndex ? set->nextInUIDIndex : set->nextInKeyIndex);
+    if (prevSet == NULL)
+    {
+        bucket->first = nextSet;
+    }
+    else if (uidIndex)
+    {
+        prevSet->nextInUIDIndex = nextSet;
+    }
+    else
+    {
+        prevSet->nextInKeyIndex = nextSet;
+    }
+    if (bucket->last == set)
+    {
+        bucket->last = prevSet;
+    }
+
+    if (uidIndex)
+    {
+        set->nextInUIDIndex = NULL;
+    }
+    else
+    {
+        set->nextInKeyIndex = NULL;
+    }
+}
+
+static int rebuild_set_index(MXFHeaderMetadata *headerMetadata, size_t size, int uidIndex)
+{
+    MXFSetIndexBucket *newIndex;
+    MXFListIterator iter;
+    MXFMetadataSet *set;
+
+    newIndex = (MXFSetIndexBucket*)calloc(size, sizeof(MXFSetIndexBucket));
+    if (newIndex == NULL)
+    {
+        return 0;
+    }
+
+    if (uidIndex)
+    {
+        SAFE_FREE(headerMetadata->setUIDIndex);
+        headerMetadata->setUIDIndex = newIndex;
+        headerMetadata->setUIDIndexSize = size;
+    }
+    else
+    {
+        SAFE_FREE(headerMetadata->setKeyIndex);
+        headerMetadata->setKeyIndex = newIndex;
+        headerMetadata->setKeyIndexSize = size;
+    }
+
+    /* add in list order so that buckets are ordered as the sets list */
+    mxf_initialise_list_iter(&iter, &headerMetadata->sets);
+    while (mxf_next_list_iter_element(&iter))
+    {
+        set = (MXFMetadataSet*)mxf_get_iter_element(&iter);
+        if (uidIndex)
+        {
+            add_set_to_bucket(&newIndex[hash_index(&set->instanceUID, size)], set, 1);
+        }
+        else
+        {
+            add_set_to_bucket(&newIndex[hash_index(&set->key, size)], set, 0);
+        }
+    }
+
+    return 1;
+}
+
+static MXFSetIndexBucket* get_uid_bucket(MXFHeaderMetadata *headerMetadata, const mxfUUID *uuid)
+{
+    return &headerMetadata->setUIDIndex[hash_index(uuid, headerMetadata->setUIDIndexSize)];
+}
+
+static MXFSetIndexBucket* get_key_bucket(MXFHeaderMetadata *headerMetadata, const mxfKey *key)
+{
+    return &headerMetadata->setKeyIndex[hash_index(key, headerMetadata->setKeyIndexSize)];
+}
+
+/* called after the set has been appended to the sets list. See index_item regarding allocation failures */
+static void index_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
+{
+    size_t numSets = mxf_get_list_length(&headerMetadata->sets);
+    size_t newSize;
+
+    if (headerMetadata->setUIDIndex == NULL || numSets > headerMetadata->setUIDIndexSize)
+    {
+        newSize = grow_index_size(headerMetadata->setUIDIndexSize, MIN_SET_UID_INDEX_SIZE, numSets);
+        if (!rebuild_set_index(headerMetadata, newSize, 1) && headerMetadata->setUIDIndex != NULL)
+        {
+            add_set_to_bucket(get_uid_bucket(headerMetadata, &set->instanceUID), set, 1);
+        }
+    }
+    else
+    {
+        add_set_to_bucket(get_uid_bucket(headerMetadata, &set->instanceUID), set, 1);
+    }
+
+    /* the number of distinct set keys is small and so the key index has a fixed size */
+    if (headerMetadata->setKeyIndex == NULL)
+    {
+        rebuild_set_index(headerMetadata, SET_KEY_INDEX_SIZE, 0);
+    }
+    else
+    {
+        add_set_to_bucket(get_key_bucket(headerMetadata, &set->key), set, 0);
+    }
+}
+
+static void unindex_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
+{
+    if (headerMetadata->setUIDIndex != NULL)
+    {
+        remove_set_from_bucket(get_uid_bucket(headerMetadata, &set->instanceUID), set, 1);
+    }
+    if (headerMetadata->setKeyIndex != NULL)
+    {
+        remove_set_from_bucket(get_key_bucket(headerMetadata, &set->key), set, 0);
+    }
+}
+
+typedef struct
+{
+    mxfKey key;
+    mxfUUID instanceUID;
+    int64_t offset;
+    uint64_t len;
+    size_t nextInUIDIndex; /* index + 1 into the sets array, 0 if there is no next */
+    int isRead;
+} MXFLazySet;
+
+struct MXFLazySets
+{
+    uint8_t *data;
+    MXFFile *dataFile;
+    MXFLazySet *sets;
+    size_t numSets;
+    size_t allocSets;
+    size_t numUnread;
+    size_t *uidIndex;
+    size_t uidIndexSize;
+    int haveInstanceUIDTag;
+    mxfLocalTag instanceUIDTag;
+    MXFReadFilter filter;   /* the caller's filter, with after_set_read called when a set is read */
+};
+
+typedef struct
+{
+    MXFReadFilter *filter;
+    MXFLazySets *lazySets;
+} LazyReadFilterData;
+
+static void free_lazy_sets(MXFLazySets **lazySets)
+{
+    if (*lazySets == NULL)
+    {
+        return;
+    }
+
+    mxf_file_close(&(*lazySets)->dataFile);
+    SAFE_FREE((*lazySets)->data);
+    SAFE_FREE((*lazySets)->sets);
+    SAFE_FREE((*lazySets)->uidIndex);
+    SAFE_FREE(*lazySets);
+}
+
+static int add_lazy_set(MXFHeaderMetadata *headerMetadata, MXFLazySets *lazySets, const mxfKey *key,
+                        int64_t offset, uint64_t len)
+{
+    MXFLazySet *lazySet;
+    MXFLazySet *newSets;
+    const uint8_t *setData = &lazySets->data[offset];
+    uint64_t pos = 0;
+    mxfLocalTag itemTag;
+    uint16_t itemLen;
+
+    if (!lazySets->haveInstanceUIDTag)
+    {
+        CHK_ORET(mxf_get_item_tag(headerMetadata->primerPack, &MXF_ITEM_K(InterchangeObject, InstanceUID),
+                                  &lazySets->instanceUIDTag));
+        lazySets->haveInstanceUIDTag = 1;
+    }
+
+    if (lazySets->numSets == lazySets->allocSets)
+    {
+        size_t newAllocSets = (lazySets->allocSets == 0 ? 256 : lazySets->allocSets * 2);
+        CHK_ORET((newSets = (MXFLazySet*)realloc(lazySets->sets, newAllocSets * sizeof(MXFLazySet))) != NULL);
+        lazySets->sets = newSets;
+        lazySets->allocSets = newAllocSets;
+    }
+    lazySet = &lazySets->sets[lazySets->numSets];
+    memset(lazySet, 0, sizeof(*lazySet));
+    lazySet->key = *key;
+    lazySet->offset = offset;
+    lazySet->len = len;
+
+    /* find the instance UID item without reading the set */
+    while (pos + 4 <= len)
+    {
+        itemTag = (mxfLocalTag)((setData[pos] << 8) | setData[pos + 1]);
+        itemLen = (uint16_t)((setData[pos + 2] << 8) | setData[pos + 3]);
+        if (itemTag == lazySets->instanceUIDTag && itemLen == mxfUUID_extlen && pos + 4 + itemLen <= len)
+        {
+            mxf_get_uuid(&setData[pos + 4], &lazySet->instanceUID);
+            break;
+        }
+        pos += 4 + itemLen;
+    }
+    if (pos + 4 > len)
+    {
+        mxf_log_error("Metadata set does not have InstanceUID item" LOG_LOC_FORMAT, LOG_LOC_PARAMS);
+        return 0;
+    }
+
+    lazySets->numSets++;
+    lazySets->numUnread++;
+
+    return 1;
+}
+
+static int build_lazy_set_uid_index(MXFLazySets *lazySets)
+{
+    size_t size = 256;
+    size_t index;
+    size_t i;
+
+    while (size < 2 * lazySets->numSets)
+    {
+        size *= 2;
+    }
+    CHK_ORET((lazySets->uidIndex = (size_t*)calloc(size, sizeof(size_t))) != NULL);
+    lazySets->uidIndexSize = size;
+
+    /* prepend in reverse order so that the first of any sets with duplicate instance UIDs is found first */
+    for (i = lazySets->numSets; i > 0; i--)
+    {
+        index = hash_index(&lazySets->sets[i - 1].instanceUID, size);
+        lazySets->sets[i - 1].nextInUIDIndex = lazySets->uidIndex[index];
+        lazySets->uidIndex[index] = i;
+    }
+
+    return 1;
+}
+
+/* set is NULL if the filter's after_set_read skipped the set */
+static int read_lazy_set(MXFHeaderMetadata *headerMetadata, MXFLazySet *lazySet, MXFMetadataSet **set)
+{
+    MXFLazySets *lazySets = headerMetadata->lazySets;
+    MXFMetadataSet *newSet = NULL;
+    int skip = 0;
+
+    /* the set is marked as read even if it fails, so that it is not attempted again */
+    lazySet->isRead = 1;
+    lazySets->numUnread--;
+
+    CHK_ORET(mxf_file_seek(lazySets->dataFile, lazySet->offset, SEEK_SET));
+    CHK_ORET(mxf_read_and_return_set(lazySets->dataFile, &lazySet->key, lazySet->len, headerMetadata, 0,
+                                     &newSet) == 1);
+
+    if (lazySets->filter.after_set_read != NULL)
+    {
+        CHK_OFAIL(lazySets->filter.after_set_read(lazySets->filter.privateData, headerMetadata, newSet, &skip));
+    }
+    if (skip)
+    {
+        mxf_free_set(&newSet);
+        *set = NULL;
+        return 1;
+    }
+
+    CHK_OFAIL(mxf_add_set(headerMetadata, newSet));
+    *set = newSet;
+    return 1;
+
+fail:
+    mxf_free_set(&newSet);
+    return 0;
+}
+
+static int dereference_lazy_set(MXFHeaderMetadata *headerMetadata, const mxfUUID *uuid, MXFMetadataSet **set)
+{
+    MXFLazySets *lazySets = headerMetadata->lazySets;
+    MXFLazySet *lazySet;
+    size_t i;
+
+    if (lazySets == NULL || lazySets->numUnread == 0)
+    {
+        return 0;
+    }
+
+    for (i = lazySets->uidIndex[hash_index(uuid, lazySets->uidIndexSize)]; i != 0; i = lazySet->nextInUIDIndex)
+    {
+        lazySet = &lazySets->sets[i - 1];
+        if (!lazySet->isRead && mxf_equals_uuid(uuid, &lazySet->instanceUID))
+        {
+            return read_lazy_set(headerMetadata, lazySet, set) && *set != NULL;
+        }
+    }
+
+    return 0;
+}
+
+static int read_lazy_sets_by_key(MXFHeaderMetadata *headerMetadata, const mxfKey *key)
+{
+    MXFLazySets *lazySets = headerMetadata->lazySets;
+    MXFMetadataSet *set;
+    size_t i;
+
+    if (lazySets == NULL || lazySets->numUnread == 0)
+    {
+        return 1;
+    }
+
+    for (i = 0; i < lazySets->numSets; i++)
+    {
+        if (!lazySets->sets[i].isRead && (key == NULL || mxf_equals_key(key, &lazySets->sets[i].key)))
+        {
+            CHK_ORET(read_lazy_set(headerMetadata, &lazySets->sets[i], &set));
+        }
+    }
+
+    return 1;
+}
+
+static int lazy_before_set_read(void *privateData, MXFHeaderMetadata *headerMetadata,
+                                const mxfKey *key, uint8_t llen, uint64_t len, int *skip)
+{
+    LazyReadFilterData *filterData = (LazyReadFilterData*)privateData;
+    MXFSetDef *setDef;
+    int64_t offset;
+    int filterSkip = 0;
+
+    if (filterData->filter != NULL && filterData->filter->before_set_read != NULL)
+    {
+        CHK_ORET(filterData->filter->before_set_read(filterData->filter->privateData, headerMetadata,
+                                                     key, llen, len, &filterSkip));
+    }
+
+    /* all sets are skipped and only sets with known definitions are recorded for reading later */
+    *skip = 1;
+    if (filterSkip || !mxf_find_set_def(headerMetadata->dataModel, key, &setDef))
+    {
+        return 1;
+    }
+
+    CHK_ORET((offset = mxf_file_tell(filterData->lazySets->dataFile)) >= 0);
+    CHK_ORET(add_lazy_set(headerMetadata, filterData->lazySets, key, offset, len));
+
+    return 1;
+}
+
+
 static int get_or_create_set_item(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set,
                                   const mxfKey *itemKey, MXFMetadataItem **item)
 {
@@ -125,12 +659,20 @@ static int get_or_create_set_item(MXFHeaderMetadata *headerMetadata, MXFMetadata
     return 1;
 }
 
-static int create_empty_set(const mxfKey *key, MXFMetadataSet **set)
+static int create_empty_set(const mxfKey *key, MXFArena *arena, MXFMetadataSet **set)
 {
     MXFMetadataSet *newSet;
 
-    CHK_MALLOC_ORET(newSet, MXFMetadataSet);
+    if (arena)
+    {
+        CHK_ORET((newSet = (MXFMetadataSet*)mxf_arena_alloc(arena, sizeof(MXFMetadataSet))) != NULL);
+    }
+    else
+    {
+        CHK_MALLOC_ORET(newSet, MXFMetadataSet);
+    }
     memset(newSet, 0, sizeof(MXFMetadataSet));
+    newSet->arena = arena;
     newSet->key = *key;
     newSet->instanceUID = g_Null_UUID;
     mxf_initialise_list(&newSet->items, free_metadata_item_in_list);
@@ -151,6 +693,7 @@ static int add_item(MXFMetadataSet *set, MXFMetadataItem *item)
 
     CHK_ORET(mxf_append_list_element(&set->items, (void*)item));
     item->set = set;
+    index_item(set, item);
 
     return 1;
 }
@@ -416,12 +959,41 @@ fail:
     return 0;
 }
 
+int mxf_create_header_metadata_with_arena(MXFHeaderMetadata **headerMetadata, MXFDataModel *dataModel,
+                                          size_t arenaBlockSize)
+{
+    MXFHeaderMetadata *newHeaderMetadata = NULL;
+
+    CHK_ORET(mxf_create_header_metadata(&newHeaderMetadata, dataModel));
+    CHK_OFAIL(mxf_set_header_metadata_arena(newHeaderMetadata, 1, arenaBlockSize));
+
+    *headerMetadata = newHeaderMetadata;
+    return 1;
+
+fail:
+    mxf_free_header_metadata(&newHeaderMetadata);
+    return 0;
+}
+
+int mxf_set_header_metadata_arena(MXFHeaderMetadata *headerMetadata, int enable, size_t arenaBlockSize)
+{
+    /* existing sets could be allocated from the arena that would be freed */
+    CHK_ORET(mxf_get_list_length(&headerMetadata->sets) == 0);
+    CHK_ORET(headerMetadata->lazySets == NULL);
+
+    mxf_free_arena(&headerMetadata->arena);
+    if (enable)
+        CHK_ORET(mxf_create_arena(&headerMetadata->arena, arenaBlockSize));
+
+    return 1;
+}
+
 int mxf_create_set(MXFHeaderMetadata *headerMetadata, const mxfKey *key, MXFMetadataSet **set)
 {
     MXFMetadataSet *newSet;
     mxfUUID uuid;
 
-    CHK_ORET(create_empty_set(key, &newSet));
+    CHK_ORET(create_empty_set(key, headerMetadata->arena, &newSet));
 
     mxf_generate_uuid(&uuid);
     newSet->instanceUID = uuid;
@@ -442,8 +1014,16 @@ int mxf_create_item(MXFMetadataSet *set, const mxfKey *key, mxfLocalTag tag, MXF
 {
     MXFMetadataItem *newItem;
 
-    CHK_MALLOC_ORET(newItem, MXFMetadataItem);
+    if (set->arena)
+    {
+        CHK_ORET((newItem = (MXFMetadataItem*)mxf_arena_alloc(set->arena, sizeof(MXFMetadataItem))) != NULL);
+    }
+    else
+    {
+        CHK_MALLOC_ORET(newItem, MXFMetadataItem);
+    }
     memset(newItem, 0, sizeof(MXFMetadataItem));
+    newItem->isInArena = (set->arena != NULL);
     newItem->tag = tag;
     newItem->isPersistent = 0;
     newItem->key = *key;
@@ -466,6 +1046,10 @@ void mxf_free_header_metadata(MXFHeaderMetadata **headerMetadata)
     }
 
     mxf_clear_list(&(*headerMetadata)->sets);
+    SAFE_FREE((*headerMetadata)->setUIDIndex);
+    SAFE_FREE((*headerMetadata)->setKeyIndex);
+    free_lazy_sets(&(*headerMetadata)->lazySets);
+    mxf_free_arena(&(*headerMetadata)->arena);
     mxf_free_primer_pack(&(*headerMetadata)->primerPack);
     SAFE_FREE(*headerMetadata);
 }
@@ -478,7 +1062,15 @@ void mxf_free_set(MXFMetadataSet **set)
     }
 
     mxf_clear_list(&(*set)->items);
-    SAFE_FREE(*set);
+    SAFE_FREE((*set)->itemKeyIndex);
+    if ((*set)->arena)
+    {
+        *set = NULL;
+    }
+    else
+    {
+        SAFE_FREE(*set);
+    }
 }
 
 void mxf_free_item(MXFMetadataItem **item)
@@ -489,7 +1081,14 @@ void mxf_free_item(MXFMetadataItem **item)
     }
 
     free_metadata_item_value(*item);
-    SAFE_FREE(*item);
+    if ((*item)->isInArena)
+    {
+        *item = NULL;
+    }
+    else
+    {
+        SAFE_FREE(*item);
+    }
 }
 
 
@@ -500,6 +1099,9 @@ int mxf_add_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
        calling this function. See mxf_create_set() for example */
     CHK_ORET(!mxf_equals_uuid(&set->instanceUID, &g_Null_UUID));
 
+    /* a set allocated from an arena is freed with the arena and so can't be moved to another header metadata */
+    CHK_ORET(set->arena == NULL || set->arena == headerMetadata->arena);
+
     /* if set already attached to header metadata, then removed it first */
     if (set->headerMetadata != NULL)
     {
@@ -508,6 +1110,7 @@ int mxf_add_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
 
     CHK_ORET(mxf_append_list_element(&headerMetadata->sets, (void*)set));
     set->headerMetadata = headerMetadata;
+    index_set(headerMetadata, set);
 
     return 1;
 }
@@ -565,6 +1168,7 @@ int mxf_remove_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
 
     if ((result = mxf_remove_list_element(&headerMetadata->sets, (void*)set, eq_pointer)) != NULL)
     {
+        unindex_set(headerMetadata, set);
         set->headerMetadata = NULL;
         return 1;
     }
@@ -579,6 +1183,10 @@ int mxf_remove_item(MXFMetadataSet *set, const mxfKey *itemKey, MXFMetadataItem
     if ((result = mxf_remove_list_element(&set->items, (void*)itemKey, item_eq_key)) != NULL)
     {
         *item = (MXFMetadataItem*)result;
+        if (set->itemKeyIndex != NULL)
+        {
+            remove_item_from_key_index(set, *item);
+        }
         (*item)->set = NULL;
         return 1;
     }
@@ -591,15 +1199,31 @@ int mxf_find_set_by_key(MXFHeaderMetadata *headerMetadata, const mxfKey *key, MX
     MXFListIterator iter;
     MXFList *newList = NULL;
 
+    CHK_ORET(read_lazy_sets_by_key(headerMetadata, key));
+
     CHK_ORET(mxf_create_list(&newList, NULL)); /* free func == NULL because newList doesn't own the data */
 
-    mxf_initialise_list_iter(&iter, &headerMetadata->sets);
-    while (mxf_next_list_iter_element(&iter))
+    if (headerMetadata->setKeyIndex != NULL)
     {
-        MXFMetadataSet *set = (MXFMetadataSet*)mxf_get_iter_element(&iter);
-        if (mxf_equals_key(key, &set->key))
+        MXFMetadataSet *set;
+        for (set = get_key_bucket(headerMetadata, key)->first; set != NULL; set = set->nextInKeyIndex)
+        {
+            if (mxf_equals_key(key, &set->key))
+            {
+                CHK_OFAIL(mxf_append_list_element(newList, (void*)set));
+            }
+        }
+    }
+    else
+    {
+        mxf_initialise_list_iter(&iter, &headerMetadata->sets);
+        while (mxf_next_list_iter_element(&iter))
         {
-            CHK_OFAIL(mxf_append_list_element(newList, (void*)set));
+            MXFMetadataSet *set = (MXFMetadataSet*)mxf_get_iter_element(&iter);
+            if (mxf_equals_key(key, &set->key))
+            {
+                CHK_OFAIL(mxf_append_list_element(newList, (void*)set));
+            }
         }
     }
 
@@ -641,6 +1265,22 @@ int mxf_get_item(MXFMetadataSet *set, const mxfKey *key, MXFMetadataItem **resul
 {
     void *result;
 
+    if (set->itemKeyIndex != NULL)
+    {
+        MXFMetadataItem *item;
+        for (item = set->itemKeyIndex[hash_index(key, set->itemKeyIndexSize)]; item != NULL;
+             item = item->nextInKeyIndex)
+        {
+            if (mxf_equals_key(key, &item->key))
+            {
+                *resultItem = item;
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
     if ((result = mxf_find_list_element(&set->items, (void*)key, item_eq_key)) != NULL)
     {
         *resultItem = (MXFMetadataItem*)result;
@@ -851,6 +1491,60 @@ fail:
     return 0;
 }
 
+int mxf_read_lazy_header_metadata(MXFFile *mxfFile, MXFReadFilter *filter,
+                                  MXFHeaderMetadata *headerMetadata, uint64_t headerByteCount,
+                                  const mxfKey *key, uint8_t llen, uint64_t len)
+{
+    MXFLazySets *newLazySets = NULL;
+    MXFMemoryFile *memFile = NULL;
+    LazyReadFilterData filterData;
+    MXFReadFilter lazyFilter;
+    uint64_t dataSize;
+
+    CHK_ORET(headerByteCount > (uint64_t)(mxfKey_extlen + llen));
+    dataSize = headerByteCount - mxfKey_extlen - llen;
+    CHK_ORET(dataSize >= len && dataSize <= UINT32_MAX);
+
+    CHK_MALLOC_ORET(newLazySets, MXFLazySets);
+    memset(newLazySets, 0, sizeof(*newLazySets));
+
+    /* read the header metadata, excluding the primer pack key and length, into memory */
+    CHK_MALLOC_ARRAY_OFAIL(newLazySets->data, uint8_t, (size_t)dataSize);
+    CHK_OFAIL(mxf_file_read(mxfFile, newLazySets->data, (uint32_t)dataSize) == dataSize);
+    CHK_OFAIL(mxf_mem_file_open_read(newLazySets->data, (int64_t)dataSize, 0, &memFile));
+    newLazySets->dataFile = mxf_mem_file_get_file(memFile);
+
+    free_lazy_sets(&headerMetadata->lazySets);
+    headerMetadata->lazySets = newLazySets;
+    newLazySets = NULL;
+
+    if (filter != NULL)
+    {
+        headerMetadata->lazySets->filter = *filter;
+    }
+
+    filterData.filter = filter;
+    filterData.lazySets = headerMetadata->lazySets;
+    lazyFilter.privateData = &filterData;
+    lazyFilter.before_set_read = lazy_before_set_read;
+    lazyFilter.after_set_read = NULL;
+
+    CHK_ORET(mxf_read_filtered_header_metadata(headerMetadata->lazySets->dataFile, &lazyFilter, headerMetadata,
+                                               headerByteCount, key, llen, len));
+    CHK_ORET(build_lazy_set_uid_index(headerMetadata->lazySets));
+
+    return 1;
+
+fail:
+    free_lazy_sets(&newLazySets);
+    return 0;
+}
+
+int mxf_read_all_lazy_sets(MXFHeaderMetadata *headerMetadata)
+{
+    return read_lazy_sets_by_key(headerMetadata, NULL);
+}
+
 int mxf_read_set(MXFFile *mxfFile, const mxfKey *key, uint64_t len,
                  MXFHeaderMetadata *headerMetadata, int addToHeaderMetadata)
 {
@@ -876,7 +1570,7 @@ int mxf_read_and_return_set(MXFFile *mxfFile, const mxfKey *key, uint64_t len,
     /* only read sets with known definitions */
     if (mxf_find_set_def(headerMetadata->dataModel, key, &setDef))
     {
-        CHK_ORET(create_empty_set(key, &newSet));
+        CHK_ORET(create_empty_set(key, headerMetadata->arena, &newSet));
 
         /* read each item in the set*/
         haveInstanceUID = 0;
@@ -961,7 +1655,8 @@ int mxf_read_item(MXFFile *mxfFile, MXFMetadataItem *item, uint16_t len)
 
     CHK_ORET(mxf_file_read(mxfFile, buffer, len) == len);
 
-    CHK_MALLOC_ARRAY_ORET(item->value, uint8_t, len);
+    free_metadata_item_value(item);
+    CHK_ORET(alloc_metadata_item_value(item, len));
     memcpy(item->value, buffer, len);
     item->length = len;
 
@@ -988,6 +1683,8 @@ int mxf_write_header_sets(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata)
     MXFListIterator iter;
     MXFMetadataSet *prefaceSet;
 
+    CHK_ORET(mxf_read_all_lazy_sets(headerMetadata));
+
     /* must write the Preface set first (and there must be a Preface set) */
     CHK_ORET(mxf_find_singular_set_by_key(headerMetadata, &MXF_SET_K(Preface), &prefaceSet));
     CHK_ORET(mxf_write_set(mxfFile, prefaceSet));
@@ -1064,11 +1761,13 @@ int mxf_write_item(MXFFile *mxfFile, MXFMetadataItem *item)
     return 1;
 }
 
-void mxf_get_header_metadata_size(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata, uint64_t *size)
+int mxf_get_header_metadata_size(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata, uint64_t *size)
 {
     MXFListIterator iter;
     uint64_t primerSize;
 
+    CHK_ORET(mxf_read_all_lazy_sets(headerMetadata));
+
     mxf_get_primer_pack_size(mxfFile, headerMetadata->primerPack, &primerSize);
     *size = primerSize;
 
@@ -1077,6 +1776,8 @@ void mxf_get_header_metadata_size(MXFFile *mxfFile, MXFHeaderMetadata *headerMet
     {
         *size += mxf_get_set_size(mxfFile, (MXFMetadataSet*)mxf_get_iter_element(&iter));
     }
+
+    return 1;
 }
 
 /* note: keep in sync with mxf_write_set */
@@ -1416,9 +2117,25 @@ int mxf_dereference(MXFHeaderMetadata *headerMetadata, const mxfUUID *uuid, MXFM
 {
     void *result;
 
+    if (headerMetadata->setUIDIndex != NULL)
+    {
+        MXFMetadataSet *setInIndex;
+        for (setInIndex = get_uid_bucket(headerMetadata, uuid)->first; setInIndex != NULL;
+             setInIndex = setInIndex->nextInUIDIndex)
+        {
+            if (mxf_equals_uuid(uuid, &setInIndex->instanceUID))
+            {
+                *set = setInIndex;
+                return 1;
+            }
+        }
+
+        return dereference_lazy_set(headerMetadata, uuid, set);
+    }
+
     if ((result = mxf_find_list_element(&headerMetadata->sets, (void*)uuid, set_eq_instanceuid)) == NULL)
     {
-        return 0;
+        return dereference_lazy_set(headerMetadata, uuid, set);
     }
 
     *set = (MXFMetadataSet*)result;
@@ -1449,7 +2166,9 @@ int mxf_get_weakref_s(MXFHeaderMetadata *headerMetadata, MXFListIterator *setsIt
     return mxf_dereference_s(headerMetadata, setsIter, &uuid, set);
 }
 
-/* this will be faster is we de-reference multiple sets in the same order as they were written */
+/* this will be faster is we de-reference multiple sets in the same order as they were written.
+   The instance UID index is used if the set is not at or next to the previous position in the list and
+   the iterator is then left unchanged */
 int mxf_dereference_s(MXFHeaderMetadata *headerMetadata, MXFListIterator *setsIter, const mxfUUID *uuid,
                       MXFMetadataSet **set)
 {
@@ -1470,6 +2189,23 @@ int mxf_dereference_s(MXFHeaderMetadata *headerMetadata, MXFListIterator *setsIt
         }
     }
 
+    /* try the next position in the list */
+    if (mxf_next_list_iter_element(setsIter))
+    {
+        setInList = (MXFMetadataSet*)mxf_get_iter_element(setsIter);
+        if (mxf_equals_uuid(uuid, &setInList->instanceUID))
+        {
+            *set = setInList;
+            return 1;
+        }
+    }
+
+    if (headerMetadata->setUIDIndex != NULL)
+    {
+        mxf_copy_list_iter(&origSetsIter, setsIter);
+        return mxf_dereference(headerMetadata, uuid, set);
+    }
+
     /* try find it starting from the previous position in the list */
     while (mxf_next_list_iter_element(setsIter))
     {
@@ -1498,7 +2234,7 @@ int mxf_dereference_s(MXFHeaderMetadata *headerMetadata, MXFListIterator *setsIt
 
     mxf_copy_list_iter(&origSetsIter, setsIter);
 
-    return 0;
+    return dereference_lazy_set(headerMetadata, uuid, set);
 }
 
 
@@ -1806,13 +2542,16 @@ void mxf_set_array_header(uint32_t arrayLen, uint32_t arrayElementLen, uint8_t *
 
 int mxf_alloc_item_value(MXFMetadataItem *item, uint16_t len, uint8_t **value)
 {
+    /* only the first value is allocated from an arena because values that change length,
+       e.g. arrays that are appended to, would otherwise accumulate in the arena */
     if (item->value && item->length != len)
     {
         free_metadata_item_value(item);
+        CHK_MALLOC_ARRAY_ORET(item->value, uint8_t, len);
     }
-    if (!item->value)
+    else if (!item->value)
     {
-        CHK_MALLOC_ARRAY_ORET(item->value, uint8_t, len);
+        CHK_ORET(alloc_metadata_item_value(item, len));
     }
     item->isPersistent = 0;
     item->length = len;
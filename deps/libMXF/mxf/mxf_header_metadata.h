@@ -41,16 +41,28 @@ extern "C"
 #endif
 
 
-typedef struct
+typedef struct MXFMetadataItem
 {
     mxfKey key;
     uint16_t tag;
     int isPersistent;
     uint16_t length;
+    uint8_t isInArena;
+    uint8_t isValueInArena;
     uint8_t *value;
     struct MXFMetadataSet *set;
+    struct MXFMetadataItem *nextInKeyIndex;
 } MXFMetadataItem;
 
+/* The hash indexes below are maintained alongside the items and sets lists by add/remove functions
+   and must not be modified directly. The lists remain the owners and define iteration order */
+
+typedef struct
+{
+    struct MXFMetadataSet *first;
+    struct MXFMetadataSet *last;
+} MXFSetIndexBucket;
+
 typedef struct MXFMetadataSet
 {
     mxfKey key;
@@ -58,13 +70,26 @@ typedef struct MXFMetadataSet
     MXFList items;
     struct MXFHeaderMetadata *headerMetadata;
     uint64_t fixedSpaceAllocation;
+    MXFArena *arena;
+    MXFMetadataItem **itemKeyIndex;
+    size_t itemKeyIndexSize;
+    struct MXFMetadataSet *nextInUIDIndex;
+    struct MXFMetadataSet *nextInKeyIndex;
 } MXFMetadataSet;
 
+typedef struct MXFLazySets MXFLazySets;
+
 typedef struct MXFHeaderMetadata
 {
     MXFDataModel *dataModel;
     MXFPrimerPack *primerPack;
     MXFList sets;
+    MXFArena *arena;
+    MXFSetIndexBucket *setUIDIndex;
+    size_t setUIDIndexSize;
+    MXFSetIndexBucket *setKeyIndex;
+    size_t setKeyIndexSize;
+    MXFLazySets *lazySets;
 } MXFHeaderMetadata;
 
 typedef struct
@@ -89,6 +114,14 @@ int mxf_is_header_metadata(const mxfKey *key);
 
 
 int mxf_create_header_metadata(MXFHeaderMetadata **headerMetadata, MXFDataModel *dataModel);
+/* sets, items and initial item values of a header metadata with an arena are allocated from the arena and are
+   released in one go when the header metadata is freed. They must therefore not outlive the header metadata and
+   mxf_add_set fails if a set allocated from the arena is added to another header metadata.
+   arenaBlockSize 0 results in MXF_ARENA_DEFAULT_BLOCK_SIZE being used */
+int mxf_create_header_metadata_with_arena(MXFHeaderMetadata **headerMetadata, MXFDataModel *dataModel,
+                                          size_t arenaBlockSize);
+/* enables or disables the arena of a header metadata that doesn't contain any sets yet */
+int mxf_set_header_metadata_arena(MXFHeaderMetadata *headerMetadata, int enable, size_t arenaBlockSize);
 int mxf_create_set(MXFHeaderMetadata *headerMetadata, const mxfKey *key, MXFMetadataSet **set);
 int mxf_create_item(MXFMetadataSet *set, const mxfKey *key, mxfLocalTag tag, MXFMetadataItem **item);
 void mxf_free_header_metadata(MXFHeaderMetadata **headerMetadata);
@@ -122,6 +155,16 @@ int mxf_read_header_metadata(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata
 int mxf_read_filtered_header_metadata(MXFFile *mxfFile, MXFReadFilter *filter,
                                       MXFHeaderMetadata *headerMetadata, uint64_t headerByteCount,
                                       const mxfKey *key, uint8_t llen, uint64_t len);
+/* lazy reading keeps the header metadata bytes in memory and only records the key, instance UID and position of
+   the sets that are not skipped by the filter's before_set_read. A set is read when it is first dereferenced or
+   found by key, or when mxf_read_all_lazy_sets is called. The filter's after_set_read is called when a set is read
+   and so the filter's privateData must remain valid until all sets have been read or after_set_read is NULL.
+   The sets list only contains the sets read so far and so mxf_read_all_lazy_sets must be called before iterating
+   over the list */
+int mxf_read_lazy_header_metadata(MXFFile *mxfFile, MXFReadFilter *filter,
+                                  MXFHeaderMetadata *headerMetadata, uint64_t headerByteCount,
+                                  const mxfKey *key, uint8_t llen, uint64_t len);
+int mxf_read_all_lazy_sets(MXFHeaderMetadata *headerMetadata);
 int mxf_read_set(MXFFile *mxfFile, const mxfKey *key, uint64_t len,
                  MXFHeaderMetadata *headerMetadata, int addToHeaderMetadata);
 /* returns 1 on success, 0 for failure, 2 if it is an unknown set and "set" parameter is set to NULL */
@@ -135,7 +178,7 @@ int mxf_write_header_primer_pack(MXFFile *mxfFile, MXFHeaderMetadata *headerMeta
 int mxf_write_header_sets(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata);
 int mxf_write_set(MXFFile *mxfFile, MXFMetadataSet *set);
 int mxf_write_item(MXFFile *mxfFile, MXFMetadataItem *item);
-void mxf_get_header_metadata_size(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata, uint64_t *size);
+int mxf_get_header_metadata_size(MXFFile *mxfFile, MXFHeaderMetadata *headerMetadata, uint64_t *size);
 uint64_t mxf_get_set_size(MXFFile *mxfFile, MXFMetadataSet *set);
 
 
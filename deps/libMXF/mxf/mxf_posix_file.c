@@ -0,0 +1,638 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_file.h>
+#include <mxf/mxf_stream_file.h>
+#include <mxf/mxf_macros.h>
+
+
+/* size of the user-space buffer used for small reads (e.g. KLs and metadata) and small writes.
+   Reads and writes that are at least this size bypass the buffer */
+#define BUFFER_SIZE     (64 * 1024)
+
+/* maximum number of segments passed to a single writev call */
+#if defined(IOV_MAX) && IOV_MAX < 1024
+#define MAX_WRITE_VEC   IOV_MAX
+#else
+#define MAX_WRITE_VEC   1024
+#endif
+
+
+typedef enum
+{
+    NEW_MODE,
+    READ_MODE,
+    MODIFY_MODE,
+} OpenMode;
+
+struct MXFFileSysData
+{
+    int fd;
+    OpenMode mode;
+    int flags;
+    int isSeekable;
+
+    int64_t position;
+    int isEOF;
+
+    uint8_t *buffer;
+    int64_t bufferOffset;
+    uint32_t bufferFill;        /* number of bytes read into the buffer */
+    uint32_t writeFill;         /* number of bytes pending to be written from the buffer */
+
+    uint32_t readAheadSize;
+    int64_t lastReadEnd;
+    int64_t readAheadStart;     /* start of the contiguous range the kernel was asked to load */
+    int64_t readAheadEnd;       /* end of the range the kernel was last asked to load */
+
+    struct iovec *iov;          /* segments for gather writes, reused across calls */
+    uint32_t iovAllocCount;
+};
+
+
+
+static uint32_t read_at(MXFFileSysData *sysData, uint8_t *data, uint32_t count, int64_t offset)
+{
+    char errorBuf[128];
+    uint32_t total = 0;
+    ssize_t result;
+
+    while (total < count) {
+        if (sysData->isSeekable)
+            result = pread(sysData->fd, data + total, count - total, (off_t)(offset + total));
+        else
+            result = read(sysData->fd, data + total, count - total);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            mxf_log_error("%s failed: %s\n", sysData->isSeekable ? "pread" : "read",
+                          mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            break;
+        } else if (result == 0) {
+            break;
+        }
+        total += (uint32_t)result;
+    }
+
+    return total;
+}
+
+static uint32_t write_at(MXFFileSysData *sysData, const uint8_t *data, uint32_t count, int64_t offset)
+{
+    char errorBuf[128];
+    uint32_t total = 0;
+    ssize_t result;
+
+    while (total < count) {
+        if (sysData->isSeekable)
+            result = pwrite(sysData->fd, data + total, count - total, (off_t)(offset + total));
+        else
+            result = write(sysData->fd, data + total, count - total);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            mxf_log_error("%s failed: %s\n", sysData->isSeekable ? "pwrite" : "write",
+                          mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            break;
+        } else if (result == 0) {
+            break;
+        }
+        total += (uint32_t)result;
+    }
+
+    return total;
+}
+
+static uint64_t writev_at(MXFFileSysData *sysData, struct iovec *iov, int iovcnt, int64_t offset)
+{
+    char errorBuf[128];
+    uint64_t total = 0;
+    ssize_t result;
+
+    while (iovcnt > 0) {
+        if (sysData->isSeekable && lseek(sysData->fd, (off_t)(offset + total), SEEK_SET) < 0) {
+            mxf_log_error("lseek failed: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            break;
+        }
+        result = writev(sysData->fd, iov, (iovcnt < MAX_WRITE_VEC ? iovcnt : MAX_WRITE_VEC));
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            mxf_log_error("writev failed: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            break;
+        } else if (result == 0) {
+            break;
+        }
+        total += (uint64_t)result;
+
+        /* skip the segments that were written and adjust a partially written segment */
+        while (iovcnt > 0 && (size_t)result >= iov->iov_len) {
+            result -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (result > 0) {
+            iov->iov_base = (uint8_t*)iov->iov_base + result;
+            iov->iov_len -= (size_t)result;
+        }
+    }
+
+    return total;
+}
+
+static int flush_write_buffer(MXFFileSysData *sysData)
+{
+    uint32_t count = sysData->writeFill;
+
+    if (count == 0)
+        return 1;
+
+    sysData->writeFill = 0;
+    return write_at(sysData, sysData->buffer, count, sysData->bufferOffset) == count;
+}
+
+static void advise_read_ahead(MXFFileSysData *sysData, int64_t readStart, int64_t readEnd)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    int64_t adviseStart;
+
+    if (!sysData->isSeekable || (sysData->flags & MXF_POSIX_FLAG_RANDOM_ACCESS))
+        return;
+
+    /* only read ahead for sequential access patterns, unless the caller said the file will be scanned */
+    if (readStart != sysData->lastReadEnd && !(sysData->flags & MXF_POSIX_FLAG_SEQUENTIAL_SCAN)) {
+        sysData->lastReadEnd = readEnd;
+        return;
+    }
+    sysData->lastReadEnd = readEnd;
+
+    /* ask for the next window once half of the previous window has been consumed */
+    if (readEnd + sysData->readAheadSize / 2 < sysData->readAheadEnd)
+        return;
+
+    adviseStart = readEnd;
+    if (adviseStart < sysData->readAheadEnd)
+        adviseStart = sysData->readAheadEnd;
+    else
+        sysData->readAheadStart = adviseStart;
+    sysData->readAheadEnd = readEnd + sysData->readAheadSize;
+    posix_fadvise(sysData->fd, (off_t)adviseStart, (off_t)(sysData->readAheadEnd - adviseStart),
+                  POSIX_FADV_WILLNEED);
+#else
+    (void)sysData;
+    (void)readStart;
+    (void)readEnd;
+#endif
+}
+
+
+static void posix_file_close(MXFFileSysData *sysData)
+{
+    if (sysData->fd >= 0) {
+        flush_write_buffer(sysData);
+        close(sysData->fd);
+        sysData->fd = -1;
+    }
+}
+
+static uint32_t posix_file_read(MXFFileSysData *sysData, uint8_t *data, uint32_t count)
+{
+    int64_t readStart = sysData->position;
+    uint32_t total = 0;
+    uint32_t numRead;
+
+    if (sysData->writeFill > 0 && !flush_write_buffer(sysData))
+        return 0;
+
+    while (total < count) {
+        if (sysData->position >= sysData->bufferOffset &&
+            sysData->position < sysData->bufferOffset + sysData->bufferFill)
+        {
+            numRead = (uint32_t)(sysData->bufferOffset + sysData->bufferFill - sysData->position);
+            if (numRead > count - total)
+                numRead = count - total;
+            memcpy(&data[total], &sysData->buffer[sysData->position - sysData->bufferOffset], numRead);
+        }
+        else if (count - total >= BUFFER_SIZE)
+        {
+            /* read directly into the caller's buffer */
+            numRead = read_at(sysData, &data[total], count - total, sysData->position);
+            if (numRead < count - total)
+                sysData->isEOF = 1;
+        }
+        else
+        {
+            sysData->bufferOffset = sysData->position;
+            sysData->bufferFill   = read_at(sysData, sysData->buffer, BUFFER_SIZE, sysData->position);
+            if (sysData->bufferFill == 0) {
+                sysData->isEOF = 1;
+                break;
+            }
+            continue;
+        }
+
+        total += numRead;
+        sysData->position += numRead;
+        if (sysData->isEOF)
+            break;
+    }
+
+    if (total > 0)
+        advise_read_ahead(sysData, readStart, sysData->position);
+
+    return total;
+}
+
+static uint32_t posix_file_write(MXFFileSysData *sysData, const uint8_t *data, uint32_t count)
+{
+    uint32_t numWrite;
+
+    if (sysData->mode == READ_MODE)
+        return 0;
+
+    /* any data read into the buffer is discarded */
+    sysData->bufferFill = 0;
+
+    if (sysData->writeFill > 0 &&
+        (sysData->position != sysData->bufferOffset + sysData->writeFill ||
+            sysData->writeFill + count > BUFFER_SIZE))
+    {
+        if (!flush_write_buffer(sysData))
+            return 0;
+    }
+
+    if (count >= BUFFER_SIZE) {
+        numWrite = write_at(sysData, data, count, sysData->position);
+    } else {
+        if (sysData->writeFill == 0)
+            sysData->bufferOffset = sysData->position;
+        memcpy(&sysData->buffer[sysData->writeFill], data, count);
+        sysData->writeFill += count;
+        numWrite = count;
+    }
+
+    sysData->position += numWrite;
+    return numWrite;
+}
+
+static uint64_t posix_file_write_vec(MXFFileSysData *sysData, const MXFFileIOVec *vec, uint32_t count)
+{
+    struct iovec *iov;
+    uint64_t total = 0;
+    uint64_t numWrite = 0;
+    int iovcnt = 0;
+    uint32_t i;
+
+    if (sysData->mode == READ_MODE)
+        return 0;
+
+    for (i = 0; i < count; i++)
+        total += vec[i].size;
+
+    /* small batches are copied into the write buffer */
+    if (total < BUFFER_SIZE) {
+        for (i = 0; i < count; i++) {
+            uint32_t segWrite;
+            if (vec[i].size == 0)
+                continue;
+            segWrite = posix_file_write(sysData, vec[i].data, vec[i].size);
+            numWrite += segWrite;
+            if (segWrite != vec[i].size)
+                break;
+        }
+        return numWrite;
+    }
+
+    sysData->bufferFill = 0;
+
+    /* pending buffered data is included in the write if it ends at the current position */
+    if (sysData->writeFill > 0 && sysData->position != sysData->bufferOffset + sysData->writeFill) {
+        if (!flush_write_buffer(sysData))
+            return 0;
+    }
+
+    if (sysData->iovAllocCount < count + 1) {
+        iov = realloc(sysData->iov, (count + 1) * sizeof(*iov));
+        if (!iov)
+            return 0;
+        sysData->iov = iov;
+        sysData->iovAllocCount = count + 1;
+    }
+    iov = sysData->iov;
+
+    if (sysData->writeFill > 0) {
+        iov[iovcnt].iov_base = sysData->buffer;
+        iov[iovcnt].iov_len  = sysData->writeFill;
+        iovcnt++;
+    }
+    for (i = 0; i < count; i++) {
+        if (vec[i].size == 0)
+            continue;
+        iov[iovcnt].iov_base = (void*)vec[i].data;
+        iov[iovcnt].iov_len  = vec[i].size;
+        iovcnt++;
+    }
+
+    if (sysData->writeFill > 0) {
+        numWrite = writev_at(sysData, iov, iovcnt, sysData->bufferOffset);
+        if (numWrite < sysData->writeFill)
+            numWrite = 0;
+        else
+            numWrite -= sysData->writeFill;
+        sysData->writeFill = 0;
+    } else {
+        numWrite = writev_at(sysData, iov, iovcnt, sysData->position);
+    }
+
+    sysData->position += numWrite;
+    return numWrite;
+}
+
+static int posix_file_getchar(MXFFileSysData *sysData)
+{
+    uint8_t data;
+
+    if (sysData->writeFill == 0 &&
+        sysData->position >= sysData->bufferOffset &&
+        sysData->position < sysData->bufferOffset + sysData->bufferFill)
+    {
+        return sysData->buffer[sysData->position++ - sysData->bufferOffset];
+    }
+
+    if (posix_file_read(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_file_putchar(MXFFileSysData *sysData, int c)
+{
+    uint8_t data = (uint8_t)c;
+    if (posix_file_write(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_file_eof(MXFFileSysData *sysData)
+{
+    return sysData->isEOF;
+}
+
+static int64_t posix_file_size(MXFFileSysData *sysData)
+{
+    struct stat statBuf;
+
+    if (sysData->writeFill > 0 && !flush_write_buffer(sysData))
+        return -1;
+
+    if (fstat(sysData->fd, &statBuf) != 0)
+        return -1;
+
+    return statBuf.st_size;
+}
+
+static int posix_file_seek(MXFFileSysData *sysData, int64_t offset, int whence)
+{
+    int64_t position;
+    int64_t size;
+
+    if (!sysData->isSeekable)
+        return 0;
+
+    switch (whence)
+    {
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position = sysData->position + offset;
+            break;
+        case SEEK_END:
+            size = posix_file_size(sysData);
+            if (size < 0)
+                return 0;
+            position = size + offset;
+            break;
+        default:
+            return 0;
+    }
+    if (position < 0)
+        return 0;
+
+    sysData->position = position;
+    sysData->isEOF    = 0;
+    return 1;
+}
+
+static int64_t posix_file_tell(MXFFileSysData *sysData)
+{
+    return sysData->position;
+}
+
+static int posix_file_is_seekable(MXFFileSysData *sysData)
+{
+    return sysData->isSeekable;
+}
+
+static int posix_file_read_ahead(MXFFileSysData *sysData, int64_t offset, int64_t count)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    int64_t adviseStart;
+    int64_t adviseEnd;
+
+    if (!sysData->isSeekable || offset < 0 || count <= 0)
+        return 0;
+
+    /* the range has already been requested */
+    if (offset >= sysData->readAheadStart && offset + count <= sysData->readAheadEnd)
+        return 1;
+
+    /* extend the window, only advising the part that has not been requested yet */
+    if (offset >= sysData->readAheadStart && offset < sysData->readAheadEnd) {
+        adviseStart = sysData->readAheadEnd;
+    } else {
+        adviseStart = offset;
+        sysData->readAheadStart = offset;
+    }
+    adviseEnd = offset + count;
+    if (!(sysData->flags & MXF_POSIX_FLAG_RANDOM_ACCESS) && adviseEnd < offset + sysData->readAheadSize)
+        adviseEnd = offset + sysData->readAheadSize;
+    sysData->readAheadEnd = adviseEnd;
+
+    return posix_fadvise(sysData->fd, (off_t)adviseStart, (off_t)(adviseEnd - adviseStart),
+                         POSIX_FADV_WILLNEED) == 0;
+#else
+    (void)sysData;
+    (void)offset;
+    (void)count;
+    return 0;
+#endif
+}
+
+static void free_posix_file(MXFFileSysData *sysData)
+{
+    if (!sysData)
+        return;
+
+    free(sysData->buffer);
+    free(sysData->iov);
+    free(sysData);
+}
+
+static int mxf_posix_file_open(const char *filename, int flags, OpenMode mode, uint32_t readAheadSize,
+                               MXFFile **mxfFile)
+{
+    MXFFile *newMXFFile = NULL;
+    MXFFileSysData *newDiskFile = NULL;
+    struct stat statBuf;
+    char errorBuf[128];
+    int openFlags = 0;
+
+    CHK_MALLOC_OFAIL(newMXFFile, MXFFile);
+    memset(newMXFFile, 0, sizeof(MXFFile));
+    CHK_MALLOC_OFAIL(newDiskFile, MXFFileSysData);
+    memset(newDiskFile, 0, sizeof(MXFFileSysData));
+    newDiskFile->fd = -1;
+    CHK_MALLOC_ARRAY_OFAIL(newDiskFile->buffer, uint8_t, BUFFER_SIZE);
+
+    switch (mode)
+    {
+        case NEW_MODE:
+            openFlags = O_RDWR | O_CREAT | O_TRUNC;
+            break;
+        case READ_MODE:
+            openFlags = O_RDONLY;
+            break;
+        case MODIFY_MODE:
+            openFlags = O_RDWR;
+            break;
+    }
+#if defined(O_CLOEXEC)
+    openFlags |= O_CLOEXEC;
+#endif
+
+    newDiskFile->fd = open(filename, openFlags, 0666);
+    if (newDiskFile->fd < 0)
+        goto fail;
+
+    if (fstat(newDiskFile->fd, &statBuf) != 0) {
+        mxf_log_error("unexpected fstat error when checking seek support: %s\n",
+                      mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+        goto fail;
+    }
+
+    newDiskFile->mode          = mode;
+    newDiskFile->flags         = flags;
+    newDiskFile->isSeekable    = S_ISREG(statBuf.st_mode);
+    newDiskFile->readAheadSize = (readAheadSize > 0 ? readAheadSize : MXF_POSIX_DEFAULT_READ_AHEAD_SIZE);
+    newDiskFile->lastReadEnd   = -1;
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (newDiskFile->isSeekable) {
+        if (flags & MXF_POSIX_FLAG_RANDOM_ACCESS)
+            posix_fadvise(newDiskFile->fd, 0, 0, POSIX_FADV_RANDOM);
+        else if (flags & MXF_POSIX_FLAG_SEQUENTIAL_SCAN)
+            posix_fadvise(newDiskFile->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    newMXFFile->close         = posix_file_close;
+    newMXFFile->read          = posix_file_read;
+    newMXFFile->write         = posix_file_write;
+    newMXFFile->get_char      = posix_file_getchar;
+    newMXFFile->put_char      = posix_file_putchar;
+    newMXFFile->eof           = posix_file_eof;
+    newMXFFile->seek          = posix_file_seek;
+    newMXFFile->tell          = posix_file_tell;
+    newMXFFile->is_seekable   = posix_file_is_seekable;
+    newMXFFile->size          = posix_file_size;
+    newMXFFile->read_ahead    = posix_file_read_ahead;
+    newMXFFile->write_vec     = posix_file_write_vec;
+
+    newMXFFile->free_sys_data = free_posix_file;
+    newMXFFile->sysData       = newDiskFile;
+
+    if (!newDiskFile->isSeekable) {
+        MXFFile *newStreamMXFFile = NULL;
+        if (!mxf_stream_file_wrap(newMXFFile, mode == READ_MODE, &newStreamMXFFile))
+            goto fail;
+        *mxfFile = newStreamMXFFile;
+    } else {
+        *mxfFile = newMXFFile;
+    }
+
+    return 1;
+
+fail:
+    if (newDiskFile && newDiskFile->fd >= 0)
+        close(newDiskFile->fd);
+    free_posix_file(newDiskFile);
+    SAFE_FREE(newMXFFile);
+    return 0;
+}
+
+
+
+int mxf_posix_file_open_new(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return mxf_posix_file_open(filename, flags, NEW_MODE, 0, mxfFile);
+}
+
+int mxf_posix_file_open_read(const char *filename, int flags, uint32_t readAheadSize, MXFFile **mxfFile)
+{
+    return mxf_posix_file_open(filename, flags, READ_MODE, readAheadSize, mxfFile);
+}
+
+int mxf_posix_file_open_modify(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return mxf_posix_file_open(filename, flags, MODIFY_MODE, 0, mxfFile);
+}
+
@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_mmap.h>
+#include <mxf/mxf_macros.h>
+
+
+typedef enum
+{
+    READ_MODE,
+    MODIFY_MODE,
+} OpenMode;
+
+typedef struct
+{
+    MXFFileMap base;
+    uint8_t *data;
+    int64_t size;
+    int refCount;
+} PosixMMap;
+
+struct MXFFileSysData
+{
+    int fd;
+    OpenMode mode;
+
+    PosixMMap *map;
+    uint8_t *mapData;
+    int64_t mapSize;
+
+    int64_t position;
+    int isEOF;
+};
+
+
+
+static uint32_t read_at(MXFFileSysData *sysData, uint8_t *data, uint32_t count, int64_t offset)
+{
+    char errorBuf[128];
+    uint32_t total = 0;
+    ssize_t result;
+
+    while (total < count) {
+        result = pread(sysData->fd, data + total, count - total, (off_t)(offset + total));
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            mxf_log_error("pread failed: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            break;
+        } else if (result == 0) {
+            break;
+        }
+        total += (uint32_t)result;
+    }
+
+    return total;
+}
+
+static uint32_t write_at(MXFFileSysData *sysData, const uint8_t *data, uint32_t count, int64_t offset)
+{
+    char errorBuf[128];
+    uint32_t total = 0;
+    ssize_t result;
+
+    while (total < count) {
+        result = pwrite(sysData->fd, data + total, count - total, (off_t)(offset + total));
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            mxf_log_error("pwrite failed: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            break;
+        } else if (result == 0) {
+            break;
+        }
+        total += (uint32_t)result;
+    }
+
+    return total;
+}
+
+
+static void unref_posix_mmap(MXFFileMap *map)
+{
+    PosixMMap *posixMap = (PosixMMap*)map;
+
+    /* the mapping is unmapped when the file and all the references to the mapped data are released */
+    if (__sync_sub_and_fetch(&posixMap->refCount, 1) == 0) {
+        munmap(posixMap->data, (size_t)posixMap->size);
+        free(posixMap);
+    }
+}
+
+
+static void posix_mmap_close(MXFFileSysData *sysData)
+{
+    if (sysData->map) {
+        unref_posix_mmap(&sysData->map->base);
+        sysData->map     = NULL;
+        sysData->mapData = NULL;
+        sysData->mapSize = 0;
+    }
+    if (sysData->fd >= 0) {
+        close(sysData->fd);
+        sysData->fd = -1;
+    }
+}
+
+static uint32_t posix_mmap_read(MXFFileSysData *sysData, uint8_t *data, uint32_t count)
+{
+    uint32_t numRead = 0;
+
+    if (sysData->position < sysData->mapSize) {
+        numRead = count;
+        if (sysData->position + numRead > sysData->mapSize)
+            numRead = (uint32_t)(sysData->mapSize - sysData->position);
+        memcpy(data, &sysData->mapData[sysData->position], numRead);
+    }
+
+    /* the file could have grown since it was mapped */
+    if (numRead < count)
+        numRead += read_at(sysData, &data[numRead], count - numRead, sysData->position + numRead);
+
+    if (numRead < count)
+        sysData->isEOF = 1;
+    sysData->position += numRead;
+
+    return numRead;
+}
+
+static uint32_t posix_mmap_write(MXFFileSysData *sysData, const uint8_t *data, uint32_t count)
+{
+    uint32_t numWrite = 0;
+
+    if (sysData->mode == READ_MODE)
+        return 0;
+
+    if (sysData->position < sysData->mapSize) {
+        numWrite = count;
+        if (sysData->position + numWrite > sysData->mapSize)
+            numWrite = (uint32_t)(sysData->mapSize - sysData->position);
+        memcpy(&sysData->mapData[sysData->position], data, numWrite);
+    }
+
+    /* the mapping is shared and so writes past the mapped region are visible to it */
+    if (numWrite < count)
+        numWrite += write_at(sysData, &data[numWrite], count - numWrite, sysData->position + numWrite);
+
+    sysData->position += numWrite;
+
+    return numWrite;
+}
+
+static int posix_mmap_getchar(MXFFileSysData *sysData)
+{
+    uint8_t data;
+
+    if (sysData->position < sysData->mapSize)
+        return sysData->mapData[sysData->position++];
+
+    if (posix_mmap_read(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_mmap_putchar(MXFFileSysData *sysData, int c)
+{
+    uint8_t data = (uint8_t)c;
+    if (posix_mmap_write(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_mmap_eof(MXFFileSysData *sysData)
+{
+    return sysData->isEOF;
+}
+
+static int64_t posix_mmap_size(MXFFileSysData *sysData)
+{
+    struct stat statBuf;
+
+    if (fstat(sysData->fd, &statBuf) != 0)
+        return -1;
+
+    return statBuf.st_size;
+}
+
+static int posix_mmap_seek(MXFFileSysData *sysData, int64_t offset, int whence)
+{
+    int64_t position;
+    int64_t size;
+
+    switch (whence)
+    {
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position = sysData->position + offset;
+            break;
+        case SEEK_END:
+            size = posix_mmap_size(sysData);
+            if (size < 0)
+                return 0;
+            position = size + offset;
+            break;
+        default:
+            return 0;
+    }
+    if (position < 0)
+        return 0;
+
+    sysData->position = position;
+    sysData->isEOF    = 0;
+    return 1;
+}
+
+static int64_t posix_mmap_tell(MXFFileSysData *sysData)
+{
+    return sysData->position;
+}
+
+static int posix_mmap_is_seekable(MXFFileSysData *sysData)
+{
+    (void)sysData;
+    return 1;
+}
+
+static int posix_mmap_read_ahead(MXFFileSysData *sysData, int64_t offset, int64_t count)
+{
+    int64_t pageOffset;
+
+    if (offset < 0 || count <= 0)
+        return 0;
+
+    if (offset < sysData->mapSize) {
+        if (offset + count > sysData->mapSize)
+            count = sysData->mapSize - offset;
+
+        /* madvise requires a page aligned address */
+        pageOffset = offset - offset % mxf_get_system_page_size();
+        return madvise(&sysData->mapData[pageOffset], (size_t)(count + offset - pageOffset), MADV_WILLNEED) == 0;
+    }
+
+#if defined(POSIX_FADV_WILLNEED)
+    return posix_fadvise(sysData->fd, (off_t)offset, (off_t)count, POSIX_FADV_WILLNEED) == 0;
+#else
+    return 0;
+#endif
+}
+
+static const uint8_t* posix_mmap_map_data(MXFFileSysData *sysData, int64_t offset, uint32_t count)
+{
+    /* the mapped data could change in modify mode */
+    if (sysData->mode != READ_MODE || offset < 0 || offset + count > sysData->mapSize)
+        return NULL;
+
+    return &sysData->mapData[offset];
+}
+
+static MXFFileMap* posix_mmap_ref_map(MXFFileSysData *sysData)
+{
+    if (sysData->mode != READ_MODE || !sysData->map)
+        return NULL;
+
+    __sync_add_and_fetch(&sysData->map->refCount, 1);
+    return &sysData->map->base;
+}
+
+static void free_posix_mmap(MXFFileSysData *sysData)
+{
+    free(sysData);
+}
+
+static int mxf_posix_mmap_open(const char *filename, int flags, OpenMode mode, MXFFile **mxfFile)
+{
+    MXFFile *newMXFFile = NULL;
+    MXFFileSysData *newMMapFile = NULL;
+    struct stat statBuf;
+    char errorBuf[128];
+    int openFlags = (mode == READ_MODE ? O_RDONLY : O_RDWR);
+    int protFlags = (mode == READ_MODE ? PROT_READ : PROT_READ | PROT_WRITE);
+    void *mapData;
+
+    CHK_MALLOC_OFAIL(newMXFFile, MXFFile);
+    memset(newMXFFile, 0, sizeof(MXFFile));
+    CHK_MALLOC_OFAIL(newMMapFile, MXFFileSysData);
+    memset(newMMapFile, 0, sizeof(MXFFileSysData));
+    newMMapFile->fd   = -1;
+    newMMapFile->mode = mode;
+
+#if defined(O_CLOEXEC)
+    openFlags |= O_CLOEXEC;
+#endif
+    newMMapFile->fd = open(filename, openFlags);
+    if (newMMapFile->fd < 0)
+        goto fail;
+
+    if (fstat(newMMapFile->fd, &statBuf) != 0) {
+        mxf_log_error("unexpected fstat error: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+        goto fail;
+    }
+    if (!S_ISREG(statBuf.st_mode)) {
+        mxf_log_error("memory-mapped file I/O requires a regular file\n");
+        goto fail;
+    }
+
+    /* a file that can't be mapped, e.g. an empty file or a file too large for the address space,
+       is accessed using pread and pwrite only */
+    if (statBuf.st_size > 0 && (uint64_t)statBuf.st_size <= (size_t)(-1)) {
+        CHK_MALLOC_OFAIL(newMMapFile->map, PosixMMap);
+        mapData = mmap(NULL, (size_t)statBuf.st_size, protFlags, MAP_SHARED, newMMapFile->fd, 0);
+        if (mapData != MAP_FAILED) {
+            newMMapFile->map->base.unref = unref_posix_mmap;
+            newMMapFile->map->data       = (uint8_t*)mapData;
+            newMMapFile->map->size       = statBuf.st_size;
+            newMMapFile->map->refCount   = 1;
+
+            newMMapFile->mapData = (uint8_t*)mapData;
+            newMMapFile->mapSize = statBuf.st_size;
+
+            if (flags & MXF_POSIX_FLAG_RANDOM_ACCESS)
+                madvise(mapData, (size_t)statBuf.st_size, MADV_RANDOM);
+            else if (flags & MXF_POSIX_FLAG_SEQUENTIAL_SCAN)
+                madvise(mapData, (size_t)statBuf.st_size, MADV_SEQUENTIAL);
+        } else {
+            mxf_log_warn("Failed to memory-map file: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+            SAFE_FREE(newMMapFile->map);
+        }
+    }
+
+    newMXFFile->close         = posix_mmap_close;
+    newMXFFile->read          = posix_mmap_read;
+    newMXFFile->write         = posix_mmap_write;
+    newMXFFile->get_char      = posix_mmap_getchar;
+    newMXFFile->put_char      = posix_mmap_putchar;
+    newMXFFile->eof           = posix_mmap_eof;
+    newMXFFile->seek          = posix_mmap_seek;
+    newMXFFile->tell          = posix_mmap_tell;
+    newMXFFile->is_seekable   = posix_mmap_is_seekable;
+    newMXFFile->size          = posix_mmap_size;
+    newMXFFile->read_ahead    = posix_mmap_read_ahead;
+    newMXFFile->map_data      = posix_mmap_map_data;
+    newMXFFile->ref_map       = posix_mmap_ref_map;
+
+    newMXFFile->free_sys_data = free_posix_mmap;
+    newMXFFile->sysData       = newMMapFile;
+
+
+    *mxfFile = newMXFFile;
+    return 1;
+
+fail:
+    if (newMMapFile) {
+        SAFE_FREE(newMMapFile->map);
+        if (newMMapFile->fd >= 0)
+            close(newMMapFile->fd);
+    }
+    SAFE_FREE(newMMapFile);
+    SAFE_FREE(newMXFFile);
+    return 0;
+}
+
+
+
+int mxf_posix_mmap_open_read(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return mxf_posix_mmap_open(filename, flags, READ_MODE, mxfFile);
+}
+
+int mxf_posix_mmap_open_modify(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return mxf_posix_mmap_open(filename, flags, MODIFY_MODE, mxfFile);
+}
+
@@ -120,6 +120,23 @@ static uint32_t stream_file_write(MXFFileSysData *sysData, const uint8_t *data,
     return result;
 }
 
+static uint64_t stream_file_write_vec(MXFFileSysData *sysData, const MXFFileIOVec *vec, uint32_t count)
+{
+    uint64_t result;
+
+    if (sysData->readOnly)
+        return 0;
+
+    if (sysData->position > sysData->headPosition && !write_skip(sysData))
+        return 0;
+
+    result = mxf_file_write_vec(sysData->target, vec, count);
+    sysData->headPosition += result;
+    sysData->position = sysData->headPosition;
+
+    return result;
+}
+
 static int stream_file_getchar(MXFFileSysData *sysData)
 {
     int result;
@@ -229,6 +246,7 @@ int mxf_stream_file_wrap(MXFFile *target, int readOnly, MXFFile **streamMXFFile)
     newMXFFile->tell          = stream_file_tell;
     newMXFFile->is_seekable   = stream_file_is_seekable;
     newMXFFile->size          = stream_file_size;
+    newMXFFile->write_vec     = stream_file_write_vec;
     newMXFFile->free_sys_data = free_stream_file;
     newMXFFile->sysData       = newStreamFile;
     newMXFFile->minLLen       = target->minLLen;
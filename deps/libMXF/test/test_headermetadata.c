@@ -200,6 +200,7 @@ int test_read(const char *filename)
     MXFHeaderMetadata *headerMetadata = NULL;
     MXFDataModel *srcDataModel = NULL;
     MXFHeaderMetadata *srcHeaderMetadata = NULL;
+    MXFHeaderMetadata *otherHeaderMetadata = NULL;
     MXFMetadataSet *prefaceSet;
     MXFMetadataSet *set1;
     MXFMetadataSet *set2;
@@ -256,6 +257,8 @@ int test_read(const char *filename)
     MXFListIterator setsIter;
     FilterData filterData;
     MXFReadFilter readFilter;
+    uint64_t headerMetadataSize;
+    uint64_t lazyHeaderMetadataSize;
 
 
     if (!mxf_disk_file_open_read(filename, &mxfFile))
@@ -458,6 +461,87 @@ int test_read(const char *filename)
     CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 1); /* Preface */
 
 
+    /* read header metadata again, now allocated from an arena */
+    mxf_free_header_metadata(&headerMetadata);
+    CHK_OFAIL(mxf_create_header_metadata_with_arena(&headerMetadata, dataModel, 1024));
+    CHK_OFAIL(mxf_file_seek(mxfFile, headerMetadataFilePos, SEEK_SET));
+    CHK_OFAIL(mxf_read_next_nonfiller_kl(mxfFile, &key, &llen, &len));
+    CHK_OFAIL(mxf_read_header_metadata(mxfFile, headerMetadata, headerPartition->headerByteCount, &key, llen, len));
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 8);
+    CHK_OFAIL(mxf_get_header_metadata_size(mxfFile, headerMetadata, &headerMetadataSize));
+    CHK_OFAIL(mxf_find_singular_set_by_key(headerMetadata, &MXF_SET_K(TestSet1), &set1));
+    CHK_OFAIL(set1->arena == headerMetadata->arena);
+    CHK_OFAIL(mxf_create_header_metadata(&otherHeaderMetadata, dataModel));
+    CHK_OFAIL(!mxf_add_set(otherHeaderMetadata, set1)); /* arena sets can't be moved */
+    CHK_OFAIL(set1->headerMetadata == headerMetadata);
+    CHK_OFAIL(mxf_get_list_length(&otherHeaderMetadata->sets) == 0);
+    mxf_free_header_metadata(&otherHeaderMetadata);
+    CHK_OFAIL(mxf_get_strongref_item(set1, &MXF_ITEM_K(TestSet1, TestItem15), &set));
+    CHK_OFAIL(mxf_set_utf16string_item(set1, &MXF_ITEM_K(TestSet1, TestItem14), L"A longer UTF16 String"));
+    CHK_OFAIL(mxf_get_utf16string_item(set1, &MXF_ITEM_K(TestSet1, TestItem14), value14));
+    CHK_OFAIL(wcscmp(L"A longer UTF16 String", value14) == 0);
+    CHK_OFAIL(mxf_remove_set(headerMetadata, set));
+    mxf_free_set(&set);
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 7);
+    CHK_OFAIL(mxf_get_arena_allocated_size(headerMetadata->arena) > 0);
+
+
+    /* read header metadata again, now lazily */
+    mxf_free_header_metadata(&headerMetadata);
+    CHK_OFAIL(mxf_create_header_metadata(&headerMetadata, dataModel));
+    CHK_OFAIL(mxf_file_seek(mxfFile, headerMetadataFilePos, SEEK_SET));
+    CHK_OFAIL(mxf_read_next_nonfiller_kl(mxfFile, &key, &llen, &len));
+    CHK_OFAIL(mxf_read_lazy_header_metadata(mxfFile, NULL, headerMetadata, headerPartition->headerByteCount,
+                                            &key, llen, len));
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 0);
+    CHK_OFAIL(mxf_find_singular_set_by_key(headerMetadata, &MXF_SET_K(TestSet1), &set1));
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 1);
+    CHK_OFAIL(mxf_get_strongref_item(set1, &MXF_ITEM_K(TestSet1, TestItem15), &set2));
+    CHK_OFAIL(mxf_equals_key(&set2->key, &MXF_SET_K(TestSet2)));
+    CHK_OFAIL(mxf_get_strongref_item(set1, &MXF_ITEM_K(TestSet1, TestItem15), &set));
+    CHK_OFAIL(set == set2);
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 2);
+    CHK_OFAIL(mxf_read_all_lazy_sets(headerMetadata));
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 8);
+    CHK_OFAIL(mxf_find_singular_set_by_key(headerMetadata, &MXF_SET_K(Preface), &prefaceSet));
+
+
+    /* read header metadata again, lazily with the filter */
+    memset(&filterData, 0, sizeof(FilterData));
+    mxf_free_header_metadata(&headerMetadata);
+    CHK_OFAIL(mxf_create_header_metadata(&headerMetadata, dataModel));
+    CHK_OFAIL(mxf_file_seek(mxfFile, headerMetadataFilePos, SEEK_SET));
+    CHK_OFAIL(mxf_read_next_nonfiller_kl(mxfFile, &key, &llen, &len));
+    CHK_OFAIL(mxf_read_lazy_header_metadata(mxfFile, &readFilter, headerMetadata, headerPartition->headerByteCount,
+                                            &key, llen, len));
+    CHK_OFAIL(filterData.skippedBeforeCount == 1); /* TestSet1 skipped */
+    CHK_OFAIL(filterData.nonSkippedBeforeCount == 7); /* all except TestSet1 */
+    CHK_OFAIL(filterData.skippedAfterCount == 0 && filterData.nonSkippedAfterCount == 0);
+    CHK_OFAIL(!mxf_find_singular_set_by_key(headerMetadata, &MXF_SET_K(TestSet2), &set2));
+    CHK_OFAIL(filterData.skippedAfterCount == 1); /* TestSet2 was read and skipped */
+    CHK_OFAIL(mxf_read_all_lazy_sets(headerMetadata));
+    CHK_OFAIL(filterData.skippedAfterCount == 6); /* all except Preface */
+    CHK_OFAIL(filterData.nonSkippedAfterCount == 1); /* Preface was not skipped */
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 1); /* Preface */
+    CHK_OFAIL(mxf_find_singular_set_by_key(headerMetadata, &MXF_SET_K(Preface), &prefaceSet));
+
+
+    /* the size of lazily read header metadata includes the sets that have not been read yet */
+    mxf_free_header_metadata(&headerMetadata);
+    CHK_OFAIL(mxf_create_header_metadata(&headerMetadata, dataModel));
+    CHK_OFAIL(mxf_file_seek(mxfFile, headerMetadataFilePos, SEEK_SET));
+    CHK_OFAIL(mxf_read_next_nonfiller_kl(mxfFile, &key, &llen, &len));
+    CHK_OFAIL(mxf_read_lazy_header_metadata(mxfFile, NULL, headerMetadata, headerPartition->headerByteCount,
+                                            &key, llen, len));
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 0);
+    CHK_OFAIL(mxf_get_header_metadata_size(mxfFile, headerMetadata, &lazyHeaderMetadataSize));
+    CHK_OFAIL(lazyHeaderMetadataSize == headerMetadataSize);
+    CHK_OFAIL(mxf_read_all_lazy_sets(headerMetadata));
+    CHK_OFAIL(mxf_get_list_length(&headerMetadata->sets) == 8);
+    CHK_OFAIL(mxf_get_header_metadata_size(mxfFile, headerMetadata, &lazyHeaderMetadataSize));
+    CHK_OFAIL(lazyHeaderMetadataSize == headerMetadataSize);
+
+
 
 
     /* skip filler and read footer pp */
@@ -473,6 +557,7 @@ int test_read(const char *filename)
     mxf_free_header_metadata(&headerMetadata);
     mxf_free_data_model(&srcDataModel);
     mxf_free_header_metadata(&srcHeaderMetadata);
+    mxf_free_header_metadata(&otherHeaderMetadata);
     return 1;
 
 fail:
@@ -482,6 +567,7 @@ fail:
     mxf_free_header_metadata(&headerMetadata);
     mxf_free_data_model(&srcDataModel);
     mxf_free_header_metadata(&srcHeaderMetadata);
+    mxf_free_header_metadata(&otherHeaderMetadata);
     return 0;
 }
 
@@ -611,6 +697,105 @@ fail:
 }
 
 
+int test_set_indexes()
+{
+    MXFDataModel *dataModel = NULL;
+    MXFHeaderMetadata *headerMetadata = NULL;
+    MXFMetadataSet *sets[2000];
+    MXFMetadataSet *set;
+    MXFMetadataItem *item;
+    MXFList *setList = NULL;
+    MXFListIterator iter;
+    MXFListIterator setsIter;
+    size_t i;
+
+    CHK_OFAIL(mxf_load_data_model(&dataModel));
+    CHK_OFAIL(mxf_finalise_data_model(dataModel));
+    CHK_OFAIL(mxf_create_header_metadata(&headerMetadata, dataModel));
+
+    /* alternate set keys and grow the instance UID index several times */
+    for (i = 0; i < 2000; i++)
+    {
+        CHK_OFAIL(mxf_create_set(headerMetadata, (i % 2 ? &MXF_SET_K(Identification) : &MXF_SET_K(ContentStorage)),
+                                 &sets[i]));
+    }
+    for (i = 0; i < 2000; i++)
+    {
+        CHK_OFAIL(mxf_dereference(headerMetadata, &sets[i]->instanceUID, &set));
+        CHK_OFAIL(set == sets[i]);
+    }
+
+    /* remove and re-add sets; re-added sets move to the end of the list */
+    for (i = 0; i < 2000; i += 10)
+    {
+        CHK_OFAIL(mxf_remove_set(headerMetadata, sets[i]));
+        CHK_OFAIL(!mxf_dereference(headerMetadata, &sets[i]->instanceUID, &set));
+    }
+    for (i = 0; i < 2000; i += 20)
+    {
+        CHK_OFAIL(mxf_add_set(headerMetadata, sets[i]));
+    }
+    for (i = 0; i < 2000; i += 10)
+    {
+        if (i % 20 == 0)
+        {
+            CHK_OFAIL(mxf_dereference(headerMetadata, &sets[i]->instanceUID, &set));
+            CHK_OFAIL(set == sets[i]);
+        }
+        else
+        {
+            mxf_free_set(&sets[i]);
+        }
+    }
+
+    /* sets found by key are in sets list order */
+    CHK_OFAIL(mxf_find_set_by_key(headerMetadata, &MXF_SET_K(ContentStorage), &setList));
+    CHK_OFAIL(mxf_get_list_length(setList) == 1000 - 100);
+    mxf_initialise_list_iter(&iter, setList);
+    mxf_initialise_sets_iter(headerMetadata, &setsIter);
+    while (mxf_next_list_iter_element(&iter))
+    {
+        do
+        {
+            CHK_OFAIL(mxf_next_list_iter_element(&setsIter));
+            set = (MXFMetadataSet*)mxf_get_iter_element(&setsIter);
+        }
+        while (!mxf_equals_key(&set->key, &MXF_SET_K(ContentStorage)));
+        CHK_OFAIL(set == mxf_get_iter_element(&iter));
+    }
+    mxf_free_list(&setList);
+
+    /* item key index */
+    set = sets[1];
+    CHK_OFAIL(mxf_set_utf16string_item(set, &MXF_ITEM_K(Identification, CompanyName), L"company"));
+    CHK_OFAIL(mxf_set_utf16string_item(set, &MXF_ITEM_K(Identification, ProductName), L"product"));
+    CHK_OFAIL(mxf_set_utf16string_item(set, &MXF_ITEM_K(Identification, VersionString), L"version"));
+    CHK_OFAIL(mxf_set_uuid_item(set, &MXF_ITEM_K(Identification, ThisGenerationUID), &someUUID));
+    CHK_OFAIL(mxf_set_uuid_item(set, &MXF_ITEM_K(Identification, ProductUID), &someUUID));
+    CHK_OFAIL(mxf_set_timestamp_item(set, &MXF_ITEM_K(Identification, ModificationDate), &someTimestamp));
+    CHK_OFAIL(mxf_set_product_version_item(set, &MXF_ITEM_K(Identification, ToolkitVersion), mxf_get_version()));
+    CHK_OFAIL(mxf_set_utf16string_item(set, &MXF_ITEM_K(Identification, Platform), L"platform"));
+    CHK_OFAIL(mxf_set_product_version_item(set, &MXF_ITEM_K(Identification, ProductVersion), mxf_get_version()));
+    CHK_OFAIL(set->itemKeyIndex != NULL);
+    CHK_OFAIL(mxf_get_item(set, &MXF_ITEM_K(Identification, Platform), &item));
+    CHK_OFAIL(mxf_remove_item(set, &MXF_ITEM_K(Identification, Platform), &item));
+    mxf_free_item(&item);
+    CHK_OFAIL(!mxf_have_item(set, &MXF_ITEM_K(Identification, Platform)));
+    CHK_OFAIL(mxf_have_item(set, &MXF_ITEM_K(Identification, ProductVersion)));
+    CHK_OFAIL(mxf_have_item(set, &MXF_ITEM_K(InterchangeObject, InstanceUID)));
+
+    mxf_free_header_metadata(&headerMetadata);
+    mxf_free_data_model(&dataModel);
+    return 1;
+
+fail:
+    mxf_free_list(&setList);
+    mxf_free_header_metadata(&headerMetadata);
+    mxf_free_data_model(&dataModel);
+    return 0;
+}
+
+
 void usage(const char *cmd)
 {
     fprintf(stderr, "Usage: %s filename\n", cmd);
@@ -639,6 +824,11 @@ int main(int argc, const char *argv[])
         return 1;
     }
 
+    if (!test_set_indexes())
+    {
+        return 1;
+    }
+
     return 0;
 }
 
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_file.h>
+
+
+#define DATA_SIZE           10000
+#define LARGE_DATA_SIZE     (200 * 1024)
+#define NUM_SEGMENTS        2000
+#define SEGMENT_SIZE        64
+
+
+
+#define CHECK(cmd) \
+    if (!(cmd)) \
+    { \
+        fprintf(stderr, "'%s' failed in %s:%d\n", #cmd, __FILENAME__, __LINE__); \
+        exit(1); \
+    }
+
+
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s filename\n", cmd);
+}
+
+int main(int argc, const char *argv[])
+{
+    MXFFile *mxfFile;
+    unsigned char *writeData;
+    unsigned char *readData;
+    MXFFileIOVec vec[4];
+    MXFFileIOVec *segments;
+    uint32_t segmentsSize;
+    uint32_t i;
+
+    if (argc != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    writeData = malloc(LARGE_DATA_SIZE);
+    for (i = 0; i < LARGE_DATA_SIZE; i++)
+        writeData[i] = (unsigned char)(i % 251);
+    readData = malloc(LARGE_DATA_SIZE);
+
+
+    CHECK(mxf_posix_file_open_new(argv[1], MXF_POSIX_FLAG_DEFAULT, &mxfFile));
+
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == DATA_SIZE);
+
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_SET));
+    CHECK(mxf_file_size(mxfFile) == DATA_SIZE);
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(memcmp(readData, writeData, DATA_SIZE) == 0);
+    CHECK(!mxf_file_eof(mxfFile));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == 0);
+    CHECK(mxf_file_eof(mxfFile));
+    CHECK(mxf_file_seek(mxfFile, -DATA_SIZE / 2, SEEK_CUR));
+    CHECK(!mxf_file_eof(mxfFile));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE / 2);
+    CHECK(memcmp(readData, &writeData[DATA_SIZE / 2], DATA_SIZE / 2) == 0);
+    CHECK(mxf_file_eof(mxfFile));
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+    CHECK(mxf_file_tell(mxfFile) == DATA_SIZE);
+    CHECK(mxf_file_seek(mxfFile, DATA_SIZE * 2, SEEK_SET));
+    CHECK(mxf_file_tell(mxfFile) == DATA_SIZE * 2);
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+    CHECK(mxf_file_seek(mxfFile, DATA_SIZE, SEEK_SET));
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == DATA_SIZE);
+    CHECK(mxf_file_tell(mxfFile) == DATA_SIZE * 2);
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == 0);
+    CHECK(mxf_file_size(mxfFile) == DATA_SIZE * 2);
+
+    /* large writes and reads bypass the buffer */
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_END));
+    CHECK(mxf_file_putc(mxfFile, 0x01) == 0x01);
+    CHECK(mxf_file_write(mxfFile, writeData, LARGE_DATA_SIZE) == LARGE_DATA_SIZE);
+    CHECK(mxf_file_putc(mxfFile, 0x02) == 0x02);
+    CHECK(mxf_file_size(mxfFile) == DATA_SIZE * 2 + LARGE_DATA_SIZE + 2);
+    CHECK(mxf_file_seek(mxfFile, DATA_SIZE * 2, SEEK_SET));
+    CHECK(mxf_file_getc(mxfFile) == 0x01);
+    CHECK(mxf_file_read(mxfFile, readData, LARGE_DATA_SIZE) == LARGE_DATA_SIZE);
+    CHECK(memcmp(readData, writeData, LARGE_DATA_SIZE) == 0);
+    CHECK(mxf_file_getc(mxfFile) == 0x02);
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_posix_file_open_modify(argv[1], MXF_POSIX_FLAG_DEFAULT, &mxfFile));
+    CHECK(mxf_file_seek(mxfFile, DATA_SIZE / 2, SEEK_SET));
+    CHECK(mxf_file_putc(mxfFile, 0x03) == 0x03);
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_posix_file_open_read(argv[1], MXF_POSIX_FLAG_SEQUENTIAL_SCAN, 64 * 1024, &mxfFile));
+    CHECK(mxf_file_is_seekable(mxfFile));
+    CHECK(mxf_file_size(mxfFile) == DATA_SIZE * 2 + LARGE_DATA_SIZE + 2);
+    CHECK(mxf_file_read_ahead(mxfFile, DATA_SIZE * 2, LARGE_DATA_SIZE));
+    CHECK(mxf_file_read_ahead(mxfFile, DATA_SIZE * 2 + 1, LARGE_DATA_SIZE / 2));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(readData[DATA_SIZE / 2] == 0x03);
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(memcmp(readData, writeData, DATA_SIZE) == 0);
+    CHECK(mxf_file_getc(mxfFile) == 0x01);
+    for (i = 0; i < LARGE_DATA_SIZE; i += DATA_SIZE / 4) {
+        uint32_t count = (LARGE_DATA_SIZE - i < DATA_SIZE / 4 ? LARGE_DATA_SIZE - i : DATA_SIZE / 4);
+        CHECK(mxf_file_read(mxfFile, readData, count) == count);
+        CHECK(memcmp(readData, &writeData[i], count) == 0);
+    }
+    CHECK(mxf_file_getc(mxfFile) == 0x02);
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) != DATA_SIZE);
+    mxf_file_close(&mxfFile);
+
+
+    /* gather writes */
+    CHECK(mxf_posix_file_open_new(argv[1], MXF_POSIX_FLAG_DEFAULT, &mxfFile));
+    CHECK(mxf_file_write_vec(mxfFile, NULL, 0) == 0);
+
+    /* small batches, including zero size segments, go through the write buffer */
+    vec[0].data = writeData;
+    vec[0].size = DATA_SIZE / 2;
+    vec[1].data = NULL;
+    vec[1].size = 0;
+    vec[2].data = &writeData[DATA_SIZE / 2];
+    vec[2].size = 0;
+    vec[3].data = &writeData[DATA_SIZE / 2];
+    vec[3].size = DATA_SIZE / 2;
+    CHECK(mxf_file_write_vec(mxfFile, vec, 4) == DATA_SIZE);
+
+    /* large batches are written with writev, together with the pending buffered data */
+    vec[0].data = &writeData[DATA_SIZE];
+    vec[0].size = LARGE_DATA_SIZE / 2 - DATA_SIZE;
+    vec[1].data = NULL;
+    vec[1].size = 0;
+    vec[2].data = &writeData[LARGE_DATA_SIZE / 2];
+    vec[2].size = LARGE_DATA_SIZE / 2;
+    CHECK(mxf_file_write_vec(mxfFile, vec, 3) == LARGE_DATA_SIZE - DATA_SIZE);
+    CHECK(mxf_file_tell(mxfFile) == LARGE_DATA_SIZE);
+
+    /* more segments than can be written in a single writev call */
+    segments = malloc(NUM_SEGMENTS * sizeof(*segments));
+    segmentsSize = 0;
+    for (i = 0; i < NUM_SEGMENTS; i++) {
+        segments[i].data = &writeData[segmentsSize];
+        segments[i].size = (i % 10 == 0 ? 0 : SEGMENT_SIZE);
+        segmentsSize += segments[i].size;
+    }
+    CHECK(segmentsSize >= 64 * 1024);
+    CHECK(mxf_file_write_vec(mxfFile, segments, NUM_SEGMENTS) == segmentsSize);
+    CHECK(mxf_file_putc(mxfFile, 0x04) == 0x04);
+    free(segments);
+
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_SET));
+    CHECK(mxf_file_size(mxfFile) == LARGE_DATA_SIZE + segmentsSize + 1);
+    CHECK(mxf_file_read(mxfFile, readData, LARGE_DATA_SIZE) == LARGE_DATA_SIZE);
+    CHECK(memcmp(readData, writeData, LARGE_DATA_SIZE) == 0);
+    CHECK(mxf_file_read(mxfFile, readData, segmentsSize) == segmentsSize);
+    CHECK(memcmp(readData, writeData, segmentsSize) == 0);
+    CHECK(mxf_file_getc(mxfFile) == 0x04);
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+    mxf_file_close(&mxfFile);
+
+
+    free(writeData);
+    free(readData);
+
+    return 0;
+}
+
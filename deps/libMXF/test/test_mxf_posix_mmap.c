@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_mmap.h>
+
+
+#define DATA_SIZE   10000
+
+
+
+#define CHECK(cmd) \
+    if (!(cmd)) \
+    { \
+        fprintf(stderr, "'%s' failed in %s:%d\n", #cmd, __FILENAME__, __LINE__); \
+        exit(1); \
+    }
+
+
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s filename\n", cmd);
+}
+
+int main(int argc, const char *argv[])
+{
+    MXFFile *mxfFile;
+    unsigned char *writeData;
+    unsigned char *readData;
+    const uint8_t *mapData;
+    MXFFileMap *map;
+    uint32_t i;
+
+    if (argc != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    writeData = malloc(DATA_SIZE);
+    for (i = 0; i < DATA_SIZE; i++)
+        writeData[i] = (unsigned char)(i % 251);
+    readData = malloc(DATA_SIZE);
+
+
+    CHECK(mxf_disk_file_open_new(argv[1], &mxfFile));
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == DATA_SIZE);
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_posix_mmap_open_modify(argv[1], MXF_POSIX_FLAG_DEFAULT, &mxfFile));
+    CHECK(mxf_file_map_data(mxfFile, 0, DATA_SIZE) == NULL);
+    CHECK(mxf_file_ref_map(mxfFile) == NULL);
+    CHECK(mxf_file_seek(mxfFile, DATA_SIZE / 2, SEEK_SET));
+    CHECK(mxf_file_putc(mxfFile, 0x01) == 0x01);
+    CHECK(mxf_file_seek(mxfFile, -1, SEEK_END));
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == DATA_SIZE);
+    CHECK(mxf_file_size(mxfFile) == 2 * DATA_SIZE - 1);
+    CHECK(mxf_file_seek(mxfFile, DATA_SIZE - 1, SEEK_SET));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(memcmp(readData, writeData, DATA_SIZE) == 0);
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_posix_mmap_open_read(argv[1], MXF_POSIX_FLAG_SEQUENTIAL_SCAN, &mxfFile));
+    CHECK(mxf_file_is_seekable(mxfFile));
+    CHECK(mxf_file_size(mxfFile) == 2 * DATA_SIZE - 1);
+    CHECK(mxf_file_read_ahead(mxfFile, DATA_SIZE / 2, DATA_SIZE));
+    CHECK((mapData = mxf_file_map_data(mxfFile, DATA_SIZE - 1, DATA_SIZE)) != NULL);
+    CHECK(memcmp(mapData, writeData, DATA_SIZE) == 0);
+    CHECK(mxf_file_map_data(mxfFile, DATA_SIZE, DATA_SIZE) == NULL);
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(readData[DATA_SIZE / 2] == 0x01);
+    CHECK(!mxf_file_eof(mxfFile));
+    CHECK(mxf_file_getc(mxfFile) == writeData[1]);
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE - 2);
+    CHECK(mxf_file_eof(mxfFile));
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+    CHECK(mxf_file_tell(mxfFile) == 2 * DATA_SIZE - 1);
+    CHECK(mxf_file_write(mxfFile, writeData, 1) == 0);
+    CHECK((map = mxf_file_ref_map(mxfFile)) != NULL);
+    mxf_file_close(&mxfFile);
+
+    /* the referenced mapping remains valid after the file is closed */
+    CHECK(memcmp(mapData, writeData, DATA_SIZE) == 0);
+    mxf_file_unref_map(map);
+
+
+    free(writeData);
+    free(readData);
+
+    return 0;
+}
+
@@ -42,8 +42,8 @@ using namespace mxfpp;
 
 
 
-AvidHeaderMetadata::AvidHeaderMetadata(DataModel *dataModel)
-: HeaderMetadata(dataModel)
+AvidHeaderMetadata::AvidHeaderMetadata(DataModel *dataModel, bool useArena)
+: HeaderMetadata(dataModel, useArena)
 {
     MXFPP_CHECK(mxf_avid_load_extensions(dataModel->getCDataModel()));
     dataModel->finalise();
@@ -73,6 +73,12 @@ void AvidHeaderMetadata::read(File *file, Partition *partition, const mxfKey *ke
                                                        partition->getCPartition()->headerByteCount, key, llen, len));
 }
 
+void AvidHeaderMetadata::readLazy(File *file, Partition *partition, const mxfKey *key, uint8_t llen, uint64_t len)
+{
+    MXFPP_CHECK(mxf_avid_read_lazy_header_metadata(file->getCFile(), 0, getCHeaderMetadata(),
+                                                   partition->getCPartition()->headerByteCount, key, llen, len));
+}
+
 void AvidHeaderMetadata::write(File *file, Partition *partition, FillerWriter *filler)
 {
     partition->markHeaderStart(file);
@@ -46,7 +46,7 @@ namespace mxfpp
 class AvidHeaderMetadata : public HeaderMetadata
 {
 public:
-    AvidHeaderMetadata(DataModel *dataModel);
+    AvidHeaderMetadata(DataModel *dataModel, bool useArena = false);
     virtual ~AvidHeaderMetadata();
 
 
@@ -56,6 +56,7 @@ public:
 
 
     virtual void read(File *file, Partition *partition, const mxfKey *key, uint8_t llen, uint64_t len);
+    virtual void readLazy(File *file, Partition *partition, const mxfKey *key, uint8_t llen, uint64_t len);
 
     virtual void write(File *file, Partition *partition, FillerWriter *filler);
 
@@ -457,6 +457,11 @@ void File::readNextPartition(const mxfKey *key, uint64_t len)
     _partitions.push_back(Partition::read(this, key, len));
 }
 
+void File::addPartition(Partition *partition)
+{
+    _partitions.push_back(partition);
+}
+
 uint8_t File::readUInt8()
 {
     uint8_t value;
@@ -578,11 +583,31 @@ bool File::isSeekable()
     return mxf_file_is_seekable(_cFile) == 1;
 }
 
+bool File::readAhead(int64_t position, int64_t count)
+{
+    return mxf_file_read_ahead(_cFile, position, count) == 1;
+}
+
+const unsigned char* File::mapData(int64_t position, uint32_t count)
+{
+    return mxf_file_map_data(_cFile, position, count);
+}
+
+MXFFileMap* File::refMap()
+{
+    return mxf_file_ref_map(_cFile);
+}
+
 uint32_t File::write(const unsigned char *data, uint32_t count)
 {
     return mxf_file_write(_cFile, data, count);
 }
 
+uint64_t File::writeVec(const MXFFileIOVec *vec, uint32_t count)
+{
+    return mxf_file_write_vec(_cFile, vec, count);
+}
+
 void File::writeUInt8(uint8_t value)
 {
     MXFPP_CHECK(mxf_write_uint8(_cFile, value));
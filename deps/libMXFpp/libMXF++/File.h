@@ -74,6 +74,7 @@ public:
     Partition* readFooterPartition();  // Caller takes ownership
     bool readPartitions();
     void readNextPartition(const mxfKey *key, uint64_t len);
+    void addPartition(Partition *partition);  // File takes ownership
 
     uint8_t readUInt8();
     uint16_t readUInt16();
@@ -98,9 +99,13 @@ public:
     int64_t size();
     bool eof();
     bool isSeekable();
+    bool readAhead(int64_t position, int64_t count);
+    const unsigned char* mapData(int64_t position, uint32_t count);
+    MXFFileMap* refMap();
 
 
     uint32_t write(const unsigned char *data, uint32_t count);
+    uint64_t writeVec(const MXFFileIOVec *vec, uint32_t count);
 
     void writeUInt8(uint8_t value);
     void writeUInt16(uint16_t value);
@@ -45,13 +45,16 @@ bool HeaderMetadata::isHeaderMetadata(const mxfKey *key)
     return mxf_is_header_metadata(key) != 0;
 }
 
-HeaderMetadata::HeaderMetadata(DataModel *dataModel)
+HeaderMetadata::HeaderMetadata(DataModel *dataModel, bool useArena)
 {
     _initGenerationUID = false;
     _generationUID = g_Null_UUID;
 
     initialiseObjectFactory();
-    MXFPP_CHECK(mxf_create_header_metadata(&_cHeaderMetadata, dataModel->getCDataModel()));
+    if (useArena)
+        MXFPP_CHECK(mxf_create_header_metadata_with_arena(&_cHeaderMetadata, dataModel->getCDataModel(), 0));
+    else
+        MXFPP_CHECK(mxf_create_header_metadata(&_cHeaderMetadata, dataModel->getCDataModel()));
     _ownCHeaderMetadata = true;
 
     _dataModel = new DataModel(_cHeaderMetadata->dataModel, false);
@@ -111,6 +114,11 @@ void HeaderMetadata::disableGenerationUIDInit()
     _initGenerationUID = false;
 }
 
+void HeaderMetadata::setUseArena(bool useArena)
+{
+    MXFPP_CHECK(mxf_set_header_metadata_arena(_cHeaderMetadata, useArena, 0));
+}
+
 void HeaderMetadata::registerObjectFactory(const mxfKey *key, AbsMetadataSetFactory *factory)
 {
     pair<map<mxfKey, AbsMetadataSetFactory*>::iterator, bool> result =
@@ -134,6 +142,12 @@ void HeaderMetadata::read(File *file, Partition *partition, const mxfKey *key, u
                                          partition->getCPartition()->headerByteCount, key, llen, len));
 }
 
+void HeaderMetadata::readLazy(File *file, Partition *partition, const mxfKey *key, uint8_t llen, uint64_t len)
+{
+    MXFPP_CHECK(mxf_read_lazy_header_metadata(file->getCFile(), 0, _cHeaderMetadata,
+                                              partition->getCPartition()->headerByteCount, key, llen, len));
+}
+
 void HeaderMetadata::write(File *file, Partition *partition, FillerWriter *filler)
 {
     partition->markHeaderStart(file);
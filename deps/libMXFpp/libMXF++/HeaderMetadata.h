@@ -57,7 +57,9 @@ public:
 public:
     static bool isHeaderMetadata(const mxfKey *key);
 
-    HeaderMetadata(DataModel *dataModel);
+    // sets, items and item values are allocated from an arena if useArena is true; see
+    // mxf_create_header_metadata_with_arena
+    HeaderMetadata(DataModel *dataModel, bool useArena = false);
     HeaderMetadata(::MXFHeaderMetadata *c_header_metadata, bool take_ownership);
     virtual ~HeaderMetadata();
 
@@ -68,6 +70,9 @@ public:
     void enableGenerationUIDInit(mxfUUID generationUID);
     void disableGenerationUIDInit();
 
+    // only possible before any sets have been created or read
+    void setUseArena(bool useArena);
+
 
     void registerObjectFactory(const mxfKey *key, AbsMetadataSetFactory *factory);
 
@@ -75,6 +80,8 @@ public:
 
 
     virtual void read(File *file, Partition *partition, const mxfKey *key, uint8_t llen, uint64_t len);
+    // sets are read when first used; see mxf_read_lazy_header_metadata
+    virtual void readLazy(File *file, Partition *partition, const mxfKey *key, uint8_t llen, uint64_t len);
 
     virtual void write(File *file, Partition *partition, FillerWriter *filler);
 
@@ -48,6 +48,7 @@ class BMXFileIO: public virtual BMXIO
 public:
     static BMXFileIO* OpenRead(const std::string &filename);
     static BMXFileIO* OpenNew(const std::string &filename);
+    static BMXFileIO* OpenTemp();
 
 public:
     virtual ~BMXFileIO();
@@ -61,12 +62,21 @@ public:
     virtual int64_t Tell();
     virtual int64_t Size();
 
+    virtual const unsigned char* MapData(int64_t offset, uint32_t size);
+
+public:
+    // map the read-only file into memory so that MapData can be used to access data that was present
+    // when the file was mapped. Returns false if the file could not be mapped or mapping is not supported
+    bool MapFile();
+
 protected:
     BMXFileIO(FILE *file, bool read_only);
 
 protected:
     FILE *mFile;
     bool mReadOnly;
+    unsigned char *mMapData;
+    int64_t mMapSize;
 };
 
 
@@ -59,6 +59,10 @@ public:
 
     virtual int64_t Tell();
     virtual int64_t Size();
+
+    // returns a pointer to file data that remains valid until the file is closed, or null if the
+    // data is not available without reading it
+    virtual const unsigned char* MapData(int64_t offset, uint32_t size);
 };
 
 
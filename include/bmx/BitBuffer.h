@@ -73,11 +73,14 @@ public:
     bool GetBits(uint8_t num_bits, int32_t *value);
     bool GetBits(uint8_t num_bits, int64_t *value);
 
+    bool PeekBits(uint8_t num_bits, uint64_t *value) const;
+
     void SetPos(uint32_t pos);
     void SetBitPos(uint64_t bit_pos);
 
 protected:
-    void GetBits(const unsigned char *data, uint32_t *pos_io, uint64_t *bit_pos_io, uint8_t num_bits, uint64_t *value);
+    void GetBits(const unsigned char *data, uint32_t *pos_io, uint64_t *bit_pos_io, uint8_t num_bits,
+                 uint64_t *value) const;
 
 protected:
     const unsigned char *mData;
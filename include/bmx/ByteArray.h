@@ -49,6 +49,8 @@ public:
     ~ByteArray();
 
     void SetAllocBlockSize(uint32_t block_size);
+    void SetAlignment(uint32_t alignment);
+    uint32_t GetAlignment() const { return mAlignment; }
 
     unsigned char* GetBytes() const;
     uint32_t GetSize() const;
@@ -71,12 +73,17 @@ public:
 
     void Clear();
 
+private:
+    unsigned char* AllocBytes(uint32_t size);
+    void FreeBytes(unsigned char *bytes);
+
 private:
     unsigned char *mBytes;
     uint32_t mSize;
     bool mIsCopy;
     uint32_t mAllocatedSize;
     uint32_t mAllocBlockSize;
+    uint32_t mAlignment;
 };
 
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_CPU_FEATURES_H_
+#define BMX_CPU_FEATURES_H_
+
+
+// x86-64 always has SSE2; the other instruction set extensions are checked at runtime and
+// the functions using them are compiled with a target attribute
+#if defined(__x86_64__) || defined(_M_X64)
+#define BMX_HAVE_X86_SIMD   1
+#endif
+
+#if defined(BMX_HAVE_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define BMX_TARGET_ISA(isa) __attribute__((target(isa)))
+#else
+#define BMX_TARGET_ISA(isa)
+#endif
+
+
+
+namespace bmx
+{
+
+
+bool cpu_has_sse2();
+bool cpu_has_ssse3();
+bool cpu_has_sse41();
+bool cpu_has_pclmul();
+bool cpu_has_avx2();
+bool cpu_has_sha();
+
+// force the scalar code paths to be used, e.g. for testing and benchmarking
+void disable_cpu_features(bool disable);
+
+
+};
+
+
+
+#endif
@@ -33,6 +33,9 @@
 #define BMX_CHECKSUM_H_
 
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <bmx/CRC32.h>
 #include <bmx/MD5.h>
@@ -87,6 +90,61 @@ private:
 };
 
 
+#define CHECKSUM_ENGINE_BUFFER_SIZE     (4 * 1024 * 1024)
+
+// The ChecksumEngine calculates one or more checksums over the same data with each checksum
+// updated in its own worker thread. Data is collected in one of 2 buffers, and a full buffer is
+// handed over to the workers whilst the other one is filled. The wall time is therefore
+// close to that of the slowest checksum rather than the sum of all of them.
+// A single checksum is updated in the caller's thread, without workers, and a buffer is only
+// allocated if GetBuffer() is used.
+
+class ChecksumEngine
+{
+public:
+    ChecksumEngine(const std::vector<ChecksumType> &types, uint32_t buffer_size = CHECKSUM_ENGINE_BUFFER_SIZE);
+    ~ChecksumEngine();
+
+    unsigned char* GetBuffer(uint32_t *size);   // space in the current buffer, e.g. for reading directly into
+    void CommitBuffer(uint32_t size);           // size bytes have been written to the GetBuffer() space
+
+    void Update(const unsigned char *data, uint32_t size);
+    void Final();
+
+    size_t GetNumChecksums() const { return mChecksums.size(); }
+    const Checksum& GetChecksum(size_t index) const;
+    const Checksum& GetChecksum(ChecksumType type) const;
+
+private:
+    typedef struct
+    {
+        unsigned char *alloc_data;
+        unsigned char *data;
+        uint32_t size;
+        size_t pending_count;
+    } Buffer;
+
+private:
+    void AllocateBuffer(Buffer *buffer);
+    void SubmitBuffer();
+    void WaitForWorkers();
+    void StopWorkers();
+    void ProcessBuffers(size_t checksum_index);
+
+private:
+    std::vector<Checksum> mChecksums;
+    std::vector<std::thread> mWorkers;
+    uint32_t mBufferSize;
+    Buffer mBuffers[2];
+    size_t mCurrentBuffer;
+    uint64_t mSubmitCount;
+    bool mStop;
+    bool mFinal;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+};
+
+
 };
 
 
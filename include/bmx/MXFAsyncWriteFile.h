@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_MXF_ASYNC_WRITE_FILE_H_
+#define BMX_MXF_ASYNC_WRITE_FILE_H_
+
+
+#include <mxf/mxf_file.h>
+
+
+#define MXF_ASYNC_WRITE_DEFAULT_BUFFER_SIZE     (4 * 1024 * 1024)
+#define MXF_ASYNC_WRITE_DEFAULT_NUM_BUFFERS     8
+
+
+
+namespace bmx
+{
+
+
+// An MXF file wrapper that queues data written to the target file in a bounded set of buffers which are written
+// by a dedicated I/O thread. Writing blocks when all buffers are queued. Other operations (except tell) wait for
+// the queued data to be written first. A failed write causes subsequent writes and the flush to fail.
+
+typedef struct MXFAsyncWriteFile MXFAsyncWriteFile;
+
+MXFAsyncWriteFile* mxf_async_write_file_open(MXFFile *target, uint32_t buffer_size, uint32_t num_buffers);
+MXFFile* mxf_async_write_file_get_file(MXFAsyncWriteFile *async_file);
+bool mxf_async_write_file_flush(MXFAsyncWriteFile *async_file);
+
+
+};
+
+
+
+#endif
@@ -34,6 +34,7 @@
 
 
 #include <string>
+#include <vector>
 
 #include <mxf/mxf_file.h>
 
@@ -48,6 +49,7 @@ namespace bmx
 typedef struct MXFChecksumFile MXFChecksumFile;
 
 MXFChecksumFile* mxf_checksum_file_open(MXFFile *target, ChecksumType type);
+MXFChecksumFile* mxf_checksum_file_open(MXFFile *target, const std::vector<ChecksumType> &types);
 MXFFile* mxf_checksum_file_get_file(MXFChecksumFile *checksum_file);
 void mxf_checksum_file_force_update(MXFChecksumFile *checksum_file);
 bool mxf_checksum_file_final(MXFChecksumFile *checksum_file);
@@ -55,6 +57,12 @@ size_t mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file);
 void mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, unsigned char *digest, size_t size);
 std::string mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file);
 
+// digests for a checksum file opened with multiple checksum types
+size_t mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file, ChecksumType type);
+void mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, ChecksumType type, unsigned char *digest,
+                              size_t size);
+std::string mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file, ChecksumType type);
+
 
 };
 
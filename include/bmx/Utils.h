@@ -100,6 +100,8 @@ bool check_ends_with_dir_separator(std::string name);
 
 int64_t get_file_size(const std::string &filename);
 int64_t get_file_size(FILE *file);
+int64_t get_file_modification_time(const std::string &filename);
+void replace_file(const std::string &filename, const std::string &new_filename);  // renames filename to new_filename
 
 std::string trim_string(std::string value);
 std::vector<std::string> split_string(std::string value, char separator, bool allow_empty, bool trim);
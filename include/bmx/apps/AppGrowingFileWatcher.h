@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_APP_GROWING_FILE_WATCHER_H_
+#define BMX_APP_GROWING_FILE_WATCHER_H_
+
+#include <string>
+#include <vector>
+
+#include <bmx/BMXTypes.h>
+
+
+
+namespace bmx
+{
+
+
+// Waits for one or more growing files to be extended by a writer.
+// On Linux the files are watched using inotify and the wait ends as soon as data is written.
+// Otherwise, or if a watch can't be added, the file sizes are polled with an increasing interval.
+
+class AppGrowingFileWatcher
+{
+public:
+    AppGrowingFileWatcher();
+    ~AppGrowingFileWatcher();
+
+    bool AddFile(const std::string &filename);
+    size_t GetNumFiles() const { return mFiles.size(); }
+
+    bool WaitForGrowth(uint32_t timeout_msec);  // returns true if a file has grown since the previous call
+
+private:
+    typedef struct
+    {
+        std::string filename;
+        int64_t size;
+    } WatchedFile;
+
+private:
+    bool CheckGrowth();
+
+private:
+    std::vector<WatchedFile> mFiles;
+    int mINotifyFD;
+    bool mPollSizes;
+};
+
+
+};
+
+
+
+#endif
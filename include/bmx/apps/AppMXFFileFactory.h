@@ -35,6 +35,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <mutex>
 
 #include <bmx/mxf_helper/MXFFileFactory.h>
 #include <bmx/MXFChecksumFile.h>
@@ -47,6 +48,9 @@
 #if !defined(__MINGW32__)
 #include <mxf/mxf_win32_mmap.h>
 #endif
+#else
+#include <mxf/mxf_posix_file.h>
+#include <mxf/mxf_posix_mmap.h>
 #endif
 
 
@@ -67,9 +71,15 @@ public:
     void SetRWInterleave(uint32_t rw_interleave_size);
     void SetHTTPMinReadSize(uint32_t size);
     void SetHTTPEnableSeek(bool enable);  // Default true
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
+    // On POSIX, frames reference the mapped data and keep it mapped after the file is closed.
+    // Only files opened for read or modify are mapped; new files use positioned read/write file I/O
     void SetUseMMapFile(bool enable);
 #endif
+#if !defined(_WIN32)
+    void SetUsePReadFile(bool enable);
+    void SetReadAheadSize(uint32_t size);   // Default 0 uses MXF_POSIX_DEFAULT_READ_AHEAD_SIZE
+#endif
 
 public:
     virtual mxfpp::File* OpenNew(std::string filename);
@@ -101,15 +111,20 @@ private:
     } InputChecksumFile;
 
 private:
+    std::mutex mOpenReadMutex;  // OpenRead may be called concurrently by MXFFileReader::OpenConcurrent
     std::set<ChecksumType> mInputChecksumTypes;
     int mInputFlags;
     std::vector<InputChecksumFile> mInputChecksumFiles;
     MXFRWInterleaver *mRWInterleaver;
     uint32_t mHTTPMinReadSize;
     bool mHTTPEnableSeek;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool mUseMMapFile;
 #endif
+#if !defined(_WIN32)
+    bool mUsePReadFile;
+    uint32_t mReadAheadSize;
+#endif
 };
 
 
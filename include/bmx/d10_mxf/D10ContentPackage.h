@@ -40,6 +40,7 @@
 
 #include <bmx/BMXTypes.h>
 #include <bmx/ByteArray.h>
+#include <bmx/MXFWriteBatch.h>
 #include <bmx/frame/DataBufferArray.h>
 
 
@@ -98,13 +99,13 @@ public:
     void WriteSample(uint32_t track_index, const CDataBuffer *data_array, uint32_t array_size);
 
     bool IsComplete();
-    void Write(mxfpp::File *mxf_file);
+    void Write(MXFWriteBatch *batch);
 
 private:
     void CopySoundSamples(const unsigned char *data, uint32_t num_samples, const D10SoundChannelInfo &channel_info,
                           uint32_t output_start_sample);
 
-    uint32_t WriteSystemItem(mxfpp::File *mxf_file);
+    uint32_t WriteSystemItem(MXFWriteBatch *batch);
 
 private:
     D10ContentPackageInfo *mInfo;
@@ -172,6 +173,8 @@ private:
     std::vector<D10ContentPackage*> mFreeContentPackages;
 
     int64_t mPosition;
+
+    MXFWriteBatch mWriteBatch;
 };
 
 
@@ -97,6 +97,7 @@ public:
 
 private:
     void GetRBSPBits(uint8_t num_bits, uint64_t *value);
+    bool FindEmulationPreventionByte(uint8_t num_bits, uint8_t *before_bits) const;
 };
 
 
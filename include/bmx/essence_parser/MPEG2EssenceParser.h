@@ -102,7 +102,6 @@ private:
 private:
     // parse frame
     uint32_t mOffset;
-    uint32_t mState;
     bool mSequenceHeader;
     bool mGroupHeader;
     bool mPictureStart;
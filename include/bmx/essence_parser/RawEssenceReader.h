@@ -66,7 +66,7 @@ public:
 public:
     virtual uint32_t ReadSamples(uint32_t num_samples);
 
-    virtual unsigned char* GetSampleData() const        { return mSampleBuffer.GetBytes(); }
+    virtual unsigned char* GetSampleData() const        { return mSampleBuffer.GetBytes() + mSampleDataOffset; }
     uint32_t GetSampleDataSize() const                  { return mSampleDataSize; }
     uint32_t GetNumSamples() const                      { return mNumSamples; }
     uint32_t GetSampleSize() const;
@@ -76,10 +76,14 @@ public:
 protected:
     bool ReadAndParseSample();
     uint32_t ReadBytes(uint32_t size);
-    void ShiftSampleData(uint32_t to_offset, uint32_t from_offset);
+    void SkipSampleData(uint32_t size);
+    uint32_t GetBufferedSize() const                    { return mSampleBuffer.GetSize() - mSampleDataOffset; }
 
     uint32_t AppendBytes(const unsigned char *bytes, uint32_t size);
 
+private:
+    void ReserveBytes(uint32_t size);
+
 protected:
     EssenceSource *mEssenceSource;
 
@@ -93,6 +97,7 @@ protected:
     EssenceParser *mEssenceParser;
 
     ByteArray mSampleBuffer;
+    uint32_t mSampleDataOffset;
     uint32_t mSampleDataSize;
     uint32_t mNumSamples;
     bool mReadFirstSample;
@@ -56,10 +56,28 @@ void deinterleave_audio(const unsigned char *input_data, uint32_t input_data_siz
                         uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                         unsigned char *output_data, uint32_t output_data_size);
 
+// interleave input_count inputs, each with input_block_align bytes per sample, into consecutive positions
+// in the output blocks. The other bytes in the output blocks are left unchanged
+void interleave_audio_inputs(const unsigned char * const *input_data, uint16_t input_count,
+                             uint32_t input_block_align, uint32_t sample_count,
+                             unsigned char *output_data, uint32_t output_block_align);
+
+// deinterleave output_count consecutive groups of channels, each with output_block_align bytes per sample,
+// from the input blocks into the outputs
+void deinterleave_audio_outputs(const unsigned char *input_data, uint32_t input_block_align,
+                                uint32_t sample_count, uint32_t output_block_align,
+                                unsigned char * const *output_data, uint16_t output_count);
+
 void interleave_audio(const unsigned char *input_data, uint32_t input_data_size,
                       uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                       unsigned char *output_data, uint32_t output_data_size);
 
+// interleave input_count inputs, each with input_block_align bytes per sample, into consecutive positions
+// in the output blocks. The other bytes in the output blocks are left unchanged
+void interleave_audio_inputs(const unsigned char * const *input_data, uint16_t input_count,
+                             uint32_t input_block_align, uint32_t sample_count,
+                             unsigned char *output_data, uint32_t output_block_align);
+
 
 
 };
@@ -36,6 +36,9 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
 
 #include <bmx/BMXTypes.h>
 #include <bmx/ByteArray.h>
@@ -43,24 +46,49 @@
 
 #define NULL_FRAME_POSITION     (int64_t)(((uint64_t)1)<<63)
 
+#define FRAME_INLINE_METADATA_COUNT     4
+
 
 
 namespace bmx
 {
 
 
+typedef uint16_t FrameMetadataId;
+
+
 class FrameMetadata
 {
+public:
+    // Returns the numeric id interned for the string id. Equal strings return the same numeric id
+    static FrameMetadataId RegisterId(const char *id);
+
 public:
     FrameMetadata(const char *id);
+    FrameMetadata(const FrameMetadata &from);
     virtual ~FrameMetadata();
 
+    FrameMetadata& operator=(const FrameMetadata &from);
+
     const char* GetId() const { return mId; }
+    FrameMetadataId GetNumericId() const { return mNumericId; }
 
     virtual FrameMetadata* Clone() = 0;
 
+public:
+    // Metadata is reference counted so that it can be shared between frames, e.g. the frames for all
+    // tracks in a content package, and reused by the producer once it is no longer shared.
+    // Shared metadata must not be modified. Release() deletes the metadata when the count reaches 0
+    FrameMetadata* AddRef();
+    void Release();
+    bool IsShared() const;
+
 protected:
     const char *mId;
+    FrameMetadataId mNumericId;
+
+private:
+    std::atomic<uint32_t> mRefCount;
 };
 
 
@@ -82,14 +110,27 @@ public:
 
     virtual Frame* Clone() = 0;
 
+    // Reference data owned elsewhere, e.g. a memory-mapped file, instead of copying it into an empty frame.
+    // The frame holds the owner until the data is released, which keeps the data valid after the source
+    // is closed. The data is copied when the frame is grown. Returns false if the frame doesn't support it
+    virtual bool ReferenceBytes(const unsigned char *bytes, uint32_t size, std::shared_ptr<const void> owner);
+
 public:
     bool IsEmpty() const    { return num_samples == 0; }
     bool IsComplete() const { return num_samples == request_num_samples; }
 
-    const std::map<std::string, std::vector<FrameMetadata*> >& GetMetadata() const { return mMetadata; }
-    const std::vector<FrameMetadata*>* GetMetadata(std::string id) const;
+    size_t GetNumMetadata() const { return mNumMetadata; }
+    FrameMetadata* GetMetadataItem(size_t index) const;
+    FrameMetadata* FindMetadata(FrameMetadataId id, size_t index = 0) const;
+
+    // The frame takes ownership of a reference to the metadata
     void InsertMetadata(FrameMetadata *metadata);
 
+    // Compatibility accessors that build a string keyed map on first use.
+    // Building the map modifies the frame and so these are not thread safe, unlike FindMetadata
+    const std::map<std::string, std::vector<FrameMetadata*> >& GetMetadata() const;
+    const std::vector<FrameMetadata*>* GetMetadata(std::string id) const;
+
 public:
     Rational edit_rate;
     int64_t position;
@@ -115,7 +156,19 @@ public:
     mxfKey element_key;
 
 protected:
-    std::map<std::string, std::vector<FrameMetadata*> > mMetadata;
+    // Releases all the metadata. Subclasses add metadata using InsertMetadata
+    void ClearMetadata();
+
+private:
+    void UpdateMetadataMap() const;
+
+private:
+    FrameMetadata *mInlineMetadata[FRAME_INLINE_METADATA_COUNT];
+    std::vector<FrameMetadata*> mExtraMetadata;
+    size_t mNumMetadata;
+
+    mutable std::map<std::string, std::vector<FrameMetadata*> > mMetadataMap;
+    mutable bool mMetadataMapValid;
 };
 
 
@@ -145,8 +198,16 @@ public:
 
     virtual Frame* Clone();
 
+    virtual bool ReferenceBytes(const unsigned char *bytes, uint32_t size, std::shared_ptr<const void> owner);
+
+private:
+    void CopyReferencedBytes();
+
 private:
     ByteArray mData;
+    const unsigned char *mRefBytes;
+    uint32_t mRefSize;
+    std::shared_ptr<const void> mRefOwner;
 };
 
 
@@ -159,6 +220,126 @@ public:
 };
 
 
+typedef struct
+{
+    uint64_t frame_hits;        // frame objects taken from the (process wide) free list
+    uint64_t frame_misses;      // frame objects allocated from the heap
+    uint64_t data_hits;         // data buffers taken from the pool
+    uint64_t data_misses;       // data buffers allocated from the heap
+    size_t free_data_count;     // data buffers in the pool
+    uint64_t free_data_size;    // total allocated size of the data buffers in the pool
+} FramePoolStats;
+
+
+// Free data buffers are kept in power of 2 size classes so that a buffer is acquired with sufficient
+// size for the frame. Buffers smaller than the alignment are only aligned to a cache line.
+// The limits on the free buffers are the sum of the limits added by the users of the pool.
+// The pool is thread safe
+class FrameDataPool
+{
+public:
+    FrameDataPool(uint32_t alignment);
+    ~FrameDataPool();
+
+    void AddLimits(size_t max_free_buffers, uint64_t max_free_size);
+    void RemoveLimits(size_t max_free_buffers, uint64_t max_free_size);
+
+    ByteArray* Acquire(uint32_t min_size);
+    void Release(ByteArray *data);
+
+    uint32_t GetAlignment() const { return mAlignment; }
+
+    void GetStats(FramePoolStats *stats);
+
+private:
+    size_t GetSizeClass(uint32_t size, bool round_up) const;
+    uint32_t GetClassAlignment(uint64_t class_size) const;
+    void TrimFreeBuffers();
+
+private:
+    std::mutex mMutex;
+    uint32_t mAlignment;
+    uint32_t mMinClassSize;
+    size_t mMaxFreeBuffers;
+    uint64_t mMaxFreeSize;
+    std::vector<std::vector<ByteArray*> > mFreeBuffers;
+    size_t mFreeCount;
+    uint64_t mFreeSize;
+    uint64_t mHits;
+    uint64_t mMisses;
+};
+
+
+class PooledFrame : public Frame
+{
+public:
+    // The frame object storage is recycled through a process wide free list
+    static void* operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
+    static void GetObjectStats(uint64_t *hits, uint64_t *misses);
+
+public:
+    PooledFrame(std::shared_ptr<FrameDataPool> pool);
+    PooledFrame(const PooledFrame &from);
+    virtual ~PooledFrame();
+
+    virtual uint32_t GetSize() const;
+    virtual const unsigned char* GetBytes() const;
+
+    virtual void Grow(uint32_t min_size);
+    virtual uint32_t GetSizeAvailable() const;
+    virtual unsigned char* GetBytesAvailable() const;
+    virtual void SetSize(uint32_t size);
+    virtual void IncrementSize(uint32_t inc);
+
+    virtual Frame* Clone();
+
+    virtual bool ReferenceBytes(const unsigned char *bytes, uint32_t size, std::shared_ptr<const void> owner);
+
+private:
+    void AcquireData(uint32_t min_size);
+    void CopyReferencedBytes();
+
+private:
+    std::shared_ptr<FrameDataPool> mPool;
+    ByteArray *mData;
+    const unsigned char *mRefBytes;
+    uint32_t mRefSize;
+    std::shared_ptr<const void> mRefOwner;
+};
+
+
+// Creates frames with aligned data buffers that are recycled when the frames are deleted.
+// The buffers are aligned to the system page size if alignment is 0.
+// Frames can outlive the factory because the pool is shared with the frames.
+class PooledFrameFactory : public FrameFactory
+{
+public:
+    // Returns a factory that uses the process wide pool of page aligned buffers. The pool limits grow with
+    // the number of shared factories, e.g. one for each track reader.
+    // The DefaultFrameBuffer uses this factory unless another is set.
+    static PooledFrameFactory* CreateShared(size_t max_free_buffers = 8, uint64_t max_free_size = 16 * 1024 * 1024);
+
+public:
+    PooledFrameFactory(uint32_t alignment = 0, size_t max_free_buffers = 32,
+                       uint64_t max_free_size = 64 * 1024 * 1024);
+    virtual ~PooledFrameFactory();
+
+    virtual Frame* CreateFrame();
+
+    void GetStats(FramePoolStats *stats);
+
+private:
+    PooledFrameFactory(std::shared_ptr<FrameDataPool> pool, size_t max_free_buffers, uint64_t max_free_size);
+
+private:
+    std::shared_ptr<FrameDataPool> mPool;
+    size_t mMaxFreeBuffers;
+    uint64_t mMaxFreeSize;
+};
+
+
 };
 
 
@@ -32,7 +32,7 @@
 #ifndef BMX_FRAME_BUFFER_H_
 #define BMX_FRAME_BUFFER_H_
 
-#include <deque>
+#include <vector>
 
 #include <bmx/frame/Frame.h>
 
@@ -88,10 +88,14 @@ public:
 
     virtual void Clear(bool del_frames);
 
+private:
+    void PopFrontFrame();
+
 private:
     FrameFactory *mFrameFactory;
     bool mOwnFrameFactory;
-    std::deque<Frame*> mFrames;
+    std::vector<Frame*> mFrames;    // queue starting at mFrontIndex. The capacity is kept for reuse
+    size_t mFrontIndex;
     size_t mStartReadIndex;
 };
 
@@ -39,6 +39,7 @@
 #include <libMXF++/MXF.h>
 
 #include <bmx/ByteArray.h>
+#include <bmx/MXFWriteBatch.h>
 #include <bmx/frame/DataBufferArray.h>
 #include <bmx/mxf_op1a/OP1AIndexTable.h>
 
@@ -111,7 +112,7 @@ public:
 
     uint32_t GetWriteSize() const;
     uint32_t GetNumSamplesWritten() const { return mNumSamplesWritten; }
-    uint32_t Write();
+    uint32_t Write(MXFWriteBatch *batch);
     void CompleteWrite();
 
     void Reset(int64_t new_position);
@@ -148,8 +149,8 @@ public:
 public:
     bool IsReady();
     void UpdateIndexTable();
-    uint32_t Write();
-    void WriteSystemItem();
+    uint32_t Write(MXFWriteBatch *batch);
+    void WriteSystemItem(MXFWriteBatch *batch);
     void CompleteWrite();
 
 private:
@@ -233,6 +234,8 @@ private:
     std::deque<OP1AContentPackage*> mContentPackages;
     std::vector<OP1AContentPackage*> mFreeContentPackages;
     int64_t mPosition;
+
+    MXFWriteBatch mWriteBatch;
 };
 
 
@@ -48,6 +48,7 @@
 #include <bmx/wave/WaveChunk.h>
 #include <bmx/BMXTypes.h>
 #include <bmx/MXFChecksumFile.h>
+#include <bmx/MXFAsyncWriteFile.h>
 
 
 #define OP1A_DEFAULT_FLAVOUR                0x0000
@@ -103,9 +104,11 @@ public:
     void SetAddSystemItem(bool enable);                                 // default false, no system item
     void SetRepeatIndexTable(bool enable);                              // default false. Repeat index table in Footer if true
     void ForceWriteCBEDuration0(bool enable);                           // force duration=0 for CBE index table
+    void SetSpillIndexTable(bool enable);                               // default false. If true then completed VBE index table segments are kept in a temporary file until written
     void SetPrimaryPackage(bool enable);                                // default false
     void SetIndexFollowsEssence(bool enable);                           // default false. If true then place index partition after the essence it indexes, even for CBE
     void SetSignalST3792(bool enable);                                  // default false. If true then signal ST 379-2 compliance using sub-descriptor
+    void SetPipelinedWrite(bool enable);                                // default false. If true then file writes are done in a separate I/O thread
 
     uint32_t AddWaveChunk(WaveChunk *chunk, bool take_ownership);
     uint32_t AddADMWaveChunk(WaveChunk *chunk, bool take_ownership, const std::vector<UL> &profile_and_level_uls);
@@ -204,6 +207,7 @@ private:
     mxfUL mOPLabel;
     bool mIndexFollowsEssence;
     bool mSignalST3792;
+    bool mPipelinedWrite;
 
     int64_t mOutputStartOffset;
     int64_t mOutputEndOffset;
@@ -242,6 +246,7 @@ private:
     int64_t mFooterPartitionOffset;
 
     MXFChecksumFile *mMXFChecksumFile;
+    MXFAsyncWriteFile *mMXFAsyncWriteFile;
     std::string mMD5DigestStr;
 
     size_t mCBEIndexPartitionIndex;
@@ -33,9 +33,11 @@
 #define BMX_OP1A_INDEX_TABLE_H_
 
 #include <vector>
-#include <set>
+#include <deque>
+#include <map>
 
 #include <bmx/ByteArray.h>
+#include <bmx/BMXFileIO.h>
 
 
 
@@ -98,6 +100,7 @@ public:
 
     bool RequireUpdatesAtEnd(int64_t end_offset) const;
     bool RequireUpdatesAtPos(int64_t position) const;
+    void ClearRequiredUpdate(int64_t position);
     void IgnoreRequiredUpdates();
 
 public:
@@ -110,11 +113,21 @@ public:
 
     uint32_t element_size;
 
-    std::set<int64_t> require_updates;
     int64_t last_add_index_entry_pos;
 
 private:
-    std::map<int64_t, OP1AIndexEntry> mIndexEntryCache;
+    typedef struct
+    {
+        int64_t position;   // -1 if the slot is free
+        OP1AIndexEntry entry;
+    } CachedIndexEntry;
+
+    OP1AIndexEntry* GetCachedIndexEntry(int64_t position);
+
+private:
+    std::vector<CachedIndexEntry> mIndexEntryCache;    // ring buffer indexed by position
+    size_t mIndexEntryCacheCount;
+    std::deque<int64_t> mRequireUpdates;               // sorted positions
 };
 
 
@@ -136,13 +149,22 @@ public:
 
     uint32_t GetDuration() const;
 
+    void Spill(BMXFileIO *spill_file);
+    bool IsSpilled() const { return mSpillFile != 0; }
+
     mxfpp::IndexTableSegment* GetSegment() { return &mSegment; }
-    ByteArray* GetEntries() { return &mEntries; }
+    void WriteEntries(mxfpp::File *mxf_file, ByteArray *buffer);
+
+private:
+    void SetEntryBytes(int64_t segment_position, const unsigned char *bytes, uint32_t size);
 
 private:
     mxfpp::IndexTableSegment mSegment;
     ByteArray mEntries;
     uint32_t mIndexEntrySize;
+    BMXFileIO *mSpillFile;
+    int64_t mSpillOffset;
+    uint32_t mSpillSize;
 };
 
 
@@ -157,6 +179,7 @@ public:
                        mxfOptBool forward_index_direction);
     void SetRepeatIndexTable(bool enable);
     void ForceWriteCBEDuration0(bool enable);
+    void SetSpillSegments(bool enable);
 
     void RegisterSystemItem();
     void RegisterPictureTrackElement(uint32_t track_index, bool is_cbe, bool apply_temporal_reordering);
@@ -217,6 +240,8 @@ private:
     void WriteCBESegments(mxfpp::File *mxf_file, mxfpp::Partition *partition, bool final_write);
     void WriteVBESegments(mxfpp::File *mxf_file, mxfpp::Partition *partition, std::vector<OP1AIndexTableSegment*> &segments);
 
+    void SpillSegment(OP1AIndexTableSegment *segment);
+
 private:
     uint32_t mIndexSID;
     uint32_t mBodySID;
@@ -245,6 +270,10 @@ private:
 
     std::vector<OP1AIndexTableSegment*> mWrittenVBEIndexSegments;
     bool mHaveWritten;
+
+    bool mSpillSegments;
+    BMXFileIO *mSpillFile;
+    ByteArray mSpillBuffer;
 };
 
 
@@ -32,6 +32,8 @@
 #ifndef BMX_OP1A_PCM_TRACK_H_
 #define BMX_OP1A_PCM_TRACK_H_
 
+#include <set>
+
 #include <bmx/mxf_op1a/OP1ATrack.h>
 #include <bmx/mxf_helper/WaveMXFDescriptorHelper.h>
 #include <bmx/wave/WaveCHNA.h>
@@ -62,6 +62,9 @@ public:
 
 class EssenceChunkHelper
 {
+public:
+    friend class MXFIndexCache;
+
 public:
     EssenceChunkHelper(MXFFileReader *file_reader);
     ~EssenceChunkHelper();
@@ -34,7 +34,7 @@
 
 
 #include <vector>
-#include <deque>
+#include <memory>
 
 #include <bmx/frame/Frame.h>
 #include <bmx/mxf_reader/FrameMetadataReader.h>
@@ -62,6 +62,7 @@ public:
 
     Frame* GetFrame(uint32_t track_index);
     void PushFrames(uint32_t actual_read_num_samples);
+    void AbortRead();
 
     size_t GetBufferSize() const { return mRequestSampleCounts.size(); }
 
@@ -77,9 +78,9 @@ private:
 
 private:
     MXFFileReader *mFileReader;
-    std::vector<std::deque<Frame*> > mTrackFrames;
-    std::deque<uint32_t> mRequestSampleCounts;
-    std::deque<uint32_t> mReadSampleCounts;
+    std::vector<std::vector<Frame*> > mTrackFrames;
+    std::vector<uint32_t> mRequestSampleCounts;
+    std::vector<uint32_t> mReadSampleCounts;
     int64_t mStartPosition;
     size_t mCurrentFrame;
     bool mBufferFrames;
@@ -111,6 +112,8 @@ public:
 private:
     uint32_t ReadClipWrappedSamples(uint32_t num_samples);
     uint32_t ReadFrameWrappedSamples(uint32_t num_samples);
+    void ReadAhead(int64_t position, uint32_t num_samples);
+    bool ReferenceFileData(Frame *frame, int64_t file_position, uint32_t size);
 
     void GetEditUnit(int64_t position, mxfKey *element_key, int64_t *file_position, int64_t *size);
     void GetEditUnitGroup(int64_t position, uint32_t max_samples, mxfKey *element_key, int64_t *file_position,
@@ -143,6 +146,7 @@ private:
 private:
     MXFFileReader *mFileReader;
     mxfpp::File *mFile;
+    std::shared_ptr<const void> mFileMap;   // reference to the memory-mapped file data held by frames
     bool mFileIsComplete;
     bool mParseOnly;    // KLV parsing only, no essence reading
 
@@ -168,6 +172,8 @@ private:
     mxfKey mEssenceStartKey;
     int64_t mLastKnownFilePosition;
     int64_t mLastKnownBasePosition;
+    int64_t mReadAheadStart;
+    int64_t mReadAheadEnd;
     bool mHaveFooter;
     bool mBaseReadError;
 };
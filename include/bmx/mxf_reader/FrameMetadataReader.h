@@ -76,9 +76,11 @@ private:
     bool mIsBBCPreservationFile;
 
     SS1TimecodeArray *mTimecodeArray;
+    bool mHaveTimecodeArray;
 
     std::vector<uint32_t> mCRC32s;
     std::vector<uint32_t> mTrackNumbers;
+    std::vector<SS1APPChecksum*> mChecksums;
 };
 
 
@@ -95,6 +97,7 @@ public:
 private:
     mxfpp::File *mFile;
     SDTICPSystemMetadata *mMetadata;
+    bool mHaveMetadata;
 };
 
 
@@ -111,6 +114,7 @@ public:
 private:
     mxfpp::File *mFile;
     SDTICPPackageMetadata *mMetadata;
+    bool mHaveMetadata;
 };
 
 
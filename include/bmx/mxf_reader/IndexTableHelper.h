@@ -50,6 +50,9 @@ class MXFFileReader;
 
 class IndexTableHelperSegment : public mxfpp::IndexTableSegment
 {
+public:
+    friend class MXFIndexCache;
+
 public:
     IndexTableHelperSegment();
     virtual ~IndexTableHelperSegment();
@@ -84,6 +87,9 @@ public:
 
     void CopyIndexEntries(const IndexTableHelperSegment *segment, uint32_t duration);
 
+    void ReadCache(mxfpp::File *cache_file);
+    void WriteCache(mxfpp::File *cache_file) const;
+
 private:
     unsigned char *mIndexEntries;
     uint32_t mAllocIndexEntries;
@@ -102,6 +108,9 @@ private:
 
 class IndexTableHelper
 {
+public:
+    friend class MXFIndexCache;
+
 public:
     IndexTableHelper(MXFFileReader *file_reader);
     ~IndexTableHelper();
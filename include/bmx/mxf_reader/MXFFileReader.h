@@ -43,6 +43,7 @@
 #include <bmx/mxf_reader/MXFReader.h>
 #include <bmx/mxf_reader/MXFFileTrackReader.h>
 #include <bmx/mxf_reader/EssenceReader.h>
+#include <bmx/mxf_reader/MXFIndexCache.h>
 #include <bmx/mxf_reader/MXFPackageResolver.h>
 #include <bmx/mxf_helper/MXFFileFactory.h>
 #include <bmx/URI.h>
@@ -60,6 +61,7 @@ public:
     friend class EssenceReader;
     friend class IndexTableHelper;
     friend class EssenceChunkHelper;
+    friend class MXFIndexCache;
     friend class MXFFileTrackReader;
     friend class MXFTimedTextTrackReader;
     friend class MXFTextObject;
@@ -89,6 +91,12 @@ public:
 public:
     static std::string ResultToString(OpenResult result);
 
+    // Open the files in the calling thread using each reader's file factory and then parse the header metadata
+    // and index tables concurrently using up to num_threads threads. The file factories must support concurrent
+    // OpenRead calls if external files are referenced
+    static void OpenConcurrent(const std::vector<MXFFileReader*> &readers, const std::vector<std::string> &filenames,
+                               int mode_flags, uint32_t num_threads, std::vector<OpenResult> *results);
+
 public:
     MXFFileReader();
     virtual ~MXFFileReader();
@@ -100,6 +108,9 @@ public:
     virtual void SetFileIndex(MXFFileIndex *file_index, bool take_ownership);
     virtual void SetMCALabelIndex(MXFMCALabelIndex *label_index, bool take_ownership);
     void SetEnableIndexFile(bool enable);  // Default true
+    void SetUseHeaderMetadataArena(bool enable);  // Default false. Allocate header metadata from an arena
+    void SetLazyHeaderMetadata(bool enable);      // Default false. Read header metadata sets when first used
+    void SetEnableIndexCache(bool enable);        // Default false. Read and write a '<filename>.bmxidx' index cache
 
     OpenResult Open(std::string filename, int mode_flags=0);
     OpenResult Open(mxfpp::File *file, std::string filename, int mode_flags=0);
@@ -265,6 +276,9 @@ private:
     std::vector<MXFTextObject*> mInternalTextObjects;
 
     bool mEnableIndexFile;
+    bool mLazyHeaderMetadata;
+    bool mEnableIndexCache;
+    MXFIndexCache *mIndexCache;
     EssenceReader *mEssenceReader;
 
     uint32_t mRequireFrameInfoCount;
@@ -45,6 +45,10 @@ extern const char *SYSTEM_SCHEME_1_FMETA_ID;
 extern const char *SDTI_CP_SYSTEM_METADATA_FMETA_ID;
 extern const char *SDTI_CP_PACKAGE_METADATA_FMETA_ID;
 
+extern const FrameMetadataId SYSTEM_SCHEME_1_FMETA_NUM_ID;
+extern const FrameMetadataId SDTI_CP_SYSTEM_METADATA_FMETA_NUM_ID;
+extern const FrameMetadataId SDTI_CP_PACKAGE_METADATA_FMETA_NUM_ID;
+
 
 class SystemScheme1Metadata : public FrameMetadata
 {
@@ -109,6 +113,8 @@ public:
     SDTICPSystemMetadata();
     virtual ~SDTICPSystemMetadata();
 
+    void Reset();
+
     virtual FrameMetadata* Clone();
 
 public:
@@ -126,6 +132,8 @@ public:
     SDTICPPackageMetadata();
     virtual ~SDTICPPackageMetadata();
 
+    void Reset();
+
     virtual FrameMetadata* Clone();
 
 public:
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_MXF_INDEX_CACHE_H_
+#define BMX_MXF_INDEX_CACHE_H_
+
+
+#include <string>
+#include <vector>
+
+#include <libMXF++/MXF.h>
+
+#include <bmx/mxf_reader/EssenceChunkHelper.h>
+#include <bmx/mxf_reader/IndexTableHelper.h>
+
+
+
+namespace bmx
+{
+
+
+class MXFFileReader;
+
+
+// A sidecar file that stores the partition packs, essence container chunks and index table segments
+// extracted from a complete MXF file. The cache is only used when the MXF file size, modification time,
+// header partition pack and the Preface InstanceUID, GenerationUID and LastModifiedDate in the header
+// partition match those recorded in the cache.
+
+class MXFIndexCache
+{
+public:
+    MXFIndexCache(const std::string &cache_filename, int64_t file_size, int64_t modification_time);
+    ~MXFIndexCache();
+
+    bool Read(mxfpp::File *mxf_file);
+    bool RestorePartitions(mxfpp::File *mxf_file);
+    bool RestoreEssenceIndex(MXFFileReader *file_reader, EssenceChunkHelper *chunk_helper,
+                             IndexTableHelper *index_helper);
+
+    void Write(MXFFileReader *file_reader, const EssenceChunkHelper *chunk_helper,
+               const IndexTableHelper *index_helper);
+
+private:
+    void ReadPrefaceIdentity(mxfpp::File *mxf_file);
+    void ReadCache(mxfpp::File *cache_file, const mxfpp::Partition *header_partition);
+    void WriteCache(mxfpp::File *cache_file, MXFFileReader *file_reader, const EssenceChunkHelper *chunk_helper,
+                    const IndexTableHelper *index_helper);
+
+    void Clear();
+
+private:
+    std::string mCacheFilename;
+    int64_t mFileSize;
+    int64_t mModificationTime;
+    mxfUUID mPrefaceInstanceUID;
+    mxfUUID mPrefaceGenerationUID;
+    mxfTimestamp mPrefaceLastModifiedDate;
+
+    bool mHaveCache;
+    std::vector<mxfpp::Partition*> mPartitions;
+    uint32_t mBodySID;
+    uint32_t mIndexSID;
+    MXFEssenceWrappingType mWrappingType;
+
+    std::vector<EssenceChunk> mEssenceChunks;
+    size_t mNumIndexedPartitions;
+
+    bool mIndexIsComplete;
+    Rational mIndexEditRate;
+    uint32_t mIndexEditUnitSize;
+    int64_t mIndexDuration;
+    std::vector<IndexTableHelperSegment*> mIndexSegments;
+};
+
+
+};
+
+
+
+#endif
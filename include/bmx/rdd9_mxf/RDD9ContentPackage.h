@@ -39,6 +39,7 @@
 #include <libMXF++/MXF.h>
 
 #include <bmx/ByteArray.h>
+#include <bmx/MXFWriteBatch.h>
 #include <bmx/rdd9_mxf/RDD9IndexTable.h>
 
 
@@ -75,7 +76,7 @@ public:
 
     uint32_t GetElementSize(uint32_t data_size) const;
 
-    void Write(mxfpp::File *mxf_file, unsigned char *data, uint32_t size);
+    void Write(MXFWriteBatch *batch, const unsigned char *data, uint32_t size);
 
     uint32_t GetTrackIndex() const                         { return mTrackIndex; }
     ElementType GetElementType() const                     { return mElementType; }
@@ -113,7 +114,7 @@ public:
 
     uint32_t GetElementSize() const;
     uint32_t GetNumSamplesWritten() const { return mNumSamplesWritten; }
-    void Write();
+    void Write(MXFWriteBatch *batch);
 
     void Reset(int64_t new_position);
 
@@ -149,8 +150,8 @@ public:
 public:
     bool IsComplete();
     void UpdateIndexTable();
-    void Write();
-    void WriteSystemItem();
+    void Write(MXFWriteBatch *batch);
+    void WriteSystemItem(MXFWriteBatch *batch);
 
 private:
     mxfpp::File *mMXFFile;
@@ -221,6 +222,8 @@ private:
     std::deque<RDD9ContentPackage*> mContentPackages;
     std::vector<RDD9ContentPackage*> mFreeContentPackages;
     int64_t mPosition;
+
+    MXFWriteBatch mWriteBatch;
 };
 
 
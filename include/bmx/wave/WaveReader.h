@@ -118,6 +118,8 @@ private:
     int64_t mDataStartFilePosition;
     int64_t mPosition;
     ByteArray mReadBuffer;
+    std::vector<Frame*> mReadFrames;
+    std::vector<unsigned char*> mReadOutputs;
 
     std::vector<WaveFileChunk*> mChunks;
 };
@@ -65,6 +65,7 @@ public:
     uint32_t GetSampleSize() const;
     Rational GetSamplingRate() const;
     uint16_t GetChannelCount() const { return mChannelCount; }
+    uint32_t GetTrackIndex() const   { return mTrackIndex; }
 
     int64_t GetDuration() const;
 
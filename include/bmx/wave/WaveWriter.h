@@ -81,11 +81,15 @@ public:
 
     void PrepareWrite();
     void WriteSamples(uint32_t track_index, const unsigned char *data, uint32_t size, uint32_t num_samples);
+    // write num_samples for all tracks, with track_data[i] containing the samples for track i
+    // the samples are interleaved directly into the output block without buffering
+    void WriteSamples(const unsigned char * const *track_data, uint32_t num_samples);
     void CompleteWrite();
 
 public:
     Rational GetSamplingRate() const    { return mSamplingRate; }
     int64_t GetDuration() const         { return mSampleCount; }
+    bool HaveBufferedSamples() const    { return !mBufferSegments.empty(); }
 
     uint32_t GetNumTracks() const       { return (uint32_t)mTracks.size(); }
     WaveTrackWriter* GetTrack(uint32_t track_index);
@@ -96,6 +100,8 @@ private:
 
     void RemoveChunk(WaveChunkId id);
 
+    void ZeroUnwrittenSamples();
+
 private:
     WaveIO *mOutput;
     bool mOwnOutput;
@@ -127,7 +133,10 @@ private:
     } BufferSegment;
 
     std::deque<BufferSegment*> mBufferSegments;
+    std::vector<BufferSegment*> mFreeBufferSegments;
     uint32_t mBufferSize;
+    ByteArray mInterleaveBuffer;
+    std::vector<const unsigned char*> mInterleaveTrackData;
     int64_t mSampleCount;
 
     int64_t mJunkChunkFilePosition;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#include <bmx/apps/AppGrowingFileWatcher.h>
+#include <bmx/apps/AppUtils.h>
+#include <bmx/Utils.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define MIN_POLL_INTERVAL   1
+#define MAX_POLL_INTERVAL   32
+
+
+static int64_t stat_file_size(const string &filename)
+{
+    // unlike bmx::get_file_size this returns -1 rather than throwing if the file is not accessible
+#if defined(_WIN32)
+    struct _stati64 buf;
+    if (_stati64(filename.c_str(), &buf) != 0)
+        return -1;
+#else
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) != 0)
+        return -1;
+#endif
+
+    return buf.st_size;
+}
+
+
+
+AppGrowingFileWatcher::AppGrowingFileWatcher()
+{
+    mINotifyFD = -1;
+    mPollSizes = true;
+
+#if defined(__linux__)
+    mINotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mINotifyFD < 0)
+        log_warn("Failed to initialise inotify; falling back to polling the growing file size: %s\n",
+                 bmx_strerror(errno).c_str());
+    else
+        mPollSizes = false;
+#endif
+}
+
+AppGrowingFileWatcher::~AppGrowingFileWatcher()
+{
+#if defined(__linux__)
+    if (mINotifyFD >= 0)
+        close(mINotifyFD);
+#endif
+}
+
+bool AppGrowingFileWatcher::AddFile(const string &filename)
+{
+    WatchedFile file;
+    file.filename = filename;
+    file.size = stat_file_size(filename);
+    if (file.size < 0)
+        return false;
+
+#if defined(__linux__)
+    if (mINotifyFD >= 0 && inotify_add_watch(mINotifyFD, filename.c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+        log_warn("Failed to add inotify watch for '%s'; falling back to polling the file size: %s\n",
+                 filename.c_str(), bmx_strerror(errno).c_str());
+        mPollSizes = true;
+    }
+#endif
+
+    mFiles.push_back(file);
+    return true;
+}
+
+bool AppGrowingFileWatcher::WaitForGrowth(uint32_t timeout_msec)
+{
+    // the file could have grown between the failed read and this call
+    if (CheckGrowth())
+        return true;
+
+    uint32_t start_tick = get_tick_count();
+    uint32_t poll_interval = MIN_POLL_INTERVAL;
+    while (true) {
+        uint32_t elapsed = get_tick_count() - start_tick;
+        if (elapsed >= timeout_msec)
+            return false;
+        uint32_t remaining = timeout_msec - elapsed;
+
+#if defined(__linux__)
+        if (!mPollSizes) {
+            struct pollfd poll_fd;
+            poll_fd.fd      = mINotifyFD;
+            poll_fd.events  = POLLIN;
+            poll_fd.revents = 0;
+            int result = poll(&poll_fd, 1, (int)remaining);
+            if (result > 0) {
+                // drain the events; they are only used to trigger a size check
+                char buffer[4096];
+                while (read(mINotifyFD, buffer, sizeof(buffer)) > 0)
+                {}
+            } else if (result < 0 && errno != EINTR) {
+                log_warn("Failed to poll inotify events; falling back to polling the growing file size: %s\n",
+                         bmx_strerror(errno).c_str());
+                mPollSizes = true;
+            }
+        }
+        else
+#endif
+        {
+            sleep_msec(remaining < poll_interval ? remaining : poll_interval);
+            if (poll_interval < MAX_POLL_INTERVAL)
+                poll_interval *= 2;
+        }
+
+        if (CheckGrowth())
+            return true;
+    }
+}
+
+bool AppGrowingFileWatcher::CheckGrowth()
+{
+    bool grown = false;
+    size_t i;
+    for (i = 0; i < mFiles.size(); i++) {
+        int64_t size = stat_file_size(mFiles[i].filename);
+        if (size > mFiles[i].size) {
+            mFiles[i].size = size;
+            grown = true;
+        }
+    }
+
+    return grown;
+}
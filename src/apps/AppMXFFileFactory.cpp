@@ -55,9 +55,13 @@ AppMXFFileFactory::AppMXFFileFactory()
     mRWInterleaver = 0;
     mHTTPMinReadSize = 1024 * 1024;
     mHTTPEnableSeek = true;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     mUseMMapFile = false;
 #endif
+#if !defined(_WIN32)
+    mUsePReadFile = false;
+    mReadAheadSize = 0;
+#endif
 }
 
 AppMXFFileFactory::~AppMXFFileFactory()
@@ -104,13 +108,25 @@ void AppMXFFileFactory::SetHTTPEnableSeek(bool enable)
     mHTTPEnableSeek = enable;
 }
 
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
 void AppMXFFileFactory::SetUseMMapFile(bool enable)
 {
     mUseMMapFile = enable;
 }
 #endif
 
+#if !defined(_WIN32)
+void AppMXFFileFactory::SetUsePReadFile(bool enable)
+{
+    mUsePReadFile = enable;
+}
+
+void AppMXFFileFactory::SetReadAheadSize(uint32_t size)
+{
+    mReadAheadSize = size;
+}
+#endif
+
 File* AppMXFFileFactory::OpenNew(string filename)
 {
     MXFFile *mxf_file = 0;
@@ -128,7 +144,11 @@ File* AppMXFFileFactory::OpenNew(string filename)
 #endif
             BMX_CHECK(mxf_win32_file_open_new(filename.c_str(), 0, &mxf_file));
 #else
-        BMX_CHECK(mxf_disk_file_open_new(filename.c_str(), &mxf_file));
+        // new files are not memory-mapped because the mapping would have to grow with the file
+        if (mUsePReadFile || mUseMMapFile)
+            BMX_CHECK(mxf_posix_file_open_new(filename.c_str(), 0, &mxf_file));
+        else
+            BMX_CHECK(mxf_disk_file_open_new(filename.c_str(), &mxf_file));
 #endif
 
         if (mRWInterleaver) {
@@ -148,6 +168,8 @@ File* AppMXFFileFactory::OpenNew(string filename)
 
 File* AppMXFFileFactory::OpenRead(string filename)
 {
+    lock_guard<mutex> lock(mOpenReadMutex);
+
     MXFFile *mxf_file = 0;
 
     try
@@ -169,7 +191,12 @@ File* AppMXFFileFactory::OpenRead(string filename)
 #endif
                     BMX_CHECK(mxf_win32_file_open_read(filename.c_str(), mInputFlags, &mxf_file));
 #else
-                BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
+                if (mUseMMapFile)
+                    BMX_CHECK(mxf_posix_mmap_open_read(filename.c_str(), mInputFlags, &mxf_file));
+                else if (mUsePReadFile)
+                    BMX_CHECK(mxf_posix_file_open_read(filename.c_str(), mInputFlags, mReadAheadSize, &mxf_file));
+                else
+                    BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
 #endif
             }
         }
@@ -191,12 +218,13 @@ File* AppMXFFileFactory::OpenRead(string filename)
             input_checksum_file.filename = filename;
             input_checksum_file.abs_uri = abs_uri;
 
-            set<ChecksumType>::const_iterator types_iter;
-            for (types_iter = mInputChecksumTypes.begin(); types_iter != mInputChecksumTypes.end(); types_iter++) {
-                MXFChecksumFile *checksum_file = mxf_checksum_file_open(mxf_file, *types_iter);
-                input_checksum_file.checksum_files.push_back(make_pair(*types_iter, checksum_file));
-                mxf_file = mxf_checksum_file_get_file(checksum_file);
-            }
+            // a single checksum file calculates all the checksum types concurrently
+            vector<ChecksumType> checksum_types(mInputChecksumTypes.begin(), mInputChecksumTypes.end());
+            MXFChecksumFile *checksum_file = mxf_checksum_file_open(mxf_file, checksum_types);
+            size_t i;
+            for (i = 0; i < checksum_types.size(); i++)
+                input_checksum_file.checksum_files.push_back(make_pair(checksum_types[i], checksum_file));
+            mxf_file = mxf_checksum_file_get_file(checksum_file);
 
             mInputChecksumFiles.push_back(input_checksum_file);
         }
@@ -233,7 +261,12 @@ File* AppMXFFileFactory::OpenModify(string filename)
 #endif
             BMX_CHECK(mxf_win32_file_open_modify(filename.c_str(), 0, &mxf_file));
 #else
-        BMX_CHECK(mxf_disk_file_open_modify(filename.c_str(), &mxf_file));
+        if (mUseMMapFile)
+            BMX_CHECK(mxf_posix_mmap_open_modify(filename.c_str(), 0, &mxf_file));
+        else if (mUsePReadFile)
+            BMX_CHECK(mxf_posix_file_open_modify(filename.c_str(), 0, &mxf_file));
+        else
+            BMX_CHECK(mxf_disk_file_open_modify(filename.c_str(), &mxf_file));
 #endif
 
         if (mRWInterleaver) {
@@ -292,18 +325,18 @@ vector<ChecksumType> AppMXFFileFactory::GetInputChecksumTypes(size_t file_index)
 
 size_t AppMXFFileFactory::GetInputChecksumDigestSize(size_t file_index, ChecksumType type) const
 {
-    return mxf_checksum_file_digest_size(GetChecksumFile(file_index, type));
+    return mxf_checksum_file_digest_size(GetChecksumFile(file_index, type), type);
 }
 
 void AppMXFFileFactory::GetInputChecksumDigest(size_t file_index, ChecksumType type, unsigned char *digest,
                                                size_t size) const
 {
-    return mxf_checksum_file_digest(GetChecksumFile(file_index, type), digest, size);
+    return mxf_checksum_file_digest(GetChecksumFile(file_index, type), type, digest, size);
 }
 
 string AppMXFFileFactory::GetInputChecksumDigestString(size_t file_index, ChecksumType type) const
 {
-    return mxf_checksum_file_digest_str(GetChecksumFile(file_index, type));
+    return mxf_checksum_file_digest_str(GetChecksumFile(file_index, type), type);
 }
 
 MXFChecksumFile* AppMXFFileFactory::GetChecksumFile(size_t file_index, ChecksumType type) const
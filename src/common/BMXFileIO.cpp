@@ -33,9 +33,14 @@
 #include "config.h"
 #endif
 
+#define __STDC_LIMIT_MACROS
+
 #include <errno.h>
 #include <string.h>
 #include <sys/types.h>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
 
 #include <bmx/BMXFileIO.h>
 #include <bmx/Utils.h>
@@ -65,15 +70,31 @@ BMXFileIO* BMXFileIO::OpenNew(const string &filename)
     return new BMXFileIO(file, false);
 }
 
+BMXFileIO* BMXFileIO::OpenTemp()
+{
+    // the file is removed when it is closed
+    FILE *file = tmpfile();
+    if (!file)
+        BMX_EXCEPTION(("Failed to open temporary file: %s", bmx_strerror(errno).c_str()));
+
+    return new BMXFileIO(file, false);
+}
+
 BMXFileIO::BMXFileIO(FILE *file, bool read_only)
 : BMXIO()
 {
     mFile = file;
     mReadOnly = read_only;
+    mMapData = 0;
+    mMapSize = 0;
 }
 
 BMXFileIO::~BMXFileIO()
 {
+#if !defined(_WIN32)
+    if (mMapData)
+        munmap(mMapData, (size_t)mMapSize);
+#endif
     if (mFile)
         fclose(mFile);
 }
@@ -129,3 +150,37 @@ int64_t BMXFileIO::Size()
         return -1;
     }
 }
+
+const unsigned char* BMXFileIO::MapData(int64_t offset, uint32_t size)
+{
+    if (!mMapData || offset < 0 || offset + size > mMapSize)
+        return 0;
+
+    return &mMapData[offset];
+}
+
+bool BMXFileIO::MapFile()
+{
+    BMX_CHECK(mReadOnly);
+    if (mMapData)
+        return true;
+
+#if defined(_WIN32)
+    return false;
+#else
+    int64_t size = Size();
+    if (size <= 0 || (uint64_t)size > SIZE_MAX)
+        return false;
+
+    void *map_data = mmap(0, (size_t)size, PROT_READ, MAP_SHARED, fileno(mFile), 0);
+    if (map_data == MAP_FAILED) {
+        log_warn("Failed to map file: %s\n", bmx_strerror(errno).c_str());
+        return false;
+    }
+    madvise(map_data, (size_t)size, MADV_SEQUENTIAL);
+
+    mMapData = (unsigned char*)map_data;
+    mMapSize = size;
+    return true;
+#endif
+}
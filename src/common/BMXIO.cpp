@@ -171,3 +171,10 @@ int64_t BMXIO::Size()
     BMX_ASSERT(false);
     return 0;
 }
+
+const unsigned char* BMXIO::MapData(int64_t offset, uint32_t size)
+{
+    (void)offset;
+    (void)size;
+    return 0;
+}
@@ -137,13 +137,11 @@ bool GetBitBuffer::GetBits(uint8_t num_bits, uint32_t *value)
 
 bool GetBitBuffer::GetBits(uint8_t num_bits, uint64_t *value)
 {
-    if (num_bits > mBitSize - mBitPos)
+    if (!PeekBits(num_bits, value))
         return false;
 
-    if (num_bits > 0)
-        GetBits(mData, &mPos, &mBitPos, num_bits, value);
-    else
-        *value = 0;
+    mBitPos += num_bits;
+    mPos = (uint32_t)(mBitPos >> 3);
 
     return true;
 }
@@ -190,6 +188,36 @@ bool GetBitBuffer::GetBits(uint8_t num_bits, int64_t *value)
     return true;
 }
 
+bool GetBitBuffer::PeekBits(uint8_t num_bits, uint64_t *value) const
+{
+    BMX_ASSERT(num_bits <= 64);
+
+    if (num_bits > mBitSize - mBitPos)
+        return false;
+
+    if (num_bits == 0) {
+        *value = 0;
+        return true;
+    }
+
+    // load a 64-bit big-endian word if the bits are contained in it, else fall back to loading a byte at a time
+    uint8_t bit_offset = (uint8_t)(mBitPos & 0x07);
+    if (bit_offset + num_bits <= 64 && mSize - mPos >= 8) {
+        const unsigned char *bytes = &mData[mPos];
+        uint64_t word = ((uint64_t)bytes[0] << 56) | ((uint64_t)bytes[1] << 48) |
+                        ((uint64_t)bytes[2] << 40) | ((uint64_t)bytes[3] << 32) |
+                        ((uint64_t)bytes[4] << 24) | ((uint64_t)bytes[5] << 16) |
+                        ((uint64_t)bytes[6] <<  8) |  (uint64_t)bytes[7];
+        *value = (word << bit_offset) >> (64 - num_bits);
+    } else {
+        uint32_t pos = mPos;
+        uint64_t bit_pos = mBitPos;
+        GetBits(mData, &pos, &bit_pos, num_bits, value);
+    }
+
+    return true;
+}
+
 void GetBitBuffer::SetPos(uint32_t pos)
 {
     mPos = pos;
@@ -203,7 +231,7 @@ void GetBitBuffer::SetBitPos(uint64_t bit_pos)
 }
 
 void GetBitBuffer::GetBits(const unsigned char *data, uint32_t *pos_io, uint64_t *bit_pos_io, uint8_t num_bits,
-                           uint64_t *value)
+                           uint64_t *value) const
 {
     BMX_ASSERT(num_bits > 0 || num_bits <= 64);
 
@@ -33,7 +33,12 @@
 #include "config.h"
 #endif
 
+#include <cstdlib>
 #include <cstring>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
 
 #include <bmx/ByteArray.h>
 #include <bmx/BMXException.h>
@@ -51,6 +56,7 @@ ByteArray::ByteArray()
     mIsCopy = false;
     mAllocatedSize = 0;
     mAllocBlockSize = 256;
+    mAlignment = 0;
 }
 
 ByteArray::ByteArray(uint32_t size)
@@ -60,6 +66,7 @@ ByteArray::ByteArray(uint32_t size)
     mIsCopy = false;
     mAllocatedSize = 0;
     mAllocBlockSize = 256;
+    mAlignment = 0;
 
     Allocate(size);
 }
@@ -71,6 +78,7 @@ ByteArray::ByteArray(const ByteArray &from)
     mIsCopy         = false;
     mAllocatedSize  = 0;
     mAllocBlockSize = 256;
+    mAlignment      = from.mAlignment;
 
     if (from.mBytes)
         CopyBytes(from.mBytes, from.mSize);
@@ -79,7 +87,7 @@ ByteArray::ByteArray(const ByteArray &from)
 ByteArray::~ByteArray()
 {
     if (!mIsCopy)
-        delete [] mBytes;
+        FreeBytes(mBytes);
 }
 
 void ByteArray::SetAllocBlockSize(uint32_t block_size)
@@ -88,6 +96,13 @@ void ByteArray::SetAllocBlockSize(uint32_t block_size)
     mAllocBlockSize = block_size;
 }
 
+void ByteArray::SetAlignment(uint32_t alignment)
+{
+    BMX_CHECK(alignment == 0 || ((alignment & (alignment - 1)) == 0 && alignment % sizeof(void*) == 0));
+    BMX_CHECK(!mBytes);
+    mAlignment = alignment;
+}
+
 unsigned char* ByteArray::GetBytes() const
 {
     return mBytes;
@@ -101,6 +116,8 @@ uint32_t ByteArray::GetSize() const
 
 void ByteArray::TakeBytes()
 {
+    BMX_ASSERT(mAlignment == 0);
+
     mBytes = 0;
     mSize = 0;
     mIsCopy = false;
@@ -184,12 +201,12 @@ void ByteArray::Allocate(uint32_t min_size)
 
     uint32_t size = ((min_size / mAllocBlockSize) + 1) * mAllocBlockSize;
 
-    delete [] mBytes;
+    FreeBytes(mBytes);
     mBytes = 0;
     mSize = 0;
     mAllocatedSize = 0;
 
-    mBytes = new unsigned char[size];
+    mBytes = AllocBytes(size);
     memset(mBytes, 0, size);
     mAllocatedSize = size;
 }
@@ -202,16 +219,16 @@ void ByteArray::Reallocate(uint32_t min_size)
         return;
 
     if (mSize == 0) {
-        delete [] mBytes;
+        FreeBytes(mBytes);
         mBytes = 0;
     }
 
     uint32_t size = ((min_size / mAllocBlockSize) + 1) * mAllocBlockSize;
 
-    unsigned char *newBytes = new unsigned char[size];
+    unsigned char *newBytes = AllocBytes(size);
     if (mSize > 0) {
         memcpy(newBytes, mBytes, mSize);
-        delete [] mBytes;
+        FreeBytes(mBytes);
         mBytes = 0;
     }
     memset(&newBytes[mSize], 0, size - mSize);
@@ -235,10 +252,40 @@ void ByteArray::Clear()
         mAllocatedSize = 0;
         mIsCopy = false;
     } else {
-        delete [] mBytes;
+        FreeBytes(mBytes);
         mBytes = 0;
         mSize = 0;
         mAllocatedSize = 0;
     }
 }
 
+unsigned char* ByteArray::AllocBytes(uint32_t size)
+{
+    if (mAlignment == 0)
+        return new unsigned char[size];
+
+    void *bytes;
+#if defined(_WIN32)
+    bytes = _aligned_malloc(size, mAlignment);
+    if (!bytes)
+        throw std::bad_alloc();
+#else
+    if (posix_memalign(&bytes, mAlignment, size) != 0)
+        throw std::bad_alloc();
+#endif
+
+    return (unsigned char*)bytes;
+}
+
+void ByteArray::FreeBytes(unsigned char *bytes)
+{
+    if (mAlignment == 0) {
+        delete [] bytes;
+    } else {
+#if defined(_WIN32)
+        _aligned_free(bytes);
+#else
+        free(bytes);
+#endif
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+#include <bmx/BMXTypes.h>
+#include <bmx/CPUFeatures.h>
+
+using namespace bmx;
+
+
+#define SSE2_FEATURE    0x01
+#define SSSE3_FEATURE   0x02
+#define SSE41_FEATURE   0x04
+#define PCLMUL_FEATURE  0x08
+#define AVX2_FEATURE    0x10
+#define SHA_FEATURE     0x20
+
+
+static bool g_features_disabled = false;
+
+
+#if defined(BMX_HAVE_X86_SIMD)
+
+static void get_cpuid(uint32_t leaf, uint32_t sub_leaf, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, (int)leaf, (int)sub_leaf);
+    regs[0] = (uint32_t)info[0];
+    regs[1] = (uint32_t)info[1];
+    regs[2] = (uint32_t)info[2];
+    regs[3] = (uint32_t)info[3];
+#else
+    __cpuid_count(leaf, sub_leaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64_t get_xcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+static int detect_features()
+{
+    uint32_t regs[4];
+    int features = SSE2_FEATURE;
+
+    get_cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+    if (max_leaf < 1)
+        return features;
+
+    get_cpuid(1, 0, regs);
+    if (regs[2] & (1 << 9))
+        features |= SSSE3_FEATURE;
+    if (regs[2] & (1 << 19))
+        features |= SSE41_FEATURE;
+    if (regs[2] & (1 << 1))
+        features |= PCLMUL_FEATURE;
+
+    // AVX2 requires the OS to save the YMM registers
+    bool os_ymm_support = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (get_xcr0() & 0x6) == 0x6;
+    if (max_leaf >= 7) {
+        get_cpuid(7, 0, regs);
+        if (os_ymm_support && (regs[1] & (1 << 5)))
+            features |= AVX2_FEATURE;
+        if (regs[1] & (1 << 29))
+            features |= SHA_FEATURE;
+    }
+
+    return features;
+}
+
+#else
+
+static int detect_features()
+{
+    return 0;
+}
+
+#endif
+
+static bool have_feature(int feature)
+{
+    static const int features = detect_features();
+
+    return !g_features_disabled && (features & feature);
+}
+
+
+
+bool bmx::cpu_has_sse2()
+{
+    return have_feature(SSE2_FEATURE);
+}
+
+bool bmx::cpu_has_ssse3()
+{
+    return have_feature(SSSE3_FEATURE);
+}
+
+bool bmx::cpu_has_sse41()
+{
+    return have_feature(SSE41_FEATURE);
+}
+
+bool bmx::cpu_has_pclmul()
+{
+    return have_feature(PCLMUL_FEATURE);
+}
+
+bool bmx::cpu_has_avx2()
+{
+    return have_feature(AVX2_FEATURE);
+}
+
+bool bmx::cpu_has_sha()
+{
+    return have_feature(SHA_FEATURE);
+}
+
+void bmx::disable_cpu_features(bool disable)
+{
+    g_features_disabled = disable;
+}
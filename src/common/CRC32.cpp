@@ -38,11 +38,21 @@
 #include <cerrno>
 
 #include <bmx/CRC32.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+#if defined(BMX_HAVE_X86_SIMD)
+#include <immintrin.h>
+#endif
+
 using namespace std;
+using namespace bmx;
+
+
+#define SLICE_COUNT         16
+#define PCLMUL_MIN_SIZE     64
 
 
 
@@ -113,6 +123,157 @@ static const uint32_t CRC32_TABLE[256] =
 };
 
 
+/*
+The slicing-by-16 tables extend CRC32_TABLE so that 16 bytes are processed per iteration:
+table[k][n] is the CRC of byte n followed by k zero bytes.
+*/
+
+typedef struct
+{
+    uint32_t table[SLICE_COUNT][256];
+} SliceTables;
+
+static SliceTables* create_slice_tables()
+{
+    SliceTables *tables = new SliceTables;
+
+    int k, n;
+    for (n = 0; n < 256; n++)
+        tables->table[0][n] = CRC32_TABLE[n];
+    for (k = 1; k < SLICE_COUNT; k++) {
+        for (n = 0; n < 256; n++)
+            tables->table[k][n] = (tables->table[k - 1][n] >> 8) ^ CRC32_TABLE[tables->table[k - 1][n] & 0xff];
+    }
+
+    return tables;
+}
+
+static inline uint32_t get_uint32_le(const unsigned char *data)
+{
+    return  (uint32_t)data[0]        |
+           ((uint32_t)data[1] << 8)  |
+           ((uint32_t)data[2] << 16) |
+           ((uint32_t)data[3] << 24);
+}
+
+static uint32_t crc32_update_table(uint32_t crc, const unsigned char *data, size_t size)
+{
+    size_t i;
+    for (i = 0; i < size; i++)
+        crc = CRC32_TABLE[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+
+    return crc;
+}
+
+static uint32_t crc32_update_slice16(uint32_t crc, const unsigned char *data, size_t size)
+{
+    static const SliceTables *tables = create_slice_tables();
+    const uint32_t (*t)[256] = tables->table;
+
+    while (size >= 16) {
+        uint32_t w0 = get_uint32_le(data) ^ crc;
+        uint32_t w1 = get_uint32_le(data + 4);
+        uint32_t w2 = get_uint32_le(data + 8);
+        uint32_t w3 = get_uint32_le(data + 12);
+        crc = t[15][ w0        & 0xff] ^ t[14][(w0 >> 8) & 0xff] ^ t[13][(w0 >> 16) & 0xff] ^ t[12][w0 >> 24] ^
+              t[11][ w1        & 0xff] ^ t[10][(w1 >> 8) & 0xff] ^ t[ 9][(w1 >> 16) & 0xff] ^ t[ 8][w1 >> 24] ^
+              t[ 7][ w2        & 0xff] ^ t[ 6][(w2 >> 8) & 0xff] ^ t[ 5][(w2 >> 16) & 0xff] ^ t[ 4][w2 >> 24] ^
+              t[ 3][ w3        & 0xff] ^ t[ 2][(w3 >> 8) & 0xff] ^ t[ 1][(w3 >> 16) & 0xff] ^ t[ 0][w3 >> 24];
+        data += 16;
+        size -= 16;
+    }
+
+    return crc32_update_table(crc, data, size);
+}
+
+
+#if defined(BMX_HAVE_X86_SIMD)
+
+/*
+Carry-less multiplication folding as described in "Fast CRC Computation for Generic Polynomials
+Using PCLMULQDQ Instruction" (Intel, 2009). The constants are the bit-reflected fold constants
+(x^(4*128+32) mod P, x^(4*128-32) mod P, etc.) and Barrett reduction constants for the
+CRC-32 polynomial 0x04c11db7.
+*/
+
+BMX_TARGET_ISA("sse4.1,pclmul")
+static uint32_t crc32_update_pclmul(uint32_t crc, const unsigned char *data, size_t size)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000LL, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(-1, 0, -1, 0);
+    __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+    // fold 4 x 128-bit blocks in parallel
+    x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(data     )), _mm_cvtsi32_si128((int)crc));
+    x2 = _mm_loadu_si128((const __m128i*)(data + 16));
+    x3 = _mm_loadu_si128((const __m128i*)(data + 32));
+    x4 = _mm_loadu_si128((const __m128i*)(data + 48));
+    data += 64;
+    size -= 64;
+
+    while (size >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data     )));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 16)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 32)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 48)));
+        data += 64;
+        size -= 64;
+    }
+
+    // fold the 4 blocks into 1
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // fold remaining whole 128-bit blocks
+    while (size >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data)), x5);
+        data += 16;
+        size -= 16;
+    }
+
+    // fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    crc = (uint32_t)_mm_extract_epi32(x1, 1);
+
+    return crc32_update_slice16(crc, data, size);
+}
+
+#endif
+
+
+
 void bmx::crc32_init(uint32_t *crc32)
 {
     *crc32 = 0xffffffffL;
@@ -120,9 +281,14 @@ void bmx::crc32_init(uint32_t *crc32)
 
 void bmx::crc32_update(uint32_t *crc32, const unsigned char *data, size_t size)
 {
-    size_t i;
-    for (i = 0; i < size; i++)
-        *crc32 = CRC32_TABLE[((*crc32) ^ data[i]) & 0xff] ^ ((*crc32) >> 8);
+#if defined(BMX_HAVE_X86_SIMD)
+    if (size >= PCLMUL_MIN_SIZE && cpu_has_pclmul() && cpu_has_sse41()) {
+        *crc32 = crc32_update_pclmul(*crc32, data, size);
+        return;
+    }
+#endif
+
+    *crc32 = crc32_update_slice16(*crc32, data, size);
 }
 
 void bmx::crc32_final(uint32_t *crc32)
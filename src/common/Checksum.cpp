@@ -89,34 +89,27 @@ vector<string> Checksum::CalcFileChecksums(const string &filename, const vector<
 
 vector<string> Checksum::CalcFileChecksums(FILE *file, const vector<ChecksumType> &types)
 {
-    vector<Checksum> checksums;
-    size_t i;
-    for (i = 0; i < types.size(); i++)
-        checksums.push_back(Checksum(types[i]));
+    ChecksumEngine engine(types);
 
-    const size_t buffer_size = 8192;
-    unsigned char *buffer = new unsigned char[buffer_size];
-    size_t num_read = buffer_size;
+    // the file is read directly into the engine's buffers
+    uint32_t buffer_size = 0;
+    size_t num_read = 0;
     while (num_read == buffer_size) {
+        unsigned char *buffer = engine.GetBuffer(&buffer_size);
         num_read = fread(buffer, 1, buffer_size, file);
         if (num_read != buffer_size && ferror(file)) {
             log_warn("Read failure when calculating checksum: %s\n", bmx_strerror(errno).c_str());
-            delete [] buffer;
             return vector<string>();
         }
 
-        if (num_read > 0) {
-            for (i = 0; i < checksums.size(); i++)
-                checksums[i].Update(buffer, (uint32_t)num_read);
-        }
+        engine.CommitBuffer((uint32_t)num_read);
     }
-    delete [] buffer;
+    engine.Final();
 
     vector<string> result;
-    for (i = 0; i < checksums.size(); i++) {
-        checksums[i].Final();
-        result.push_back(checksums[i].GetDigestString());
-    }
+    size_t i;
+    for (i = 0; i < engine.GetNumChecksums(); i++)
+        result.push_back(engine.GetChecksum(i).GetDigestString());
 
     return result;
 }
@@ -216,3 +209,219 @@ string Checksum::GetDigestString() const
     }
 }
 
+
+
+
+ChecksumEngine::ChecksumEngine(const vector<ChecksumType> &types, uint32_t buffer_size)
+{
+    BMX_CHECK(!types.empty());
+    BMX_CHECK(buffer_size > 0);
+
+    mBufferSize = buffer_size;
+    mCurrentBuffer = 0;
+    mSubmitCount = 0;
+    mStop = false;
+    mFinal = false;
+
+    size_t i;
+    for (i = 0; i < BMX_ARRAY_SIZE(mBuffers); i++) {
+        mBuffers[i].alloc_data = 0;
+        mBuffers[i].data = 0;
+        mBuffers[i].size = 0;
+        mBuffers[i].pending_count = 0;
+    }
+
+    for (i = 0; i < types.size(); i++)
+        mChecksums.push_back(Checksum(types[i]));
+
+    // a single checksum is updated in the caller's thread
+    if (mChecksums.size() == 1)
+        return;
+
+    try
+    {
+        for (i = 0; i < BMX_ARRAY_SIZE(mBuffers); i++)
+            AllocateBuffer(&mBuffers[i]);
+
+        for (i = 0; i < mChecksums.size(); i++)
+            mWorkers.push_back(thread(&ChecksumEngine::ProcessBuffers, this, i));
+    }
+    catch (...)
+    {
+        StopWorkers();
+        for (i = 0; i < BMX_ARRAY_SIZE(mBuffers); i++)
+            delete [] mBuffers[i].alloc_data;
+        throw;
+    }
+}
+
+ChecksumEngine::~ChecksumEngine()
+{
+    StopWorkers();
+
+    size_t i;
+    for (i = 0; i < BMX_ARRAY_SIZE(mBuffers); i++)
+        delete [] mBuffers[i].alloc_data;
+}
+
+unsigned char* ChecksumEngine::GetBuffer(uint32_t *size)
+{
+    BMX_CHECK(!mFinal);
+
+    Buffer &buffer = mBuffers[mCurrentBuffer];
+    if (!buffer.alloc_data)
+        AllocateBuffer(&buffer);
+    *size = mBufferSize - buffer.size;
+
+    return &buffer.data[buffer.size];
+}
+
+void ChecksumEngine::CommitBuffer(uint32_t size)
+{
+    Buffer &buffer = mBuffers[mCurrentBuffer];
+    BMX_CHECK(!mFinal);
+    BMX_CHECK(size <= mBufferSize - buffer.size);
+
+    if (mWorkers.empty()) {
+        mChecksums[0].Update(buffer.data, size);
+        return;
+    }
+
+    buffer.size += size;
+    if (buffer.size == mBufferSize)
+        SubmitBuffer();
+}
+
+void ChecksumEngine::Update(const unsigned char *data, uint32_t size)
+{
+    BMX_CHECK(!mFinal);
+
+    if (mWorkers.empty()) {
+        mChecksums[0].Update(data, size);
+        return;
+    }
+
+    uint32_t remaining = size;
+    while (remaining > 0) {
+        uint32_t buffer_size;
+        unsigned char *buffer = GetBuffer(&buffer_size);
+        if (buffer_size > remaining)
+            buffer_size = remaining;
+        memcpy(buffer, &data[size - remaining], buffer_size);
+        CommitBuffer(buffer_size);
+        remaining -= buffer_size;
+    }
+}
+
+void ChecksumEngine::Final()
+{
+    if (mFinal)
+        return;
+
+    if (!mWorkers.empty()) {
+        if (mBuffers[mCurrentBuffer].size > 0)
+            SubmitBuffer();
+        WaitForWorkers();
+        StopWorkers();
+    }
+
+    size_t i;
+    for (i = 0; i < mChecksums.size(); i++)
+        mChecksums[i].Final();
+
+    mFinal = true;
+}
+
+const Checksum& ChecksumEngine::GetChecksum(size_t index) const
+{
+    BMX_ASSERT(mFinal);
+    BMX_ASSERT(index < mChecksums.size());
+
+    return mChecksums[index];
+}
+
+const Checksum& ChecksumEngine::GetChecksum(ChecksumType type) const
+{
+    BMX_ASSERT(mFinal);
+
+    size_t i;
+    for (i = 0; i < mChecksums.size(); i++) {
+        if (mChecksums[i].GetType() == type)
+            return mChecksums[i];
+    }
+
+    BMX_EXCEPTION(("Checksum type %d was not calculated", type));
+}
+
+void ChecksumEngine::AllocateBuffer(Buffer *buffer)
+{
+    // align the buffer data to a cache line
+    buffer->alloc_data = new unsigned char[mBufferSize + 64];
+    buffer->data = buffer->alloc_data + ((64 - ((uintptr_t)buffer->alloc_data & 63)) & 63);
+}
+
+void ChecksumEngine::SubmitBuffer()
+{
+    unique_lock<mutex> lock(mMutex);
+
+    mBuffers[mCurrentBuffer].pending_count = mWorkers.size();
+    mSubmitCount++;
+    mCondition.notify_all();
+
+    // wait for the workers to complete the other buffer before it is filled
+    mCurrentBuffer = (mCurrentBuffer + 1) % BMX_ARRAY_SIZE(mBuffers);
+    while (mBuffers[mCurrentBuffer].pending_count > 0)
+        mCondition.wait(lock);
+    mBuffers[mCurrentBuffer].size = 0;
+}
+
+void ChecksumEngine::WaitForWorkers()
+{
+    unique_lock<mutex> lock(mMutex);
+
+    size_t i;
+    for (i = 0; i < BMX_ARRAY_SIZE(mBuffers); i++) {
+        while (mBuffers[i].pending_count > 0)
+            mCondition.wait(lock);
+    }
+}
+
+void ChecksumEngine::StopWorkers()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+        mCondition.notify_all();
+    }
+
+    size_t i;
+    for (i = 0; i < mWorkers.size(); i++) {
+        if (mWorkers[i].joinable())
+            mWorkers[i].join();
+    }
+}
+
+void ChecksumEngine::ProcessBuffers(size_t checksum_index)
+{
+    uint64_t processed_count = 0;
+
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && processed_count == mSubmitCount)
+            mCondition.wait(lock);
+        if (processed_count == mSubmitCount)
+            break;
+
+        // buffers are submitted in alternating order
+        Buffer &buffer = mBuffers[processed_count % BMX_ARRAY_SIZE(mBuffers)];
+        lock.unlock();
+
+        mChecksums[checksum_index].Update(buffer.data, buffer.size);
+
+        lock.lock();
+        processed_count++;
+        buffer.pending_count--;
+        if (buffer.pending_count == 0)
+            mCondition.notify_all();
+    }
+}
@@ -65,52 +65,31 @@ using namespace std;
 
 
 
-/*  The following tests optimise behaviour on little-endian
-    machines, where there is no need to reverse the byte order
-    of 32 bit words in the MD5 computation.  By default,
-    HIGHFIRST is defined, which indicates we're running on a
-    big-endian (most significant byte first) machine, on which
-    the byteReverse function in md5.c must be invoked. However,
-    byteReverse is coded in such a way that it is an identity
-    function when run on a little-endian machine, so calling it
-    on such a platform causes no harm apart from wasting time.
-    If the platform is known to be little-endian, we speed
-    things up by undefining HIGHFIRST, which defines
-    byteReverse as a null macro.  Doing things in this manner
-    insures we work on new platforms regardless of their byte
-    order.  */
-
-#define HIGHFIRST
-
-#ifndef WORDS_BIGENDIAN
-#undef HIGHFIRST
-#endif
+/* Words are read and written in little-endian byte order, independent of the host byte order */
 
+static inline uint32_t get_uint32_le(const unsigned char *data)
+{
+    return  (uint32_t)data[0]        |
+           ((uint32_t)data[1] << 8)  |
+           ((uint32_t)data[2] << 16) |
+           ((uint32_t)data[3] << 24);
+}
 
-#ifndef HIGHFIRST
-#define byte_reverse(buf, len)   /* Nothing */
-#else
-/*
- * Note: this code is harmless on little-endian machines.
- */
-static void byte_reverse(unsigned char *buf, unsigned longs)
+static inline void put_uint32_le(unsigned char *data, uint32_t value)
 {
-    uint32_t t;
-    do {
-        t = (uint32_t) ((unsigned) buf[3] << 8 | buf[2]) << 16 |
-            ((unsigned) buf[1] << 8 | buf[0]);
-        *(uint32_t *) buf = t;
-        buf += 4;
-    } while (--longs);
+    data[0] = (unsigned char)(value      );
+    data[1] = (unsigned char)(value >> 8 );
+    data[2] = (unsigned char)(value >> 16);
+    data[3] = (unsigned char)(value >> 24);
 }
-#endif
 
 
-/* The four core functions - F1 is optimized somewhat */
+/* The four core functions - F1 and F2 are optimized somewhat */
 
 /* #define F1(x, y, z) (x & y | ~x & z) */
 #define F1(x, y, z) (z ^ (x & (y ^ z)))
-#define F2(x, y, z) F1(z, x, y)
+/* #define F2(x, y, z) (x & z | y & ~z). The 2 terms have no bits in common and so can be added */
+#define F2(x, y, z) ((x & z) + (y & ~z))
 #define F3(x, y, z) (x ^ y ^ z)
 #define F4(x, y, z) (y ^ (x | ~z))
 
@@ -121,90 +100,111 @@ static void byte_reverse(unsigned char *buf, unsigned longs)
 
 /*
  * The core of the MD5 algorithm, this alters an existing MD5 hash to
- * reflect the addition of 16 longwords of new data.  MD5Update blocks
- * the data and converts bytes into longwords for this routine.
+ * reflect the addition of 16 longwords of new data for each of the 64-byte
+ * blocks. The state is kept in registers from one block to the next, and
+ * md5_update passes whole blocks directly from the input data.
  */
-static void md5_transform(uint32_t buf[4], uint32_t in[16])
+static void md5_transform(uint32_t buf[4], const unsigned char *data, size_t block_count)
 {
     uint32_t a, b, c, d;
+    uint32_t x[16];
+    int i;
 
     a = buf[0];
     b = buf[1];
     c = buf[2];
     d = buf[3];
 
-    MD5STEP(F1, a, b, c, d, in[0] + 0xd76aa478, 7);
-    MD5STEP(F1, d, a, b, c, in[1] + 0xe8c7b756, 12);
-    MD5STEP(F1, c, d, a, b, in[2] + 0x242070db, 17);
-    MD5STEP(F1, b, c, d, a, in[3] + 0xc1bdceee, 22);
-    MD5STEP(F1, a, b, c, d, in[4] + 0xf57c0faf, 7);
-    MD5STEP(F1, d, a, b, c, in[5] + 0x4787c62a, 12);
-    MD5STEP(F1, c, d, a, b, in[6] + 0xa8304613, 17);
-    MD5STEP(F1, b, c, d, a, in[7] + 0xfd469501, 22);
-    MD5STEP(F1, a, b, c, d, in[8] + 0x698098d8, 7);
-    MD5STEP(F1, d, a, b, c, in[9] + 0x8b44f7af, 12);
-    MD5STEP(F1, c, d, a, b, in[10] + 0xffff5bb1, 17);
-    MD5STEP(F1, b, c, d, a, in[11] + 0x895cd7be, 22);
-    MD5STEP(F1, a, b, c, d, in[12] + 0x6b901122, 7);
-    MD5STEP(F1, d, a, b, c, in[13] + 0xfd987193, 12);
-    MD5STEP(F1, c, d, a, b, in[14] + 0xa679438e, 17);
-    MD5STEP(F1, b, c, d, a, in[15] + 0x49b40821, 22);
-
-    MD5STEP(F2, a, b, c, d, in[1] + 0xf61e2562, 5);
-    MD5STEP(F2, d, a, b, c, in[6] + 0xc040b340, 9);
-    MD5STEP(F2, c, d, a, b, in[11] + 0x265e5a51, 14);
-    MD5STEP(F2, b, c, d, a, in[0] + 0xe9b6c7aa, 20);
-    MD5STEP(F2, a, b, c, d, in[5] + 0xd62f105d, 5);
-    MD5STEP(F2, d, a, b, c, in[10] + 0x02441453, 9);
-    MD5STEP(F2, c, d, a, b, in[15] + 0xd8a1e681, 14);
-    MD5STEP(F2, b, c, d, a, in[4] + 0xe7d3fbc8, 20);
-    MD5STEP(F2, a, b, c, d, in[9] + 0x21e1cde6, 5);
-    MD5STEP(F2, d, a, b, c, in[14] + 0xc33707d6, 9);
-    MD5STEP(F2, c, d, a, b, in[3] + 0xf4d50d87, 14);
-    MD5STEP(F2, b, c, d, a, in[8] + 0x455a14ed, 20);
-    MD5STEP(F2, a, b, c, d, in[13] + 0xa9e3e905, 5);
-    MD5STEP(F2, d, a, b, c, in[2] + 0xfcefa3f8, 9);
-    MD5STEP(F2, c, d, a, b, in[7] + 0x676f02d9, 14);
-    MD5STEP(F2, b, c, d, a, in[12] + 0x8d2a4c8a, 20);
-
-    MD5STEP(F3, a, b, c, d, in[5] + 0xfffa3942, 4);
-    MD5STEP(F3, d, a, b, c, in[8] + 0x8771f681, 11);
-    MD5STEP(F3, c, d, a, b, in[11] + 0x6d9d6122, 16);
-    MD5STEP(F3, b, c, d, a, in[14] + 0xfde5380c, 23);
-    MD5STEP(F3, a, b, c, d, in[1] + 0xa4beea44, 4);
-    MD5STEP(F3, d, a, b, c, in[4] + 0x4bdecfa9, 11);
-    MD5STEP(F3, c, d, a, b, in[7] + 0xf6bb4b60, 16);
-    MD5STEP(F3, b, c, d, a, in[10] + 0xbebfbc70, 23);
-    MD5STEP(F3, a, b, c, d, in[13] + 0x289b7ec6, 4);
-    MD5STEP(F3, d, a, b, c, in[0] + 0xeaa127fa, 11);
-    MD5STEP(F3, c, d, a, b, in[3] + 0xd4ef3085, 16);
-    MD5STEP(F3, b, c, d, a, in[6] + 0x04881d05, 23);
-    MD5STEP(F3, a, b, c, d, in[9] + 0xd9d4d039, 4);
-    MD5STEP(F3, d, a, b, c, in[12] + 0xe6db99e5, 11);
-    MD5STEP(F3, c, d, a, b, in[15] + 0x1fa27cf8, 16);
-    MD5STEP(F3, b, c, d, a, in[2] + 0xc4ac5665, 23);
-
-    MD5STEP(F4, a, b, c, d, in[0] + 0xf4292244, 6);
-    MD5STEP(F4, d, a, b, c, in[7] + 0x432aff97, 10);
-    MD5STEP(F4, c, d, a, b, in[14] + 0xab9423a7, 15);
-    MD5STEP(F4, b, c, d, a, in[5] + 0xfc93a039, 21);
-    MD5STEP(F4, a, b, c, d, in[12] + 0x655b59c3, 6);
-    MD5STEP(F4, d, a, b, c, in[3] + 0x8f0ccc92, 10);
-    MD5STEP(F4, c, d, a, b, in[10] + 0xffeff47d, 15);
-    MD5STEP(F4, b, c, d, a, in[1] + 0x85845dd1, 21);
-    MD5STEP(F4, a, b, c, d, in[8] + 0x6fa87e4f, 6);
-    MD5STEP(F4, d, a, b, c, in[15] + 0xfe2ce6e0, 10);
-    MD5STEP(F4, c, d, a, b, in[6] + 0xa3014314, 15);
-    MD5STEP(F4, b, c, d, a, in[13] + 0x4e0811a1, 21);
-    MD5STEP(F4, a, b, c, d, in[4] + 0xf7537e82, 6);
-    MD5STEP(F4, d, a, b, c, in[11] + 0xbd3af235, 10);
-    MD5STEP(F4, c, d, a, b, in[2] + 0x2ad7d2bb, 15);
-    MD5STEP(F4, b, c, d, a, in[9] + 0xeb86d391, 21);
-
-    buf[0] += a;
-    buf[1] += b;
-    buf[2] += c;
-    buf[3] += d;
+    while (block_count > 0) {
+        uint32_t prev_a = a;
+        uint32_t prev_b = b;
+        uint32_t prev_c = c;
+        uint32_t prev_d = d;
+
+        for (i = 0; i < 16; i++)
+            x[i] = get_uint32_le(&data[i * 4]);
+
+        MD5STEP(F1, a, b, c, d, x[0] + 0xd76aa478, 7);
+        MD5STEP(F1, d, a, b, c, x[1] + 0xe8c7b756, 12);
+        MD5STEP(F1, c, d, a, b, x[2] + 0x242070db, 17);
+        MD5STEP(F1, b, c, d, a, x[3] + 0xc1bdceee, 22);
+        MD5STEP(F1, a, b, c, d, x[4] + 0xf57c0faf, 7);
+        MD5STEP(F1, d, a, b, c, x[5] + 0x4787c62a, 12);
+        MD5STEP(F1, c, d, a, b, x[6] + 0xa8304613, 17);
+        MD5STEP(F1, b, c, d, a, x[7] + 0xfd469501, 22);
+        MD5STEP(F1, a, b, c, d, x[8] + 0x698098d8, 7);
+        MD5STEP(F1, d, a, b, c, x[9] + 0x8b44f7af, 12);
+        MD5STEP(F1, c, d, a, b, x[10] + 0xffff5bb1, 17);
+        MD5STEP(F1, b, c, d, a, x[11] + 0x895cd7be, 22);
+        MD5STEP(F1, a, b, c, d, x[12] + 0x6b901122, 7);
+        MD5STEP(F1, d, a, b, c, x[13] + 0xfd987193, 12);
+        MD5STEP(F1, c, d, a, b, x[14] + 0xa679438e, 17);
+        MD5STEP(F1, b, c, d, a, x[15] + 0x49b40821, 22);
+
+        MD5STEP(F2, a, b, c, d, x[1] + 0xf61e2562, 5);
+        MD5STEP(F2, d, a, b, c, x[6] + 0xc040b340, 9);
+        MD5STEP(F2, c, d, a, b, x[11] + 0x265e5a51, 14);
+        MD5STEP(F2, b, c, d, a, x[0] + 0xe9b6c7aa, 20);
+        MD5STEP(F2, a, b, c, d, x[5] + 0xd62f105d, 5);
+        MD5STEP(F2, d, a, b, c, x[10] + 0x02441453, 9);
+        MD5STEP(F2, c, d, a, b, x[15] + 0xd8a1e681, 14);
+        MD5STEP(F2, b, c, d, a, x[4] + 0xe7d3fbc8, 20);
+        MD5STEP(F2, a, b, c, d, x[9] + 0x21e1cde6, 5);
+        MD5STEP(F2, d, a, b, c, x[14] + 0xc33707d6, 9);
+        MD5STEP(F2, c, d, a, b, x[3] + 0xf4d50d87, 14);
+        MD5STEP(F2, b, c, d, a, x[8] + 0x455a14ed, 20);
+        MD5STEP(F2, a, b, c, d, x[13] + 0xa9e3e905, 5);
+        MD5STEP(F2, d, a, b, c, x[2] + 0xfcefa3f8, 9);
+        MD5STEP(F2, c, d, a, b, x[7] + 0x676f02d9, 14);
+        MD5STEP(F2, b, c, d, a, x[12] + 0x8d2a4c8a, 20);
+
+        MD5STEP(F3, a, b, c, d, x[5] + 0xfffa3942, 4);
+        MD5STEP(F3, d, a, b, c, x[8] + 0x8771f681, 11);
+        MD5STEP(F3, c, d, a, b, x[11] + 0x6d9d6122, 16);
+        MD5STEP(F3, b, c, d, a, x[14] + 0xfde5380c, 23);
+        MD5STEP(F3, a, b, c, d, x[1] + 0xa4beea44, 4);
+        MD5STEP(F3, d, a, b, c, x[4] + 0x4bdecfa9, 11);
+        MD5STEP(F3, c, d, a, b, x[7] + 0xf6bb4b60, 16);
+        MD5STEP(F3, b, c, d, a, x[10] + 0xbebfbc70, 23);
+        MD5STEP(F3, a, b, c, d, x[13] + 0x289b7ec6, 4);
+        MD5STEP(F3, d, a, b, c, x[0] + 0xeaa127fa, 11);
+        MD5STEP(F3, c, d, a, b, x[3] + 0xd4ef3085, 16);
+        MD5STEP(F3, b, c, d, a, x[6] + 0x04881d05, 23);
+        MD5STEP(F3, a, b, c, d, x[9] + 0xd9d4d039, 4);
+        MD5STEP(F3, d, a, b, c, x[12] + 0xe6db99e5, 11);
+        MD5STEP(F3, c, d, a, b, x[15] + 0x1fa27cf8, 16);
+        MD5STEP(F3, b, c, d, a, x[2] + 0xc4ac5665, 23);
+
+        MD5STEP(F4, a, b, c, d, x[0] + 0xf4292244, 6);
+        MD5STEP(F4, d, a, b, c, x[7] + 0x432aff97, 10);
+        MD5STEP(F4, c, d, a, b, x[14] + 0xab9423a7, 15);
+        MD5STEP(F4, b, c, d, a, x[5] + 0xfc93a039, 21);
+        MD5STEP(F4, a, b, c, d, x[12] + 0x655b59c3, 6);
+        MD5STEP(F4, d, a, b, c, x[3] + 0x8f0ccc92, 10);
+        MD5STEP(F4, c, d, a, b, x[10] + 0xffeff47d, 15);
+        MD5STEP(F4, b, c, d, a, x[1] + 0x85845dd1, 21);
+        MD5STEP(F4, a, b, c, d, x[8] + 0x6fa87e4f, 6);
+        MD5STEP(F4, d, a, b, c, x[15] + 0xfe2ce6e0, 10);
+        MD5STEP(F4, c, d, a, b, x[6] + 0xa3014314, 15);
+        MD5STEP(F4, b, c, d, a, x[13] + 0x4e0811a1, 21);
+        MD5STEP(F4, a, b, c, d, x[4] + 0xf7537e82, 6);
+        MD5STEP(F4, d, a, b, c, x[11] + 0xbd3af235, 10);
+        MD5STEP(F4, c, d, a, b, x[2] + 0x2ad7d2bb, 15);
+        MD5STEP(F4, b, c, d, a, x[9] + 0xeb86d391, 21);
+
+        a += prev_a;
+        b += prev_b;
+        c += prev_c;
+        d += prev_d;
+
+        data += 64;
+        block_count--;
+    }
+
+    buf[0] = a;
+    buf[1] = b;
+    buf[2] = c;
+    buf[3] = d;
 }
 
 /*
@@ -250,19 +250,17 @@ void bmx::md5_update(MD5Context *ctx, const unsigned char *buf, uint32_t len)
             return;
         }
         memcpy(p, buf, t);
-        byte_reverse(ctx->in, 16);
-        md5_transform(ctx->buf, (uint32_t *) ctx->in);
+        md5_transform(ctx->buf, ctx->in, 1);
         buf += t;
         len -= t;
     }
-    /* Process data in 64-byte chunks */
-
-    while (len >= 64) {
-        memcpy(ctx->in, buf, 64);
-        byte_reverse(ctx->in, 16);
-        md5_transform(ctx->buf, (uint32_t *) ctx->in);
-        buf += 64;
-        len -= 64;
+
+    /* Process data in 64-byte chunks directly from the input */
+
+    if (len >= 64) {
+        md5_transform(ctx->buf, buf, len / 64);
+        buf += len & ~0x3f;
+        len &= 0x3f;
     }
 
     /* Handle any remaining bytes of data. */
@@ -272,7 +270,7 @@ void bmx::md5_update(MD5Context *ctx, const unsigned char *buf, uint32_t len)
 
 /*
  * Final wrapup - pad to 64-byte boundary with the bit pattern
- * 1 0* (64-bit count of bits processed, MSB-first)
+ * 1 0* (64-bit count of bits processed, LSB-first)
  */
 void bmx::md5_final(unsigned char digest[16], MD5Context *ctx)
 {
@@ -294,8 +292,7 @@ void bmx::md5_final(unsigned char digest[16], MD5Context *ctx)
     if (count < 8) {
         /* Two lots of padding:  Pad the first block to 64 bytes */
         memset(p, 0, count);
-        byte_reverse(ctx->in, 16);
-        md5_transform(ctx->buf, (uint32_t *) ctx->in);
+        md5_transform(ctx->buf, ctx->in, 1);
 
         /* Now fill the next block with 56 bytes */
         memset(ctx->in, 0, 56);
@@ -303,15 +300,16 @@ void bmx::md5_final(unsigned char digest[16], MD5Context *ctx)
         /* Pad block to 56 bytes */
         memset(p, 0, count - 8);
     }
-    byte_reverse(ctx->in, 14);
 
     /* Append length in bits and transform */
-    memcpy(&ctx->in[14 * sizeof(uint32_t)], &ctx->bits[0], sizeof(uint32_t));
-    memcpy(&ctx->in[15 * sizeof(uint32_t)], &ctx->bits[1], sizeof(uint32_t));
-
-    md5_transform(ctx->buf, (uint32_t *) ctx->in);
-    byte_reverse((unsigned char *) ctx->buf, 4);
-    memcpy(digest, ctx->buf, 16);
+    put_uint32_le(&ctx->in[14 * 4], ctx->bits[0]);
+    put_uint32_le(&ctx->in[15 * 4], ctx->bits[1]);
+
+    md5_transform(ctx->buf, ctx->in, 1);
+    put_uint32_le(&digest[0],  ctx->buf[0]);
+    put_uint32_le(&digest[4],  ctx->buf[1]);
+    put_uint32_le(&digest[8],  ctx->buf[2]);
+    put_uint32_le(&digest[12], ctx->buf[3]);
     memset(ctx, 0, sizeof(*ctx));        /* In case it's sensitive */
 }
 
@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include <mxf/mxf.h>
+
+#include <bmx/MXFAsyncWriteFile.h>
+#include <bmx/Logging.h>
+#include <bmx/BMXException.h>
+
+
+using namespace std;
+using namespace bmx;
+
+
+struct bmx::MXFAsyncWriteFile
+{
+    MXFFile *mxf_file;
+};
+
+typedef struct
+{
+    int64_t position;
+    vector<unsigned char> data;
+} WriteBuffer;
+
+struct MXFFileSysData
+{
+    MXFAsyncWriteFile async_file;
+    MXFFile *target;
+    uint32_t buffer_size;
+    int64_t position;
+    bool is_seekable;
+
+    WriteBuffer *current;
+    vector<WriteBuffer*> buffers;
+    vector<WriteBuffer*> free_buffers;
+    deque<WriteBuffer*> queue;
+    bool writing;
+    bool write_failed;
+    bool stop;
+
+    mutex buffer_mutex;
+    condition_variable buffer_cond;
+    thread io_thread;
+};
+
+
+static void io_thread_main(MXFFileSysData *sys_data)
+{
+    unique_lock<mutex> lock(sys_data->buffer_mutex);
+    while (true) {
+        while (!sys_data->stop && sys_data->queue.empty())
+            sys_data->buffer_cond.wait(lock);
+        if (sys_data->queue.empty())
+            break;
+
+        WriteBuffer *buffer = sys_data->queue.front();
+        sys_data->queue.pop_front();
+        sys_data->writing = true;
+        bool write_failed = sys_data->write_failed;
+        lock.unlock();
+
+        // buffers are discarded after a failure so that the writer doesn't block
+        if (!write_failed) {
+            uint32_t size = (uint32_t)buffer->data.size();
+            if ((mxf_file_tell(sys_data->target) != buffer->position &&
+                    !mxf_file_seek(sys_data->target, buffer->position, SEEK_SET)) ||
+                mxf_file_write(sys_data->target, &buffer->data[0], size) != size)
+            {
+                write_failed = true;
+            }
+        }
+
+        lock.lock();
+        if (write_failed)
+            sys_data->write_failed = true;
+        buffer->data.clear();
+        sys_data->free_buffers.push_back(buffer);
+        sys_data->writing = false;
+        sys_data->buffer_cond.notify_all();
+    }
+}
+
+static void submit_current_buffer(MXFFileSysData *sys_data)
+{
+    if (!sys_data->current)
+        return;
+
+    lock_guard<mutex> lock(sys_data->buffer_mutex);
+    if (sys_data->current->data.empty()) {
+        sys_data->free_buffers.push_back(sys_data->current);
+    } else {
+        sys_data->queue.push_back(sys_data->current);
+        sys_data->buffer_cond.notify_all();
+    }
+    sys_data->current = 0;
+}
+
+static bool acquire_current_buffer(MXFFileSysData *sys_data)
+{
+    BMX_ASSERT(!sys_data->current);
+
+    unique_lock<mutex> lock(sys_data->buffer_mutex);
+    while (!sys_data->write_failed && sys_data->free_buffers.empty())
+        sys_data->buffer_cond.wait(lock);
+    if (sys_data->write_failed)
+        return false;
+
+    sys_data->current = sys_data->free_buffers.back();
+    sys_data->free_buffers.pop_back();
+    sys_data->current->position = sys_data->position;
+
+    return true;
+}
+
+static bool flush_buffers(MXFFileSysData *sys_data)
+{
+    submit_current_buffer(sys_data);
+
+    {
+        unique_lock<mutex> lock(sys_data->buffer_mutex);
+        while (!sys_data->queue.empty() || sys_data->writing)
+            sys_data->buffer_cond.wait(lock);
+        if (sys_data->write_failed)
+            return false;
+    }
+
+    // the target position is left at the end of the last write
+    if (mxf_file_tell(sys_data->target) != sys_data->position)
+        return mxf_file_seek(sys_data->target, sys_data->position, SEEK_SET) != 0;
+
+    return true;
+}
+
+
+static void async_file_close(MXFFileSysData *sys_data)
+{
+    if (sys_data->target && !flush_buffers(sys_data))
+        log_error("Failed to write queued data to the MXF file\n");
+
+    {
+        lock_guard<mutex> lock(sys_data->buffer_mutex);
+        sys_data->stop = true;
+        sys_data->buffer_cond.notify_all();
+    }
+    if (sys_data->io_thread.joinable())
+        sys_data->io_thread.join();
+
+    if (sys_data->target)
+        mxf_file_close(&sys_data->target);
+}
+
+static uint32_t async_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
+{
+    if (!flush_buffers(sys_data))
+        return 0;
+
+    uint32_t result = mxf_file_read(sys_data->target, data, count);
+    sys_data->position += result;
+
+    return result;
+}
+
+static uint32_t async_file_write(MXFFileSysData *sys_data, const uint8_t *data, uint32_t count)
+{
+    if (sys_data->current &&
+        sys_data->current->position + (int64_t)sys_data->current->data.size() != sys_data->position)
+    {
+        submit_current_buffer(sys_data);
+    }
+
+    uint32_t total_written = 0;
+    while (total_written < count) {
+        if (!sys_data->current && !acquire_current_buffer(sys_data))
+            break;
+
+        uint32_t space = sys_data->buffer_size - (uint32_t)sys_data->current->data.size();
+        uint32_t write_count = count - total_written;
+        if (write_count > space)
+            write_count = space;
+        sys_data->current->data.insert(sys_data->current->data.end(), data + total_written,
+                                       data + total_written + write_count);
+        total_written += write_count;
+        sys_data->position += write_count;
+
+        if (sys_data->current->data.size() >= sys_data->buffer_size)
+            submit_current_buffer(sys_data);
+    }
+
+    return total_written;
+}
+
+static int async_file_getc(MXFFileSysData *sys_data)
+{
+    if (!flush_buffers(sys_data))
+        return EOF;
+
+    int result = mxf_file_getc(sys_data->target);
+    if (result != EOF)
+        sys_data->position++;
+
+    return result;
+}
+
+static int async_file_putc(MXFFileSysData *sys_data, int c)
+{
+    uint8_t byte = (uint8_t)c;
+    if (async_file_write(sys_data, &byte, 1) != 1)
+        return EOF;
+
+    return c;
+}
+
+static int async_file_eof(MXFFileSysData *sys_data)
+{
+    if (!flush_buffers(sys_data))
+        return 1;
+
+    return mxf_file_eof(sys_data->target);
+}
+
+static int async_file_seek(MXFFileSysData *sys_data, int64_t offset, int whence)
+{
+    // a seek relative to the start or current position only changes where the next buffer is written
+    if (whence == SEEK_SET || whence == SEEK_CUR) {
+        if (whence == SEEK_CUR)
+            offset += sys_data->position;
+        if (offset < 0)
+            return 0;
+        sys_data->position = offset;
+        return 1;
+    }
+
+    if (!flush_buffers(sys_data) || !mxf_file_seek(sys_data->target, offset, whence))
+        return 0;
+
+    sys_data->position = mxf_file_tell(sys_data->target);
+
+    return 1;
+}
+
+static int64_t async_file_tell(MXFFileSysData *sys_data)
+{
+    return sys_data->position;
+}
+
+static int async_file_is_seekable(MXFFileSysData *sys_data)
+{
+    return sys_data->is_seekable;
+}
+
+static int64_t async_file_size(MXFFileSysData *sys_data)
+{
+    if (!flush_buffers(sys_data))
+        return -1;
+
+    return mxf_file_size(sys_data->target);
+}
+
+
+static void free_async_file(MXFFileSysData *sys_data)
+{
+    if (sys_data) {
+        size_t i;
+        for (i = 0; i < sys_data->buffers.size(); i++)
+            delete sys_data->buffers[i];
+        delete sys_data;
+    }
+}
+
+
+MXFAsyncWriteFile* bmx::mxf_async_write_file_open(MXFFile *target, uint32_t buffer_size, uint32_t num_buffers)
+{
+    if (buffer_size == 0)
+        buffer_size = MXF_ASYNC_WRITE_DEFAULT_BUFFER_SIZE;
+    if (num_buffers == 0)
+        num_buffers = MXF_ASYNC_WRITE_DEFAULT_NUM_BUFFERS;
+
+    MXFFile *async_file = 0;
+    try
+    {
+        // using malloc() because mxf_file_close will call free()
+        BMX_CHECK((async_file = (MXFFile*)malloc(sizeof(MXFFile))) != 0);
+        memset(async_file, 0, sizeof(MXFFile));
+        async_file->sysData = new MXFFileSysData;
+
+        MXFFileSysData *sys_data = async_file->sysData;
+        sys_data->async_file.mxf_file = async_file;
+        sys_data->target       = target;
+        sys_data->buffer_size  = buffer_size;
+        sys_data->position     = mxf_file_tell(target);
+        sys_data->is_seekable  = (mxf_file_is_seekable(target) != 0);
+        sys_data->current      = 0;
+        sys_data->writing      = false;
+        sys_data->write_failed = false;
+        sys_data->stop         = false;
+
+        async_file->close         = async_file_close;
+        async_file->read          = async_file_read;
+        async_file->write         = async_file_write;
+        async_file->get_char      = async_file_getc;
+        async_file->put_char      = async_file_putc;
+        async_file->eof           = async_file_eof;
+        async_file->seek          = async_file_seek;
+        async_file->tell          = async_file_tell;
+        async_file->is_seekable   = async_file_is_seekable;
+        async_file->size          = async_file_size;
+        async_file->free_sys_data = free_async_file;
+
+        async_file->minLLen       = target->minLLen;
+        async_file->runinLen      = target->runinLen;
+
+        uint32_t i;
+        for (i = 0; i < num_buffers; i++) {
+            sys_data->buffers.push_back(new WriteBuffer);
+            sys_data->buffers.back()->position = 0;
+            sys_data->buffers.back()->data.reserve(buffer_size);
+            sys_data->free_buffers.push_back(sys_data->buffers.back());
+        }
+
+        sys_data->io_thread = thread(io_thread_main, sys_data);
+
+        return &sys_data->async_file;
+    }
+    catch (...)
+    {
+        if (async_file) {
+            if (async_file->sysData)
+                async_file->sysData->target = 0; // ownership returns to the caller
+            mxf_file_close(&async_file);
+        }
+        throw;
+    }
+}
+
+MXFFile* bmx::mxf_async_write_file_get_file(MXFAsyncWriteFile *async_file)
+{
+    return async_file->mxf_file;
+}
+
+bool bmx::mxf_async_write_file_flush(MXFAsyncWriteFile *async_file)
+{
+    return flush_buffers(async_file->mxf_file->sysData);
+}
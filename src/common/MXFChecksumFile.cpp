@@ -48,6 +48,10 @@ using namespace std;
 using namespace bmx;
 
 
+// written data arrives in small pieces and a smaller buffer than the default for file reads is sufficient
+#define CHECKSUM_BUFFER_SIZE    (256 * 1024)
+
+
 struct bmx::MXFChecksumFile
 {
     MXFFile *mxf_file;
@@ -57,7 +61,7 @@ struct MXFFileSysData
 {
     MXFChecksumFile checksum_file;
     MXFFile *target;
-    Checksum *checksum;
+    ChecksumEngine *checksum_engine;
     int64_t position;
     int64_t checksum_position;
     bool force_update;
@@ -155,7 +159,7 @@ static uint32_t checksum_file_read(MXFFileSysData *sys_data, uint8_t *data, uint
             sys_data->position + result >  sys_data->checksum_position)
         {
             uint32_t checksum_count = (uint32_t)(sys_data->position + result - sys_data->checksum_position);
-            sys_data->checksum->Update(&data[(uint32_t)(sys_data->checksum_position - sys_data->position)],
+            sys_data->checksum_engine->Update(&data[(uint32_t)(sys_data->checksum_position - sys_data->position)],
                                        checksum_count);
             sys_data->checksum_position += checksum_count;
         }
@@ -175,7 +179,7 @@ static uint32_t checksum_file_write(MXFFileSysData *sys_data, const uint8_t *dat
     if (result > 0) {
         // sys_data->position == sys_data->checksum_position
         if (!sys_data->checksum_final) {
-            sys_data->checksum->Update(data, result);
+            sys_data->checksum_engine->Update(data, result);
             sys_data->checksum_position += result;
         }
         sys_data->position += result;
@@ -197,7 +201,7 @@ static int checksum_file_getc(MXFFileSysData *sys_data)
     if (result != EOF) {
         if (!sys_data->checksum_final && sys_data->position == sys_data->checksum_position) {
             unsigned char byte = (unsigned char)result;
-            sys_data->checksum->Update(&byte, 1);
+            sys_data->checksum_engine->Update(&byte, 1);
             sys_data->checksum_position++;
         }
         sys_data->position++;
@@ -217,7 +221,7 @@ static int checksum_file_putc(MXFFileSysData *sys_data, int c)
         // sys_data->position == sys_data->checksum_position
         if (!sys_data->checksum_final) {
             unsigned char byte = (unsigned char)c;
-            sys_data->checksum->Update(&byte, 1);
+            sys_data->checksum_engine->Update(&byte, 1);
             sys_data->checksum_position++;
         }
         sys_data->position++;
@@ -290,17 +294,53 @@ static int64_t checksum_file_size(MXFFileSysData *sys_data)
     return mxf_file_size(sys_data->target);
 }
 
+static int checksum_file_read_ahead(MXFFileSysData *sys_data, int64_t offset, int64_t count)
+{
+    return mxf_file_read_ahead(sys_data->target, offset, count);
+}
+
+static uint64_t checksum_file_write_vec(MXFFileSysData *sys_data, const MXFFileIOVec *vec, uint32_t count)
+{
+    BMX_CHECK_M(sys_data->position == sys_data->checksum_position,
+                ("File modification not supported when using the MXF checksum file"));
+
+    uint64_t result = mxf_file_write_vec(sys_data->target, vec, count);
+
+    // sys_data->position == sys_data->checksum_position
+    if (!sys_data->checksum_final) {
+        uint64_t rem_count = result;
+        uint32_t i;
+        for (i = 0; i < count && rem_count > 0; i++) {
+            uint32_t update_count = (rem_count < vec[i].size ? (uint32_t)rem_count : vec[i].size);
+            sys_data->checksum_engine->Update(vec[i].data, update_count);
+            rem_count -= update_count;
+        }
+        sys_data->checksum_position += result;
+    }
+    sys_data->position += result;
+
+    return result;
+}
+
 
 static void free_checksum_file(MXFFileSysData *sys_data)
 {
     if (sys_data) {
-        delete sys_data->checksum;
+        delete sys_data->checksum_engine;
         free(sys_data);
     }
 }
 
 
 MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
+{
+    vector<ChecksumType> types;
+    types.push_back(type);
+
+    return mxf_checksum_file_open(target, types);
+}
+
+MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, const vector<ChecksumType> &types)
 {
     MXFFile *checksum_file = 0;
     try
@@ -312,7 +352,7 @@ MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
         memset(checksum_file->sysData, 0, sizeof(MXFFileSysData));
 
         checksum_file->sysData->target            = target;
-        checksum_file->sysData->checksum          = new Checksum(type);
+        checksum_file->sysData->checksum_engine   = new ChecksumEngine(types, CHECKSUM_BUFFER_SIZE);
         checksum_file->sysData->position          = mxf_file_tell(target);
         checksum_file->sysData->checksum_position = 0;
         checksum_file->sysData->force_update      = false;
@@ -330,6 +370,8 @@ MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
         checksum_file->tell          = checksum_file_tell;
         checksum_file->is_seekable   = checksum_file_is_seekable;
         checksum_file->size          = checksum_file_size;
+        checksum_file->read_ahead    = checksum_file_read_ahead;
+        checksum_file->write_vec     = checksum_file_write_vec;
         checksum_file->free_sys_data = free_checksum_file;
 
         checksum_file->minLLen       = target->minLLen;
@@ -377,7 +419,7 @@ bool bmx::mxf_checksum_file_final(MXFChecksumFile *checksum_file)
         update_checksum_to_nonseekable_end(checksum_file);
     }
 
-    sys_data->checksum->Final();
+    sys_data->checksum_engine->Final();
     sys_data->checksum_final = true;
 
     return true;
@@ -385,15 +427,31 @@ bool bmx::mxf_checksum_file_final(MXFChecksumFile *checksum_file)
 
 size_t bmx::mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file)
 {
-    return checksum_file->mxf_file->sysData->checksum->GetDigestSize();
+    return checksum_file->mxf_file->sysData->checksum_engine->GetChecksum(0).GetDigestSize();
 }
 
 void bmx::mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, unsigned char *digest, size_t size)
 {
-    return checksum_file->mxf_file->sysData->checksum->GetDigest(digest, size);
+    return checksum_file->mxf_file->sysData->checksum_engine->GetChecksum(0).GetDigest(digest, size);
 }
 
 string bmx::mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file)
 {
-    return checksum_file->mxf_file->sysData->checksum->GetDigestString();
+    return checksum_file->mxf_file->sysData->checksum_engine->GetChecksum(0).GetDigestString();
+}
+
+size_t bmx::mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file, ChecksumType type)
+{
+    return checksum_file->mxf_file->sysData->checksum_engine->GetChecksum(type).GetDigestSize();
+}
+
+void bmx::mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, ChecksumType type, unsigned char *digest,
+                                   size_t size)
+{
+    return checksum_file->mxf_file->sysData->checksum_engine->GetChecksum(type).GetDigest(digest, size);
+}
+
+string bmx::mxf_checksum_file_digest_str(const MXFChecksumFile *checksum_file, ChecksumType type)
+{
+    return checksum_file->mxf_file->sysData->checksum_engine->GetChecksum(type).GetDigestString();
 }
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+
+#include <bmx/MXFWriteBatch.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+#define ZEROS_SIZE  4096
+
+static const unsigned char ZEROS[ZEROS_SIZE] = {0};
+
+
+
+MXFWriteBatch::MXFWriteBatch(uint8_t min_llen)
+{
+    mMinLLen = min_llen;
+    mBytes.SetAllocBlockSize(1024);
+    mSize = 0;
+}
+
+MXFWriteBatch::~MXFWriteBatch()
+{
+}
+
+void MXFWriteBatch::Clear()
+{
+    mBytes.SetSize(0);
+    mSegments.clear();
+    mSize = 0;
+}
+
+void MXFWriteBatch::AppendFixedKL(const mxfKey *key, uint8_t llen, uint64_t len)
+{
+    AppendCopy((const unsigned char*)key, mxfKey_extlen);
+    AppendFixedL(llen, len);
+}
+
+void MXFWriteBatch::AppendUInt8(uint8_t value)
+{
+    unsigned char *bytes = AppendBytes(1);
+    bytes[0] = value;
+}
+
+void MXFWriteBatch::AppendUInt16(uint16_t value)
+{
+    unsigned char *bytes = AppendBytes(2);
+    bytes[0] = (unsigned char)((value >> 8) & 0xff);
+    bytes[1] = (unsigned char)( value       & 0xff);
+}
+
+void MXFWriteBatch::AppendUL(const mxfUL *ul)
+{
+    AppendCopy((const unsigned char*)ul, mxfUL_extlen);
+}
+
+void MXFWriteBatch::AppendCopy(const unsigned char *data, uint32_t size)
+{
+    if (size > 0)
+        memcpy(AppendBytes(size), data, size);
+}
+
+void MXFWriteBatch::AppendRef(const unsigned char *data, uint32_t size)
+{
+    if (size == 0)
+        return;
+
+    Segment segment;
+    segment.data   = data;
+    segment.offset = 0;
+    segment.size   = size;
+    mSegments.push_back(segment);
+    mSize += size;
+}
+
+void MXFWriteBatch::AppendFill(uint32_t size)
+{
+    BMX_CHECK(size >= (uint32_t)(mxfKey_extlen + mMinLLen));
+
+    uint32_t fill_size = size - mxfKey_extlen;
+    uint8_t llen = mxf_get_llen(0, fill_size);
+    if (llen < mMinLLen)
+        llen = mMinLLen;
+    BMX_ASSERT(fill_size >= llen);
+    fill_size -= llen;
+
+    AppendFixedKL(&g_KLVFill_key, llen, fill_size);
+    AppendZeros(fill_size);
+}
+
+void MXFWriteBatch::AppendZeros(uint32_t size)
+{
+    uint32_t rem_size = size;
+    while (rem_size > 0) {
+        uint32_t seg_size = (rem_size > ZEROS_SIZE ? ZEROS_SIZE : rem_size);
+        AppendRef(ZEROS, seg_size);
+        rem_size -= seg_size;
+    }
+}
+
+void MXFWriteBatch::Write(File *mxf_file)
+{
+    if (mSegments.empty())
+        return;
+
+    mIOVec.resize(mSegments.size());
+    size_t i;
+    for (i = 0; i < mSegments.size(); i++) {
+        if (mSegments[i].data)
+            mIOVec[i].data = mSegments[i].data;
+        else
+            mIOVec[i].data = mBytes.GetBytes() + mSegments[i].offset;
+        mIOVec[i].size = mSegments[i].size;
+    }
+
+    BMX_CHECK(mxf_file->writeVec(&mIOVec[0], (uint32_t)mIOVec.size()) == mSize);
+
+    Clear();
+}
+
+void MXFWriteBatch::AppendFixedL(uint8_t llen, uint64_t len)
+{
+    BMX_ASSERT(llen > 0 && llen <= 9);
+
+    unsigned char *bytes = AppendBytes(llen);
+    if (llen == 1) {
+        BMX_CHECK(len < 0x80);
+        bytes[0] = (unsigned char)len;
+    } else {
+        BMX_CHECK(llen == 9 || (len >> ((llen - 1) * 8)) == 0);
+        bytes[0] = (unsigned char)(0x80 + llen - 1);
+        uint8_t i;
+        for (i = 0; i < llen - 1; i++)
+            bytes[llen - 1 - i] = (unsigned char)((len >> (i * 8)) & 0xff);
+    }
+}
+
+unsigned char* MXFWriteBatch::AppendBytes(uint32_t size)
+{
+    // extend the last segment if it is also stored in mBytes
+    if (mSegments.empty() || mSegments.back().data ||
+        mSegments.back().offset + mSegments.back().size != mBytes.GetSize())
+    {
+        Segment segment;
+        segment.data   = 0;
+        segment.offset = mBytes.GetSize();
+        segment.size   = 0;
+        mSegments.push_back(segment);
+    }
+
+    mBytes.Grow(size);
+    unsigned char *bytes = mBytes.GetBytesAvailable();
+    mBytes.IncrementSize(size);
+    mSegments.back().size += size;
+    mSize += size;
+
+    return bytes;
+}
@@ -40,6 +40,9 @@
 // * Changed 'unsigned long' to 'uint32_t' (otherwise calculation is
 //   wrong)
 // * Changed sha1_update 'len' parameter type to 'uint32_t'
+// * Read the block words directly from the input data, without the static
+//   workspace copy, and process multiple blocks per sha1_transform call
+// * Added a SHA extensions (SHA-NI) sha1_transform
 
 
 #ifdef HAVE_CONFIG_H
@@ -51,28 +54,26 @@
 #include <cerrno>
 
 #include <bmx/SHA1.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
-using namespace std;
-
+#if defined(BMX_HAVE_X86_SIMD)
+#include <immintrin.h>
+#endif
 
-#define SHA1HANDSOFF /* Copies data before messing with it. */
+using namespace std;
+using namespace bmx;
 
 
 #define rol(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
 
 /* blk0() and blk() perform the initial expand. */
 /* I got the idea of expanding during the round function from SSLeay */
-#ifndef WORDS_BIGENDIAN
-#define blk0(i) (block->l[i] = (rol(block->l[i],24)&0xFF00FF00) \
-    |(rol(block->l[i],8)&0x00FF00FF))
-#else
-#define blk0(i) block->l[i]
-#endif
-#define blk(i) (block->l[i&15] = rol(block->l[(i+13)&15]^block->l[(i+8)&15] \
-    ^block->l[(i+2)&15]^block->l[i&15],1))
+#define blk0(i) (block[i] = get_uint32_be(&data[(i) * 4]))
+#define blk(i) (block[i&15] = rol(block[(i+13)&15]^block[(i+8)&15] \
+    ^block[(i+2)&15]^block[i&15],1))
 
 /* (R0+R1), R2, R3, R4 are the different operations used in SHA1 */
 #define R0(v,w,x,y,z,i) z+=((w&(x^y))^y)+blk0(i)+0x5A827999+rol(v,5);w=rol(w,30);
@@ -82,58 +83,180 @@ using namespace std;
 #define R4(v,w,x,y,z,i) z+=(w^x^y)+blk(i)+0xCA62C1D6+rol(v,5);w=rol(w,30);
 
 
-/* Hash a single 512-bit block. This is the core of the algorithm. */
+static inline uint32_t get_uint32_be(const unsigned char *data)
+{
+    return ((uint32_t)data[0] << 24) |
+           ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8)  |
+            (uint32_t)data[3];
+}
+
 
-static void sha1_transform(uint32_t state[5], const unsigned char buffer[64])
+/* Hash 512-bit blocks. This is the core of the algorithm. */
+
+static void sha1_transform_c(uint32_t state[5], const unsigned char *data, size_t block_count)
 {
 uint32_t a, b, c, d, e;
-typedef union {
-    unsigned char c[64];
-    uint32_t l[16];
-} CHAR64LONG16;
-CHAR64LONG16* block;
-#ifdef SHA1HANDSOFF
-static unsigned char workspace[64];
-    block = (CHAR64LONG16*)workspace;
-    memcpy(block, buffer, 64);
-#else
-    block = (CHAR64LONG16*)buffer;
+uint32_t block[16];
+
+    while (block_count > 0) {
+        /* Copy context->state[] to working vars */
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        /* 4 rounds of 20 operations each. Loop unrolled. */
+        R0(a,b,c,d,e, 0); R0(e,a,b,c,d, 1); R0(d,e,a,b,c, 2); R0(c,d,e,a,b, 3);
+        R0(b,c,d,e,a, 4); R0(a,b,c,d,e, 5); R0(e,a,b,c,d, 6); R0(d,e,a,b,c, 7);
+        R0(c,d,e,a,b, 8); R0(b,c,d,e,a, 9); R0(a,b,c,d,e,10); R0(e,a,b,c,d,11);
+        R0(d,e,a,b,c,12); R0(c,d,e,a,b,13); R0(b,c,d,e,a,14); R0(a,b,c,d,e,15);
+        R1(e,a,b,c,d,16); R1(d,e,a,b,c,17); R1(c,d,e,a,b,18); R1(b,c,d,e,a,19);
+        R2(a,b,c,d,e,20); R2(e,a,b,c,d,21); R2(d,e,a,b,c,22); R2(c,d,e,a,b,23);
+        R2(b,c,d,e,a,24); R2(a,b,c,d,e,25); R2(e,a,b,c,d,26); R2(d,e,a,b,c,27);
+        R2(c,d,e,a,b,28); R2(b,c,d,e,a,29); R2(a,b,c,d,e,30); R2(e,a,b,c,d,31);
+        R2(d,e,a,b,c,32); R2(c,d,e,a,b,33); R2(b,c,d,e,a,34); R2(a,b,c,d,e,35);
+        R2(e,a,b,c,d,36); R2(d,e,a,b,c,37); R2(c,d,e,a,b,38); R2(b,c,d,e,a,39);
+        R3(a,b,c,d,e,40); R3(e,a,b,c,d,41); R3(d,e,a,b,c,42); R3(c,d,e,a,b,43);
+        R3(b,c,d,e,a,44); R3(a,b,c,d,e,45); R3(e,a,b,c,d,46); R3(d,e,a,b,c,47);
+        R3(c,d,e,a,b,48); R3(b,c,d,e,a,49); R3(a,b,c,d,e,50); R3(e,a,b,c,d,51);
+        R3(d,e,a,b,c,52); R3(c,d,e,a,b,53); R3(b,c,d,e,a,54); R3(a,b,c,d,e,55);
+        R3(e,a,b,c,d,56); R3(d,e,a,b,c,57); R3(c,d,e,a,b,58); R3(b,c,d,e,a,59);
+        R4(a,b,c,d,e,60); R4(e,a,b,c,d,61); R4(d,e,a,b,c,62); R4(c,d,e,a,b,63);
+        R4(b,c,d,e,a,64); R4(a,b,c,d,e,65); R4(e,a,b,c,d,66); R4(d,e,a,b,c,67);
+        R4(c,d,e,a,b,68); R4(b,c,d,e,a,69); R4(a,b,c,d,e,70); R4(e,a,b,c,d,71);
+        R4(d,e,a,b,c,72); R4(c,d,e,a,b,73); R4(b,c,d,e,a,74); R4(a,b,c,d,e,75);
+        R4(e,a,b,c,d,76); R4(d,e,a,b,c,77); R4(c,d,e,a,b,78); R4(b,c,d,e,a,79);
+        /* Add the working vars back into context.state[] */
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+
+        data += 64;
+        block_count--;
+    }
+}
+
+
+#if defined(BMX_HAVE_X86_SIMD)
+
+/* Hash 512-bit blocks using the SHA extensions. Each sha1rnds4 does 4 rounds and the
+   message schedule for later rounds is calculated in parallel using sha1msg1/sha1msg2 */
+
+BMX_TARGET_ISA("sha,sse4.1")
+static void sha1_transform_shani(uint32_t state[5], const unsigned char *data, size_t block_count)
+{
+    const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+    __m128i abcd, abcd_save, e0, e0_save, e1;
+    __m128i msg0, msg1, msg2, msg3;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1b);
+    e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    while (block_count > 0) {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        /* Rounds 0-3 */
+        msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data     )), byte_swap);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        /* Rounds 4-7 */
+        msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), byte_swap);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        /* Rounds 8-11 */
+        msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), byte_swap);
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* Rounds 12-15 */
+        msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), byte_swap);
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+/* Rounds 16-67 follow the same pattern with the message and e registers rotating */
+#define SHA1_NI_ROUNDS(e_in, e_out, msg_cur, msg_prev, msg_prev2, msg_next, func) \
+        e_in = _mm_sha1nexte_epu32(e_in, msg_cur); \
+        e_out = abcd; \
+        msg_next = _mm_sha1msg2_epu32(msg_next, msg_cur); \
+        abcd = _mm_sha1rnds4_epu32(abcd, e_in, func); \
+        msg_prev = _mm_sha1msg1_epu32(msg_prev, msg_cur); \
+        msg_prev2 = _mm_xor_si128(msg_prev2, msg_cur);
+
+        SHA1_NI_ROUNDS(e0, e1, msg0, msg3, msg2, msg1, 0)   /* Rounds 16-19 */
+        SHA1_NI_ROUNDS(e1, e0, msg1, msg0, msg3, msg2, 1)   /* Rounds 20-23 */
+        SHA1_NI_ROUNDS(e0, e1, msg2, msg1, msg0, msg3, 1)   /* Rounds 24-27 */
+        SHA1_NI_ROUNDS(e1, e0, msg3, msg2, msg1, msg0, 1)   /* Rounds 28-31 */
+        SHA1_NI_ROUNDS(e0, e1, msg0, msg3, msg2, msg1, 1)   /* Rounds 32-35 */
+        SHA1_NI_ROUNDS(e1, e0, msg1, msg0, msg3, msg2, 1)   /* Rounds 36-39 */
+        SHA1_NI_ROUNDS(e0, e1, msg2, msg1, msg0, msg3, 2)   /* Rounds 40-43 */
+        SHA1_NI_ROUNDS(e1, e0, msg3, msg2, msg1, msg0, 2)   /* Rounds 44-47 */
+        SHA1_NI_ROUNDS(e0, e1, msg0, msg3, msg2, msg1, 2)   /* Rounds 48-51 */
+        SHA1_NI_ROUNDS(e1, e0, msg1, msg0, msg3, msg2, 2)   /* Rounds 52-55 */
+        SHA1_NI_ROUNDS(e0, e1, msg2, msg1, msg0, msg3, 2)   /* Rounds 56-59 */
+        SHA1_NI_ROUNDS(e1, e0, msg3, msg2, msg1, msg0, 3)   /* Rounds 60-63 */
+        SHA1_NI_ROUNDS(e0, e1, msg0, msg3, msg2, msg1, 3)   /* Rounds 64-67 */
+
+#undef SHA1_NI_ROUNDS
+
+        /* Rounds 68-71 */
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        /* Rounds 72-75 */
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+        /* Rounds 76-79 */
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+        /* Add the working vars back into the state */
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+
+        data += 64;
+        block_count--;
+    }
+
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
 #endif
-    /* Copy context->state[] to working vars */
-    a = state[0];
-    b = state[1];
-    c = state[2];
-    d = state[3];
-    e = state[4];
-    /* 4 rounds of 20 operations each. Loop unrolled. */
-    R0(a,b,c,d,e, 0); R0(e,a,b,c,d, 1); R0(d,e,a,b,c, 2); R0(c,d,e,a,b, 3);
-    R0(b,c,d,e,a, 4); R0(a,b,c,d,e, 5); R0(e,a,b,c,d, 6); R0(d,e,a,b,c, 7);
-    R0(c,d,e,a,b, 8); R0(b,c,d,e,a, 9); R0(a,b,c,d,e,10); R0(e,a,b,c,d,11);
-    R0(d,e,a,b,c,12); R0(c,d,e,a,b,13); R0(b,c,d,e,a,14); R0(a,b,c,d,e,15);
-    R1(e,a,b,c,d,16); R1(d,e,a,b,c,17); R1(c,d,e,a,b,18); R1(b,c,d,e,a,19);
-    R2(a,b,c,d,e,20); R2(e,a,b,c,d,21); R2(d,e,a,b,c,22); R2(c,d,e,a,b,23);
-    R2(b,c,d,e,a,24); R2(a,b,c,d,e,25); R2(e,a,b,c,d,26); R2(d,e,a,b,c,27);
-    R2(c,d,e,a,b,28); R2(b,c,d,e,a,29); R2(a,b,c,d,e,30); R2(e,a,b,c,d,31);
-    R2(d,e,a,b,c,32); R2(c,d,e,a,b,33); R2(b,c,d,e,a,34); R2(a,b,c,d,e,35);
-    R2(e,a,b,c,d,36); R2(d,e,a,b,c,37); R2(c,d,e,a,b,38); R2(b,c,d,e,a,39);
-    R3(a,b,c,d,e,40); R3(e,a,b,c,d,41); R3(d,e,a,b,c,42); R3(c,d,e,a,b,43);
-    R3(b,c,d,e,a,44); R3(a,b,c,d,e,45); R3(e,a,b,c,d,46); R3(d,e,a,b,c,47);
-    R3(c,d,e,a,b,48); R3(b,c,d,e,a,49); R3(a,b,c,d,e,50); R3(e,a,b,c,d,51);
-    R3(d,e,a,b,c,52); R3(c,d,e,a,b,53); R3(b,c,d,e,a,54); R3(a,b,c,d,e,55);
-    R3(e,a,b,c,d,56); R3(d,e,a,b,c,57); R3(c,d,e,a,b,58); R3(b,c,d,e,a,59);
-    R4(a,b,c,d,e,60); R4(e,a,b,c,d,61); R4(d,e,a,b,c,62); R4(c,d,e,a,b,63);
-    R4(b,c,d,e,a,64); R4(a,b,c,d,e,65); R4(e,a,b,c,d,66); R4(d,e,a,b,c,67);
-    R4(c,d,e,a,b,68); R4(b,c,d,e,a,69); R4(a,b,c,d,e,70); R4(e,a,b,c,d,71);
-    R4(d,e,a,b,c,72); R4(c,d,e,a,b,73); R4(b,c,d,e,a,74); R4(a,b,c,d,e,75);
-    R4(e,a,b,c,d,76); R4(d,e,a,b,c,77); R4(c,d,e,a,b,78); R4(b,c,d,e,a,79);
-    /* Add the working vars back into context.state[] */
-    state[0] += a;
-    state[1] += b;
-    state[2] += c;
-    state[3] += d;
-    state[4] += e;
-    /* Wipe variables */
-    a = b = c = d = e = 0;
+
+
+static void sha1_transform(uint32_t state[5], const unsigned char *data, size_t block_count)
+{
+#if defined(BMX_HAVE_X86_SIMD)
+    if (cpu_has_sha() && cpu_has_sse41()) {
+        sha1_transform_shani(state, data, block_count);
+        return;
+    }
+#endif
+
+    sha1_transform_c(state, data, block_count);
 }
 
 
@@ -162,9 +285,11 @@ size_t i, j;
     context->count[1] += (len >> 29);
     if ((j + len) > 63) {
         memcpy(&context->buffer[j], data, (i = 64-j));
-        sha1_transform(context->state, context->buffer);
-        for ( ; i + 63 < len; i += 64) {
-            sha1_transform(context->state, &data[i]);
+        sha1_transform(context->state, context->buffer, 1);
+        if (i + 63 < len) {
+            /* whole blocks are processed directly from the input */
+            sha1_transform(context->state, &data[i], (len - i) / 64);
+            i += (len - i) & ~(size_t)63;
         }
         j = 0;
     }
@@ -179,15 +304,17 @@ void bmx::sha1_final(unsigned char digest[20], SHA1Context *context)
 {
 uint32_t i, j;
 unsigned char finalcount[8];
+unsigned char padding[64];
 
     for (i = 0; i < 8; i++) {
         finalcount[i] = (unsigned char)((context->count[(i >= 4 ? 0 : 1)]
          >> ((3-(i & 3)) * 8) ) & 255);  /* Endian independent */
     }
-    sha1_update(context, (unsigned char *)"\200", 1);
-    while ((context->count[0] & 504) != 448) {
-        sha1_update(context, (unsigned char *)"\0", 1);
-    }
+    /* Pad to 56 mod 64 bytes in a single update */
+    j = (context->count[0] >> 3) & 63;
+    memset(padding, 0, sizeof(padding));
+    padding[0] = 0x80;
+    sha1_update(context, padding, (j < 56 ? 56 : 120) - j);
     sha1_update(context, finalcount, 8);  /* Should cause a sha1_transform() */
     for (i = 0; i < 20; i++) {
         digest[i] = (unsigned char)
@@ -199,9 +326,6 @@ unsigned char finalcount[8];
     memset(context->state, 0, 20);
     memset(context->count, 0, 8);
     memset(&finalcount, 0, 8);
-#ifdef SHA1HANDSOFF  /* make sha1_transform overwrite it's own static vars */
-    sha1_transform(context->state, context->buffer);
-#endif
 }
 
 string bmx::sha1_digest_str(const unsigned char digest[20])
@@ -254,7 +378,7 @@ string bmx::sha1_calc_file(FILE *file)
             sha1_update(&context, buffer, (uint32_t)num_read);
     }
 
-    unsigned char digest[16];
+    unsigned char digest[20];
     sha1_final(digest, &context);
 
     return sha1_digest_str(digest);
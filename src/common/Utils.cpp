@@ -743,6 +743,32 @@ int64_t bmx::get_file_size(FILE *file)
     return (int64_t)stat_buf.st_size;
 }
 
+int64_t bmx::get_file_modification_time(const string &filename)
+{
+#if defined(_WIN32)
+    struct _stati64 stat_buf;
+    if (_stati64(filename.c_str(), &stat_buf) != 0)
+#else
+    struct stat stat_buf;
+    if (stat(filename.c_str(), &stat_buf) != 0)
+#endif
+        throw BMXIOException("Failed to get file modification time: %s", bmx_strerror(errno).c_str());
+
+    return (int64_t)stat_buf.st_mtime;
+}
+
+void bmx::replace_file(const string &filename, const string &new_filename)
+{
+    // an existing new_filename is replaced atomically
+#if defined(_WIN32)
+    if (!MoveFileExA(filename.c_str(), new_filename.c_str(), MOVEFILE_REPLACE_EXISTING))
+        throw BMXIOException("Failed to rename file '%s': error %lu", filename.c_str(), GetLastError());
+#else
+    if (rename(filename.c_str(), new_filename.c_str()) != 0)
+        throw BMXIOException("Failed to rename file '%s': %s", filename.c_str(), bmx_strerror(errno).c_str());
+#endif
+}
+
 string bmx::trim_string(string value)
 {
     size_t start;
@@ -232,7 +232,7 @@ bool D10ContentPackage::IsComplete()
     return true;
 }
 
-void D10ContentPackage::Write(File *mxf_file)
+void D10ContentPackage::Write(MXFWriteBatch *batch)
 {
     BMX_ASSERT(IsComplete());
 
@@ -253,16 +253,16 @@ void D10ContentPackage::Write(File *mxf_file)
 
     // write
 
-    uint32_t size = WriteSystemItem(mxf_file);
-    mxf_file->writeFill(mInfo->system_item_size - size);
+    uint32_t size = WriteSystemItem(batch);
+    batch->AppendFill(mInfo->system_item_size - size);
 
-    mxf_file->writeFixedKL(&PICTURE_ELEMENT_KEY, LLEN, mPictureData.GetSize());
-    BMX_CHECK(mxf_file->write(mPictureData.GetBytes(), mPictureData.GetSize()) == mPictureData.GetSize());
-    mxf_file->writeFill(mInfo->picture_item_size - (mxfKey_extlen + LLEN + mPictureData.GetSize()));
+    batch->AppendFixedKL(&PICTURE_ELEMENT_KEY, LLEN, mPictureData.GetSize());
+    batch->AppendRef(mPictureData.GetBytes(), mPictureData.GetSize());
+    batch->AppendFill(mInfo->picture_item_size - (mxfKey_extlen + LLEN + mPictureData.GetSize()));
 
-    mxf_file->writeFixedKL(&SOUND_ELEMENT_KEY, LLEN, mSoundData.GetSize());
-    BMX_CHECK(mxf_file->write(mSoundData.GetBytes(), mSoundData.GetSize()) == mSoundData.GetSize());
-    mxf_file->writeFill(mInfo->sound_item_size - (mxfKey_extlen + LLEN + mSoundData.GetSize()));
+    batch->AppendFixedKL(&SOUND_ELEMENT_KEY, LLEN, mSoundData.GetSize());
+    batch->AppendRef(mSoundData.GetBytes(), mSoundData.GetSize());
+    batch->AppendFill(mInfo->sound_item_size - (mxfKey_extlen + LLEN + mSoundData.GetSize()));
 }
 
 void D10ContentPackage::CopySoundSamples(const unsigned char *data, uint32_t num_samples,
@@ -319,9 +319,9 @@ void D10ContentPackage::CopySoundSamples(const unsigned char *data, uint32_t num
     }
 }
 
-uint32_t D10ContentPackage::WriteSystemItem(File *mxf_file)
+uint32_t D10ContentPackage::WriteSystemItem(MXFWriteBatch *batch)
 {
-    mxf_file->writeFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
+    batch->AppendFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
 
     // system metadata bitmap = 0x5c
     // b7 = 0 (FEC not used)
@@ -334,19 +334,19 @@ uint32_t D10ContentPackage::WriteSystemItem(File *mxf_file)
     // b0 = 0 (control element)
 
     // core fields
-    mxf_file->writeUInt8(0x5c);                                         // system metadata bitmap
-    mxf_file->writeUInt8(mInfo->is_25hz ? (2 << 1) : ((3 << 1) | 1));   // content package rate (25 or 30/1.001)
-    mxf_file->writeUInt8(0x00);                                         // content package type (default)
-    mxf_file->writeUInt16(0x0000);                                      // channel handle (default)
-    mxf_file->writeUInt16((uint16_t)(mPosition % 65536));               // continuity count
+    batch->AppendUInt8(0x5c);                                           // system metadata bitmap
+    batch->AppendUInt8(mInfo->is_25hz ? (2 << 1) : ((3 << 1) | 1));     // content package rate (25 or 30/1.001)
+    batch->AppendUInt8(0x00);                                           // content package type (default)
+    batch->AppendUInt16(0x0000);                                        // channel handle (default)
+    batch->AppendUInt16((uint16_t)(mPosition % 65536));                 // continuity count
 
     // SMPTE Universal Label
-    mxf_file->writeUL(&mInfo->essence_container_ul);
+    batch->AppendUL(&mInfo->essence_container_ul);
 
     // (null) Package creation date / time stamp
     unsigned char ts_bytes[17];
     memset(ts_bytes, 0, sizeof(ts_bytes));
-    BMX_CHECK(mxf_file->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    batch->AppendCopy(ts_bytes, sizeof(ts_bytes));
 
     // User date / time stamp
     Timecode user_timecode;
@@ -360,11 +360,11 @@ uint32_t D10ContentPackage::WriteSystemItem(File *mxf_file)
         user_timecode = Timecode((mInfo->is_25hz ? 25 : 30), false, mPosition);
     }
     encode_smpte_timecode(user_timecode, false, &ts_bytes[1], sizeof(ts_bytes) - 1);
-    BMX_CHECK(mxf_file->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    batch->AppendCopy(ts_bytes, sizeof(ts_bytes));
 
 
     // (empty) Package Metadata Set
-    mxf_file->writeFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), LLEN, 0);
+    batch->AppendFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), LLEN, 0);
 
 
     return mxfKey_extlen + LLEN + SYSTEM_ITEM_METADATA_PACK_SIZE + mxfKey_extlen + LLEN;
@@ -373,6 +373,7 @@ uint32_t D10ContentPackage::WriteSystemItem(File *mxf_file)
 
 
 D10ContentPackageManager::D10ContentPackageManager(mxfRational frame_rate)
+: mWriteBatch(LLEN)
 {
     BMX_CHECK(frame_rate == FRAME_RATE_25 ||
               frame_rate == FRAME_RATE_2997);
@@ -621,7 +622,8 @@ void D10ContentPackageManager::WriteNextContentPackage(File *mxf_file)
 {
     BMX_ASSERT(HaveContentPackage());
 
-    mContentPackages.front()->Write(mxf_file);
+    mContentPackages.front()->Write(&mWriteBatch);
+    mWriteBatch.Write(mxf_file);
 
     mFreeContentPackages.push_back(mContentPackages.front());
     mContentPackages.pop_front();
@@ -41,6 +41,7 @@
 #include <set>
 
 #include <bmx/essence_parser/AVCEssenceParser.h>
+#include "EssenceParserUtils.h"
 #include <bmx/mxf_helper/AVCIMXFDescriptorHelper.h>
 #include <bmx/BitBuffer.h>
 #include <bmx/Utils.h>
@@ -129,6 +130,27 @@ void AVCGetBitBuffer::GetII(uint8_t num_bits, int64_t *value)
 
 void AVCGetBitBuffer::GetUE(uint64_t *value)
 {
+    // fast path: decode the code from a single peek if it fits in a 64-bit window and doesn't contain an
+    // emulation prevention byte
+    uint64_t rem_bit_size = GetRemBitSize();
+    uint8_t window_bits = (uint8_t)(rem_bit_size < 64 ? rem_bit_size : 64);
+    uint64_t window;
+    if (window_bits > 0 && PeekBits(window_bits, &window)) {
+        window <<= 64 - window_bits;
+        if (window) {
+            uint8_t leading_zero_bits = 0;
+            while (!(window & (UINT64_C(0x8000000000000000) >> leading_zero_bits)))
+                leading_zero_bits++;
+            uint8_t code_bits = 2 * leading_zero_bits + 1;
+            uint8_t before_bits;
+            if (code_bits <= window_bits && !FindEmulationPreventionByte(code_bits, &before_bits)) {
+                *value = (window >> (64 - code_bits)) - 1;
+                SetBitPos(mBitPos + code_bits);
+                return;
+            }
+        }
+    }
+
     uint64_t start_bit_pos = mBitPos;
     try
     {
@@ -189,15 +211,22 @@ void AVCGetBitBuffer::GetSE(int32_t *value)
 
 bool AVCGetBitBuffer::MoreRBSPData()
 {
-    uint64_t bit_pos = mBitSize - 1;
-    uint8_t b = 0;
+    // find the rbsp_stop_one_bit, the last bit set to 1, and check that there is data before it
+    uint32_t pos = mSize;
+    while (pos > mPos && !mData[pos - 1])
+        pos--;
+    if (pos <= mPos)
+        return false;
 
-    while (!b && bit_pos >= mBitPos) {
-        b = mData[bit_pos / 8] & (0x80 >> (bit_pos % 8));
-        bit_pos--;
+    uint8_t last_byte = mData[pos - 1];
+    uint8_t trailing_bits = 0;
+    while (!(last_byte & 0x01)) {
+        last_byte >>= 1;
+        trailing_bits++;
     }
+    uint64_t stop_bit_pos = ((uint64_t)pos << 3) - 1 - trailing_bits;
 
-    return (b && bit_pos >= mBitPos);
+    return stop_bit_pos > mBitPos;
 }
 
 bool AVCGetBitBuffer::NextBits(uint8_t num_bits, uint64_t *next_value)
@@ -243,36 +272,15 @@ void AVCGetBitBuffer::GetRBSPBits(uint8_t num_bits, uint64_t *value)
     if (num_bits > GetRemBitSize())
         throw false;
 
-    // remove emulation prevention bytes (0x03 in a 0x000003 sequence) from NAL unit bitstream
-
-    uint8_t check_num_bytes = (uint8_t)(((uint64_t)num_bits + (mBitPos & 7) + 7) >> 3);
-    const unsigned char *bytes = &mData[mPos];
-
-    uint8_t prev_bytes = 0;
-    if (mPos >= 2 && (mBitPos & 7) == 0)
-        prev_bytes = 2; // start check where current byte could be 0x03
-    else if (mPos >= 1)
-        prev_bytes = 1; // start check where the next byte could be 0x03
-    bytes -= prev_bytes;
-    check_num_bytes += prev_bytes;
-
-    uint32_t state = 0xffffff;
-    uint8_t i;
-    for (i = 0; i < check_num_bytes; i++) {
-        state = (state << 8) | bytes[i];
-        if ((state & 0xffffff) == 0x000003)
-            break;
-    }
-
     uint64_t start_bit_pos = mBitPos;
     try
     {
-        if (i < check_num_bytes) {
+        uint8_t before_bits;
+        if (FindEmulationPreventionByte(num_bits, &before_bits)) {
             // discard emulation prevention byte
-            uint8_t before_bits, after_bits;
+            uint8_t after_bits;
             uint64_t before_value, after_value;
 
-            before_bits = ((i - prev_bytes) << 3) - (uint8_t)(mBitPos & 7);
             after_bits = num_bits - before_bits;
 
             GetBits(before_bits, &before_value);
@@ -291,6 +299,31 @@ void AVCGetBitBuffer::GetRBSPBits(uint8_t num_bits, uint64_t *value)
     }
 }
 
+bool AVCGetBitBuffer::FindEmulationPreventionByte(uint8_t num_bits, uint8_t *before_bits) const
+{
+    // find an emulation prevention byte (0x03 in a 0x000003 sequence) in the NAL unit bitstream
+
+    uint8_t check_num_bytes = (uint8_t)(((uint64_t)num_bits + (mBitPos & 7) + 7) >> 3);
+    const unsigned char *bytes = &mData[mPos];
+
+    uint8_t prev_bytes = 0;
+    if (mPos >= 2 && (mBitPos & 7) == 0)
+        prev_bytes = 2; // start check where current byte could be 0x03
+    else if (mPos >= 1)
+        prev_bytes = 1; // start check where the next byte could be 0x03
+    bytes -= prev_bytes;
+    check_num_bytes += prev_bytes;
+
+    uint8_t i;
+    for (i = 2; i < check_num_bytes; i++) {
+        if (bytes[i] == 0x03 && !bytes[i - 1] && !bytes[i - 2]) {
+            *before_bits = ((i - prev_bytes) << 3) - (uint8_t)(mBitPos & 7);
+            return true;
+        }
+    }
+
+    return false;
+}
 
 
 ParamSetData::ParamSetData()
@@ -1012,24 +1045,11 @@ EssenceType AVCEssenceParser::GetAVCIEssenceType(uint32_t data_size, bool is_int
 
 uint32_t AVCEssenceParser::NextStartCodePrefix(const unsigned char *data, uint32_t size)
 {
-    const unsigned char *datap3 = data + 3;
-    const unsigned char *end    = data + size;
-
-    // loop logic is based on FFmpeg's avpriv_find_start_code in libavcodec/utils.c
-    while (datap3 < end) {
-        if (datap3[-1] > 1)
-            datap3 += 3;
-        else if (datap3[-2])
-            datap3 += 2;
-        else if (datap3[-3] | (datap3[-1] - 1))
-            datap3++;
-        else
-            break;
-    }
-    if (datap3 < end)
-        return (uint32_t)(datap3 - data) - 3;
-    else
+    // the start code prefix must be followed by at least 1 byte
+    if (size < 4)
         return ESSENCE_PARSER_NULL_OFFSET;
+
+    return find_start_code_prefix(data, size - 1);
 }
 
 uint32_t AVCEssenceParser::CompletePSSize(const unsigned char *ps_start, const unsigned char *ps_max_end)
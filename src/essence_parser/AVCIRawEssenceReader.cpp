@@ -63,8 +63,8 @@ uint32_t AVCIRawEssenceReader::ReadSamples(uint32_t num_samples)
     if (mLastSampleRead)
         return 0;
 
-    // shift data from previous read to start of sample data
-    ShiftSampleData(0, mSampleDataSize);
+    // skip data from previous read
+    SkipSampleData(mSampleDataSize);
     mSampleDataSize = 0;
     mNumSamples = 0;
 
@@ -72,19 +72,19 @@ uint32_t AVCIRawEssenceReader::ReadSamples(uint32_t num_samples)
     // read same size as previous frame assuming the size remains constant after the second frame
     uint32_t read_size;
     if (mLastSampleSize > 0)
-        read_size = mLastSampleSize - mSampleBuffer.GetSize();
+        read_size = mLastSampleSize - GetBufferedSize();
     else
-        read_size = mFixedSampleSize - mSampleBuffer.GetSize();
+        read_size = mFixedSampleSize - GetBufferedSize();
 
     ReadBytes(read_size);
-    if (mSampleBuffer.GetSize() < mFixedSampleSize - AVCI_HEADER_SIZE) {
+    if (GetBufferedSize() < mFixedSampleSize - AVCI_HEADER_SIZE) {
         mLastSampleRead = true;
         return 0;
     }
 
 
-    if (mAVCParser->CheckFrameHasAVCIHeader(mSampleBuffer.GetBytes(), mSampleBuffer.GetSize())) {
-        if (mSampleBuffer.GetSize() < mFixedSampleSize) {
+    if (mAVCParser->CheckFrameHasAVCIHeader(GetSampleData(), GetBufferedSize())) {
+        if (GetBufferedSize() < mFixedSampleSize) {
             if (ReadBytes(AVCI_HEADER_SIZE) != AVCI_HEADER_SIZE) {
                 mLastSampleRead = true;
                 return 0;
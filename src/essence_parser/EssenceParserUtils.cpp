@@ -36,19 +36,121 @@
 #define __STDC_LIMIT_MACROS
 
 #include "EssenceParserUtils.h"
+#include <bmx/essence_parser/EssenceParser.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+#if defined(BMX_HAVE_X86_SIMD)
+#include <immintrin.h>
+#endif
+
 using namespace bmx;
 
 
 
+static uint32_t find_start_code_prefix_scalar(const unsigned char *data, uint32_t size, unsigned char prefix_end)
+{
+    const unsigned char *datap3 = data + 3;
+    const unsigned char *end    = data + size;
+
+    // loop logic is based on FFmpeg's avpriv_find_start_code in libavcodec/utils.c, generalised
+    // for any non-zero last prefix byte
+    while (datap3 <= end) {
+        if (datap3[-1] && datap3[-1] != prefix_end)
+            datap3 += 3;
+        else if (datap3[-2])
+            datap3 += 2;
+        else if (datap3[-3] || datap3[-1] != prefix_end)
+            datap3++;
+        else
+            return (uint32_t)(datap3 - data) - 3;
+    }
+
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+#if defined(BMX_HAVE_X86_SIMD)
+
+// The SIMD functions compare 3 unaligned loads, offset by 1 byte, with the prefix bytes and return the
+// number of bytes searched without finding a prefix if the result is ESSENCE_PARSER_NULL_OFFSET.
+// The remainder is left to find_start_code_prefix_scalar
+
+static uint32_t find_start_code_prefix_sse2(const unsigned char *data, uint32_t size, unsigned char prefix_end,
+                                            uint32_t *searched_size)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i end_byte = _mm_set1_epi8((char)prefix_end);
+    uint32_t offset = 0;
+    for (; offset + 18 <= size; offset += 16) {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(data + offset));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(data + offset + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(data + offset + 2));
+        __m128i match = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                      _mm_cmpeq_epi8(b2, end_byte));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(match);
+        if (mask) {
+            while (!(mask & 1)) {
+                mask >>= 1;
+                offset++;
+            }
+            return offset;
+        }
+    }
+
+    *searched_size = offset;
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+BMX_TARGET_ISA("avx2")
+static uint32_t find_start_code_prefix_avx2(const unsigned char *data, uint32_t size, unsigned char prefix_end,
+                                            uint32_t *searched_size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i end_byte = _mm256_set1_epi8((char)prefix_end);
+    uint32_t offset = 0;
+    for (; offset + 34 <= size; offset += 32) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(data + offset));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(data + offset + 1));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(data + offset + 2));
+        __m256i match = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero),
+                                                          _mm256_cmpeq_epi8(b1, zero)),
+                                         _mm256_cmpeq_epi8(b2, end_byte));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(match);
+        if (mask) {
+            while (!(mask & 1)) {
+                mask >>= 1;
+                offset++;
+            }
+            return offset;
+        }
+    }
+
+    *searched_size = offset;
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+#endif
+
+
+
 uint32_t bmx::get_bits(const unsigned char *data, uint32_t data_size, uint32_t bit_offset, uint8_t num_bits)
 {
     BMX_ASSERT(num_bits <= 32);
     BMX_CHECK((bit_offset + num_bits + 7) / 8 <= data_size);
 
+    if (num_bits == 0)
+        return 0;
+
     const unsigned char *byte = data + bit_offset / 8;
+
+    // a 40-bit big-endian load contains up to 32 bits at any bit offset
+    if (data_size - bit_offset / 8 >= 5) {
+        uint64_t buffer = ((uint64_t)byte[0] << 32) | ((uint64_t)byte[1] << 24) | ((uint64_t)byte[2] << 16) |
+                          ((uint64_t)byte[3] <<  8) |  (uint64_t)byte[4];
+        return (uint32_t)((buffer >> (40 - (bit_offset % 8) - num_bits)) & (UINT64_MAX >> (64 - num_bits)));
+    }
+
     uint32_t num_bytes = ((bit_offset % 8) + num_bits + 7) / 8;
     uint64_t buffer = 0;
     uint32_t i;
@@ -63,3 +165,28 @@ uint32_t bmx::get_bits(const unsigned char *data, uint32_t data_size, uint32_t b
     return (uint32_t)buffer;
 }
 
+
+uint32_t bmx::find_start_code_prefix(const unsigned char *data, uint32_t size, unsigned char prefix_end)
+{
+    BMX_ASSERT(prefix_end != 0);
+
+    uint32_t offset = 0;
+
+#if defined(BMX_HAVE_X86_SIMD)
+    uint32_t searched_size = 0;
+    uint32_t prefix_offset = ESSENCE_PARSER_NULL_OFFSET;
+    if (cpu_has_avx2())
+        prefix_offset = find_start_code_prefix_avx2(data, size, prefix_end, &searched_size);
+    else if (cpu_has_sse2())
+        prefix_offset = find_start_code_prefix_sse2(data, size, prefix_end, &searched_size);
+    if (prefix_offset != ESSENCE_PARSER_NULL_OFFSET)
+        return prefix_offset;
+    offset = searched_size;
+#endif
+
+    uint32_t prefix_offset_rem = find_start_code_prefix_scalar(data + offset, size - offset, prefix_end);
+    if (prefix_offset_rem == ESSENCE_PARSER_NULL_OFFSET)
+        return ESSENCE_PARSER_NULL_OFFSET;
+
+    return offset + prefix_offset_rem;
+}
@@ -43,6 +43,10 @@ namespace bmx
 
 uint32_t get_bits(const unsigned char *data, uint32_t data_size, uint32_t bit_offset, uint8_t num_bits);
 
+// returns the offset of the first 0x00 0x00 <prefix_end> byte sequence, e.g. the MPEG-2 and AVC
+// 0x000001 start code prefix, or ESSENCE_PARSER_NULL_OFFSET if not found
+uint32_t find_start_code_prefix(const unsigned char *data, uint32_t size, unsigned char prefix_end = 0x01);
+
 
 
 };
@@ -43,6 +43,7 @@ using namespace std;
 using namespace bmx;
 
 
+#define START_CODE_PREFIX       0x00000100
 #define PICTURE_START_CODE      0x00000100
 #define SEQUENCE_HEADER_CODE    0x000001b3
 #define EXTENSION_START_CODE    0x000001b5
@@ -84,6 +85,19 @@ static const FrameRateMap FRAME_RATE_MAP[] =
 };
 
 
+// returns the offset of the next start code value byte at or after 'offset', where offset >= 3
+static uint32_t next_start_code(const unsigned char *data, uint32_t data_size, uint32_t offset)
+{
+    BMX_ASSERT(offset >= 3 && offset < data_size);
+
+    uint32_t prefix_offset = find_start_code_prefix(&data[offset - 3], data_size - offset + 2);
+    if (prefix_offset == ESSENCE_PARSER_NULL_OFFSET)
+        return ESSENCE_PARSER_NULL_OFFSET;
+
+    return offset + prefix_offset;
+}
+
+
 
 MPEG2EssenceParser::MPEG2EssenceParser()
 {
@@ -120,10 +134,13 @@ uint32_t MPEG2EssenceParser::ParseFrameStart(const unsigned char *data, uint32_t
 {
     BMX_CHECK(data_size != ESSENCE_PARSER_NULL_OFFSET);
 
-    uint32_t state = 0xffffffff;
-    uint32_t offset = 0;
+    uint32_t offset = 3;
     while (offset < data_size) {
-        state = (state << 8) | data[offset];
+        offset = next_start_code(data, data_size, offset);
+        if (offset == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+
+        uint32_t state = START_CODE_PREFIX | data[offset];
         if (state == SEQUENCE_HEADER_CODE ||
             state == GROUP_HEADER_CODE ||
             state == PICTURE_START_CODE)
@@ -145,30 +162,50 @@ uint32_t MPEG2EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t
     if (data_size < 4)
         return ESSENCE_PARSER_NULL_OFFSET;
 
+    if (mOffset == 0) {
+        uint32_t state = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+                         ((uint32_t)data[2] << 8)  |  (uint32_t)data[3];
+        if (state != SEQUENCE_HEADER_CODE &&
+            state != GROUP_HEADER_CODE &&
+            state != PICTURE_START_CODE)
+        {
+            // not a valid frame start
+            ResetFrameSize();
+            return ESSENCE_PARSER_NULL_FRAME_SIZE;
+        }
+
+        mSequenceHeader = (state == SEQUENCE_HEADER_CODE);
+        mGroupHeader = (state == GROUP_HEADER_CODE);
+        mPictureStart = (state == PICTURE_START_CODE);
+        mOffset = 4;
+    }
+
     while (mOffset < data_size) {
-        mState = (mState << 8) | data[mOffset];
-        if (mState == SEQUENCE_HEADER_CODE ||
-            mState == GROUP_HEADER_CODE ||
-            mState == PICTURE_START_CODE)
+        uint32_t code_offset = next_start_code(data, data_size, mOffset);
+        if (code_offset == ESSENCE_PARSER_NULL_OFFSET) {
+            // a start code prefix at the end of the data is checked again when more data is available
+            mOffset = data_size;
+            break;
+        }
+        mOffset = code_offset;
+
+        uint32_t state = START_CODE_PREFIX | data[mOffset];
+        if (state == SEQUENCE_HEADER_CODE ||
+            state == GROUP_HEADER_CODE ||
+            state == PICTURE_START_CODE)
         {
-            if ((mState == SEQUENCE_HEADER_CODE && (mSequenceHeader || mGroupHeader || mPictureStart)) ||
-                (mState == GROUP_HEADER_CODE && (mGroupHeader || mPictureStart)) ||
-                (mState == PICTURE_START_CODE && mPictureStart))
+            if ((state == SEQUENCE_HEADER_CODE && (mSequenceHeader || mGroupHeader || mPictureStart)) ||
+                (state == GROUP_HEADER_CODE && (mGroupHeader || mPictureStart)) ||
+                (state == PICTURE_START_CODE && mPictureStart))
             {
                 uint32_t frame_size = mOffset - 3;
                 ResetFrameSize();
                 return frame_size;
             }
 
-            mSequenceHeader = mSequenceHeader || (mState == SEQUENCE_HEADER_CODE);
-            mGroupHeader = mGroupHeader || (mState == GROUP_HEADER_CODE);
-            mPictureStart = mPictureStart || (mState == PICTURE_START_CODE);
-        }
-        else if (mOffset == 3)
-        {
-            // not a valid frame start
-            ResetFrameSize();
-            return ESSENCE_PARSER_NULL_FRAME_SIZE;
+            mSequenceHeader = mSequenceHeader || (state == SEQUENCE_HEADER_CODE);
+            mGroupHeader = mGroupHeader || (state == GROUP_HEADER_CODE);
+            mPictureStart = mPictureStart || (state == PICTURE_START_CODE);
         }
 
         mOffset++;
@@ -184,10 +221,13 @@ void MPEG2EssenceParser::ParseFrameInfo(const unsigned char *data, uint32_t data
     ResetFrameInfo();
 
     size_t i;
-    uint32_t state = 0xffffffff;
-    uint32_t offset = 0;
+    uint32_t offset = 3;
     while (offset < data_size) {
-        state = (state << 8) | data[offset];
+        offset = next_start_code(data, data_size, offset);
+        if (offset == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+
+        uint32_t state = START_CODE_PREFIX | data[offset];
         if (state == SEQUENCE_HEADER_CODE) {
             mHaveSequenceHeader = true;
             mHorizontalSize = get_bits(data, data_size, (offset - 3) * 8 + 32, 12);
@@ -405,7 +445,6 @@ void MPEG2EssenceParser::ParseFrameAllInfo(const unsigned char *data, uint32_t d
 void MPEG2EssenceParser::ResetFrameSize()
 {
     mOffset = 0;
-    mState = 0xffffffff;
     mSequenceHeader = false;
     mGroupHeader = false;
     mPictureStart = false;
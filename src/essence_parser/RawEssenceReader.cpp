@@ -66,6 +66,7 @@ RawEssenceReader::RawEssenceReader(EssenceSource *essence_source)
     mMaxSampleSize = 0;
     mFixedSampleSize = 0;
     mEssenceParser = 0;
+    mSampleDataOffset = 0;
     mSampleDataSize = 0;
     mNumSamples = 0;
     mFrameStartSize = PARSE_FRAME_START_SIZE;
@@ -118,10 +119,11 @@ uint32_t RawEssenceReader::ReadSamples(uint32_t num_samples)
     if (mLastSampleRead)
         return 0;
 
-    // shift data from previous read to start of sample data
+    // skip the data from the previous read. The read-ahead data stays in place and is only moved to the
+    // start of the buffer when there is no space left for reading
     // note that this is needed even if mFixedSampleSize > 0 because the previous read could have occurred
     // when mFixedSampleSize == 0
-    ShiftSampleData(0, mSampleDataSize);
+    SkipSampleData(mSampleDataSize);
     mSampleDataSize = 0;
     mNumSamples = 0;
 
@@ -133,12 +135,13 @@ uint32_t RawEssenceReader::ReadSamples(uint32_t num_samples)
                 break;
         }
     } else {
-        ReadBytes(mFixedSampleSize * num_samples - mSampleBuffer.GetSize());
-        if (mSampleBuffer.GetSize() < mFixedSampleSize * num_samples)
+        if (GetBufferedSize() < mFixedSampleSize * num_samples)
+            ReadBytes(mFixedSampleSize * num_samples - GetBufferedSize());
+        if (GetBufferedSize() < mFixedSampleSize * num_samples)
             mLastSampleRead = true;
 
-        mNumSamples = mSampleBuffer.GetSize() / mFixedSampleSize;
-        mSampleBuffer.SetSize(mNumSamples * mFixedSampleSize);
+        mNumSamples = GetBufferedSize() / mFixedSampleSize;
+        mSampleBuffer.SetSize(mSampleDataOffset + mNumSamples * mFixedSampleSize);
         mSampleDataSize = mNumSamples * mFixedSampleSize;
     }
 
@@ -158,6 +161,7 @@ void RawEssenceReader::Reset()
 
     mTotalReadLength = 0;
     mSampleBuffer.SetSize(0);
+    mSampleDataOffset = 0;
     mSampleDataSize = 0;
     mNumSamples = 0;
     mReadFirstSample = false;
@@ -168,24 +172,28 @@ bool RawEssenceReader::ReadAndParseSample()
 {
     BMX_CHECK(mEssenceParser);
 
+    // the sample data pointer passed to the parser is re-evaluated after each read because the buffered
+    // data is moved if ReadBytes needs to make space. The parser offsets are relative to the sample start
     uint32_t sample_start_offset = mSampleDataSize;
-    uint32_t sample_num_read = mSampleBuffer.GetSize() - sample_start_offset;
+    uint32_t sample_num_read = GetBufferedSize() - sample_start_offset;
     uint32_t num_read;
 
     if (!mReadFirstSample) {
         // find the start of the first sample
 
         sample_num_read += ReadBytes(mFrameStartSize);
-        uint32_t offset = mEssenceParser->ParseFrameStart(mSampleBuffer.GetBytes() + sample_start_offset, sample_num_read);
+        uint32_t offset = mEssenceParser->ParseFrameStart(mSampleBuffer.GetBytes() + mSampleDataOffset + sample_start_offset,
+                                                          sample_num_read);
         if (offset == ESSENCE_PARSER_NULL_OFFSET) {
             log_warn("Failed to find start of raw essence sample\n");
             mLastSampleRead = true;
             return false;
         }
 
-        // shift start of first sample to offset 0
+        // skip to the start of the first sample
         if (offset > 0) {
-            ShiftSampleData(sample_start_offset, sample_start_offset + offset);
+            BMX_ASSERT(sample_start_offset == 0);
+            SkipSampleData(offset);
             sample_num_read -= offset;
         }
 
@@ -196,11 +204,12 @@ bool RawEssenceReader::ReadAndParseSample()
 
     uint32_t sample_size = 0;
     while (true) {
-        sample_size = mEssenceParser->ParseFrameSize(mSampleBuffer.GetBytes() + sample_start_offset, sample_num_read);
+        sample_size = mEssenceParser->ParseFrameSize(mSampleBuffer.GetBytes() + mSampleDataOffset + sample_start_offset,
+                                                     sample_num_read);
         if (sample_size != ESSENCE_PARSER_NULL_OFFSET)
             break;
 
-        BMX_CHECK_M(mMaxSampleSize == 0 || mSampleBuffer.GetSize() - sample_start_offset <= mMaxSampleSize,
+        BMX_CHECK_M(mMaxSampleSize == 0 || GetBufferedSize() - sample_start_offset <= mMaxSampleSize,
                    ("Max raw sample size (%u) exceeded", mMaxSampleSize));
 
         num_read = ReadBytes(mReadBlockSize);
@@ -218,7 +227,7 @@ bool RawEssenceReader::ReadAndParseSample()
         // assume remaining data is valid sample data
         mLastSampleRead = true;
         if (sample_num_read > 0) {
-            mSampleDataSize = mSampleBuffer.GetSize();
+            mSampleDataSize = GetBufferedSize();
             mNumSamples++;
         }
         return false;
@@ -239,7 +248,7 @@ uint32_t RawEssenceReader::ReadBytes(uint32_t size)
     if (actual_size == 0)
         return 0;
 
-    mSampleBuffer.Grow(actual_size);
+    ReserveBytes(actual_size);
     uint32_t num_read = mEssenceSource->Read(mSampleBuffer.GetBytesAvailable(), actual_size);
     if (num_read < actual_size && mEssenceSource->HaveError())
         log_error("Failed to read from raw essence source: %s\n", mEssenceSource->GetStrError().c_str());
@@ -250,15 +259,15 @@ uint32_t RawEssenceReader::ReadBytes(uint32_t size)
     return num_read;
 }
 
-void RawEssenceReader::ShiftSampleData(uint32_t to_offset, uint32_t from_offset)
+void RawEssenceReader::SkipSampleData(uint32_t size)
 {
-    BMX_ASSERT(to_offset <= from_offset);
-    BMX_ASSERT(from_offset <= mSampleBuffer.GetSize());
+    BMX_ASSERT(size <= GetBufferedSize());
 
-    uint32_t size = mSampleBuffer.GetSize() - from_offset;
-    if (size > 0)
-        memmove(mSampleBuffer.GetBytes() + to_offset, mSampleBuffer.GetBytes() + from_offset, size);
-    mSampleBuffer.SetSize(to_offset + size);
+    mSampleDataOffset += size;
+    if (mSampleDataOffset == mSampleBuffer.GetSize()) {
+        mSampleBuffer.SetSize(0);
+        mSampleDataOffset = 0;
+    }
 }
 
 uint32_t RawEssenceReader::AppendBytes(const unsigned char *bytes, uint32_t size)
@@ -271,7 +280,7 @@ uint32_t RawEssenceReader::AppendBytes(const unsigned char *bytes, uint32_t size
     if (actual_size == 0)
         return 0;
 
-    mSampleBuffer.Grow(actual_size);
+    ReserveBytes(actual_size);
     memcpy(mSampleBuffer.GetBytesAvailable(), bytes, actual_size);
 
     mTotalReadLength += actual_size;
@@ -279,3 +288,27 @@ uint32_t RawEssenceReader::AppendBytes(const unsigned char *bytes, uint32_t size
 
     return actual_size;
 }
+
+void RawEssenceReader::ReserveBytes(uint32_t size)
+{
+    if (mSampleBuffer.GetSizeAvailable() >= size)
+        return;
+
+    // move the buffered data to the start of the buffer. This only happens when the end of the buffer is
+    // reached and so each byte is moved at most once if the buffer is large enough for 2 samples
+    uint32_t buffered_size = GetBufferedSize();
+    if (mSampleDataOffset > 0) {
+        if (buffered_size > 0)
+            memmove(mSampleBuffer.GetBytes(), mSampleBuffer.GetBytes() + mSampleDataOffset, buffered_size);
+        mSampleBuffer.SetSize(buffered_size);
+        mSampleDataOffset = 0;
+    }
+
+    // grow the buffer exponentially to limit the number of reallocations and moves
+    if (mSampleBuffer.GetSizeAvailable() < size) {
+        uint32_t alloc_size = mSampleBuffer.GetAllocatedSize() * 2;
+        if (alloc_size < buffered_size + size)
+            alloc_size = buffered_size + size;
+        mSampleBuffer.Reallocate(alloc_size);
+    }
+}
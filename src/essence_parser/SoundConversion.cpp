@@ -36,9 +36,767 @@
 #include <cstring>
 
 #include <bmx/essence_parser/SoundConversion.h>
+#include <bmx/CPUFeatures.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+#if defined(BMX_HAVE_X86_SIMD)
+#include <immintrin.h>
+#endif
+
+using namespace bmx;
+
+
+// An AES3 subframe word in D-10 audio is little-endian with the 24-bit audio sample in bits 4..27
+
+static inline uint32_t get_aes3_word(const unsigned char *data)
+{
+    return  (uint32_t)data[0]        |
+           ((uint32_t)data[1] << 8)  |
+           ((uint32_t)data[2] << 16) |
+           ((uint32_t)data[3] << 24);
+}
+
+static void convert_aes3_to_mc_pcm_scalar(const unsigned char *aes_data_ptr, uint32_t sample_count,
+                                          uint32_t bytes_per_sample, uint8_t channel_count, uint8_t valid_flags,
+                                          unsigned char *pcm_data_ptr)
+{
+    uint32_t channel_masks[8];
+    uint32_t sample_num;
+    uint8_t channel_num;
+
+    for (channel_num = 0; channel_num < 8; channel_num++)
+        channel_masks[channel_num] = ((valid_flags & (1 << channel_num)) ? 0xffffffff : 0);
+
+    if (bytes_per_sample == 2) {
+        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+            for (channel_num = 0; channel_num < channel_count; channel_num++) {
+                uint32_t word = get_aes3_word(&aes_data_ptr[channel_num * 4]) & channel_masks[channel_num];
+                pcm_data_ptr[0] = (unsigned char)(word >> 12);
+                pcm_data_ptr[1] = (unsigned char)(word >> 20);
+                pcm_data_ptr += 2;
+            }
+            aes_data_ptr += 8 * 4;
+        }
+    } else {
+        for (sample_num = 0; sample_num < sample_count; sample_num++) {
+            for (channel_num = 0; channel_num < channel_count; channel_num++) {
+                uint32_t word = get_aes3_word(&aes_data_ptr[channel_num * 4]) & channel_masks[channel_num];
+                pcm_data_ptr[0] = (unsigned char)(word >> 4);
+                pcm_data_ptr[1] = (unsigned char)(word >> 12);
+                pcm_data_ptr[2] = (unsigned char)(word >> 20);
+                pcm_data_ptr += 3;
+            }
+            aes_data_ptr += 8 * 4;
+        }
+    }
+}
+
+static void deinterleave_audio_scalar(const unsigned char *input_data, uint32_t input_block_align,
+                                      uint32_t block_align, uint32_t sample_count,
+                                      unsigned char *output_data)
+{
+    uint32_t i;
+
+    // fixed size copies allow the compiler to use single loads and stores
+    switch (block_align)
+    {
+        case 2:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * 2], &input_data[i * input_block_align], 2);
+            break;
+        case 3:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * 3], &input_data[i * input_block_align], 3);
+            break;
+        case 4:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * 4], &input_data[i * input_block_align], 4);
+            break;
+        default:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * block_align], &input_data[i * input_block_align], block_align);
+            break;
+    }
+}
+
+static void interleave_audio_scalar(const unsigned char *input_data, uint32_t block_align,
+                                    uint32_t output_block_align, uint32_t sample_count,
+                                    unsigned char *output_data)
+{
+    uint32_t i;
+
+    switch (block_align)
+    {
+        case 2:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_block_align], &input_data[i * 2], 2);
+            break;
+        case 3:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_block_align], &input_data[i * 3], 3);
+            break;
+        case 4:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_block_align], &input_data[i * 4], 4);
+            break;
+        default:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_block_align], &input_data[i * block_align], block_align);
+            break;
+    }
+}
+
+
+#if defined(BMX_HAVE_X86_SIMD)
+
+// The SIMD functions below process whole blocks of samples and return the number of samples
+// converted. The remaining samples are converted by the scalar functions.
+
+static inline __m128i get_aes3_channel_masks_128(uint8_t valid_flags, uint8_t first_channel)
+{
+    return _mm_setr_epi32((valid_flags & (1 << (first_channel    ))) ? -1 : 0,
+                          (valid_flags & (1 << (first_channel + 1))) ? -1 : 0,
+                          (valid_flags & (1 << (first_channel + 2))) ? -1 : 0,
+                          (valid_flags & (1 << (first_channel + 3))) ? -1 : 0);
+}
+
+// sign extend the 16-bit sample in bits 12..27 so that the signed saturating pack is exact
+static inline __m128i aes3_to_pcm16_128(__m128i words, __m128i masks)
+{
+    return _mm_srai_epi32(_mm_slli_epi32(_mm_and_si128(words, masks), 4), 16);
+}
+
+static uint32_t convert_aes3_to_mc_pcm16_sse2(const unsigned char *aes_data_ptr, uint32_t sample_count,
+                                              uint8_t channel_count, uint8_t valid_flags,
+                                              unsigned char *pcm_data_ptr)
+{
+    __m128i masks_0_3 = get_aes3_channel_masks_128(valid_flags, 0);
+    __m128i masks_4_7 = get_aes3_channel_masks_128(valid_flags, 4);
+    uint32_t i = 0;
+
+    if (channel_count == 8) {
+        for (; i + 2 <= sample_count; i += 2) {
+            const unsigned char *input = &aes_data_ptr[i * 32];
+            __m128i s0 = aes3_to_pcm16_128(_mm_loadu_si128((const __m128i*)(input     )), masks_0_3);
+            __m128i s1 = aes3_to_pcm16_128(_mm_loadu_si128((const __m128i*)(input + 16)), masks_4_7);
+            __m128i s2 = aes3_to_pcm16_128(_mm_loadu_si128((const __m128i*)(input + 32)), masks_0_3);
+            __m128i s3 = aes3_to_pcm16_128(_mm_loadu_si128((const __m128i*)(input + 48)), masks_4_7);
+            _mm_storeu_si128((__m128i*)&pcm_data_ptr[i * 16     ], _mm_packs_epi32(s0, s1));
+            _mm_storeu_si128((__m128i*)&pcm_data_ptr[i * 16 + 16], _mm_packs_epi32(s2, s3));
+        }
+    } else if (channel_count == 4) {
+        for (; i + 2 <= sample_count; i += 2) {
+            const unsigned char *input = &aes_data_ptr[i * 32];
+            __m128i s0 = aes3_to_pcm16_128(_mm_loadu_si128((const __m128i*)(input     )), masks_0_3);
+            __m128i s1 = aes3_to_pcm16_128(_mm_loadu_si128((const __m128i*)(input + 32)), masks_0_3);
+            _mm_storeu_si128((__m128i*)&pcm_data_ptr[i * 8], _mm_packs_epi32(s0, s1));
+        }
+    }
+
+    return i;
+}
+
+// pack the 3 low bytes of each 32-bit word in 4 registers into 48 bytes
+static inline void store_packed_24bit(unsigned char *output, __m128i r0, __m128i r1, __m128i r2, __m128i r3)
+{
+    _mm_storeu_si128((__m128i*)(output     ), _mm_or_si128(r0, _mm_slli_si128(r1, 12)));
+    _mm_storeu_si128((__m128i*)(output + 16), _mm_or_si128(_mm_srli_si128(r1, 4), _mm_slli_si128(r2, 8)));
+    _mm_storeu_si128((__m128i*)(output + 32), _mm_or_si128(_mm_srli_si128(r2, 8), _mm_slli_si128(r3, 4)));
+}
+
+BMX_TARGET_ISA("ssse3")
+static inline __m128i aes3_to_pcm24_128(__m128i words, __m128i masks, __m128i shuffle)
+{
+    return _mm_shuffle_epi8(_mm_and_si128(_mm_srli_epi32(words, 4), masks), shuffle);
+}
+
+BMX_TARGET_ISA("ssse3")
+static uint32_t convert_aes3_to_mc_pcm24_ssse3(const unsigned char *aes_data_ptr, uint32_t sample_count,
+                                               uint8_t channel_count, uint8_t valid_flags,
+                                               unsigned char *pcm_data_ptr)
+{
+    __m128i masks_0_3 = get_aes3_channel_masks_128(valid_flags, 0);
+    __m128i masks_4_7 = get_aes3_channel_masks_128(valid_flags, 4);
+    __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    uint32_t i = 0;
+
+    if (channel_count == 8) {
+        for (; i + 2 <= sample_count; i += 2) {
+            const unsigned char *input = &aes_data_ptr[i * 32];
+            store_packed_24bit(&pcm_data_ptr[i * 24],
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input     )), masks_0_3, shuffle),
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input + 16)), masks_4_7, shuffle),
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input + 32)), masks_0_3, shuffle),
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input + 48)), masks_4_7, shuffle));
+        }
+    } else if (channel_count == 4) {
+        for (; i + 4 <= sample_count; i += 4) {
+            const unsigned char *input = &aes_data_ptr[i * 32];
+            store_packed_24bit(&pcm_data_ptr[i * 12],
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input     )), masks_0_3, shuffle),
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input + 32)), masks_0_3, shuffle),
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input + 64)), masks_0_3, shuffle),
+                               aes3_to_pcm24_128(_mm_loadu_si128((const __m128i*)(input + 96)), masks_0_3, shuffle));
+        }
+    }
+
+    return i;
+}
+
+BMX_TARGET_ISA("avx2")
+static inline __m256i aes3_to_pcm16_256(__m256i words, __m256i masks)
+{
+    return _mm256_srai_epi32(_mm256_slli_epi32(_mm256_and_si256(words, masks), 4), 16);
+}
+
+BMX_TARGET_ISA("avx2")
+static uint32_t convert_aes3_to_mc_pcm16_avx2(const unsigned char *aes_data_ptr, uint32_t sample_count,
+                                              uint8_t channel_count, uint8_t valid_flags,
+                                              unsigned char *pcm_data_ptr)
+{
+    if (channel_count != 8)
+        return 0;
+
+    __m256i masks = _mm256_setr_epi32((valid_flags & 0x01) ? -1 : 0, (valid_flags & 0x02) ? -1 : 0,
+                                      (valid_flags & 0x04) ? -1 : 0, (valid_flags & 0x08) ? -1 : 0,
+                                      (valid_flags & 0x10) ? -1 : 0, (valid_flags & 0x20) ? -1 : 0,
+                                      (valid_flags & 0x40) ? -1 : 0, (valid_flags & 0x80) ? -1 : 0);
+    uint32_t i = 0;
+
+    for (; i + 4 <= sample_count; i += 4) {
+        const unsigned char *input = &aes_data_ptr[i * 32];
+        __m256i s0 = aes3_to_pcm16_256(_mm256_loadu_si256((const __m256i*)(input     )), masks);
+        __m256i s1 = aes3_to_pcm16_256(_mm256_loadu_si256((const __m256i*)(input + 32)), masks);
+        __m256i s2 = aes3_to_pcm16_256(_mm256_loadu_si256((const __m256i*)(input + 64)), masks);
+        __m256i s3 = aes3_to_pcm16_256(_mm256_loadu_si256((const __m256i*)(input + 96)), masks);
+        // the pack operates on each 128-bit lane and so the 64-bit blocks are re-ordered
+        _mm256_storeu_si256((__m256i*)&pcm_data_ptr[i * 16     ],
+                            _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), 0xd8));
+        _mm256_storeu_si256((__m256i*)&pcm_data_ptr[i * 16 + 32],
+                            _mm256_permute4x64_epi64(_mm256_packs_epi32(s2, s3), 0xd8));
+    }
+
+    return i;
+}
+
+// select the 16-bit channel 0 (low half) or 1 (high half) from 32-bit stereo frames, sign extended
+static inline __m128i select_stereo_16bit_128(__m128i frames, uint16_t channel_num)
+{
+    if (channel_num == 0)
+        return _mm_srai_epi32(_mm_slli_epi32(frames, 16), 16);
+    else
+        return _mm_srai_epi32(frames, 16);
+}
+
+static uint32_t deinterleave_audio_sse2(const unsigned char *input_data, uint32_t bits_per_sample,
+                                        uint16_t channel_count, uint16_t channel_num, uint32_t sample_count,
+                                        unsigned char *output_data)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    uint32_t i = 0;
+
+    if (block_align == 2 && channel_count == 2) {
+        for (; i + 8 <= sample_count; i += 8) {
+            const unsigned char *input = &input_data[i * 4];
+            __m128i s0 = select_stereo_16bit_128(_mm_loadu_si128((const __m128i*)(input     )), channel_num);
+            __m128i s1 = select_stereo_16bit_128(_mm_loadu_si128((const __m128i*)(input + 16)), channel_num);
+            _mm_storeu_si128((__m128i*)&output_data[i * 2], _mm_packs_epi32(s0, s1));
+        }
+    } else if (block_align == 2 && channel_count == 4) {
+        // first select the pair of channels from the 64-bit frames and then the channel from the pair
+        for (; i + 8 <= sample_count; i += 8) {
+            const unsigned char *input = &input_data[i * 8];
+            __m128i f0 = _mm_loadu_si128((const __m128i*)(input     ));
+            __m128i f1 = _mm_loadu_si128((const __m128i*)(input + 16));
+            __m128i f2 = _mm_loadu_si128((const __m128i*)(input + 32));
+            __m128i f3 = _mm_loadu_si128((const __m128i*)(input + 48));
+            if (channel_num < 2) {
+                f0 = _mm_shuffle_epi32(f0, _MM_SHUFFLE(3, 1, 2, 0));
+                f1 = _mm_shuffle_epi32(f1, _MM_SHUFFLE(3, 1, 2, 0));
+                f2 = _mm_shuffle_epi32(f2, _MM_SHUFFLE(3, 1, 2, 0));
+                f3 = _mm_shuffle_epi32(f3, _MM_SHUFFLE(3, 1, 2, 0));
+            } else {
+                f0 = _mm_shuffle_epi32(f0, _MM_SHUFFLE(2, 0, 3, 1));
+                f1 = _mm_shuffle_epi32(f1, _MM_SHUFFLE(2, 0, 3, 1));
+                f2 = _mm_shuffle_epi32(f2, _MM_SHUFFLE(2, 0, 3, 1));
+                f3 = _mm_shuffle_epi32(f3, _MM_SHUFFLE(2, 0, 3, 1));
+            }
+            __m128i s0 = select_stereo_16bit_128(_mm_unpacklo_epi64(f0, f1), channel_num & 1);
+            __m128i s1 = select_stereo_16bit_128(_mm_unpacklo_epi64(f2, f3), channel_num & 1);
+            _mm_storeu_si128((__m128i*)&output_data[i * 2], _mm_packs_epi32(s0, s1));
+        }
+    } else if (block_align == 4 && channel_count == 2) {
+        for (; i + 4 <= sample_count; i += 4) {
+            const unsigned char *input = &input_data[i * 8];
+            __m128 f0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(input     )));
+            __m128 f1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(input + 16)));
+            __m128 s;
+            if (channel_num == 0)
+                s = _mm_shuffle_ps(f0, f1, _MM_SHUFFLE(2, 0, 2, 0));
+            else
+                s = _mm_shuffle_ps(f0, f1, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_si128((__m128i*)&output_data[i * 4], _mm_castps_si128(s));
+        }
+    }
+
+    return i;
+}
+
+BMX_TARGET_ISA("ssse3")
+static uint32_t deinterleave_audio_ssse3(const unsigned char *input_data, uint32_t bits_per_sample,
+                                         uint16_t channel_count, uint16_t channel_num, uint32_t sample_count,
+                                         unsigned char *output_data)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    uint32_t i = 0;
+
+    if (block_align == 3 && channel_count == 2) {
+        // each 16 byte load contains 2 whole 6 byte frames
+        __m128i shuffle;
+        if (channel_num == 0)
+            shuffle = _mm_setr_epi8(0, 1, 2, 6, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        else
+            shuffle = _mm_setr_epi8(3, 4, 5, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        // the last load reads 16 bytes from frame i + 6
+        for (; i + 9 <= sample_count; i += 8) {
+            const unsigned char *input = &input_data[i * 6];
+            __m128i s0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input     )), shuffle);
+            __m128i s1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 12)), shuffle);
+            __m128i s2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 24)), shuffle);
+            __m128i s3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 36)), shuffle);
+            __m128i r0 = _mm_or_si128(s0, _mm_slli_si128(s1, 6));
+            __m128i r1 = _mm_or_si128(s2, _mm_slli_si128(s3, 6));
+            _mm_storeu_si128((__m128i*)&output_data[i * 3], _mm_or_si128(r0, _mm_slli_si128(r1, 12)));
+            _mm_storel_epi64((__m128i*)&output_data[i * 3 + 16], _mm_srli_si128(r1, 4));
+        }
+    }
+
+    return i;
+}
+
+BMX_TARGET_ISA("avx2")
+static uint32_t deinterleave_audio_avx2(const unsigned char *input_data, uint32_t bits_per_sample,
+                                        uint16_t channel_count, uint16_t channel_num, uint32_t sample_count,
+                                        unsigned char *output_data)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    uint32_t i = 0;
+
+    if (block_align == 2 && channel_count == 2) {
+        for (; i + 16 <= sample_count; i += 16) {
+            const unsigned char *input = &input_data[i * 4];
+            __m256i f0 = _mm256_loadu_si256((const __m256i*)(input     ));
+            __m256i f1 = _mm256_loadu_si256((const __m256i*)(input + 32));
+            if (channel_num == 0) {
+                f0 = _mm256_srai_epi32(_mm256_slli_epi32(f0, 16), 16);
+                f1 = _mm256_srai_epi32(_mm256_slli_epi32(f1, 16), 16);
+            } else {
+                f0 = _mm256_srai_epi32(f0, 16);
+                f1 = _mm256_srai_epi32(f1, 16);
+            }
+            _mm256_storeu_si256((__m256i*)&output_data[i * 2],
+                                _mm256_permute4x64_epi64(_mm256_packs_epi32(f0, f1), 0xd8));
+        }
+    }
+
+    return i;
+}
+
+static uint32_t interleave_audio_sse2(const unsigned char *input_data, uint32_t bits_per_sample,
+                                      uint16_t channel_count, uint16_t channel_num, uint32_t sample_count,
+                                      unsigned char *output_data)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    uint32_t i = 0;
+
+    // the other channel's samples in the output are preserved by blending with a mask
+    if (block_align == 2 && channel_count == 2) {
+        __m128i other_mask = (channel_num == 0 ? _mm_set1_epi32((int)0xffff0000) : _mm_set1_epi32(0x0000ffff));
+        for (; i + 8 <= sample_count; i += 8) {
+            __m128i s = _mm_loadu_si128((const __m128i*)&input_data[i * 2]);
+            __m128i s0 = _mm_unpacklo_epi16(s, s);
+            __m128i s1 = _mm_unpackhi_epi16(s, s);
+            unsigned char *output = &output_data[i * 4];
+            __m128i o0 = _mm_loadu_si128((const __m128i*)(output     ));
+            __m128i o1 = _mm_loadu_si128((const __m128i*)(output + 16));
+            o0 = _mm_or_si128(_mm_and_si128(o0, other_mask), _mm_andnot_si128(other_mask, s0));
+            o1 = _mm_or_si128(_mm_and_si128(o1, other_mask), _mm_andnot_si128(other_mask, s1));
+            _mm_storeu_si128((__m128i*)(output     ), o0);
+            _mm_storeu_si128((__m128i*)(output + 16), o1);
+        }
+    } else if (block_align == 4 && channel_count == 2) {
+        __m128i other_mask = (channel_num == 0 ? _mm_setr_epi32(0, -1, 0, -1) : _mm_setr_epi32(-1, 0, -1, 0));
+        for (; i + 4 <= sample_count; i += 4) {
+            __m128i s = _mm_loadu_si128((const __m128i*)&input_data[i * 4]);
+            __m128i s0 = _mm_unpacklo_epi32(s, s);
+            __m128i s1 = _mm_unpackhi_epi32(s, s);
+            unsigned char *output = &output_data[i * 8];
+            __m128i o0 = _mm_loadu_si128((const __m128i*)(output     ));
+            __m128i o1 = _mm_loadu_si128((const __m128i*)(output + 16));
+            o0 = _mm_or_si128(_mm_and_si128(o0, other_mask), _mm_andnot_si128(other_mask, s0));
+            o1 = _mm_or_si128(_mm_and_si128(o1, other_mask), _mm_andnot_si128(other_mask, s1));
+            _mm_storeu_si128((__m128i*)(output     ), o0);
+            _mm_storeu_si128((__m128i*)(output + 16), o1);
+        }
+    }
+
+    return i;
+}
+
+// the multi-input interleave kernels transpose a group of inputs, storing each sample's group of
+// channels at the output block stride
+
+static uint32_t interleave_inputs_16bit_x8_sse2(const unsigned char * const *input_data, uint32_t sample_count,
+                                                unsigned char *output_data, uint32_t output_block_align)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&input_data[0][i * 2]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&input_data[1][i * 2]);
+        __m128i c = _mm_loadu_si128((const __m128i*)&input_data[2][i * 2]);
+        __m128i d = _mm_loadu_si128((const __m128i*)&input_data[3][i * 2]);
+        __m128i e = _mm_loadu_si128((const __m128i*)&input_data[4][i * 2]);
+        __m128i f = _mm_loadu_si128((const __m128i*)&input_data[5][i * 2]);
+        __m128i g = _mm_loadu_si128((const __m128i*)&input_data[6][i * 2]);
+        __m128i h = _mm_loadu_si128((const __m128i*)&input_data[7][i * 2]);
+
+        __m128i ab_lo = _mm_unpacklo_epi16(a, b);
+        __m128i ab_hi = _mm_unpackhi_epi16(a, b);
+        __m128i cd_lo = _mm_unpacklo_epi16(c, d);
+        __m128i cd_hi = _mm_unpackhi_epi16(c, d);
+        __m128i ef_lo = _mm_unpacklo_epi16(e, f);
+        __m128i ef_hi = _mm_unpackhi_epi16(e, f);
+        __m128i gh_lo = _mm_unpacklo_epi16(g, h);
+        __m128i gh_hi = _mm_unpackhi_epi16(g, h);
+
+        __m128i abcd_01 = _mm_unpacklo_epi32(ab_lo, cd_lo);
+        __m128i abcd_23 = _mm_unpackhi_epi32(ab_lo, cd_lo);
+        __m128i abcd_45 = _mm_unpacklo_epi32(ab_hi, cd_hi);
+        __m128i abcd_67 = _mm_unpackhi_epi32(ab_hi, cd_hi);
+        __m128i efgh_01 = _mm_unpacklo_epi32(ef_lo, gh_lo);
+        __m128i efgh_23 = _mm_unpackhi_epi32(ef_lo, gh_lo);
+        __m128i efgh_45 = _mm_unpacklo_epi32(ef_hi, gh_hi);
+        __m128i efgh_67 = _mm_unpackhi_epi32(ef_hi, gh_hi);
+
+        unsigned char *output = &output_data[i * output_block_align];
+        _mm_storeu_si128((__m128i*)(output                         ), _mm_unpacklo_epi64(abcd_01, efgh_01));
+        _mm_storeu_si128((__m128i*)(output +     output_block_align), _mm_unpackhi_epi64(abcd_01, efgh_01));
+        _mm_storeu_si128((__m128i*)(output + 2 * output_block_align), _mm_unpacklo_epi64(abcd_23, efgh_23));
+        _mm_storeu_si128((__m128i*)(output + 3 * output_block_align), _mm_unpackhi_epi64(abcd_23, efgh_23));
+        _mm_storeu_si128((__m128i*)(output + 4 * output_block_align), _mm_unpacklo_epi64(abcd_45, efgh_45));
+        _mm_storeu_si128((__m128i*)(output + 5 * output_block_align), _mm_unpackhi_epi64(abcd_45, efgh_45));
+        _mm_storeu_si128((__m128i*)(output + 6 * output_block_align), _mm_unpacklo_epi64(abcd_67, efgh_67));
+        _mm_storeu_si128((__m128i*)(output + 7 * output_block_align), _mm_unpackhi_epi64(abcd_67, efgh_67));
+    }
+
+    return i;
+}
+
+static inline void store_low_high_64(unsigned char *output, uint32_t output_block_align, __m128i r)
+{
+    _mm_storel_epi64((__m128i*)(output                     ), r);
+    _mm_storel_epi64((__m128i*)(output + output_block_align), _mm_srli_si128(r, 8));
+}
+
+static uint32_t interleave_inputs_16bit_x4_sse2(const unsigned char * const *input_data, uint32_t sample_count,
+                                                unsigned char *output_data, uint32_t output_block_align)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&input_data[0][i * 2]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&input_data[1][i * 2]);
+        __m128i c = _mm_loadu_si128((const __m128i*)&input_data[2][i * 2]);
+        __m128i d = _mm_loadu_si128((const __m128i*)&input_data[3][i * 2]);
+
+        __m128i ab_lo = _mm_unpacklo_epi16(a, b);
+        __m128i ab_hi = _mm_unpackhi_epi16(a, b);
+        __m128i cd_lo = _mm_unpacklo_epi16(c, d);
+        __m128i cd_hi = _mm_unpackhi_epi16(c, d);
+
+        unsigned char *output = &output_data[i * output_block_align];
+        store_low_high_64(output,                          output_block_align, _mm_unpacklo_epi32(ab_lo, cd_lo));
+        store_low_high_64(output + 2 * output_block_align, output_block_align, _mm_unpackhi_epi32(ab_lo, cd_lo));
+        store_low_high_64(output + 4 * output_block_align, output_block_align, _mm_unpacklo_epi32(ab_hi, cd_hi));
+        store_low_high_64(output + 6 * output_block_align, output_block_align, _mm_unpackhi_epi32(ab_hi, cd_hi));
+    }
+
+    return i;
+}
+
+static uint32_t interleave_inputs_32bit_x4_sse2(const unsigned char * const *input_data, uint32_t sample_count,
+                                                unsigned char *output_data, uint32_t output_block_align)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= sample_count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&input_data[0][i * 4]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&input_data[1][i * 4]);
+        __m128i c = _mm_loadu_si128((const __m128i*)&input_data[2][i * 4]);
+        __m128i d = _mm_loadu_si128((const __m128i*)&input_data[3][i * 4]);
+
+        __m128i ab_01 = _mm_unpacklo_epi32(a, b);
+        __m128i ab_23 = _mm_unpackhi_epi32(a, b);
+        __m128i cd_01 = _mm_unpacklo_epi32(c, d);
+        __m128i cd_23 = _mm_unpackhi_epi32(c, d);
+
+        unsigned char *output = &output_data[i * output_block_align];
+        _mm_storeu_si128((__m128i*)(output                         ), _mm_unpacklo_epi64(ab_01, cd_01));
+        _mm_storeu_si128((__m128i*)(output +     output_block_align), _mm_unpackhi_epi64(ab_01, cd_01));
+        _mm_storeu_si128((__m128i*)(output + 2 * output_block_align), _mm_unpacklo_epi64(ab_23, cd_23));
+        _mm_storeu_si128((__m128i*)(output + 3 * output_block_align), _mm_unpackhi_epi64(ab_23, cd_23));
+    }
+
+    return i;
+}
+
+static uint32_t interleave_inputs_32bit_x2_sse2(const unsigned char * const *input_data, uint32_t sample_count,
+                                                unsigned char *output_data, uint32_t output_block_align)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= sample_count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&input_data[0][i * 4]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&input_data[1][i * 4]);
+
+        unsigned char *output = &output_data[i * output_block_align];
+        store_low_high_64(output,                          output_block_align, _mm_unpacklo_epi32(a, b));
+        store_low_high_64(output + 2 * output_block_align, output_block_align, _mm_unpackhi_epi32(a, b));
+    }
+
+    return i;
+}
+
+BMX_TARGET_ISA("ssse3")
+static inline void store_24bit_x4(unsigned char *output, __m128i r, __m128i pack)
+{
+    __m128i packed = _mm_shuffle_epi8(r, pack);
+    _mm_storel_epi64((__m128i*)output, packed);
+    uint32_t last = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+    memcpy(output + 8, &last, 4);
+}
+
+BMX_TARGET_ISA("ssse3")
+static uint32_t interleave_inputs_24bit_x4_ssse3(const unsigned char * const *input_data, uint32_t sample_count,
+                                                 unsigned char *output_data, uint32_t output_block_align)
+{
+    __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    uint32_t i = 0;
+
+    // each 16 byte load reads 4 bytes beyond the 4 samples, hence the requirement for 2 more samples
+    for (; i + 6 <= sample_count; i += 4) {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&input_data[0][i * 3]), expand);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&input_data[1][i * 3]), expand);
+        __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&input_data[2][i * 3]), expand);
+        __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&input_data[3][i * 3]), expand);
+
+        __m128i ab_01 = _mm_unpacklo_epi32(a, b);
+        __m128i ab_23 = _mm_unpackhi_epi32(a, b);
+        __m128i cd_01 = _mm_unpacklo_epi32(c, d);
+        __m128i cd_23 = _mm_unpackhi_epi32(c, d);
+
+        unsigned char *output = &output_data[i * output_block_align];
+        store_24bit_x4(output,                          _mm_unpacklo_epi64(ab_01, cd_01), pack);
+        store_24bit_x4(output +     output_block_align, _mm_unpackhi_epi64(ab_01, cd_01), pack);
+        store_24bit_x4(output + 2 * output_block_align, _mm_unpacklo_epi64(ab_23, cd_23), pack);
+        store_24bit_x4(output + 3 * output_block_align, _mm_unpackhi_epi64(ab_23, cd_23), pack);
+    }
+
+    return i;
+}
+
+// the multi-output deinterleave kernels load a group of channels from each input block and transpose
+// them into the outputs
+
+static uint32_t deinterleave_outputs_16bit_x8_sse2(const unsigned char *input_data, uint32_t input_block_align,
+                                                   uint32_t sample_count, unsigned char * const *output_data)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        const unsigned char *input = &input_data[i * input_block_align];
+        __m128i s0 = _mm_loadu_si128((const __m128i*)(input                        ));
+        __m128i s1 = _mm_loadu_si128((const __m128i*)(input +     input_block_align));
+        __m128i s2 = _mm_loadu_si128((const __m128i*)(input + 2 * input_block_align));
+        __m128i s3 = _mm_loadu_si128((const __m128i*)(input + 3 * input_block_align));
+        __m128i s4 = _mm_loadu_si128((const __m128i*)(input + 4 * input_block_align));
+        __m128i s5 = _mm_loadu_si128((const __m128i*)(input + 5 * input_block_align));
+        __m128i s6 = _mm_loadu_si128((const __m128i*)(input + 6 * input_block_align));
+        __m128i s7 = _mm_loadu_si128((const __m128i*)(input + 7 * input_block_align));
+
+        // the 8x8 transpose is the same as the one used for interleaving
+        __m128i s01_lo = _mm_unpacklo_epi16(s0, s1);
+        __m128i s01_hi = _mm_unpackhi_epi16(s0, s1);
+        __m128i s23_lo = _mm_unpacklo_epi16(s2, s3);
+        __m128i s23_hi = _mm_unpackhi_epi16(s2, s3);
+        __m128i s45_lo = _mm_unpacklo_epi16(s4, s5);
+        __m128i s45_hi = _mm_unpackhi_epi16(s4, s5);
+        __m128i s67_lo = _mm_unpacklo_epi16(s6, s7);
+        __m128i s67_hi = _mm_unpackhi_epi16(s6, s7);
+
+        __m128i s0123_ab = _mm_unpacklo_epi32(s01_lo, s23_lo);
+        __m128i s0123_cd = _mm_unpackhi_epi32(s01_lo, s23_lo);
+        __m128i s0123_ef = _mm_unpacklo_epi32(s01_hi, s23_hi);
+        __m128i s0123_gh = _mm_unpackhi_epi32(s01_hi, s23_hi);
+        __m128i s4567_ab = _mm_unpacklo_epi32(s45_lo, s67_lo);
+        __m128i s4567_cd = _mm_unpackhi_epi32(s45_lo, s67_lo);
+        __m128i s4567_ef = _mm_unpacklo_epi32(s45_hi, s67_hi);
+        __m128i s4567_gh = _mm_unpackhi_epi32(s45_hi, s67_hi);
+
+        _mm_storeu_si128((__m128i*)&output_data[0][i * 2], _mm_unpacklo_epi64(s0123_ab, s4567_ab));
+        _mm_storeu_si128((__m128i*)&output_data[1][i * 2], _mm_unpackhi_epi64(s0123_ab, s4567_ab));
+        _mm_storeu_si128((__m128i*)&output_data[2][i * 2], _mm_unpacklo_epi64(s0123_cd, s4567_cd));
+        _mm_storeu_si128((__m128i*)&output_data[3][i * 2], _mm_unpackhi_epi64(s0123_cd, s4567_cd));
+        _mm_storeu_si128((__m128i*)&output_data[4][i * 2], _mm_unpacklo_epi64(s0123_ef, s4567_ef));
+        _mm_storeu_si128((__m128i*)&output_data[5][i * 2], _mm_unpackhi_epi64(s0123_ef, s4567_ef));
+        _mm_storeu_si128((__m128i*)&output_data[6][i * 2], _mm_unpacklo_epi64(s0123_gh, s4567_gh));
+        _mm_storeu_si128((__m128i*)&output_data[7][i * 2], _mm_unpackhi_epi64(s0123_gh, s4567_gh));
+    }
+
+    return i;
+}
+
+static uint32_t deinterleave_outputs_16bit_x4_sse2(const unsigned char *input_data, uint32_t input_block_align,
+                                                   uint32_t sample_count, unsigned char * const *output_data)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        const unsigned char *input = &input_data[i * input_block_align];
+        __m128i s0 = _mm_loadl_epi64((const __m128i*)(input                        ));
+        __m128i s1 = _mm_loadl_epi64((const __m128i*)(input +     input_block_align));
+        __m128i s2 = _mm_loadl_epi64((const __m128i*)(input + 2 * input_block_align));
+        __m128i s3 = _mm_loadl_epi64((const __m128i*)(input + 3 * input_block_align));
+        __m128i s4 = _mm_loadl_epi64((const __m128i*)(input + 4 * input_block_align));
+        __m128i s5 = _mm_loadl_epi64((const __m128i*)(input + 5 * input_block_align));
+        __m128i s6 = _mm_loadl_epi64((const __m128i*)(input + 6 * input_block_align));
+        __m128i s7 = _mm_loadl_epi64((const __m128i*)(input + 7 * input_block_align));
+
+        __m128i s01 = _mm_unpacklo_epi16(s0, s1);
+        __m128i s23 = _mm_unpacklo_epi16(s2, s3);
+        __m128i s45 = _mm_unpacklo_epi16(s4, s5);
+        __m128i s67 = _mm_unpacklo_epi16(s6, s7);
+
+        __m128i s0123_ab = _mm_unpacklo_epi32(s01, s23);
+        __m128i s0123_cd = _mm_unpackhi_epi32(s01, s23);
+        __m128i s4567_ab = _mm_unpacklo_epi32(s45, s67);
+        __m128i s4567_cd = _mm_unpackhi_epi32(s45, s67);
+
+        _mm_storeu_si128((__m128i*)&output_data[0][i * 2], _mm_unpacklo_epi64(s0123_ab, s4567_ab));
+        _mm_storeu_si128((__m128i*)&output_data[1][i * 2], _mm_unpackhi_epi64(s0123_ab, s4567_ab));
+        _mm_storeu_si128((__m128i*)&output_data[2][i * 2], _mm_unpacklo_epi64(s0123_cd, s4567_cd));
+        _mm_storeu_si128((__m128i*)&output_data[3][i * 2], _mm_unpackhi_epi64(s0123_cd, s4567_cd));
+    }
+
+    return i;
+}
+
+static inline __m128i load_32bit_pair(const unsigned char *input, uint32_t input_block_align)
+{
+    uint32_t s0, s1;
+    memcpy(&s0, input, 4);
+    memcpy(&s1, input + input_block_align, 4);
+    return _mm_unpacklo_epi32(_mm_cvtsi32_si128((int)s0), _mm_cvtsi32_si128((int)s1));
+}
+
+static uint32_t deinterleave_outputs_16bit_x2_sse2(const unsigned char *input_data, uint32_t input_block_align,
+                                                   uint32_t sample_count, unsigned char * const *output_data)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        const unsigned char *input = &input_data[i * input_block_align];
+        __m128i s0123 = _mm_unpacklo_epi64(load_32bit_pair(input,                         input_block_align),
+                                           load_32bit_pair(input + 2 * input_block_align, input_block_align));
+        __m128i s4567 = _mm_unpacklo_epi64(load_32bit_pair(input + 4 * input_block_align, input_block_align),
+                                           load_32bit_pair(input + 6 * input_block_align, input_block_align));
+
+        // a0 b0 a1 b1 a2 b2 a3 b3 -> a0 a1 a2 a3 b0 b1 b2 b3
+        s0123 = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(s0123, 0xd8), 0xd8), 0xd8);
+        s4567 = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(s4567, 0xd8), 0xd8), 0xd8);
+
+        _mm_storeu_si128((__m128i*)&output_data[0][i * 2], _mm_unpacklo_epi64(s0123, s4567));
+        _mm_storeu_si128((__m128i*)&output_data[1][i * 2], _mm_unpackhi_epi64(s0123, s4567));
+    }
+
+    return i;
+}
+
+static uint32_t deinterleave_outputs_32bit_x4_sse2(const unsigned char *input_data, uint32_t input_block_align,
+                                                   uint32_t sample_count, unsigned char * const *output_data)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= sample_count; i += 4) {
+        const unsigned char *input = &input_data[i * input_block_align];
+        __m128i s0 = _mm_loadu_si128((const __m128i*)(input                        ));
+        __m128i s1 = _mm_loadu_si128((const __m128i*)(input +     input_block_align));
+        __m128i s2 = _mm_loadu_si128((const __m128i*)(input + 2 * input_block_align));
+        __m128i s3 = _mm_loadu_si128((const __m128i*)(input + 3 * input_block_align));
+
+        __m128i s01_ab = _mm_unpacklo_epi32(s0, s1);
+        __m128i s01_cd = _mm_unpackhi_epi32(s0, s1);
+        __m128i s23_ab = _mm_unpacklo_epi32(s2, s3);
+        __m128i s23_cd = _mm_unpackhi_epi32(s2, s3);
+
+        _mm_storeu_si128((__m128i*)&output_data[0][i * 4], _mm_unpacklo_epi64(s01_ab, s23_ab));
+        _mm_storeu_si128((__m128i*)&output_data[1][i * 4], _mm_unpackhi_epi64(s01_ab, s23_ab));
+        _mm_storeu_si128((__m128i*)&output_data[2][i * 4], _mm_unpacklo_epi64(s01_cd, s23_cd));
+        _mm_storeu_si128((__m128i*)&output_data[3][i * 4], _mm_unpackhi_epi64(s01_cd, s23_cd));
+    }
+
+    return i;
+}
+
+static uint32_t deinterleave_outputs_32bit_x2_sse2(const unsigned char *input_data, uint32_t input_block_align,
+                                                   uint32_t sample_count, unsigned char * const *output_data)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= sample_count; i += 4) {
+        const unsigned char *input = &input_data[i * input_block_align];
+        __m128i s01 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(input                    )),
+                                         _mm_loadl_epi64((const __m128i*)(input + input_block_align)));
+        __m128i s23 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(input + 2 * input_block_align)),
+                                         _mm_loadl_epi64((const __m128i*)(input + 3 * input_block_align)));
+
+        __m128i a0b0_a2b2 = _mm_unpacklo_epi32(s01, s23);
+        __m128i a1b1_a3b3 = _mm_unpackhi_epi32(s01, s23);
+
+        _mm_storeu_si128((__m128i*)&output_data[0][i * 4], _mm_unpacklo_epi32(a0b0_a2b2, a1b1_a3b3));
+        _mm_storeu_si128((__m128i*)&output_data[1][i * 4], _mm_unpackhi_epi32(a0b0_a2b2, a1b1_a3b3));
+    }
+
+    return i;
+}
+
+BMX_TARGET_ISA("ssse3")
+static uint32_t deinterleave_outputs_24bit_x4_ssse3(const unsigned char *input_data, uint32_t input_block_align,
+                                                    uint32_t sample_count, unsigned char * const *output_data)
+{
+    __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    uint32_t i = 0;
+
+    // each 16 byte load reads 4 bytes beyond the group's 12 bytes, which are within the next input block
+    for (; i + 5 <= sample_count; i += 4) {
+        const unsigned char *input = &input_data[i * input_block_align];
+        __m128i s0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input                        )), expand);
+        __m128i s1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input +     input_block_align)), expand);
+        __m128i s2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 2 * input_block_align)), expand);
+        __m128i s3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 3 * input_block_align)), expand);
+
+        __m128i s01_ab = _mm_unpacklo_epi32(s0, s1);
+        __m128i s01_cd = _mm_unpackhi_epi32(s0, s1);
+        __m128i s23_ab = _mm_unpacklo_epi32(s2, s3);
+        __m128i s23_cd = _mm_unpackhi_epi32(s2, s3);
+
+        store_24bit_x4(&output_data[0][i * 3], _mm_unpacklo_epi64(s01_ab, s23_ab), pack);
+        store_24bit_x4(&output_data[1][i * 3], _mm_unpackhi_epi64(s01_ab, s23_ab), pack);
+        store_24bit_x4(&output_data[2][i * 3], _mm_unpacklo_epi64(s01_cd, s23_cd), pack);
+        store_24bit_x4(&output_data[3][i * 3], _mm_unpackhi_epi64(s01_cd, s23_cd), pack);
+    }
+
+    return i;
+}
+
+#endif
+
 
 
 uint8_t bmx::get_aes3_channel_valid_flags(const unsigned char *aes3_data, uint32_t aes3_data_size)
@@ -71,31 +829,26 @@ uint32_t bmx::convert_aes3_to_pcm(const unsigned char *aes3_data, uint32_t aes3_
         return 4 + sample_count * 4 * 8;
     }
 
-    const unsigned char *aes_data_ptr = &aes3_data[4];
+    const unsigned char *aes_data_ptr = &aes3_data[4 + channel_num * 4];
     unsigned char *pcm_data_ptr = &pcm_data[0];
     uint16_t sample_num;
 
     if (block_align == 2) {
         for (sample_num = 0; sample_num < sample_count; sample_num++) {
-            aes_data_ptr += channel_num * 4;
-            pcm_data_ptr[0] = (aes_data_ptr[1] >> 4) |
-                              (aes_data_ptr[2] << 4);
-            pcm_data_ptr[1] = (aes_data_ptr[2] >> 4) |
-                              (aes_data_ptr[3] << 4);
+            uint32_t word = get_aes3_word(aes_data_ptr);
+            pcm_data_ptr[0] = (unsigned char)(word >> 12);
+            pcm_data_ptr[1] = (unsigned char)(word >> 20);
             pcm_data_ptr += 2;
-            aes_data_ptr += (8 - channel_num) * 4;
+            aes_data_ptr += 8 * 4;
         }
     } else {
         for (sample_num = 0; sample_num < sample_count; sample_num++) {
-            aes_data_ptr += channel_num * 4;
-            pcm_data_ptr[0] = (aes_data_ptr[0] >> 4) |
-                              (aes_data_ptr[1] << 4);
-            pcm_data_ptr[1] = (aes_data_ptr[1] >> 4) |
-                              (aes_data_ptr[2] << 4);
-            pcm_data_ptr[2] = (aes_data_ptr[2] >> 4) |
-                              (aes_data_ptr[3] << 4);
+            uint32_t word = get_aes3_word(aes_data_ptr);
+            pcm_data_ptr[0] = (unsigned char)(word >> 4);
+            pcm_data_ptr[1] = (unsigned char)(word >> 12);
+            pcm_data_ptr[2] = (unsigned char)(word >> 20);
             pcm_data_ptr += 3;
-            aes_data_ptr += (8 - channel_num) * 4;
+            aes_data_ptr += 8 * 4;
         }
     }
 
@@ -116,47 +869,26 @@ uint32_t bmx::convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t ae
     BMX_CHECK(pcm_data_size >= channel_count * bytes_per_sample * sample_count);
 
     const unsigned char *aes_data_ptr = &aes3_data[4];
-    unsigned char *pcm_data_ptr = &pcm_data[0];
-    uint16_t sample_num, channel_num;
+    uint32_t converted_count = 0;
 
+#if defined(BMX_HAVE_X86_SIMD)
     if (bytes_per_sample == 2) {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
-            for (channel_num = 0; channel_num < channel_count; channel_num++) {
-                if (valid_flags & (1 << channel_num)) {
-                    pcm_data_ptr[0] = (aes_data_ptr[1] >> 4) |
-                                      (aes_data_ptr[2] << 4);
-                    pcm_data_ptr[1] = (aes_data_ptr[2] >> 4) |
-                                      (aes_data_ptr[3] << 4);
-                } else {
-                    pcm_data_ptr[0] = 0x00;
-                    pcm_data_ptr[1] = 0x00;
-                }
-                pcm_data_ptr += 2;
-                aes_data_ptr += 4;
-            }
-            aes_data_ptr += (8 - channel_count) * 4;
-        }
+        if (cpu_has_avx2())
+            converted_count = convert_aes3_to_mc_pcm16_avx2(aes_data_ptr, sample_count, channel_count, valid_flags,
+                                                            pcm_data);
+        if (converted_count == 0 && cpu_has_sse2())
+            converted_count = convert_aes3_to_mc_pcm16_sse2(aes_data_ptr, sample_count, channel_count, valid_flags,
+                                                            pcm_data);
     } else {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
-            for (channel_num = 0; channel_num < channel_count; channel_num++) {
-                if (valid_flags & (1 << channel_num)) {
-                    pcm_data_ptr[0] = (aes_data_ptr[0] >> 4) |
-                                      (aes_data_ptr[1] << 4);
-                    pcm_data_ptr[1] = (aes_data_ptr[1] >> 4) |
-                                      (aes_data_ptr[2] << 4);
-                    pcm_data_ptr[2] = (aes_data_ptr[2] >> 4) |
-                                      (aes_data_ptr[3] << 4);
-                } else {
-                    pcm_data_ptr[0] = 0x00;
-                    pcm_data_ptr[1] = 0x00;
-                    pcm_data_ptr[2] = 0x00;
-                }
-                pcm_data_ptr += 3;
-                aes_data_ptr += 4;
-            }
-            aes_data_ptr += (8 - channel_count) * 4;
-        }
+        if (cpu_has_ssse3())
+            converted_count = convert_aes3_to_mc_pcm24_ssse3(aes_data_ptr, sample_count, channel_count, valid_flags,
+                                                             pcm_data);
     }
+#endif
+
+    convert_aes3_to_mc_pcm_scalar(&aes_data_ptr[converted_count * 8 * 4], sample_count - converted_count,
+                                  bytes_per_sample, channel_count, valid_flags,
+                                  &pcm_data[converted_count * channel_count * bytes_per_sample]);
 
     return 4 + sample_count * 4 * 8;
 }
@@ -169,13 +901,77 @@ void bmx::deinterleave_audio(const unsigned char *input_data, uint32_t input_dat
     uint32_t output_block_align = (bits_per_sample + 7) / 8;
     uint32_t channel_offset = channel_num * output_block_align;
     uint32_t sample_count = input_data_size / input_block_align;
-    uint32_t i, j;
+    uint32_t converted_count = 0;
 
     BMX_CHECK(output_data_size >= sample_count * output_block_align);
 
-    for (i = 0; i < sample_count; i++) {
-        for (j = 0; j < output_block_align; j++)
-            output_data[i * output_block_align + j] = input_data[i * input_block_align + channel_offset + j];
+#if defined(BMX_HAVE_X86_SIMD)
+    if (cpu_has_avx2())
+        converted_count = deinterleave_audio_avx2(input_data, bits_per_sample, channel_count, channel_num,
+                                                  sample_count, output_data);
+    if (converted_count == 0 && cpu_has_ssse3())
+        converted_count = deinterleave_audio_ssse3(input_data, bits_per_sample, channel_count, channel_num,
+                                                   sample_count, output_data);
+    if (converted_count == 0 && cpu_has_sse2())
+        converted_count = deinterleave_audio_sse2(input_data, bits_per_sample, channel_count, channel_num,
+                                                  sample_count, output_data);
+#endif
+
+    deinterleave_audio_scalar(&input_data[converted_count * input_block_align + channel_offset], input_block_align,
+                              output_block_align, sample_count - converted_count,
+                              &output_data[converted_count * output_block_align]);
+}
+
+void bmx::deinterleave_audio_outputs(const unsigned char *input_data, uint32_t input_block_align,
+                                     uint32_t sample_count, uint32_t output_block_align,
+                                     unsigned char * const *output_data, uint16_t output_count)
+{
+    uint16_t output_index = 0;
+    while (output_index < output_count) {
+        const unsigned char *group_input_data = &input_data[output_index * output_block_align];
+        unsigned char * const *group_output_data = &output_data[output_index];
+        uint16_t remainder = output_count - output_index;
+        uint16_t group_count = 1;
+        uint32_t converted_count = 0;
+
+#if defined(BMX_HAVE_X86_SIMD)
+        if (output_block_align == 2 && remainder >= 8 && cpu_has_sse2()) {
+            group_count = 8;
+            converted_count = deinterleave_outputs_16bit_x8_sse2(group_input_data, input_block_align,
+                                                                 sample_count, group_output_data);
+        } else if (output_block_align == 2 && remainder >= 4 && cpu_has_sse2()) {
+            group_count = 4;
+            converted_count = deinterleave_outputs_16bit_x4_sse2(group_input_data, input_block_align,
+                                                                 sample_count, group_output_data);
+        } else if (output_block_align == 2 && remainder >= 2 && cpu_has_sse2()) {
+            group_count = 2;
+            converted_count = deinterleave_outputs_16bit_x2_sse2(group_input_data, input_block_align,
+                                                                 sample_count, group_output_data);
+        } else if (output_block_align == 3 && remainder >= 4 && cpu_has_ssse3()) {
+            group_count = 4;
+            converted_count = deinterleave_outputs_24bit_x4_ssse3(group_input_data, input_block_align,
+                                                                  sample_count, group_output_data);
+        } else if (output_block_align == 4 && remainder >= 4 && cpu_has_sse2()) {
+            group_count = 4;
+            converted_count = deinterleave_outputs_32bit_x4_sse2(group_input_data, input_block_align,
+                                                                 sample_count, group_output_data);
+        } else if (output_block_align == 4 && remainder >= 2 && cpu_has_sse2()) {
+            group_count = 2;
+            converted_count = deinterleave_outputs_32bit_x2_sse2(group_input_data, input_block_align,
+                                                                 sample_count, group_output_data);
+        }
+#else
+        (void)remainder;
+#endif
+
+        uint16_t i;
+        for (i = 0; i < group_count; i++) {
+            deinterleave_audio_scalar(&group_input_data[converted_count * input_block_align + i * output_block_align],
+                                      input_block_align, output_block_align, sample_count - converted_count,
+                                      &group_output_data[i][converted_count * output_block_align]);
+        }
+
+        output_index += group_count;
     }
 }
 
@@ -187,12 +983,66 @@ void bmx::interleave_audio(const unsigned char *input_data, uint32_t input_data_
     uint32_t output_block_align = channel_count * input_block_align;
     uint32_t channel_offset = channel_num * input_block_align;
     uint32_t sample_count = input_data_size / input_block_align;
-    uint32_t i, j;
+    uint32_t converted_count = 0;
 
     BMX_CHECK(output_data_size >= sample_count * output_block_align);
 
-    for (i = 0; i < sample_count; i++) {
-        for (j = 0; j < input_block_align; j++)
-            output_data[i * output_block_align + channel_offset + j] = input_data[i * input_block_align + j];
+#if defined(BMX_HAVE_X86_SIMD)
+    if (cpu_has_sse2())
+        converted_count = interleave_audio_sse2(input_data, bits_per_sample, channel_count, channel_num,
+                                                sample_count, output_data);
+#endif
+
+    interleave_audio_scalar(&input_data[converted_count * input_block_align], input_block_align,
+                            output_block_align, sample_count - converted_count,
+                            &output_data[converted_count * output_block_align + channel_offset]);
+}
+
+void bmx::interleave_audio_inputs(const unsigned char * const *input_data, uint16_t input_count,
+                                  uint32_t input_block_align, uint32_t sample_count,
+                                  unsigned char *output_data, uint32_t output_block_align)
+{
+    uint16_t input_index = 0;
+    while (input_index < input_count) {
+        const unsigned char * const *group_input_data = &input_data[input_index];
+        unsigned char *group_output_data = &output_data[input_index * input_block_align];
+        uint16_t remainder = input_count - input_index;
+        uint16_t group_count = 1;
+        uint32_t converted_count = 0;
+
+#if defined(BMX_HAVE_X86_SIMD)
+        if (input_block_align == 2 && remainder >= 8 && cpu_has_sse2()) {
+            group_count = 8;
+            converted_count = interleave_inputs_16bit_x8_sse2(group_input_data, sample_count,
+                                                              group_output_data, output_block_align);
+        } else if (input_block_align == 2 && remainder >= 4 && cpu_has_sse2()) {
+            group_count = 4;
+            converted_count = interleave_inputs_16bit_x4_sse2(group_input_data, sample_count,
+                                                              group_output_data, output_block_align);
+        } else if (input_block_align == 3 && remainder >= 4 && cpu_has_ssse3()) {
+            group_count = 4;
+            converted_count = interleave_inputs_24bit_x4_ssse3(group_input_data, sample_count,
+                                                               group_output_data, output_block_align);
+        } else if (input_block_align == 4 && remainder >= 4 && cpu_has_sse2()) {
+            group_count = 4;
+            converted_count = interleave_inputs_32bit_x4_sse2(group_input_data, sample_count,
+                                                              group_output_data, output_block_align);
+        } else if (input_block_align == 4 && remainder >= 2 && cpu_has_sse2()) {
+            group_count = 2;
+            converted_count = interleave_inputs_32bit_x2_sse2(group_input_data, sample_count,
+                                                              group_output_data, output_block_align);
+        }
+#else
+        (void)remainder;
+#endif
+
+        uint16_t i;
+        for (i = 0; i < group_count; i++) {
+            interleave_audio_scalar(&group_input_data[i][converted_count * input_block_align], input_block_align,
+                                    output_block_align, sample_count - converted_count,
+                                    &group_output_data[converted_count * output_block_align + i * input_block_align]);
+        }
+
+        input_index += group_count;
     }
 }
@@ -153,6 +153,18 @@ static uint8_t intlog2(uint64_t n)
     return m;
 }
 
+static uint64_t get_uint64(const unsigned char *data)
+{
+    return (((uint64_t)data[0]) << 56) |
+           (((uint64_t)data[1]) << 48) |
+           (((uint64_t)data[2]) << 40) |
+           (((uint64_t)data[3]) << 32) |
+           (((uint64_t)data[4]) << 24) |
+           (((uint64_t)data[5]) << 16) |
+           (((uint64_t)data[6]) << 8) |
+             (uint64_t)data[7];
+}
+
 
 
 VC2GetBitBuffer::VC2GetBitBuffer(const unsigned char *data, uint32_t data_size)
@@ -193,6 +205,25 @@ uint64_t VC2GetBitBuffer::GetUIntLit(uint32_t byte_count)
 uint64_t VC2GetBitBuffer::GetUInt()
 {
     uint64_t value = 1;
+
+    // fast path: decode the interleaved (follow bit, data bit) pairs from a 64-bit window if it contains the
+    // terminating follow bit
+    if (mPos < mSize && mSize - mPos >= 8) {
+        uint64_t window = get_uint64(&mData[mPos]) << (mBitPos & 7);
+        uint64_t follow_bits = window & UINT64_C(0xaaaaaaaaaaaaaaaa);
+        if (follow_bits) {
+            uint8_t num_pairs = 0;
+            while (!(follow_bits & (UINT64_C(0x8000000000000000) >> (2 * num_pairs))))
+                num_pairs++;
+            uint8_t i;
+            for (i = 0; i < num_pairs; i++)
+                value = (value << 1) | ((window >> (62 - 2 * i)) & 1);
+            mBitPos += 2 * num_pairs + 1;
+            mPos = (uint32_t)(mBitPos >> 3);
+            return value - 1;
+        }
+    }
+
     while (GetBit() == 0) {
         value <<= 1;
         if (GetBit() == 1)
@@ -33,24 +33,108 @@
 #include "config.h"
 #endif
 
+#include <cstring>
+
+#include <mutex>
+
 #include <bmx/frame/Frame.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+#include <mxf/mxf_utils.h>
+
 using namespace std;
 using namespace bmx;
 
 
 
+typedef struct
+{
+    const char *id;
+    string id_str;
+} RegisteredMetadataId;
+
+static mutex &get_metadata_id_mutex()
+{
+    static mutex id_mutex;
+    return id_mutex;
+}
+
+static vector<RegisteredMetadataId> &get_metadata_ids()
+{
+    static vector<RegisteredMetadataId> ids;
+    return ids;
+}
+
+
+
+FrameMetadataId FrameMetadata::RegisterId(const char *id)
+{
+    lock_guard<mutex> lock(get_metadata_id_mutex());
+    vector<RegisteredMetadataId> &ids = get_metadata_ids();
+
+    // ids are usually string constants and so the pointer comparison avoids the string compare
+    size_t i;
+    for (i = 0; i < ids.size(); i++) {
+        if (ids[i].id == id)
+            return (FrameMetadataId)i;
+    }
+    for (i = 0; i < ids.size(); i++) {
+        if (ids[i].id_str == id)
+            return (FrameMetadataId)i;
+    }
+
+    BMX_CHECK(ids.size() < 0xffff);
+    RegisteredMetadataId reg_id;
+    reg_id.id = id;
+    reg_id.id_str = id;
+    ids.push_back(reg_id);
+
+    return (FrameMetadataId)(ids.size() - 1);
+}
+
 FrameMetadata::FrameMetadata(const char *id)
+: mRefCount(1)
 {
     mId = id;
+    mNumericId = RegisterId(id);
+}
+
+FrameMetadata::FrameMetadata(const FrameMetadata &from)
+: mRefCount(1)
+{
+    mId = from.mId;
+    mNumericId = from.mNumericId;
 }
 
 FrameMetadata::~FrameMetadata()
 {
 }
 
+FrameMetadata& FrameMetadata::operator=(const FrameMetadata &from)
+{
+    mId = from.mId;
+    mNumericId = from.mNumericId;
+    return *this;
+}
+
+FrameMetadata* FrameMetadata::AddRef()
+{
+    mRefCount.fetch_add(1, memory_order_relaxed);
+    return this;
+}
+
+void FrameMetadata::Release()
+{
+    if (mRefCount.fetch_sub(1, memory_order_acq_rel) == 1)
+        delete this;
+}
+
+bool FrameMetadata::IsShared() const
+{
+    return mRefCount.load(memory_order_acquire) > 1;
+}
+
 
 
 Frame::Frame()
@@ -72,6 +156,9 @@ Frame::Frame()
     kl_size = 0;
     file_id = (size_t)(-1);
     element_key = g_Null_Key;
+    memset(mInlineMetadata, 0, sizeof(mInlineMetadata));
+    mNumMetadata = 0;
+    mMetadataMapValid = false;
 }
 
 Frame::Frame(const Frame &from)
@@ -94,37 +181,104 @@ Frame::Frame(const Frame &from)
     file_id             = from.file_id;
     element_key         = from.element_key;
 
-    map<string, vector<FrameMetadata*> >::const_iterator iter;
-    for (iter = from.mMetadata.begin(); iter != from.mMetadata.end(); iter++) {
-        mMetadata[iter->first] = vector<FrameMetadata*>();
-        size_t i;
-        for (i = 0; i < iter->second.size(); i++)
-            mMetadata[iter->first].push_back(iter->second[i]->Clone());
-    }
+    memset(mInlineMetadata, 0, sizeof(mInlineMetadata));
+    mNumMetadata = 0;
+    mMetadataMapValid = false;
+
+    // the metadata is shared with the source frame
+    size_t i;
+    for (i = 0; i < from.mNumMetadata; i++)
+        InsertMetadata(from.GetMetadataItem(i)->AddRef());
 }
 
 Frame::~Frame()
 {
-    map<string, vector<FrameMetadata*> >::const_iterator iter;
-    for (iter = mMetadata.begin(); iter != mMetadata.end(); iter++) {
-        size_t i;
-        for (i = 0; i < iter->second.size(); i++)
-            delete iter->second[i];
+    ClearMetadata();
+}
+
+FrameMetadata* Frame::GetMetadataItem(size_t index) const
+{
+    BMX_ASSERT(index < mNumMetadata);
+    if (index < FRAME_INLINE_METADATA_COUNT)
+        return mInlineMetadata[index];
+    else
+        return mExtraMetadata[index - FRAME_INLINE_METADATA_COUNT];
+}
+
+FrameMetadata* Frame::FindMetadata(FrameMetadataId id, size_t index) const
+{
+    size_t i;
+    for (i = 0; i < mNumMetadata; i++) {
+        FrameMetadata *metadata = GetMetadataItem(i);
+        if (metadata->GetNumericId() == id) {
+            if (index == 0)
+                return metadata;
+            index--;
+        }
     }
+
+    return 0;
+}
+
+void Frame::InsertMetadata(FrameMetadata *metadata)
+{
+    if (mNumMetadata < FRAME_INLINE_METADATA_COUNT)
+        mInlineMetadata[mNumMetadata] = metadata;
+    else
+        mExtraMetadata.push_back(metadata);
+    mNumMetadata++;
+    mMetadataMapValid = false;
+}
+
+void Frame::ClearMetadata()
+{
+    size_t i;
+    for (i = 0; i < mNumMetadata; i++)
+        GetMetadataItem(i)->Release();
+    memset(mInlineMetadata, 0, sizeof(mInlineMetadata));
+    mExtraMetadata.clear();
+    mNumMetadata = 0;
+    mMetadataMap.clear();
+    mMetadataMapValid = false;
+}
+
+const map<string, vector<FrameMetadata*> >& Frame::GetMetadata() const
+{
+    UpdateMetadataMap();
+    return mMetadataMap;
 }
 
 const vector<FrameMetadata*>* Frame::GetMetadata(std::string id) const
 {
-    map<string, vector<FrameMetadata*> >::const_iterator result = mMetadata.find(id);
-    if (result == mMetadata.end())
+    UpdateMetadataMap();
+
+    map<string, vector<FrameMetadata*> >::const_iterator result = mMetadataMap.find(id);
+    if (result == mMetadataMap.end())
         return 0;
 
     return &result->second;
 }
 
-void Frame::InsertMetadata(FrameMetadata *metadata)
+void Frame::UpdateMetadataMap() const
+{
+    if (mMetadataMapValid)
+        return;
+
+    mMetadataMap.clear();
+    size_t i;
+    for (i = 0; i < mNumMetadata; i++) {
+        FrameMetadata *metadata = GetMetadataItem(i);
+        mMetadataMap[metadata->GetId()].push_back(metadata);
+    }
+    mMetadataMapValid = true;
+}
+
+bool Frame::ReferenceBytes(const unsigned char *bytes, uint32_t size, shared_ptr<const void> owner)
 {
-    mMetadata[metadata->GetId()].push_back(metadata);
+    (void)bytes;
+    (void)size;
+    (void)owner;
+    return false;
 }
 
 
@@ -132,6 +286,8 @@ void Frame::InsertMetadata(FrameMetadata *metadata)
 DefaultFrame::DefaultFrame()
 : Frame()
 {
+    mRefBytes = 0;
+    mRefSize = 0;
 }
 
 DefaultFrame::~DefaultFrame()
@@ -140,37 +296,59 @@ DefaultFrame::~DefaultFrame()
 
 uint32_t DefaultFrame::GetSize() const
 {
+    if (mRefBytes)
+        return mRefSize;
+
     return mData.GetSize();
 }
 
 const unsigned char* DefaultFrame::GetBytes() const
 {
+    if (mRefBytes)
+        return mRefBytes;
+
     return mData.GetBytes();
 }
 
 void DefaultFrame::Grow(uint32_t min_size)
 {
+    CopyReferencedBytes();
     mData.Grow(min_size);
 }
 
 uint32_t DefaultFrame::GetSizeAvailable() const
 {
+    if (mRefBytes)
+        return 0;
+
     return mData.GetSizeAvailable();
 }
 
 unsigned char* DefaultFrame::GetBytesAvailable() const
 {
+    if (mRefBytes)
+        return 0;
+
     return mData.GetBytesAvailable();
 }
 
 void DefaultFrame::SetSize(uint32_t size)
 {
-    mData.SetSize(size);
+    if (mRefBytes) {
+        if (size > mRefSize)
+            BMX_EXCEPTION(("Cannot set frame size > referenced data size"));
+        mRefSize = size;
+    } else {
+        mData.SetSize(size);
+    }
 }
 
 void DefaultFrame::IncrementSize(uint32_t inc)
 {
-    mData.IncrementSize(inc);
+    if (mRefBytes)
+        SetSize(mRefSize + inc);
+    else
+        mData.IncrementSize(inc);
 }
 
 Frame* DefaultFrame::Clone()
@@ -178,9 +356,430 @@ Frame* DefaultFrame::Clone()
     return new DefaultFrame(*this);
 }
 
+bool DefaultFrame::ReferenceBytes(const unsigned char *bytes, uint32_t size, shared_ptr<const void> owner)
+{
+    if (GetSize() > 0)
+        return false;
+
+    mRefBytes = bytes;
+    mRefSize  = size;
+    mRefOwner = owner;
+    return true;
+}
+
+void DefaultFrame::CopyReferencedBytes()
+{
+    if (!mRefBytes)
+        return;
+
+    mData.CopyBytes(mRefBytes, mRefSize);
+    mRefBytes = 0;
+    mRefSize  = 0;
+    mRefOwner.reset();
+}
+
 
 Frame* DefaultFrameFactory::CreateFrame()
 {
     return new DefaultFrame();
 }
 
+
+
+#define MAX_FREE_FRAME_OBJECTS  1024
+#define SMALL_DATA_ALIGNMENT    64
+
+typedef struct
+{
+    mutex free_mutex;
+    vector<void*> free_objects;
+    uint64_t hits;
+    uint64_t misses;
+} FrameObjectFreeList;
+
+static FrameObjectFreeList &get_frame_object_free_list()
+{
+    // the list is not destroyed at exit because frames may be deleted by static destructors
+    static FrameObjectFreeList *free_list = new FrameObjectFreeList();
+    return *free_list;
+}
+
+
+
+FrameDataPool::FrameDataPool(uint32_t alignment)
+{
+    mAlignment = alignment;
+    mMinClassSize = (alignment < SMALL_DATA_ALIGNMENT ? alignment : SMALL_DATA_ALIGNMENT);
+    mMaxFreeBuffers = 0;
+    mMaxFreeSize = 0;
+    mFreeCount = 0;
+    mFreeSize = 0;
+    mHits = 0;
+    mMisses = 0;
+}
+
+FrameDataPool::~FrameDataPool()
+{
+    size_t i, j;
+    for (i = 0; i < mFreeBuffers.size(); i++) {
+        for (j = 0; j < mFreeBuffers[i].size(); j++)
+            delete mFreeBuffers[i][j];
+    }
+}
+
+void FrameDataPool::AddLimits(size_t max_free_buffers, uint64_t max_free_size)
+{
+    lock_guard<mutex> lock(mMutex);
+
+    mMaxFreeBuffers += max_free_buffers;
+    mMaxFreeSize += max_free_size;
+}
+
+void FrameDataPool::RemoveLimits(size_t max_free_buffers, uint64_t max_free_size)
+{
+    lock_guard<mutex> lock(mMutex);
+
+    BMX_ASSERT(max_free_buffers <= mMaxFreeBuffers && max_free_size <= mMaxFreeSize);
+    mMaxFreeBuffers -= max_free_buffers;
+    mMaxFreeSize -= max_free_size;
+    TrimFreeBuffers();
+}
+
+ByteArray* FrameDataPool::Acquire(uint32_t min_size)
+{
+    // take a buffer from the smallest size class that is guaranteed to be large enough
+    size_t size_class = GetSizeClass(min_size, true);
+    {
+        lock_guard<mutex> lock(mMutex);
+
+        size_t i;
+        for (i = size_class; i < mFreeBuffers.size(); i++) {
+            if (!mFreeBuffers[i].empty()) {
+                ByteArray *data = mFreeBuffers[i].back();
+                mFreeBuffers[i].pop_back();
+                mFreeCount--;
+                mFreeSize -= data->GetAllocatedSize();
+                mHits++;
+                return data;
+            }
+        }
+        mMisses++;
+    }
+
+    uint64_t class_size = (uint64_t)mMinClassSize << size_class;
+    uint32_t class_alignment = GetClassAlignment(class_size);
+
+    ByteArray *data = new ByteArray();
+    data->SetAlignment(class_alignment);
+    data->SetAllocBlockSize(class_alignment);
+    if (min_size > 0) {
+        // ByteArray allocates the next multiple of the block size after the given size
+        if (class_size > UINT32_MAX - mAlignment)
+            data->Allocate(min_size);
+        else
+            data->Allocate((uint32_t)class_size - 1);
+    }
+    return data;
+}
+
+void FrameDataPool::Release(ByteArray *data)
+{
+    uint32_t alloc_size = data->GetAllocatedSize();
+    if (alloc_size > 0) {
+        size_t size_class = GetSizeClass(alloc_size, false);
+
+        // a small buffer that was grown into the aligned size classes is not sufficiently aligned
+        if (data->GetAlignment() >= GetClassAlignment((uint64_t)mMinClassSize << size_class)) {
+            lock_guard<mutex> lock(mMutex);
+
+            if (mFreeCount < mMaxFreeBuffers && mFreeSize + alloc_size <= mMaxFreeSize) {
+                if (size_class >= mFreeBuffers.size())
+                    mFreeBuffers.resize(size_class + 1);
+                data->SetSize(0);
+                mFreeBuffers[size_class].push_back(data);
+                mFreeCount++;
+                mFreeSize += alloc_size;
+                return;
+            }
+        }
+    }
+
+    delete data;
+}
+
+void FrameDataPool::GetStats(FramePoolStats *stats)
+{
+    lock_guard<mutex> lock(mMutex);
+
+    stats->data_hits       = mHits;
+    stats->data_misses     = mMisses;
+    stats->free_data_count = mFreeCount;
+    stats->free_data_size  = mFreeSize;
+}
+
+size_t FrameDataPool::GetSizeClass(uint32_t size, bool round_up) const
+{
+    // size class N holds buffers with allocated size >= min class size * 2^N
+    size_t size_class = 0;
+    uint64_t class_size = mMinClassSize;
+    if (round_up) {
+        while (class_size < size) {
+            class_size <<= 1;
+            size_class++;
+        }
+    } else {
+        while ((class_size << 1) <= size) {
+            class_size <<= 1;
+            size_class++;
+        }
+    }
+
+    return size_class;
+}
+
+uint32_t FrameDataPool::GetClassAlignment(uint64_t class_size) const
+{
+    return class_size < mAlignment ? mMinClassSize : mAlignment;
+}
+
+void FrameDataPool::TrimFreeBuffers()
+{
+    // called with the mutex locked. The largest buffers are deleted first
+    size_t i = mFreeBuffers.size();
+    while (i > 0 && (mFreeCount > mMaxFreeBuffers || mFreeSize > mMaxFreeSize)) {
+        if (mFreeBuffers[i - 1].empty()) {
+            i--;
+            continue;
+        }
+
+        ByteArray *data = mFreeBuffers[i - 1].back();
+        mFreeBuffers[i - 1].pop_back();
+        mFreeCount--;
+        mFreeSize -= data->GetAllocatedSize();
+        delete data;
+    }
+}
+
+
+
+void* PooledFrame::operator new(size_t size)
+{
+    if (size == sizeof(PooledFrame)) {
+        FrameObjectFreeList &free_list = get_frame_object_free_list();
+        lock_guard<mutex> lock(free_list.free_mutex);
+
+        if (!free_list.free_objects.empty()) {
+            void *ptr = free_list.free_objects.back();
+            free_list.free_objects.pop_back();
+            free_list.hits++;
+            return ptr;
+        }
+        free_list.misses++;
+    }
+
+    return ::operator new(size);
+}
+
+void PooledFrame::operator delete(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size == sizeof(PooledFrame)) {
+        FrameObjectFreeList &free_list = get_frame_object_free_list();
+        lock_guard<mutex> lock(free_list.free_mutex);
+
+        if (free_list.free_objects.size() < MAX_FREE_FRAME_OBJECTS) {
+            free_list.free_objects.push_back(ptr);
+            return;
+        }
+    }
+
+    ::operator delete(ptr);
+}
+
+void PooledFrame::GetObjectStats(uint64_t *hits, uint64_t *misses)
+{
+    FrameObjectFreeList &free_list = get_frame_object_free_list();
+    lock_guard<mutex> lock(free_list.free_mutex);
+
+    *hits   = free_list.hits;
+    *misses = free_list.misses;
+}
+
+PooledFrame::PooledFrame(shared_ptr<FrameDataPool> pool)
+: Frame()
+{
+    mPool = pool;
+    mData = 0;
+    mRefBytes = 0;
+    mRefSize = 0;
+}
+
+PooledFrame::PooledFrame(const PooledFrame &from)
+: Frame(from)
+{
+    mPool = from.mPool;
+    mData = 0;
+    if (from.mData && from.mData->GetSize() > 0) {
+        AcquireData(from.mData->GetSize());
+        mData->CopyBytes(from.mData->GetBytes(), from.mData->GetSize());
+    }
+    mRefBytes = from.mRefBytes;
+    mRefSize = from.mRefSize;
+    mRefOwner = from.mRefOwner;
+}
+
+PooledFrame::~PooledFrame()
+{
+    if (mData)
+        mPool->Release(mData);
+}
+
+uint32_t PooledFrame::GetSize() const
+{
+    if (mRefBytes)
+        return mRefSize;
+    else if (mData)
+        return mData->GetSize();
+    else
+        return 0;
+}
+
+const unsigned char* PooledFrame::GetBytes() const
+{
+    if (mRefBytes)
+        return mRefBytes;
+    else if (mData)
+        return mData->GetBytes();
+    else
+        return 0;
+}
+
+void PooledFrame::Grow(uint32_t min_size)
+{
+    CopyReferencedBytes();
+    AcquireData(min_size);
+    mData->Grow(min_size);
+}
+
+uint32_t PooledFrame::GetSizeAvailable() const
+{
+    if (mRefBytes || !mData)
+        return 0;
+
+    return mData->GetSizeAvailable();
+}
+
+unsigned char* PooledFrame::GetBytesAvailable() const
+{
+    if (mRefBytes || !mData)
+        return 0;
+
+    return mData->GetBytesAvailable();
+}
+
+void PooledFrame::SetSize(uint32_t size)
+{
+    if (mRefBytes) {
+        if (size > mRefSize)
+            BMX_EXCEPTION(("Cannot set frame size > referenced data size"));
+        mRefSize = size;
+    } else if (mData || size > 0) {
+        AcquireData(0);
+        mData->SetSize(size);
+    }
+}
+
+void PooledFrame::IncrementSize(uint32_t inc)
+{
+    if (mRefBytes) {
+        SetSize(mRefSize + inc);
+    } else if (mData || inc > 0) {
+        AcquireData(0);
+        mData->IncrementSize(inc);
+    }
+}
+
+Frame* PooledFrame::Clone()
+{
+    return new PooledFrame(*this);
+}
+
+bool PooledFrame::ReferenceBytes(const unsigned char *bytes, uint32_t size, shared_ptr<const void> owner)
+{
+    if (GetSize() > 0)
+        return false;
+
+    mRefBytes = bytes;
+    mRefSize  = size;
+    mRefOwner = owner;
+    return true;
+}
+
+void PooledFrame::AcquireData(uint32_t min_size)
+{
+    // the data buffer is acquired when the required size is first known so that a buffer from a
+    // suitable size class is used
+    if (!mData)
+        mData = mPool->Acquire(min_size);
+}
+
+void PooledFrame::CopyReferencedBytes()
+{
+    if (!mRefBytes)
+        return;
+
+    AcquireData(mRefSize);
+    mData->CopyBytes(mRefBytes, mRefSize);
+    mRefBytes = 0;
+    mRefSize  = 0;
+    mRefOwner.reset();
+}
+
+
+
+PooledFrameFactory* PooledFrameFactory::CreateShared(size_t max_free_buffers, uint64_t max_free_size)
+{
+    // the pool is not destroyed at exit because frames may be deleted by static destructors
+    static shared_ptr<FrameDataPool> *shared_pool =
+        new shared_ptr<FrameDataPool>(make_shared<FrameDataPool>(mxf_get_system_page_size()));
+
+    return new PooledFrameFactory(*shared_pool, max_free_buffers, max_free_size);
+}
+
+PooledFrameFactory::PooledFrameFactory(uint32_t alignment, size_t max_free_buffers, uint64_t max_free_size)
+{
+    if (alignment == 0)
+        alignment = mxf_get_system_page_size();
+
+    mPool = make_shared<FrameDataPool>(alignment);
+    mMaxFreeBuffers = max_free_buffers;
+    mMaxFreeSize = max_free_size;
+    mPool->AddLimits(mMaxFreeBuffers, mMaxFreeSize);
+}
+
+PooledFrameFactory::PooledFrameFactory(shared_ptr<FrameDataPool> pool, size_t max_free_buffers,
+                                       uint64_t max_free_size)
+{
+    mPool = pool;
+    mMaxFreeBuffers = max_free_buffers;
+    mMaxFreeSize = max_free_size;
+    mPool->AddLimits(mMaxFreeBuffers, mMaxFreeSize);
+}
+
+PooledFrameFactory::~PooledFrameFactory()
+{
+    mPool->RemoveLimits(mMaxFreeBuffers, mMaxFreeSize);
+}
+
+Frame* PooledFrameFactory::CreateFrame()
+{
+    return new PooledFrame(mPool);
+}
+
+void PooledFrameFactory::GetStats(FramePoolStats *stats)
+{
+    PooledFrame::GetObjectStats(&stats->frame_hits, &stats->frame_misses);
+    mPool->GetStats(stats);
+}
@@ -46,8 +46,9 @@ using namespace bmx;
 
 DefaultFrameBuffer::DefaultFrameBuffer()
 {
-    mFrameFactory = new DefaultFrameFactory();
+    mFrameFactory = PooledFrameFactory::CreateShared();
     mOwnFrameFactory = true;
+    mFrontIndex = 0;
     mStartReadIndex = NULL_READ_START_INDEX;
 }
 
@@ -55,6 +56,7 @@ DefaultFrameBuffer::DefaultFrameBuffer(FrameFactory *frame_factory, bool take_ow
 {
     mFrameFactory = frame_factory;
     mOwnFrameFactory = take_ownership;
+    mFrontIndex = 0;
     mStartReadIndex = NULL_READ_START_INDEX;
 }
 
@@ -77,7 +79,7 @@ void DefaultFrameBuffer::SetFrameFactory(FrameFactory *frame_factory, bool take_
 
 void DefaultFrameBuffer::StartRead()
 {
-    mStartReadIndex = mFrames.size();
+    mStartReadIndex = GetNumFrames();
 }
 
 void DefaultFrameBuffer::CompleteRead()
@@ -87,8 +89,8 @@ void DefaultFrameBuffer::CompleteRead()
 
 void DefaultFrameBuffer::AbortRead()
 {
-    if (mStartReadIndex != NULL_READ_START_INDEX && mStartReadIndex < mFrames.size()) {
-        size_t num_pops = mFrames.size() - mStartReadIndex;
+    if (mStartReadIndex != NULL_READ_START_INDEX && mStartReadIndex < GetNumFrames()) {
+        size_t num_pops = GetNumFrames() - mStartReadIndex;
         size_t i;
         for (i = 0; i < num_pops; i++)
             PopFrame(true);
@@ -104,43 +106,58 @@ Frame* DefaultFrameBuffer::CreateFrame()
 
 void DefaultFrameBuffer::PushFrame(Frame *frame)
 {
+    // move the queued frames to the start rather than letting the vector reallocate
+    if (mFrontIndex > 0 && mFrames.size() == mFrames.capacity()) {
+        mFrames.erase(mFrames.begin(), mFrames.begin() + mFrontIndex);
+        mFrontIndex = 0;
+    }
+
     mFrames.push_back(frame);
 }
 
 void DefaultFrameBuffer::PopFrame(bool del_frame)
 {
-    if (del_frame && mFrames.front())
-        delete mFrames.front();
+    if (del_frame && mFrames[mFrontIndex])
+        delete mFrames[mFrontIndex];
 
-    mFrames.pop_front();
+    PopFrontFrame();
 }
 
 Frame* DefaultFrameBuffer::GetLastFrame(bool pop)
 {
-    if (mFrames.empty())
+    if (mFrontIndex >= mFrames.size())
         return 0;
 
-    Frame *frame = mFrames.front();
+    Frame *frame = mFrames[mFrontIndex];
     if (pop)
-        mFrames.pop_front();
+        PopFrontFrame();
 
     return frame;
 }
 
 size_t DefaultFrameBuffer::GetNumFrames() const
 {
-    return mFrames.size();
+    return mFrames.size() - mFrontIndex;
 }
 
 void DefaultFrameBuffer::Clear(bool del_frames)
 {
     if (del_frames) {
         size_t i;
-        for (i = 0; i < mFrames.size(); i++)
+        for (i = mFrontIndex; i < mFrames.size(); i++)
             delete mFrames[i];
     }
 
     mFrames.clear();
+    mFrontIndex = 0;
     mStartReadIndex = NULL_READ_START_INDEX;
 }
 
+void DefaultFrameBuffer::PopFrontFrame()
+{
+    mFrontIndex++;
+    if (mFrontIndex == mFrames.size()) {
+        mFrames.clear();
+        mFrontIndex = 0;
+    }
+}
@@ -250,22 +250,23 @@ uint32_t OP1AContentPackageElementData::GetWriteSize() const
     }
 }
 
-uint32_t OP1AContentPackageElementData::Write()
+uint32_t OP1AContentPackageElementData::Write(MXFWriteBatch *batch)
 {
     uint32_t write_size = GetWriteSize();
 
     if (mElement->is_frame_wrapped) {
-        mElement->WriteKL(mMXFFile, mData.GetSize());
-        BMX_CHECK(mMXFFile->write(mData.GetBytes(), mData.GetSize()) == mData.GetSize());
+        batch->AppendFixedKL(&mElement->element_key, mElement->essence_llen, mData.GetSize());
+        batch->AppendRef(mData.GetBytes(), mData.GetSize());
         if (write_size > mxfKey_extlen + mElement->essence_llen + mData.GetSize())
-            mMXFFile->writeFill(write_size - (mxfKey_extlen + mElement->essence_llen + mData.GetSize()));
+            batch->AppendFill(write_size - (mxfKey_extlen + mElement->essence_llen + mData.GetSize()));
         else
             BMX_ASSERT(write_size == mxfKey_extlen + mElement->essence_llen + mData.GetSize());
     } else {
+        // the data is copied because it is reset before the batch is written
         BMX_ASSERT(mTotalWriteSize == 0);
-        mElementStartPos = mMXFFile->tell();
-        mElement->WriteKL(mMXFFile, 0);
-        BMX_CHECK(mMXFFile->write(mData.GetBytes(), mData.GetSize()) == mData.GetSize());
+        mElementStartPos = mMXFFile->tell() + batch->GetSize();
+        batch->AppendFixedKL(&mElement->element_key, mElement->essence_llen, 0);
+        batch->AppendCopy(mData.GetBytes(), mData.GetSize());
         mData.SetSize(0);
     }
 
@@ -436,39 +437,39 @@ void OP1AContentPackage::UpdateIndexTable()
     mHaveUpdatedIndexTable = true;
 }
 
-uint32_t OP1AContentPackage::Write()
+uint32_t OP1AContentPackage::Write(MXFWriteBatch *batch)
 {
     BMX_ASSERT(mHaveUpdatedIndexTable);
 
     if (mHaveSystemItem)
-        WriteSystemItem();
+        WriteSystemItem(batch);
 
     uint32_t size = 0;
     size_t i;
     for (i = 0; i < mElementData.size(); i++)
-        size += mElementData[i]->Write();
+        size += mElementData[i]->Write(batch);
 
     return size;
 }
 
-void OP1AContentPackage::WriteSystemItem()
+void OP1AContentPackage::WriteSystemItem(MXFWriteBatch *batch)
 {
-    mMXFFile->writeFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), FW_ESS_ELEMENT_LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
+    batch->AppendFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), FW_ESS_ELEMENT_LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
 
     // core fields
-    mMXFFile->writeUInt8(mSystemMetadataBitmap);                        // system metadata bitmap
-    mMXFFile->writeUInt8(mContentPackageRate);                          // content package rate
-    mMXFFile->writeUInt8(0x00);                                         // content package type (default)
-    mMXFFile->writeUInt16(0x0000);                                      // channel handle (default)
-    mMXFFile->writeUInt16((uint16_t)(mPosition & 0xffff));              // continuity count
+    batch->AppendUInt8(mSystemMetadataBitmap);                          // system metadata bitmap
+    batch->AppendUInt8(mContentPackageRate);                            // content package rate
+    batch->AppendUInt8(0x00);                                           // content package type (default)
+    batch->AppendUInt16(0x0000);                                        // channel handle (default)
+    batch->AppendUInt16((uint16_t)(mPosition & 0xffff));                // continuity count
 
     // SMPTE Universal Label
-    mMXFFile->writeUL(&MXF_EC_L(MultipleWrappings));
+    batch->AppendUL(&MXF_EC_L(MultipleWrappings));
 
     // (null) Package creation date / time stamp
     unsigned char ts_bytes[17];
     memset(ts_bytes, 0, sizeof(ts_bytes));
-    BMX_CHECK(mMXFFile->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    batch->AppendCopy(ts_bytes, sizeof(ts_bytes));
 
     // User date / time stamp
     Timecode user_timecode;
@@ -482,13 +483,13 @@ void OP1AContentPackage::WriteSystemItem()
         user_timecode.Init(get_rounded_tc_base(mFrameRate), false, mPosition);
     }
     encode_smpte_timecode(user_timecode, false, &ts_bytes[1], sizeof(ts_bytes) - 1);
-    BMX_CHECK(mMXFFile->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    batch->AppendCopy(ts_bytes, sizeof(ts_bytes));
 
     // empty Package Metadata Set
-    mMXFFile->writeFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), FW_ESS_ELEMENT_LLEN, 0);
+    batch->AppendFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), FW_ESS_ELEMENT_LLEN, 0);
 
     if (mSystemItemSize > NA_SYSTEM_ITEM_SIZE)
-        mMXFFile->writeFill(mSystemItemSize - NA_SYSTEM_ITEM_SIZE);
+        batch->AppendFill(mSystemItemSize - NA_SYSTEM_ITEM_SIZE);
 }
 
 void OP1AContentPackage::CompleteWrite()
@@ -501,6 +502,7 @@ void OP1AContentPackage::CompleteWrite()
 
 OP1AContentPackageManager::OP1AContentPackageManager(File *mxf_file, OP1AIndexTable *index_table, Rational frame_rate,
                                                      uint32_t kag_size, uint8_t min_llen)
+: mWriteBatch(min_llen)
 {
     // check assumption that filler will have llen == min_llen
     BMX_ASSERT(min_llen >= mxf_get_llen(0, kag_size + mxfKey_extlen + min_llen));
@@ -761,7 +763,8 @@ void OP1AContentPackageManager::WriteNextContentPackage()
     BMX_ASSERT(HaveContentPackage());
 
     mContentPackages.front()->UpdateIndexTable();
-    mContentPackages.front()->Write();
+    mContentPackages.front()->Write(&mWriteBatch);
+    mWriteBatch.Write(mMXFFile);
 
     if (mFrameWrapped) {
         mFreeContentPackages.push_back(mContentPackages.front());
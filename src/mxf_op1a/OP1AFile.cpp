@@ -124,10 +124,12 @@ OP1AFile::OP1AFile(int flavour, mxfpp::File *mxf_file, mxfRational frame_rate)
     mSupportCompleteSinglePass = false;
     mFooterPartitionOffset = 0;
     mMXFChecksumFile = 0;
+    mMXFAsyncWriteFile = 0;
     mCBEIndexPartitionIndex = 0;
     mSetPrimaryPackage = false;
     mIndexFollowsEssence = false;
     mSignalST3792 = false;
+    mPipelinedWrite = false;
 
     mTrackIdHelper.SetId("TimecodeTrack", 901);
     mTrackIdHelper.SetStartId(MXF_PICTURE_DDEF, 1001);
@@ -279,6 +281,11 @@ void OP1AFile::ForceWriteCBEDuration0(bool enable)
     mIndexTable->ForceWriteCBEDuration0(enable);
 }
 
+void OP1AFile::SetSpillIndexTable(bool enable)
+{
+    mIndexTable->SetSpillSegments(enable);
+}
+
 void OP1AFile::SetPrimaryPackage(bool enable)
 {
     mSetPrimaryPackage = enable;
@@ -294,6 +301,11 @@ void OP1AFile::SetSignalST3792(bool enable)
     mSignalST3792 = enable;
 }
 
+void OP1AFile::SetPipelinedWrite(bool enable)
+{
+    mPipelinedWrite = enable;
+}
+
 uint32_t OP1AFile::AddWaveChunk(WaveChunk *chunk, bool take_ownership)
 {
     uint32_t stream_id = mStreamIdHelper.GetNextId(STREAM_TYPE);
@@ -695,6 +707,12 @@ void OP1AFile::CompleteWrite()
     }
 
 
+    // wait for the I/O thread to complete all writes
+
+    if (mMXFAsyncWriteFile)
+        BMX_CHECK_M(mxf_async_write_file_flush(mMXFAsyncWriteFile), ("Failed to write to the MXF file"));
+
+
     // finalize md5
 
     if (mMXFChecksumFile) {
@@ -1032,6 +1050,15 @@ void OP1AFile::CreateFile()
     CheckMCALabels();
 
 
+    // hand file writes over to an I/O thread so that essence preparation and writing overlap
+
+    if (mPipelinedWrite) {
+        mMXFAsyncWriteFile = mxf_async_write_file_open(mMXFFile->getCFile(), MXF_ASYNC_WRITE_DEFAULT_BUFFER_SIZE,
+                                                       MXF_ASYNC_WRITE_DEFAULT_NUM_BUFFERS);
+        mMXFFile->swapCFile(mxf_async_write_file_get_file(mMXFAsyncWriteFile));
+    }
+
+
     // set minimum llen
 
     mMXFFile->setMinLLen(MIN_LLEN);
@@ -33,6 +33,8 @@
 #include "config.h"
 #endif
 
+#include <cstring>
+
 #include <algorithm>
 
 #include <bmx/mxf_op1a/OP1AContentPackage.h>
@@ -55,6 +57,7 @@ using namespace mxfpp;
 #define MAX_GOP_SIZE_GUESS          30
 
 #define MAX_CACHE_ENTRIES           250
+#define INDEX_ENTRY_CACHE_SIZE      512     // ring buffer size, > MAX_CACHE_ENTRIES
 
 
 
@@ -116,46 +119,69 @@ OP1AIndexTableElement::OP1AIndexTableElement(uint32_t track_index_, ElementType
     slice_offset = 0;
     element_size = 0;
     last_add_index_entry_pos = -1;
+    mIndexEntryCacheCount = 0;
 }
 
 void OP1AIndexTableElement::CacheIndexEntry(int64_t position, int8_t temporal_offset, int8_t key_frame_offset,
                                             uint8_t flags, bool can_start_partition, bool require_update)
 {
-    BMX_CHECK(mIndexEntryCache.size() <= MAX_CACHE_ENTRIES);
+    BMX_CHECK(mIndexEntryCacheCount <= MAX_CACHE_ENTRIES);
 
-    mIndexEntryCache[position] = OP1AIndexEntry(temporal_offset, key_frame_offset, flags, can_start_partition);
+    if (mIndexEntryCache.empty()) {
+        CachedIndexEntry free_entry;
+        free_entry.position = -1;
+        mIndexEntryCache.resize(INDEX_ENTRY_CACHE_SIZE, free_entry);
+    }
 
-    if (require_update)
-        require_updates.insert(position);
+    // entries are taken in position order, so an occupied slot can only hold the same position
+    CachedIndexEntry &cached_entry = mIndexEntryCache[position % INDEX_ENTRY_CACHE_SIZE];
+    BMX_CHECK(cached_entry.position < 0 || cached_entry.position == position);
+    if (cached_entry.position < 0)
+        mIndexEntryCacheCount++;
+    cached_entry.position = position;
+    cached_entry.entry = OP1AIndexEntry(temporal_offset, key_frame_offset, flags, can_start_partition);
+
+    if (require_update) {
+        if (mRequireUpdates.empty() || position > mRequireUpdates.back()) {
+            mRequireUpdates.push_back(position);
+        } else {
+            deque<int64_t>::iterator iter = lower_bound(mRequireUpdates.begin(), mRequireUpdates.end(), position);
+            if (*iter != position)
+                mRequireUpdates.insert(iter, position);
+        }
+    }
     if (position > last_add_index_entry_pos)
         last_add_index_entry_pos = position;
 }
 
 void OP1AIndexTableElement::UpdateIndexEntry(int64_t position, int8_t temporal_offset)
 {
-    BMX_ASSERT(mIndexEntryCache.find(position) != mIndexEntryCache.end());
+    OP1AIndexEntry *entry = GetCachedIndexEntry(position);
+    BMX_ASSERT(entry);
 
-    mIndexEntryCache[position].temporal_offset = temporal_offset;
+    entry->temporal_offset = temporal_offset;
 }
 
 void OP1AIndexTableElement::UpdateIndexEntry(int64_t position, int8_t temporal_offset, int8_t key_frame_offset,
                                              uint8_t flags)
 {
-    BMX_ASSERT(mIndexEntryCache.find(position) != mIndexEntryCache.end());
+    OP1AIndexEntry *entry = GetCachedIndexEntry(position);
+    BMX_ASSERT(entry);
 
-    mIndexEntryCache[position].temporal_offset  = temporal_offset;
-    mIndexEntryCache[position].key_frame_offset = key_frame_offset;
-    mIndexEntryCache[position].flags            = flags;
+    entry->temporal_offset  = temporal_offset;
+    entry->key_frame_offset = key_frame_offset;
+    entry->flags            = flags;
 }
 
 bool OP1AIndexTableElement::TakeIndexEntry(int64_t position, OP1AIndexEntry *entry)
 {
-    map<int64_t, OP1AIndexEntry>::iterator result = mIndexEntryCache.find(position);
-    if (result == mIndexEntryCache.end())
+    OP1AIndexEntry *cached_entry = GetCachedIndexEntry(position);
+    if (!cached_entry)
         return false;
 
-    *entry = result->second;
-    mIndexEntryCache.erase(result);
+    *entry = *cached_entry;
+    mIndexEntryCache[position % INDEX_ENTRY_CACHE_SIZE].position = -1;
+    mIndexEntryCacheCount--;
 
     return true;
 }
@@ -165,24 +191,48 @@ bool OP1AIndexTableElement::CanStartPartition(int64_t position)
     if (is_cbe)
         return true;
 
-    BMX_ASSERT(mIndexEntryCache.find(position) != mIndexEntryCache.end());
+    OP1AIndexEntry *entry = GetCachedIndexEntry(position);
+    BMX_ASSERT(entry);
 
-    return (mIndexEntryCache[position].can_start_partition);
+    return entry->can_start_partition;
 }
 
 bool OP1AIndexTableElement::RequireUpdatesAtEnd(int64_t end_offset) const
 {
-    return !require_updates.empty() && (*require_updates.begin()) <= last_add_index_entry_pos + end_offset;
+    return !mRequireUpdates.empty() && mRequireUpdates.front() <= last_add_index_entry_pos + end_offset;
 }
 
 bool OP1AIndexTableElement::RequireUpdatesAtPos(int64_t position) const
 {
-    return !require_updates.empty() && (*require_updates.begin()) <= position;
+    return !mRequireUpdates.empty() && mRequireUpdates.front() <= position;
+}
+
+void OP1AIndexTableElement::ClearRequiredUpdate(int64_t position)
+{
+    if (!mRequireUpdates.empty() && mRequireUpdates.front() == position) {
+        mRequireUpdates.pop_front();
+    } else {
+        deque<int64_t>::iterator iter = lower_bound(mRequireUpdates.begin(), mRequireUpdates.end(), position);
+        if (iter != mRequireUpdates.end() && *iter == position)
+            mRequireUpdates.erase(iter);
+    }
 }
 
 void OP1AIndexTableElement::IgnoreRequiredUpdates()
 {
-    require_updates.clear();
+    mRequireUpdates.clear();
+}
+
+OP1AIndexEntry* OP1AIndexTableElement::GetCachedIndexEntry(int64_t position)
+{
+    if (mIndexEntryCacheCount == 0 || position < 0)
+        return 0;
+
+    CachedIndexEntry &cached_entry = mIndexEntryCache[position % INDEX_ENTRY_CACHE_SIZE];
+    if (cached_entry.position != position)
+        return 0;
+
+    return &cached_entry.entry;
 }
 
 
@@ -194,6 +244,9 @@ OP1AIndexTableSegment::OP1AIndexTableSegment(uint32_t index_sid, uint32_t body_s
                                              mxfOptBool forward_index_direction)
 {
     mIndexEntrySize = index_entry_size;
+    mSpillFile = 0;
+    mSpillOffset = 0;
+    mSpillSize = 0;
 
     mEntries.SetAllocBlockSize(INDEX_ENTRIES_INCREMENT * index_entry_size);
 
@@ -247,19 +300,21 @@ void OP1AIndexTableSegment::AddIndexEntry(const OP1AIndexEntry *entry, int64_t s
 
 void OP1AIndexTableSegment::UpdateIndexEntry(int64_t segment_position, int8_t temporal_offset)
 {
-    BMX_ASSERT(segment_position * mIndexEntrySize < mEntries.GetSize());
+    unsigned char bytes[1];
+    mxf_set_int8(temporal_offset, &bytes[0]);
 
-    mxf_set_int8(temporal_offset, &mEntries.GetBytes()[segment_position * mIndexEntrySize]);
+    SetEntryBytes(segment_position, bytes, sizeof(bytes));
 }
 
 void OP1AIndexTableSegment::UpdateIndexEntry(int64_t segment_position, int8_t temporal_offset, int8_t key_frame_offset,
                                              uint8_t flags)
 {
-    BMX_ASSERT(segment_position * mIndexEntrySize < mEntries.GetSize());
+    unsigned char bytes[3];
+    mxf_set_int8(temporal_offset,  &bytes[0]);
+    mxf_set_int8(key_frame_offset, &bytes[1]);
+    mxf_set_int8(flags,            &bytes[2]);
 
-    mxf_set_int8(temporal_offset,  &mEntries.GetBytes()[segment_position * mIndexEntrySize]);
-    mxf_set_int8(key_frame_offset, &mEntries.GetBytes()[segment_position * mIndexEntrySize + 1]);
-    mxf_set_int8(flags,            &mEntries.GetBytes()[segment_position * mIndexEntrySize + 2]);
+    SetEntryBytes(segment_position, bytes, sizeof(bytes));
 }
 
 void OP1AIndexTableSegment::AddCBEIndexEntries(uint32_t edit_unit_byte_count, uint32_t num_entries)
@@ -279,6 +334,45 @@ uint32_t OP1AIndexTableSegment::GetDuration() const
     return (uint32_t)mSegment.getIndexDuration();
 }
 
+void OP1AIndexTableSegment::Spill(BMXFileIO *spill_file)
+{
+    BMX_ASSERT(!mSpillFile);
+
+    BMX_CHECK(spill_file->Seek(0, SEEK_END));
+    mSpillOffset = spill_file->Tell();
+    BMX_CHECK(mSpillOffset >= 0);
+    mSpillSize = mEntries.GetSize();
+    BMX_CHECK(spill_file->Write(mEntries.GetBytes(), mSpillSize) == mSpillSize);
+
+    mSpillFile = spill_file;
+    mEntries.Clear();
+}
+
+void OP1AIndexTableSegment::WriteEntries(File *mxf_file, ByteArray *buffer)
+{
+    if (!mSpillFile) {
+        mxf_file->write(mEntries.GetBytes(), mEntries.GetSize());
+        return;
+    }
+
+    buffer->Allocate(mSpillSize);
+    BMX_CHECK(mSpillFile->Seek(mSpillOffset, SEEK_SET));
+    BMX_CHECK(mSpillFile->Read(buffer->GetBytes(), mSpillSize) == mSpillSize);
+    mxf_file->write(buffer->GetBytes(), mSpillSize);
+}
+
+void OP1AIndexTableSegment::SetEntryBytes(int64_t segment_position, const unsigned char *bytes, uint32_t size)
+{
+    if (!mSpillFile) {
+        BMX_ASSERT(segment_position * mIndexEntrySize < mEntries.GetSize());
+        memcpy(&mEntries.GetBytes()[segment_position * mIndexEntrySize], bytes, size);
+    } else {
+        BMX_ASSERT(segment_position * mIndexEntrySize < mSpillSize);
+        BMX_CHECK(mSpillFile->Seek(mSpillOffset + segment_position * mIndexEntrySize, SEEK_SET));
+        BMX_CHECK(mSpillFile->Write(bytes, size) == size);
+    }
+}
+
 
 
 OP1AIndexTable::OP1AIndexTable(uint32_t index_sid, uint32_t body_sid, mxfRational edit_rate, bool force_write_slice_count)
@@ -301,6 +395,8 @@ OP1AIndexTable::OP1AIndexTable(uint32_t index_sid, uint32_t body_sid, mxfRationa
     mDuration = 0;
     mStreamOffset = 0;
     mHaveWritten = false;
+    mSpillSegments = false;
+    mSpillFile = 0;
 }
 
 OP1AIndexTable::~OP1AIndexTable()
@@ -314,6 +410,8 @@ OP1AIndexTable::~OP1AIndexTable()
         delete mIndexSegments[i];
     for (i = 0; i < mWrittenVBEIndexSegments.size(); i++)
         delete mWrittenVBEIndexSegments[i];
+
+    delete mSpillFile;
 }
 
 void OP1AIndexTable::SetEditRate(mxfRational edit_rate)
@@ -340,6 +438,11 @@ void OP1AIndexTable::ForceWriteCBEDuration0(bool enable)
     mForceWriteCBEDuration0 = enable;
 }
 
+void OP1AIndexTable::SetSpillSegments(bool enable)
+{
+    mSpillSegments = enable;
+}
+
 void OP1AIndexTable::SetInputDuration(int64_t duration)
 {
     mInputDuration = duration;
@@ -456,7 +559,7 @@ void OP1AIndexTable::UpdateIndexEntry(uint32_t track_index, int64_t position, in
         mIndexSegments[i]->UpdateIndexEntry(mIndexSegments[i]->GetDuration() - end_offset, temporal_offset);
     }
 
-    mIndexElementsMap[track_index]->require_updates.erase(position);
+    mIndexElementsMap[track_index]->ClearRequiredUpdate(position);
 }
 
 void OP1AIndexTable::UpdateIndexEntry(uint32_t track_index, int64_t position, int8_t temporal_offset,
@@ -479,7 +582,7 @@ void OP1AIndexTable::UpdateIndexEntry(uint32_t track_index, int64_t position, in
                                             key_frame_offset, flags);
     }
 
-    mIndexElementsMap[track_index]->require_updates.erase(position);
+    mIndexElementsMap[track_index]->ClearRequiredUpdate(position);
 }
 
 bool OP1AIndexTable::CanStartPartition()
@@ -564,8 +667,10 @@ void OP1AIndexTable::WriteSegments(File *mxf_file, Partition *partition, bool fi
     if (!mIsCBE) {
         if (!partition->isFooter() && mRepeatIndexTable) {
             size_t i;
-            for (i = 0; i < mIndexSegments.size(); i++)
+            for (i = 0; i < mIndexSegments.size(); i++) {
+                SpillSegment(mIndexSegments[i]);
                 mWrittenVBEIndexSegments.push_back(mIndexSegments[i]);
+            }
         } else {
             size_t i;
             for (i = 0; i < mIndexSegments.size(); i++)
@@ -739,6 +844,8 @@ void OP1AIndexTable::UpdateVBEIndex(vector<uint32_t> &element_sizes)
     }
 
     if (mIndexSegments.empty() || mIndexSegments.back()->RequireNewSegment(can_start_partition)) {
+        if (!mIndexSegments.empty())
+            SpillSegment(mIndexSegments.back());
         mIndexSegments.push_back(new OP1AIndexTableSegment(mIndexSID, mBodySID, mEditRate, mDuration,
                                                            mIndexEntrySize, mSliceCount, mForceWriteSliceCount, false,
                                                            mSingleIndexLocation, mSingleEssenceLocation,
@@ -781,7 +888,6 @@ void OP1AIndexTable::WriteVBESegments(File *mxf_file, Partition *partition, vect
     size_t i;
     for (i = 0; i < segments.size(); i++) {
         IndexTableSegment *segment = segments[i]->GetSegment();
-        ByteArray *entries = segments[i]->GetEntries();
 
         segment->writeHeader(mxf_file, (uint32_t)mDeltaEntries.size(), (uint32_t)segment->getIndexDuration());
 
@@ -795,9 +901,19 @@ void OP1AIndexTable::WriteVBESegments(File *mxf_file, Partition *partition, vect
         }
 
         segment->writeIndexEntryArrayHeader(mxf_file, mSliceCount, 0, (uint32_t)segment->getIndexDuration());
-        mxf_file->write(entries->GetBytes(), entries->GetSize());
+        segments[i]->WriteEntries(mxf_file, &mSpillBuffer);
 
         partition->fillToKag(mxf_file);
     }
 }
 
+void OP1AIndexTable::SpillSegment(OP1AIndexTableSegment *segment)
+{
+    if (!mSpillSegments || segment->IsSpilled())
+        return;
+
+    if (!mSpillFile)
+        mSpillFile = BMXFileIO::OpenTemp();
+
+    segment->Spill(mSpillFile);
+}
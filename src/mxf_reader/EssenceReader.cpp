@@ -57,6 +57,10 @@ using namespace bmx;
 using namespace mxfpp;
 
 
+// minimum number of edit units covered by a read-ahead hint
+#define READ_AHEAD_EDIT_UNITS   16
+
+
 EssenceReaderBuffer::EssenceReaderBuffer(MXFFileReader *file_reader)
 {
     mFileReader = file_reader;
@@ -66,7 +70,7 @@ EssenceReaderBuffer::EssenceReaderBuffer(MXFFileReader *file_reader)
 
     size_t t;
     for (t = 0; t < mFileReader->GetNumInternalTrackReaders(); t++)
-        mTrackFrames.push_back(deque<Frame*>());
+        mTrackFrames.push_back(vector<Frame*>());
 }
 
 EssenceReaderBuffer::~EssenceReaderBuffer()
@@ -152,6 +156,19 @@ void EssenceReaderBuffer::PushFrames(uint32_t actual_read_num_samples)
     mCurrentFrame = GetBufferSize(); // i.e. not set
 }
 
+void EssenceReaderBuffer::AbortRead()
+{
+    // remove the frames prepared for the failed read so that a retry reads the file again
+    if (mCurrentFrame < GetBufferSize()) {
+        if (mBufferFrames)
+            ClearFromFrame(mCurrentFrame);
+        else
+            Clear();
+    }
+
+    mCurrentFrame = GetBufferSize(); // i.e. not set
+}
+
 Frame* EssenceReaderBuffer::TakeFrame(uint32_t track_index)
 {
     BMX_ASSERT(track_index < mTrackFrames.size() && mCurrentFrame < mTrackFrames[track_index].size());
@@ -196,17 +213,25 @@ void EssenceReaderBuffer::Clear()
 
 void EssenceReaderBuffer::ClearBeforeFrames(size_t offset)
 {
+    if (offset > GetBufferSize())
+        offset = GetBufferSize();
+    if (offset == 0)
+        return;
+
     size_t f;
-    for (f = 0; f < offset && !mRequestSampleCounts.empty(); f++) {
+    for (f = 0; f < offset; f++) {
         size_t t;
-        for (t = 0; t < mTrackFrames.size(); t++) {
-            delete mTrackFrames[t].front();
-            mTrackFrames[t].pop_front();
-        }
-        mStartPosition += mRequestSampleCounts.front();
-        mRequestSampleCounts.pop_front();
-        mReadSampleCounts.pop_front();
+        for (t = 0; t < mTrackFrames.size(); t++)
+            delete mTrackFrames[t][f];
+        mStartPosition += mRequestSampleCounts[f];
     }
+
+    // the vectors keep their capacity, avoiding allocations in subsequent reads
+    size_t t;
+    for (t = 0; t < mTrackFrames.size(); t++)
+        mTrackFrames[t].erase(mTrackFrames[t].begin(), mTrackFrames[t].begin() + offset);
+    mRequestSampleCounts.erase(mRequestSampleCounts.begin(), mRequestSampleCounts.begin() + offset);
+    mReadSampleCounts.erase(mReadSampleCounts.begin(), mReadSampleCounts.begin() + offset);
 }
 
 void EssenceReaderBuffer::ClearFromFrame(size_t offset)
@@ -254,6 +279,8 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
     mEssenceStartKey = g_Null_Key;
     mLastKnownFilePosition = -1;
     mLastKnownBasePosition = -1;
+    mReadAheadStart = -1;
+    mReadAheadEnd = -1;
     mHaveFooter = file_is_complete;
     mBaseReadError = false;
 
@@ -284,16 +311,22 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
     // if file is complete then read the index table segments, essence container layout and
     // determine the essence wrapping type
     if (file_is_complete) {
-        if (mFileReader->mIndexSID)
-            mIndexTableHelper.ExtractIndexTable();
-
-        // first edit unit size is used to determine the essence wrapping type
-        int64_t first_edit_unit_size = 0;
-        if (mIndexTableHelper.HaveEditUnitSize(0)) {
-            int64_t offset;
-            mIndexTableHelper.GetEditUnit(0, &offset, &first_edit_unit_size);
+        MXFIndexCache *index_cache = mFileReader->mIndexCache;
+        if (!index_cache || !index_cache->RestoreEssenceIndex(mFileReader, &mEssenceChunkHelper, &mIndexTableHelper)) {
+            if (mFileReader->mIndexSID)
+                mIndexTableHelper.ExtractIndexTable();
+
+            // first edit unit size is used to determine the essence wrapping type
+            int64_t first_edit_unit_size = 0;
+            if (mIndexTableHelper.HaveEditUnitSize(0)) {
+                int64_t offset;
+                mIndexTableHelper.GetEditUnit(0, &offset, &first_edit_unit_size);
+            }
+            mEssenceChunkHelper.CreateEssenceChunkIndex(first_edit_unit_size);
+
+            if (index_cache)
+                index_cache->Write(mFileReader, &mEssenceChunkHelper, &mIndexTableHelper);
         }
-        mEssenceChunkHelper.CreateEssenceChunkIndex(first_edit_unit_size);
         BMX_ASSERT(mEssenceChunkHelper.IsComplete());
 
         // if the essence wrapping type still unknown then go with the guessed type
@@ -426,10 +459,20 @@ uint32_t EssenceReader::Read(uint32_t num_samples)
 
         // read the samples
         int64_t start_position = mPosition;
-        if (mFileReader->IsClipWrapped())
-            actual_read_num_samples = ReadClipWrappedSamples(read_num_samples);
-        else
-            actual_read_num_samples = ReadFrameWrappedSamples(read_num_samples);
+        try
+        {
+            if (mFileReader->IsClipWrapped())
+                actual_read_num_samples = ReadClipWrappedSamples(read_num_samples);
+            else
+                actual_read_num_samples = ReadFrameWrappedSamples(read_num_samples);
+        }
+        catch (...)
+        {
+            mReadFrameBuffer.AbortRead();
+            throw;
+        }
+        if (actual_read_num_samples == read_num_samples)
+            ReadAhead(mPosition, read_num_samples);
 
         // add frame metadata and information associated with first sample in frame
         int64_t essence_offset = 0;
@@ -520,23 +563,35 @@ uint32_t EssenceReader::ReadClipWrappedSamples(uint32_t num_samples)
 
         if (frame) {
             BMX_CHECK(size >= mImageStartOffset + mImageEndOffset);
+            BMX_CHECK(size <= UINT32_MAX);
 
-            if (current_file_position != file_position)
-                mFile->seek(file_position, SEEK_SET);
-            current_file_position = file_position;
+            if (ReferenceFileData(frame, file_position + mImageStartOffset,
+                                  (uint32_t)(size - mImageStartOffset - mImageEndOffset)))
+            {
+                mFile->seek(file_position + size, SEEK_SET);
+                current_file_position = file_position + size;
+                size -= mImageStartOffset + mImageEndOffset;
+            }
+            else
+            {
+                if (current_file_position != file_position)
+                    mFile->seek(file_position, SEEK_SET);
+                current_file_position = file_position;
+
+                frame->Grow((uint32_t)size);
+                uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)size);
+                current_file_position += num_read;
+                BMX_CHECK(num_read == size);
+
+                size -= mImageEndOffset;
+                if (mImageStartOffset > 0) {
+                    memmove(frame->GetBytesAvailable(),
+                            frame->GetBytesAvailable() + mImageStartOffset,
+                            (uint32_t)(size - mImageStartOffset));
+                    size -= mImageStartOffset;
+                }
 
-            BMX_CHECK(size <= UINT32_MAX);
-            frame->Grow((uint32_t)size);
-            uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)size);
-            current_file_position += num_read;
-            BMX_CHECK(num_read == size);
-
-            size -= mImageEndOffset;
-            if (mImageStartOffset > 0) {
-                memmove(frame->GetBytesAvailable(),
-                        frame->GetBytesAvailable() + mImageStartOffset,
-                        (uint32_t)(size - mImageStartOffset));
-                size -= mImageStartOffset;
+                frame->IncrementSize((uint32_t)size);
             }
 
             if (frame->IsEmpty()) {
@@ -548,7 +603,6 @@ uint32_t EssenceReader::ReadClipWrappedSamples(uint32_t num_samples)
                 frame->element_key         = element_key;
             }
 
-            frame->IncrementSize((uint32_t)size);
             frame->num_samples += num_cont_samples;
         } else {
             mFile->seek(file_position + size, SEEK_SET);
@@ -634,15 +688,19 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
 
                 if (frame) {
                     BMX_CHECK(len <= UINT32_MAX);
-                    frame->Grow((uint32_t)len);
-                    if (!mParseOnly)
-                    {
-                        uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)len);
-                        BMX_CHECK(num_read == len);
-                    } else {
+                    if (!mParseOnly && ReferenceFileData(frame, mFile->tell(), (uint32_t)len)) {
                         mFile->skip(len);
+                    } else {
+                        frame->Grow((uint32_t)len);
+                        if (!mParseOnly)
+                        {
+                            uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)len);
+                            BMX_CHECK(num_read == len);
+                        } else {
+                            mFile->skip(len);
+                        }
+                        frame->IncrementSize((uint32_t)len);
                     }
-                    frame->IncrementSize((uint32_t)len);
                     frame->num_samples++;
                 } else {
                     mFile->skip(len);
@@ -670,6 +728,63 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
     return num_samples;
 }
 
+void EssenceReader::ReadAhead(int64_t position, uint32_t num_samples)
+{
+    // tell the file which range is likely to be read next so that it can be loaded in the background
+
+    if (mParseOnly || !IsComplete())
+        return;
+
+    // the previous hint still covers the next range
+    if (position >= mReadAheadStart && position + num_samples <= mReadAheadEnd)
+        return;
+
+    int64_t end_position = position + (num_samples > READ_AHEAD_EDIT_UNITS ? num_samples : READ_AHEAD_EDIT_UNITS);
+    if (end_position > mReadStartPosition + mReadDuration)
+        end_position = mReadStartPosition + mReadDuration;
+    if (end_position > mIndexTableHelper.GetDuration())
+        end_position = mIndexTableHelper.GetDuration();
+    if (position < 0 || end_position <= position ||
+        !mIndexTableHelper.HaveEditUnitSize(position) ||
+        !mIndexTableHelper.HaveEditUnitSize(end_position - 1))
+    {
+        return;
+    }
+
+    mxfKey element_key;
+    int64_t first_file_position, first_size;
+    int64_t last_file_position, last_size;
+    GetEditUnit(position, &element_key, &first_file_position, &first_size);
+    GetEditUnit(end_position - 1, &element_key, &last_file_position, &last_size);
+    if (last_file_position + last_size > first_file_position)
+        mFile->readAhead(first_file_position, last_file_position + last_size - first_file_position);
+
+    mReadAheadStart = position;
+    mReadAheadEnd = end_position;
+}
+
+bool EssenceReader::ReferenceFileData(Frame *frame, int64_t file_position, uint32_t size)
+{
+    // memory-mapped file data is referenced by the frame rather than copied into it
+
+    if (frame->GetSize() > 0)
+        return false;
+
+    const unsigned char *data = mFile->mapData(file_position, size);
+    if (!data)
+        return false;
+
+    // frames hold a reference to the mapping so that the data remains valid after the file is closed
+    if (!mFileMap) {
+        MXFFileMap *file_map = mFile->refMap();
+        if (!file_map)
+            return false;
+        mFileMap = shared_ptr<const void>(file_map, mxf_file_unref_map);
+    }
+
+    return frame->ReferenceBytes(data, size, mFileMap);
+}
+
 void EssenceReader::GetEditUnit(int64_t position, mxfKey *element_key, int64_t *file_position, int64_t *size)
 {
     int64_t essence_offset, essence_size;
@@ -61,23 +61,45 @@ static const mxfKey ESSENCE_MARK_UTF16_KEY =
 
 
 
+template <class T>
+static T* get_reset_metadata(T *metadata)
+{
+    // the metadata is reused if no frame holds a reference to it
+    if (metadata && !metadata->IsShared()) {
+        metadata->Reset();
+        return metadata;
+    }
+
+    if (metadata)
+        metadata->Release();
+    return new T();
+}
+
+
+
 SystemScheme1Reader::SystemScheme1Reader(File *file, Rational frame_rate, bool is_bbc_preservation_file)
 {
     mFile = file;
     mFrameRate = frame_rate;
     mIsBBCPreservationFile = is_bbc_preservation_file;
     mTimecodeArray = 0;
+    mHaveTimecodeArray = false;
 }
 
 SystemScheme1Reader::~SystemScheme1Reader()
 {
-    delete mTimecodeArray;
+    if (mTimecodeArray)
+        mTimecodeArray->Release();
+    size_t i;
+    for (i = 0; i < mChecksums.size(); i++) {
+        if (mChecksums[i])
+            mChecksums[i]->Release();
+    }
 }
 
 void SystemScheme1Reader::Reset()
 {
-    delete mTimecodeArray;
-    mTimecodeArray = 0;
+    mHaveTimecodeArray = false;
     mCRC32s.clear();
     mTrackNumbers.clear();
 }
@@ -115,8 +137,16 @@ bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
 
                 uint32_t i;
                 for (i = 0; i < array_len; i++) {
-                    if (!mTimecodeArray)
-                        mTimecodeArray = new SS1TimecodeArray(mFrameRate, mIsBBCPreservationFile);
+                    if (!mHaveTimecodeArray) {
+                        if (mTimecodeArray && !mTimecodeArray->IsShared()) {
+                            mTimecodeArray->mS12MTimecodes.clear();
+                        } else {
+                            if (mTimecodeArray)
+                                mTimecodeArray->Release();
+                            mTimecodeArray = new SS1TimecodeArray(mFrameRate, mIsBBCPreservationFile);
+                        }
+                        mHaveTimecodeArray = true;
+                    }
                     BMX_CHECK(mFile->read(s12m.bytes, sizeof(s12m.bytes)) == sizeof(s12m.bytes));
                     read_count += sizeof(s12m.bytes);
                     mTimecodeArray->mS12MTimecodes.push_back(s12m);
@@ -158,14 +188,23 @@ bool SystemScheme1Reader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
 
 void SystemScheme1Reader::InsertFrameMetadata(Frame *frame, uint32_t track_number)
 {
-    if (mTimecodeArray)
-        frame->InsertMetadata(new SS1TimecodeArray(*mTimecodeArray));
+    if (mHaveTimecodeArray)
+        frame->InsertMetadata(mTimecodeArray->AddRef());
 
     if (!mCRC32s.empty()) {
         size_t i;
         for (i = 0; i < mCRC32s.size() && i < mTrackNumbers.size(); i++) {
             if (mTrackNumbers[i] == track_number) {
-                frame->InsertMetadata(new SS1APPChecksum(mCRC32s[i]));
+                if (i >= mChecksums.size())
+                    mChecksums.resize(i + 1, 0);
+                if (mChecksums[i] && !mChecksums[i]->IsShared()) {
+                    mChecksums[i]->mCRC32 = mCRC32s[i];
+                } else {
+                    if (mChecksums[i])
+                        mChecksums[i]->Release();
+                    mChecksums[i] = new SS1APPChecksum(mCRC32s[i]);
+                }
+                frame->InsertMetadata(mChecksums[i]->AddRef());
                 break;
             }
         }
@@ -178,17 +217,18 @@ SDTICPSystemMetadataReader::SDTICPSystemMetadataReader(File *file)
 {
     mFile = file;
     mMetadata = 0;
+    mHaveMetadata = false;
 }
 
 SDTICPSystemMetadataReader::~SDTICPSystemMetadataReader()
 {
-    delete mMetadata;
+    if (mMetadata)
+        mMetadata->Release();
 }
 
 void SDTICPSystemMetadataReader::Reset()
 {
-    delete mMetadata;
-    mMetadata = 0;
+    mHaveMetadata = false;
 }
 
 bool SDTICPSystemMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
@@ -196,8 +236,8 @@ bool SDTICPSystemMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_
     if (!mxf_equals_key(key, &MXF_EE_K(SDTI_CP_System_Pack)))
         return false;
 
-    delete mMetadata;
-    mMetadata = new SDTICPSystemMetadata();
+    mMetadata = get_reset_metadata(mMetadata);
+    mHaveMetadata = true;
 
     BMX_CHECK_M(len >= 2 && len <= 57,
                 ("Unexpected len %" PRIu64 " for system metadata pack", len));
@@ -247,8 +287,8 @@ void SDTICPSystemMetadataReader::InsertFrameMetadata(Frame *frame, uint32_t trac
 {
     (void)track_number;
 
-    if (mMetadata)
-        frame->InsertMetadata(new SDTICPSystemMetadata(*mMetadata));
+    if (mHaveMetadata)
+        frame->InsertMetadata(mMetadata->AddRef());
 }
 
 
@@ -257,17 +297,18 @@ SDTICPPackageMetadataReader::SDTICPPackageMetadataReader(File *file)
 {
     mFile = file;
     mMetadata = 0;
+    mHaveMetadata = false;
 }
 
 SDTICPPackageMetadataReader::~SDTICPPackageMetadataReader()
 {
-    delete mMetadata;
+    if (mMetadata)
+        mMetadata->Release();
 }
 
 void SDTICPPackageMetadataReader::Reset()
 {
-    delete mMetadata;
-    mMetadata = 0;
+    mHaveMetadata = false;
 }
 
 bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64_t len)
@@ -275,8 +316,8 @@ bool SDTICPPackageMetadataReader::ProcessFrameMetadata(const mxfKey *key, uint64
     if (!mxf_equals_key_prefix(key, &SDTI_CP_PACKAGE_META_KEY_PREFIX, 15))
         return false;
 
-    delete mMetadata;
-    mMetadata = new SDTICPPackageMetadata();
+    mMetadata = get_reset_metadata(mMetadata);
+    mHaveMetadata = true;
 
     uint64_t read_count = 0;
     uint8_t block_tag;
@@ -344,8 +385,8 @@ void SDTICPPackageMetadataReader::InsertFrameMetadata(Frame *frame, uint32_t tra
 {
     (void)track_number;
 
-    if (mMetadata)
-        frame->InsertMetadata(new SDTICPPackageMetadata(*mMetadata));
+    if (mHaveMetadata)
+        frame->InsertMetadata(mMetadata->AddRef());
 }
 
 
@@ -316,6 +316,120 @@ void IndexTableHelperSegment::CopyIndexEntries(const IndexTableHelperSegment *fr
 }
 
 
+void IndexTableHelperSegment::ReadCache(File *cache_file)
+{
+    BMX_ASSERT(!mIndexEntries);
+
+    mxfRational edit_rate;
+    edit_rate.numerator   = cache_file->readInt32();
+    edit_rate.denominator = cache_file->readInt32();
+    setIndexEditRate(edit_rate);
+    setIndexStartPosition(cache_file->readInt64());
+    setIndexDuration(cache_file->readInt64());
+    setEditUnitByteCount(cache_file->readUInt32());
+    setIndexSID(cache_file->readUInt32());
+    setBodySID(cache_file->readUInt32());
+    setSliceCount(cache_file->readUInt8());
+    setPosTableCount(cache_file->readUInt8());
+
+    uint32_t num_delta_entries = cache_file->readUInt32();
+    uint32_t i;
+    for (i = 0; i < num_delta_entries; i++) {
+        int8_t pos_table_index = cache_file->readInt8();
+        uint8_t slice          = cache_file->readUInt8();
+        uint32_t element_data  = cache_file->readUInt32();
+        appendDeltaEntry(pos_table_index, slice, element_data);
+    }
+
+    mIsFileIndexSegment     = (cache_file->readUInt8() != 0);
+    mHaveExtraIndexEntries  = (cache_file->readUInt8() != 0);
+    mHavePairedIndexEntries = (cache_file->readUInt8() != 0);
+    mIndexEndOffset         = cache_file->readInt64();
+    mEssenceStartOffset     = cache_file->readInt64();
+
+    uint32_t alloc_entries = cache_file->readUInt32();
+    uint32_t entries_start = cache_file->readUInt32();
+    uint32_t num_entries   = cache_file->readUInt32();
+    BMX_CHECK(num_entries <= alloc_entries && entries_start <= alloc_entries);
+    if (alloc_entries > 0) {
+        mIndexEntries = new unsigned char[INTERNAL_INDEX_ENTRY_SIZE * alloc_entries];
+        mAllocIndexEntries = alloc_entries;
+        mEntriesStart = entries_start;
+
+        // the stream offsets are stored big-endian in the cache and converted in place
+        uint32_t chunk_entries = 65536;
+        for (i = 0; i < num_entries; i += chunk_entries) {
+            if (chunk_entries > num_entries - i)
+                chunk_entries = num_entries - i;
+            uint32_t chunk_size = INTERNAL_INDEX_ENTRY_SIZE * chunk_entries;
+            BMX_CHECK(cache_file->read(&mIndexEntries[i * INTERNAL_INDEX_ENTRY_SIZE], chunk_size) == chunk_size);
+        }
+        int64_t stream_offset;
+        for (i = 0; i < num_entries; i++) {
+            mxf_get_int64(&mIndexEntries[i * INTERNAL_INDEX_ENTRY_SIZE + 3], &stream_offset);
+            GET_STREAM_OFFSET(i) = stream_offset;
+        }
+        mNumIndexEntries = num_entries;
+    }
+}
+
+void IndexTableHelperSegment::WriteCache(File *cache_file) const
+{
+    cache_file->writeInt32(getIndexEditRate().numerator);
+    cache_file->writeInt32(getIndexEditRate().denominator);
+    cache_file->writeInt64(getIndexStartPosition());
+    cache_file->writeInt64(getIndexDuration());
+    cache_file->writeUInt32(getEditUnitByteCount());
+    cache_file->writeUInt32(getIndexSID());
+    cache_file->writeUInt32(getBodySID());
+    cache_file->writeUInt8(getSliceCount());
+    cache_file->writeUInt8(getPosTableCount());
+
+    uint32_t num_delta_entries = 0;
+    const MXFDeltaEntry *delta_entry = _cSegment->deltaEntryArray;
+    while (delta_entry) {
+        num_delta_entries++;
+        delta_entry = delta_entry->next;
+    }
+    cache_file->writeUInt32(num_delta_entries);
+    delta_entry = _cSegment->deltaEntryArray;
+    while (delta_entry) {
+        cache_file->writeInt8(delta_entry->posTableIndex);
+        cache_file->writeUInt8(delta_entry->slice);
+        cache_file->writeUInt32(delta_entry->elementData);
+        delta_entry = delta_entry->next;
+    }
+
+    cache_file->writeUInt8(mIsFileIndexSegment);
+    cache_file->writeUInt8(mHaveExtraIndexEntries);
+    cache_file->writeUInt8(mHavePairedIndexEntries);
+    cache_file->writeInt64(mIndexEndOffset);
+    cache_file->writeInt64(mEssenceStartOffset);
+
+    // the entries are written from the start of the array because that is where GetEditUnit reads them
+    cache_file->writeUInt32(mAllocIndexEntries);
+    cache_file->writeUInt32(mEntriesStart);
+    cache_file->writeUInt32(mNumIndexEntries);
+    if (mNumIndexEntries > 0) {
+        uint32_t chunk_entries = 65536;
+        if (chunk_entries > mNumIndexEntries)
+            chunk_entries = mNumIndexEntries;
+        vector<unsigned char> buffer(INTERNAL_INDEX_ENTRY_SIZE * chunk_entries);
+        uint32_t i, j;
+        for (i = 0; i < mNumIndexEntries; i += chunk_entries) {
+            if (chunk_entries > mNumIndexEntries - i)
+                chunk_entries = mNumIndexEntries - i;
+            for (j = 0; j < chunk_entries; j++) {
+                uint32_t entry_pos = i + j;
+                memcpy(&buffer[j * INTERNAL_INDEX_ENTRY_SIZE], &mIndexEntries[entry_pos * INTERNAL_INDEX_ENTRY_SIZE], 3);
+                mxf_set_int64(GET_STREAM_OFFSET(entry_pos), &buffer[j * INTERNAL_INDEX_ENTRY_SIZE + 3]);
+            }
+            uint32_t chunk_size = INTERNAL_INDEX_ENTRY_SIZE * chunk_entries;
+            BMX_CHECK(cache_file->write(&buffer[0], chunk_size) == chunk_size);
+        }
+    }
+}
+
 
 
 IndexTableHelper::IndexTableHelper(MXFFileReader *file_reader)
@@ -40,7 +40,10 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <system_error>
+#include <thread>
 
 #include <bmx/mxf_reader/MXFFileReader.h>
 #include <bmx/mxf_reader/MXFTimedTextTrackReader.h>
@@ -98,6 +101,50 @@ static const char *RESULT_STRINGS[] =
 };
 
 
+
+typedef struct
+{
+    const vector<MXFFileReader*> *readers;
+    const vector<string> *filenames;
+    vector<File*> *files;
+    int mode_flags;
+    vector<MXFFileReader::OpenResult> *results;
+    mutex next_mutex;
+    size_t next_index;
+} ConcurrentOpenContext;
+
+
+
+static void open_concurrent_worker(ConcurrentOpenContext *context)
+{
+    while (true) {
+        size_t index;
+        {
+            lock_guard<mutex> lock(context->next_mutex);
+            if (context->next_index >= context->readers->size())
+                break;
+            index = context->next_index++;
+        }
+
+        File *file = (*context->files)[index];
+        if (!file)
+            continue;
+
+        MXFFileReader *reader = (*context->readers)[index];
+        const string &filename = (*context->filenames)[index];
+        MXFFileReader::OpenResult result;
+        if (filename.empty())
+            result = reader->Open(file, URI("stdin:"), URI(), "", context->mode_flags);
+        else
+            result = reader->Open(file, filename, context->mode_flags);
+        if (result != MXFFileReader::MXF_RESULT_SUCCESS)
+            delete file;
+
+        (*context->results)[index] = result;
+    }
+}
+
+
 #define THROW_RESULT(result)                                                        \
     do {                                                                            \
         log_warn("Open error '%s' near %s:%d\n", #result, __FILENAME__, __LINE__);  \
@@ -141,6 +188,53 @@ string MXFFileReader::ResultToString(OpenResult result)
     return RESULT_STRINGS[index];
 }
 
+void MXFFileReader::OpenConcurrent(const vector<MXFFileReader*> &readers, const vector<string> &filenames,
+                                   int mode_flags, uint32_t num_threads, vector<OpenResult> *results)
+{
+    BMX_ASSERT(readers.size() == filenames.size());
+
+    results->assign(readers.size(), MXF_RESULT_OPEN_FAIL);
+
+    // the files are opened in this thread to preserve the order in which the file factory sees them
+    vector<File*> files(readers.size(), 0);
+    size_t i;
+    for (i = 0; i < readers.size(); i++) {
+        try
+        {
+            files[i] = readers[i]->mFileFactory->OpenRead(filenames[i]);
+        }
+        catch (...)
+        {
+            files[i] = 0;
+        }
+    }
+
+    ConcurrentOpenContext context;
+    context.readers    = &readers;
+    context.filenames  = &filenames;
+    context.files      = &files;
+    context.mode_flags = mode_flags;
+    context.results    = results;
+    context.next_index = 0;
+
+    // this thread also takes part in opening the readers
+    vector<thread> threads;
+    for (i = 1; i < num_threads && i < readers.size(); i++) {
+        try
+        {
+            threads.push_back(thread(open_concurrent_worker, &context));
+        }
+        catch (const system_error &ex)
+        {
+            log_warn("Failed to start thread for opening MXF files: %s\n", ex.what());
+            break;
+        }
+    }
+    open_concurrent_worker(&context);
+    for (i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
 
 MXFFileReader::MXFFileReader()
 : MXFReader()
@@ -163,6 +257,9 @@ MXFFileReader::MXFFileReader()
     mReadDuration = -1;
     mFileOrigin = 0;
     mEnableIndexFile = true;
+    mLazyHeaderMetadata = false;
+    mEnableIndexCache = false;
+    mIndexCache = 0;
     mEssenceReader = 0;
     mRequireFrameInfoCount = 0;
     mST436ManifestCount = 2;
@@ -183,6 +280,7 @@ MXFFileReader::~MXFFileReader()
         delete mPackageResolver;
     if (mOwnFilefactory)
         delete mFileFactory;
+    delete mIndexCache;
     delete mEssenceReader;
     delete mFile;
     delete mHeaderMetadata;
@@ -256,6 +354,23 @@ void MXFFileReader::SetEnableIndexFile(bool enable)
     mEnableIndexFile = enable;
 }
 
+void MXFFileReader::SetUseHeaderMetadataArena(bool enable)
+{
+    BMX_CHECK(!mFile);
+
+    mHeaderMetadata->setUseArena(enable);
+}
+
+void MXFFileReader::SetLazyHeaderMetadata(bool enable)
+{
+    mLazyHeaderMetadata = enable;
+}
+
+void MXFFileReader::SetEnableIndexCache(bool enable)
+{
+    mEnableIndexCache = enable;
+}
+
 MXFFileReader::OpenResult MXFFileReader::Open(string filename, int mode_flags)
 {
     File *file = 0;
@@ -349,7 +464,22 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
         Partition *metadata_partition = 0;
         bool own_metadata_partition = false;
         if (mEnableIndexFile) {
-            if (mFile->isSeekable()) {
+            if (mFile->isSeekable() && mEnableIndexCache && !filename.empty() && !mxf_http_is_url(filename)) {
+                try
+                {
+                    mIndexCache = new MXFIndexCache(filename + ".bmxidx", get_file_size(filename),
+                                                    get_file_modification_time(filename));
+                    if (mIndexCache->Read(mFile))
+                        file_is_complete = mIndexCache->RestorePartitions(mFile);
+                }
+                catch (const BMXException &ex)
+                {
+                    log_warn("Failed to use index cache: %s\n", ex.what());
+                    delete mIndexCache;
+                    mIndexCache = 0;
+                }
+            }
+            if (mFile->isSeekable() && !file_is_complete) {
                 file_is_complete = mFile->readPartitions();
                 if (!file_is_complete) {
                     BMX_ASSERT(mFile->getPartitions().size() == 1);
@@ -406,7 +536,10 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
             mFile->readNextNonFillerKL(&key, &llen, &len);
             BMX_CHECK(mxf_is_header_metadata(&key));
 
-            mHeaderMetadata->read(mFile, metadata_partition, &key, llen, len);
+            if (mLazyHeaderMetadata)
+                mHeaderMetadata->readLazy(mFile, metadata_partition, &key, llen, len);
+            else
+                mHeaderMetadata->read(mFile, metadata_partition, &key, llen, len);
 
             ProcessMetadata(metadata_partition);
 
@@ -495,6 +628,9 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
     }
 
     // clean up
+    delete mIndexCache;
+    mIndexCache = 0;
+
     if (result != MXF_RESULT_SUCCESS) {
         mFile = 0;
         delete mEssenceReader;
@@ -50,6 +50,13 @@ const char *bmx::SYSTEM_SCHEME_1_FMETA_ID           = "SYSTEM_SCHEME_1";
 const char *bmx::SDTI_CP_SYSTEM_METADATA_FMETA_ID   = "SDTICP_SYS_META";
 const char *bmx::SDTI_CP_PACKAGE_METADATA_FMETA_ID  = "SDTICP_PACK_META";
 
+const FrameMetadataId bmx::SYSTEM_SCHEME_1_FMETA_NUM_ID =
+    FrameMetadata::RegisterId(SYSTEM_SCHEME_1_FMETA_ID);
+const FrameMetadataId bmx::SDTI_CP_SYSTEM_METADATA_FMETA_NUM_ID =
+    FrameMetadata::RegisterId(SDTI_CP_SYSTEM_METADATA_FMETA_ID);
+const FrameMetadataId bmx::SDTI_CP_PACKAGE_METADATA_FMETA_NUM_ID =
+    FrameMetadata::RegisterId(SDTI_CP_PACKAGE_METADATA_FMETA_ID);
+
 
 
 SystemScheme1Metadata::SystemScheme1Metadata(Type type)
@@ -118,6 +125,15 @@ FrameMetadata* SS1APPChecksum::Clone()
 
 SDTICPSystemMetadata::SDTICPSystemMetadata()
 : FrameMetadata(SDTI_CP_SYSTEM_METADATA_FMETA_ID)
+{
+    Reset();
+}
+
+SDTICPSystemMetadata::~SDTICPSystemMetadata()
+{
+}
+
+void SDTICPSystemMetadata::Reset()
 {
     mCPRate = ZERO_RATIONAL;
     mHaveCreationTimecode = false;
@@ -126,10 +142,6 @@ SDTICPSystemMetadata::SDTICPSystemMetadata()
     memset(&mUserTimecode, 0, sizeof(mUserTimecode));
 }
 
-SDTICPSystemMetadata::~SDTICPSystemMetadata()
-{
-}
-
 FrameMetadata* SDTICPSystemMetadata::Clone()
 {
     return new SDTICPSystemMetadata(*this);
@@ -139,14 +151,20 @@ FrameMetadata* SDTICPSystemMetadata::Clone()
 SDTICPPackageMetadata::SDTICPPackageMetadata()
 : FrameMetadata(SDTI_CP_PACKAGE_METADATA_FMETA_ID)
 {
-    mHaveUMID = false;
-    memset(mUMID.bytes, 0, sizeof(mUMID.bytes));
+    Reset();
 }
 
 SDTICPPackageMetadata::~SDTICPPackageMetadata()
 {
 }
 
+void SDTICPPackageMetadata::Reset()
+{
+    mHaveUMID = false;
+    memset(mUMID.bytes, 0, sizeof(mUMID.bytes));
+    mEssenceMark.clear();
+}
+
 FrameMetadata* SDTICPPackageMetadata::Clone()
 {
     return new SDTICPPackageMetadata(*this);
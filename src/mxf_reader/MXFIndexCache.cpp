@@ -0,0 +1,505 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+#include <memory>
+
+#include <bmx/mxf_reader/MXFIndexCache.h>
+#include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+#define CACHE_VERSION   2
+
+static const mxfKey CACHE_START_KEY =
+    {0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x62, 0x6d, 0x78, 0x69, 0x64, 0x78, 0x00, 0x01};
+static const mxfKey CACHE_END_KEY =
+    {0x06, 0x0e, 0x2b, 0x34, 0x01, 0x01, 0x01, 0x01, 0x62, 0x6d, 0x78, 0x69, 0x64, 0x78, 0x00, 0x02};
+
+// static local tags of the Preface identity properties
+#define INSTANCE_UID_TAG        0x3c0a
+#define GENERATION_UID_TAG      0x0102
+#define LAST_MODIFIED_DATE_TAG  0x3b02
+
+
+
+static void write_partition(File *cache_file, const Partition *partition)
+{
+    cache_file->writeUL(partition->getKey());
+    cache_file->writeUInt16(partition->getMajorVersion());
+    cache_file->writeUInt16(partition->getMinorVersion());
+    cache_file->writeUInt32(partition->getKagSize());
+    cache_file->writeUInt64(partition->getThisPartition());
+    cache_file->writeUInt64(partition->getPreviousPartition());
+    cache_file->writeUInt64(partition->getFooterPartition());
+    cache_file->writeUInt64(partition->getHeaderByteCount());
+    cache_file->writeUInt64(partition->getIndexByteCount());
+    cache_file->writeUInt32(partition->getIndexSID());
+    cache_file->writeUInt64(partition->getBodyOffset());
+    cache_file->writeUInt32(partition->getBodySID());
+    cache_file->writeUL(partition->getOperationalPattern());
+
+    vector<mxfUL> essence_containers = partition->getEssenceContainers();
+    cache_file->writeUInt32((uint32_t)essence_containers.size());
+    size_t i;
+    for (i = 0; i < essence_containers.size(); i++)
+        cache_file->writeUL(&essence_containers[i]);
+}
+
+static Partition* read_partition(File *cache_file)
+{
+    unique_ptr<Partition> partition(new Partition());
+
+    mxfKey key;
+    cache_file->readK(&key);
+    partition->setKey(&key);
+    uint16_t major_version = cache_file->readUInt16();
+    uint16_t minor_version = cache_file->readUInt16();
+    partition->setVersion(major_version, minor_version);
+    partition->setKagSize(cache_file->readUInt32());
+    partition->setThisPartition(cache_file->readUInt64());
+    partition->setPreviousPartition(cache_file->readUInt64());
+    partition->setFooterPartition(cache_file->readUInt64());
+    partition->setHeaderByteCount(cache_file->readUInt64());
+    partition->setIndexByteCount(cache_file->readUInt64());
+    partition->setIndexSID(cache_file->readUInt32());
+    partition->setBodyOffset(cache_file->readUInt64());
+    partition->setBodySID(cache_file->readUInt32());
+    mxfUL label;
+    cache_file->readK(&label);
+    partition->setOperationalPattern(&label);
+
+    uint32_t num_essence_containers = cache_file->readUInt32();
+    uint32_t i;
+    for (i = 0; i < num_essence_containers; i++) {
+        cache_file->readK(&label);
+        partition->addEssenceContainer(&label);
+    }
+
+    return partition.release();
+}
+
+static void write_uuid(File *cache_file, const mxfUUID *uuid)
+{
+    BMX_CHECK(cache_file->write((const unsigned char*)uuid, mxfUUID_extlen) == mxfUUID_extlen);
+}
+
+static void read_uuid(File *cache_file, mxfUUID *uuid)
+{
+    BMX_CHECK(cache_file->read((unsigned char*)uuid, mxfUUID_extlen) == mxfUUID_extlen);
+}
+
+static void write_timestamp(File *cache_file, const mxfTimestamp *timestamp)
+{
+    cache_file->writeInt16(timestamp->year);
+    cache_file->writeUInt8(timestamp->month);
+    cache_file->writeUInt8(timestamp->day);
+    cache_file->writeUInt8(timestamp->hour);
+    cache_file->writeUInt8(timestamp->min);
+    cache_file->writeUInt8(timestamp->sec);
+    cache_file->writeUInt8(timestamp->qmsec);
+}
+
+static void read_timestamp(File *cache_file, mxfTimestamp *timestamp)
+{
+    timestamp->year  = cache_file->readInt16();
+    timestamp->month = cache_file->readUInt8();
+    timestamp->day   = cache_file->readUInt8();
+    timestamp->hour  = cache_file->readUInt8();
+    timestamp->min   = cache_file->readUInt8();
+    timestamp->sec   = cache_file->readUInt8();
+    timestamp->qmsec = cache_file->readUInt8();
+}
+
+static bool equals_timestamp(const mxfTimestamp *left, const mxfTimestamp *right)
+{
+    return left->year  == right->year &&
+           left->month == right->month &&
+           left->day   == right->day &&
+           left->hour  == right->hour &&
+           left->min   == right->min &&
+           left->sec   == right->sec &&
+           left->qmsec == right->qmsec;
+}
+
+static bool equals_partition(const Partition *left, const Partition *right)
+{
+    if (!mxf_equals_key(left->getKey(), right->getKey()) ||
+        left->getMajorVersion()      != right->getMajorVersion() ||
+        left->getMinorVersion()      != right->getMinorVersion() ||
+        left->getKagSize()           != right->getKagSize() ||
+        left->getThisPartition()     != right->getThisPartition() ||
+        left->getPreviousPartition() != right->getPreviousPartition() ||
+        left->getFooterPartition()   != right->getFooterPartition() ||
+        left->getHeaderByteCount()   != right->getHeaderByteCount() ||
+        left->getIndexByteCount()    != right->getIndexByteCount() ||
+        left->getIndexSID()          != right->getIndexSID() ||
+        left->getBodyOffset()        != right->getBodyOffset() ||
+        left->getBodySID()           != right->getBodySID() ||
+        !mxf_equals_ul(left->getOperationalPattern(), right->getOperationalPattern()))
+    {
+        return false;
+    }
+
+    return left->getEssenceContainers() == right->getEssenceContainers();
+}
+
+
+
+MXFIndexCache::MXFIndexCache(const string &cache_filename, int64_t file_size, int64_t modification_time)
+{
+    mCacheFilename = cache_filename;
+    mFileSize = file_size;
+    mModificationTime = modification_time;
+    mPrefaceInstanceUID = g_Null_UUID;
+    mPrefaceGenerationUID = g_Null_UUID;
+    memset(&mPrefaceLastModifiedDate, 0, sizeof(mPrefaceLastModifiedDate));
+    mHaveCache = false;
+    mBodySID = 0;
+    mIndexSID = 0;
+    mWrappingType = MXF_UNKNOWN_WRAPPING_TYPE;
+    mNumIndexedPartitions = 0;
+    mIndexIsComplete = false;
+    mIndexEditRate = ZERO_RATIONAL;
+    mIndexEditUnitSize = 0;
+    mIndexDuration = 0;
+}
+
+MXFIndexCache::~MXFIndexCache()
+{
+    Clear();
+}
+
+bool MXFIndexCache::Read(File *mxf_file)
+{
+    Clear();
+
+    ReadPrefaceIdentity(mxf_file);
+
+    if (!check_file_exists(mCacheFilename))
+        return false;
+
+    File *cache_file = 0;
+    try
+    {
+        cache_file = File::openRead(mCacheFilename);
+        ReadCache(cache_file, &mxf_file->getPartition(0));
+        delete cache_file;
+    }
+    catch (...)
+    {
+        delete cache_file;
+    }
+
+    if (!mHaveCache)
+        Clear();
+
+    if (mHaveCache)
+        log_debug("Using index cache file '%s'\n", mCacheFilename.c_str());
+    else
+        log_info("Ignoring index cache file '%s' which is out of date or invalid\n", mCacheFilename.c_str());
+
+    return mHaveCache;
+}
+
+bool MXFIndexCache::RestorePartitions(File *mxf_file)
+{
+    if (!mHaveCache)
+        return false;
+
+    BMX_ASSERT(mxf_file->getPartitions().size() == 1);
+
+    // the header partition has already been read from the file and was checked against the cache
+    size_t i;
+    for (i = 1; i < mPartitions.size(); i++) {
+        mxf_file->addPartition(mPartitions[i]);
+        mPartitions[i] = 0;
+    }
+
+    return true;
+}
+
+bool MXFIndexCache::RestoreEssenceIndex(MXFFileReader *file_reader, EssenceChunkHelper *chunk_helper,
+                                        IndexTableHelper *index_helper)
+{
+    if (!mHaveCache || mBodySID != file_reader->mBodySID || mIndexSID != file_reader->mIndexSID)
+        return false;
+
+    BMX_ASSERT(chunk_helper->mEssenceChunks.empty() && index_helper->mSegments.empty());
+
+    chunk_helper->mEssenceChunks.swap(mEssenceChunks);
+    chunk_helper->mNumIndexedPartitions = mNumIndexedPartitions;
+    chunk_helper->mIsComplete = true;
+
+    index_helper->mSegments.swap(mIndexSegments);
+    index_helper->mIsComplete = mIndexIsComplete;
+    index_helper->mEditRate = mIndexEditRate;
+    index_helper->mEditUnitSize = mIndexEditUnitSize;
+    index_helper->mDuration = mIndexDuration;
+
+    if (file_reader->mWrappingType == MXF_UNKNOWN_WRAPPING_TYPE)
+        file_reader->mWrappingType = mWrappingType;
+
+    return true;
+}
+
+void MXFIndexCache::Write(MXFFileReader *file_reader, const EssenceChunkHelper *chunk_helper,
+                          const IndexTableHelper *index_helper)
+{
+    // the cache is written to a temporary file that replaces the existing cache file once it is complete,
+    // so that a reader never sees a partially written cache
+    string temp_filename = mCacheFilename + "." + get_uuid_string(generate_uuid());
+    File *cache_file = 0;
+    try
+    {
+        cache_file = File::openNew(temp_filename);
+        WriteCache(cache_file, file_reader, chunk_helper, index_helper);
+        delete cache_file;
+        cache_file = 0;
+        replace_file(temp_filename, mCacheFilename);
+    }
+    catch (...)
+    {
+        log_warn("Failed to write index cache file '%s'\n", mCacheFilename.c_str());
+        delete cache_file;
+        remove(temp_filename.c_str());
+    }
+}
+
+void MXFIndexCache::ReadPrefaceIdentity(File *mxf_file)
+{
+    // the Preface identity is read from the header metadata in the header partition without parsing the
+    // header metadata
+    const Partition &header_partition = mxf_file->getPartition(0);
+    if (header_partition.getHeaderByteCount() == 0)
+        return;
+
+    int64_t original_position = mxf_file->tell();
+    try
+    {
+        mxfKey key;
+        uint8_t llen;
+        uint64_t len;
+        mxf_file->seek(header_partition.getThisPartition(), SEEK_SET);
+        mxf_file->readKL(&key, &llen, &len);
+        mxf_file->skip(len);
+        mxf_file->readNextNonFillerKL(&key, &llen, &len);
+        BMX_CHECK(mxf_is_primer_pack(&key));
+
+        int64_t header_metadata_end = mxf_file->tell() - mxfKey_extlen - llen + header_partition.getHeaderByteCount();
+        mxf_file->skip(len);
+        while (mxf_file->tell() < header_metadata_end) {
+            mxf_file->readKL(&key, &llen, &len);
+            if (!mxf_equals_key(&key, &MXF_SET_K(Preface))) {
+                mxf_file->skip(len);
+                continue;
+            }
+
+            uint64_t count = 0;
+            while (count < len) {
+                mxfLocalTag tag;
+                uint16_t item_len;
+                mxf_file->readLocalTL(&tag, &item_len);
+                if (tag == INSTANCE_UID_TAG && item_len == mxfUUID_extlen)
+                    read_uuid(mxf_file, &mPrefaceInstanceUID);
+                else if (tag == GENERATION_UID_TAG && item_len == mxfUUID_extlen)
+                    read_uuid(mxf_file, &mPrefaceGenerationUID);
+                else if (tag == LAST_MODIFIED_DATE_TAG && item_len == 8)
+                    read_timestamp(mxf_file, &mPrefaceLastModifiedDate);
+                else
+                    mxf_file->skip(item_len);
+                count += 4 + item_len;
+            }
+            break;
+        }
+
+        mxf_file->seek(original_position, SEEK_SET);
+    }
+    catch (const BMXException&)
+    {
+        mxf_file->seek(original_position, SEEK_SET);
+        throw;
+    }
+    catch (...)
+    {
+        mxf_file->seek(original_position, SEEK_SET);
+        BMX_EXCEPTION(("Failed to read the Preface from the header partition"));
+    }
+}
+
+void MXFIndexCache::ReadCache(File *cache_file, const Partition *header_partition)
+{
+    // a truncated cache is ignored without attempting to parse it
+    mxfKey key;
+    int64_t cache_size = cache_file->size();
+    if (cache_size < 2 * mxfKey_extlen)
+        return;
+    cache_file->seek(cache_size - mxfKey_extlen, SEEK_SET);
+    cache_file->readK(&key);
+    if (!mxf_equals_key(&key, &CACHE_END_KEY))
+        return;
+    cache_file->seek(0, SEEK_SET);
+
+    // the cache is out of date if the file size, modification time, header partition pack or Preface identity
+    // has changed
+    cache_file->readK(&key);
+    if (!mxf_equals_key(&key, &CACHE_START_KEY) ||
+        cache_file->readUInt32() != CACHE_VERSION ||
+        cache_file->readInt64() != mFileSize ||
+        cache_file->readInt64() != mModificationTime)
+    {
+        return;
+    }
+
+    mxfUUID instance_uid;
+    mxfUUID generation_uid;
+    mxfTimestamp last_modified_date;
+    read_uuid(cache_file, &instance_uid);
+    read_uuid(cache_file, &generation_uid);
+    read_timestamp(cache_file, &last_modified_date);
+    if (!mxf_equals_uuid(&instance_uid, &mPrefaceInstanceUID) ||
+        !mxf_equals_uuid(&generation_uid, &mPrefaceGenerationUID) ||
+        !equals_timestamp(&last_modified_date, &mPrefaceLastModifiedDate))
+    {
+        return;
+    }
+
+    uint32_t num_partitions = cache_file->readUInt32();
+    BMX_CHECK(num_partitions > 0);
+    uint32_t i;
+    for (i = 0; i < num_partitions; i++)
+        mPartitions.push_back(read_partition(cache_file));
+    if (!equals_partition(mPartitions[0], header_partition))
+        return;
+
+    mBodySID = cache_file->readUInt32();
+    mIndexSID = cache_file->readUInt32();
+    mWrappingType = (MXFEssenceWrappingType)cache_file->readUInt8();
+
+    uint32_t num_chunks = cache_file->readUInt32();
+    mNumIndexedPartitions = (size_t)cache_file->readUInt64();
+    mEssenceChunks.resize(num_chunks);
+    for (i = 0; i < num_chunks; i++) {
+        EssenceChunk &chunk = mEssenceChunks[i];
+        chunk.file_position  = cache_file->readInt64();
+        chunk.essence_offset = cache_file->readInt64();
+        chunk.size           = cache_file->readInt64();
+        chunk.is_complete    = (cache_file->readUInt8() != 0);
+        chunk.partition_id   = (size_t)cache_file->readUInt64();
+        cache_file->readK(&chunk.element_key);
+        BMX_CHECK(chunk.partition_id < mPartitions.size());
+    }
+
+    mIndexIsComplete = (cache_file->readUInt8() != 0);
+    mIndexEditRate.numerator = cache_file->readInt32();
+    mIndexEditRate.denominator = cache_file->readInt32();
+    mIndexEditUnitSize = cache_file->readUInt32();
+    mIndexDuration = cache_file->readInt64();
+    uint32_t num_segments = cache_file->readUInt32();
+    for (i = 0; i < num_segments; i++) {
+        mIndexSegments.push_back(new IndexTableHelperSegment());
+        mIndexSegments.back()->ReadCache(cache_file);
+    }
+
+    cache_file->readK(&key);
+    BMX_CHECK(mxf_equals_key(&key, &CACHE_END_KEY));
+
+    mHaveCache = true;
+}
+
+void MXFIndexCache::WriteCache(File *cache_file, MXFFileReader *file_reader, const EssenceChunkHelper *chunk_helper,
+                               const IndexTableHelper *index_helper)
+{
+    cache_file->writeUL(&CACHE_START_KEY);
+    cache_file->writeUInt32(CACHE_VERSION);
+    cache_file->writeInt64(mFileSize);
+    cache_file->writeInt64(mModificationTime);
+    write_uuid(cache_file, &mPrefaceInstanceUID);
+    write_uuid(cache_file, &mPrefaceGenerationUID);
+    write_timestamp(cache_file, &mPrefaceLastModifiedDate);
+
+    const vector<Partition*> &partitions = file_reader->mFile->getPartitions();
+    cache_file->writeUInt32((uint32_t)partitions.size());
+    size_t i;
+    for (i = 0; i < partitions.size(); i++)
+        write_partition(cache_file, partitions[i]);
+
+    cache_file->writeUInt32(file_reader->mBodySID);
+    cache_file->writeUInt32(file_reader->mIndexSID);
+    cache_file->writeUInt8((uint8_t)file_reader->mWrappingType);
+
+    cache_file->writeUInt32((uint32_t)chunk_helper->mEssenceChunks.size());
+    cache_file->writeUInt64(chunk_helper->mNumIndexedPartitions);
+    for (i = 0; i < chunk_helper->mEssenceChunks.size(); i++) {
+        const EssenceChunk &chunk = chunk_helper->mEssenceChunks[i];
+        cache_file->writeInt64(chunk.file_position);
+        cache_file->writeInt64(chunk.essence_offset);
+        cache_file->writeInt64(chunk.size);
+        cache_file->writeUInt8(chunk.is_complete);
+        cache_file->writeUInt64(chunk.partition_id);
+        cache_file->writeUL(&chunk.element_key);
+    }
+
+    cache_file->writeUInt8(index_helper->mIsComplete);
+    cache_file->writeInt32(index_helper->mEditRate.numerator);
+    cache_file->writeInt32(index_helper->mEditRate.denominator);
+    cache_file->writeUInt32(index_helper->mEditUnitSize);
+    cache_file->writeInt64(index_helper->mDuration);
+    cache_file->writeUInt32((uint32_t)index_helper->mSegments.size());
+    for (i = 0; i < index_helper->mSegments.size(); i++)
+        index_helper->mSegments[i]->WriteCache(cache_file);
+
+    cache_file->writeUL(&CACHE_END_KEY);
+}
+
+void MXFIndexCache::Clear()
+{
+    size_t i;
+    for (i = 0; i < mPartitions.size(); i++)
+        delete mPartitions[i];
+    mPartitions.clear();
+    for (i = 0; i < mIndexSegments.size(); i++)
+        delete mIndexSegments[i];
+    mIndexSegments.clear();
+    mEssenceChunks.clear();
+    mHaveCache = false;
+}
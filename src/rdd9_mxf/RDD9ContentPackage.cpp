@@ -179,14 +179,14 @@ uint32_t RDD9ContentPackageElement::GetElementSize(uint32_t data_size) const
         return GetKAGAlignedSize(mxfKey_extlen + LLEN + data_size);
 }
 
-void RDD9ContentPackageElement::Write(File *mxf_file, unsigned char *data, uint32_t size)
+void RDD9ContentPackageElement::Write(MXFWriteBatch *batch, const unsigned char *data, uint32_t size)
 {
     uint32_t element_size = GetElementSize(size);
 
-    mxf_file->writeFixedKL(&mElementKey, LLEN, size);
-    BMX_CHECK(mxf_file->write(data, size) == size);
+    batch->AppendFixedKL(&mElementKey, LLEN, size);
+    batch->AppendRef(data, size);
     if (element_size > mxfKey_extlen + LLEN + size)
-        mxf_file->writeFill(element_size - (mxfKey_extlen + LLEN + size));
+        batch->AppendFill(element_size - (mxfKey_extlen + LLEN + size));
 }
 
 uint32_t RDD9ContentPackageElement::GetKAGAlignedSize(uint32_t klv_size) const
@@ -246,9 +246,9 @@ uint32_t RDD9ContentPackageElementData::GetElementSize() const
     return mElement->GetElementSize(mData.GetSize());
 }
 
-void RDD9ContentPackageElementData::Write()
+void RDD9ContentPackageElementData::Write(MXFWriteBatch *batch)
 {
-    mElement->Write(mMXFFile, mData.GetBytes(), mData.GetSize());
+    mElement->Write(batch, mData.GetBytes(), mData.GetSize());
 }
 
 void RDD9ContentPackageElementData::Reset(int64_t new_position)
@@ -377,22 +377,22 @@ void RDD9ContentPackage::UpdateIndexTable()
     mHaveUpdatedIndexTable = true;
 }
 
-void RDD9ContentPackage::Write()
+void RDD9ContentPackage::Write(MXFWriteBatch *batch)
 {
     BMX_ASSERT(mHaveUpdatedIndexTable);
 
-    WriteSystemItem();
+    WriteSystemItem(batch);
 
     size_t i;
     for (i = 0; i < mElementData.size(); i++)
-        mElementData[i]->Write();
+        mElementData[i]->Write(batch);
 }
 
-void RDD9ContentPackage::WriteSystemItem()
+void RDD9ContentPackage::WriteSystemItem(MXFWriteBatch *batch)
 {
     static const uint32_t SYSTEM_ITEM_METADATA_PACK_SIZE = 7 + 16 + 17 + 17;
 
-    mMXFFile->writeFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
+    batch->AppendFixedKL(&MXF_EE_K(SDTI_CP_System_Pack), LLEN, SYSTEM_ITEM_METADATA_PACK_SIZE);
 
     // system metadata bitmap = 0x50
     // b7 = 0 (FEC not used)
@@ -405,19 +405,19 @@ void RDD9ContentPackage::WriteSystemItem()
     // b0 = 0 (control element)
 
     // core fields
-    mMXFFile->writeUInt8(0x50 | mSysMetaItemFlags);                     // system metadata bitmap
-    mMXFFile->writeUInt8(get_system_item_cp_rate(mFrameRate));          // content package rate
-    mMXFFile->writeUInt8(0x00);                                         // content package type (default)
-    mMXFFile->writeUInt16(0x0000);                                      // channel handle (default)
-    mMXFFile->writeUInt16((uint16_t)(mPosition & 0xffff));              // continuity count
+    batch->AppendUInt8(0x50 | mSysMetaItemFlags);                       // system metadata bitmap
+    batch->AppendUInt8(get_system_item_cp_rate(mFrameRate));            // content package rate
+    batch->AppendUInt8(0x00);                                           // content package type (default)
+    batch->AppendUInt16(0x0000);                                        // channel handle (default)
+    batch->AppendUInt16((uint16_t)(mPosition & 0xffff));                // continuity count
 
     // SMPTE Universal Label
-    mMXFFile->writeUL(&MXF_EC_L(MultipleWrappings));
+    batch->AppendUL(&MXF_EC_L(MultipleWrappings));
 
     // (null) Package creation date / time stamp
     unsigned char ts_bytes[17];
     memset(ts_bytes, 0, sizeof(ts_bytes));
-    BMX_CHECK(mMXFFile->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    batch->AppendCopy(ts_bytes, sizeof(ts_bytes));
 
     // User date / time stamp
     Timecode user_timecode;
@@ -431,22 +431,23 @@ void RDD9ContentPackage::WriteSystemItem()
         user_timecode.Init(get_rounded_tc_base(mFrameRate), false, mPosition);
     }
     encode_smpte_timecode(user_timecode, false, &ts_bytes[1], sizeof(ts_bytes) - 1);
-    BMX_CHECK(mMXFFile->write(ts_bytes, sizeof(ts_bytes)) == sizeof(ts_bytes));
+    batch->AppendCopy(ts_bytes, sizeof(ts_bytes));
 
 
     // empty Package Metadata Set
-    mMXFFile->writeFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), LLEN, 0);
+    batch->AppendFixedKL(&MXF_EE_K(EmptyPackageMetadataSet), LLEN, 0);
 
 
     // align to KAG
-    mMXFFile->writeFill(KAG_SIZE - (mxfKey_extlen + LLEN + SYSTEM_ITEM_METADATA_PACK_SIZE +
-                                    mxfKey_extlen + LLEN));
+    batch->AppendFill(KAG_SIZE - (mxfKey_extlen + LLEN + SYSTEM_ITEM_METADATA_PACK_SIZE +
+                                  mxfKey_extlen + LLEN));
 }
 
 
 
 RDD9ContentPackageManager::RDD9ContentPackageManager(File *mxf_file, RDD9IndexTable *index_table,
                                                      Rational frame_rate)
+: mWriteBatch(LLEN)
 {
     mMXFFile = mxf_file;
     mIndexTable = index_table;
@@ -615,7 +616,8 @@ void RDD9ContentPackageManager::WriteNextContentPackage()
     BMX_ASSERT(HaveContentPackage(false));
 
     mContentPackages.front()->UpdateIndexTable();
-    mContentPackages.front()->Write();
+    mContentPackages.front()->Write(&mWriteBatch);
+    mWriteBatch.Write(mMXFFile);
 
     mFreeContentPackages.push_back(mContentPackages.front());
     mContentPackages.pop_front();
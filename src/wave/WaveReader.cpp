@@ -126,6 +126,9 @@ WaveReader::WaveReader(WaveIO *input, bool take_ownership, bool require_ds64, ui
     uint16_t i;
     for (i = 0; i < mChannelCount; i++)
         mTracks.push_back(new WaveTrackReader(this, i, 1));
+    mReadFrames.resize(mTracks.size());
+    mReadOutputs.resize(mTracks.size());
+    mReadBuffer.SetAlignment(64);
 
     // default read everything and position at start of sample data
     SetReadLimits();
@@ -189,60 +192,91 @@ uint32_t WaveReader::Read(uint32_t num_samples)
     BMX_ASSERT(read_num_samples > 0);
 
 
-    // read samples
-    bool have_read = false;
+    // create a frame for each enabled track
+    bool have_enabled_track = false;
     size_t i;
     for (i = 0; i < mTracks.size(); i++) {
-        if (!mTracks[i]->IsEnabled())
-            continue;
-
-        Frame *frame = mTracks[i]->GetFrameBuffer()->CreateFrame();
-        frame->Grow(read_num_samples * mTracks[i]->GetBlockAlign());
-
-        // read samples directly into the frame if there is only 1 track; else read into read buffer
-        if (!have_read) {
+        if (mTracks[i]->IsEnabled()) {
+            mReadFrames[i] = mTracks[i]->GetFrameBuffer()->CreateFrame();
+            mReadFrames[i]->Grow(read_num_samples * mTracks[i]->GetBlockAlign());
+            have_enabled_track = true;
+        } else {
+            mReadFrames[i] = 0;
+        }
+    }
+    if (have_enabled_track) {
+        // read samples directly into the frame if there is only 1 track; else use the mapped file data if
+        // available or read into the read buffer, and deinterleave into the track frames
+        uint32_t read_size = read_num_samples * mBlockAlign;
+        const unsigned char *read_data = 0;
+        if (mTracks.size() > 1) {
+            read_data = mInput->MapData(mDataStartFilePosition + mPosition * mBlockAlign, read_size);
+            if (read_data)
+                mInput->Seek(mDataStartFilePosition + mPosition * mBlockAlign + read_size, SEEK_SET);
+        }
+        if (!read_data) {
             unsigned char *buffer;
             if (mTracks.size() == 1) {
-                buffer = frame->GetBytesAvailable();
+                buffer = mReadFrames[0]->GetBytesAvailable();
             } else {
-                mReadBuffer.Allocate(read_num_samples * mBlockAlign);
+                mReadBuffer.Allocate(read_size);
                 buffer = mReadBuffer.GetBytes();
             }
 
-            uint32_t bytes_read = mInput->Read(buffer, read_num_samples * mBlockAlign);
-            if (bytes_read < read_num_samples * mBlockAlign) {
+            uint32_t bytes_read = mInput->Read(buffer, read_size);
+            if (bytes_read < read_size) {
                 log_error("Failed to read %u samples of %u\n",
                           read_num_samples - bytes_read / mBlockAlign, read_num_samples);
                 read_num_samples = bytes_read / mBlockAlign;
             }
-
-            if (mTracks.size() > 1)
-                mReadBuffer.SetSize(read_num_samples * mBlockAlign);
-
-            have_read = true;
+            read_data = buffer;
         }
 
         if (mTracks.size() > 1) {
-            deinterleave_audio(mReadBuffer.GetBytes(), mReadBuffer.GetSize(),
-                               mQuantizationBits, mChannelCount, (uint16_t)i,
-                               frame->GetBytesAvailable(), frame->GetSizeAvailable());
+            // deinterleave each run of consecutive enabled tracks in a single pass. There is 1 track per
+            // channel and so the track index is the channel index
+            size_t first_track = 0;
+            while (first_track < mTracks.size()) {
+                if (!mReadFrames[first_track]) {
+                    first_track++;
+                    continue;
+                }
+
+                size_t track_count = 0;
+                while (first_track + track_count < mTracks.size() && mReadFrames[first_track + track_count]) {
+                    mReadOutputs[track_count] = mReadFrames[first_track + track_count]->GetBytesAvailable();
+                    track_count++;
+                }
+
+                deinterleave_audio_outputs(read_data + first_track * mChannelBlockAlign, mBlockAlign,
+                                           read_num_samples, mChannelBlockAlign,
+                                           &mReadOutputs[0], (uint16_t)track_count);
+
+                first_track += track_count;
+            }
         }
 
-        frame->SetSize(read_num_samples * mTracks[i]->GetBlockAlign());
+        for (i = 0; i < mTracks.size(); i++) {
+            Frame *frame = mReadFrames[i];
+            if (!frame)
+                continue;
 
-        frame->edit_rate            = mSamplingRate;
-        frame->position             = mPosition;
-        frame->track_edit_rate      = mSamplingRate;
-        frame->track_position       = mPosition;
-        frame->request_num_samples  = num_samples;
-        frame->first_sample_offset  = first_sample_offset;
-        frame->num_samples          = read_num_samples;
-        frame->file_position        = mDataStartFilePosition + mPosition * mBlockAlign;
+            frame->SetSize(read_num_samples * mTracks[i]->GetBlockAlign());
+
+            frame->edit_rate            = mSamplingRate;
+            frame->position             = mPosition;
+            frame->track_edit_rate      = mSamplingRate;
+            frame->track_position       = mPosition;
+            frame->request_num_samples  = num_samples;
+            frame->first_sample_offset  = first_sample_offset;
+            frame->num_samples          = read_num_samples;
+            frame->file_position        = mDataStartFilePosition + mPosition * mBlockAlign;
+
+            mTracks[i]->GetFrameBuffer()->PushFrame(frame);
+        }
 
-        mTracks[i]->GetFrameBuffer()->PushFrame(frame);
-    }
-    if (have_read)
         mPosition += read_num_samples;
+    }
 
 
     // always be positioned num_samples after previous position
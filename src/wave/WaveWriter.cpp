@@ -39,6 +39,7 @@
 #include <set>
 
 #include <bmx/wave/WaveWriter.h>
+#include <bmx/essence_parser/SoundConversion.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -50,6 +51,9 @@ using namespace bmx;
 // prevent buffer size exceeding 50MB
 #define MAX_BUFFER_SIZE     (50 * 1000 * 1000)
 
+// number of samples interleaved into the output buffer before it is written
+#define INTERLEAVE_SAMPLE_COUNT     2048
+
 
 
 static WaveChunkId BUILTIN_CHUNKS[] = {
@@ -96,6 +100,7 @@ WaveWriter::WaveWriter(WaveIO *output, bool take_ownership)
     mChannelBlockAlign = (mQuantizationBits + 7) / 8;
     mBlockAlign = 0;
     mBufferSize = 0;
+    mInterleaveBuffer.SetAlignment(64);
     mSampleCount = 0;
     mJunkChunkFilePosition = 0;
     mBEXTFilePosition = 0;
@@ -118,6 +123,8 @@ WaveWriter::~WaveWriter()
     size_t i;
     for (i = 0; i < mBufferSegments.size(); i++)
         delete mBufferSegments[i];
+    for (i = 0; i < mFreeBufferSegments.size(); i++)
+        delete mFreeBufferSegments[i];
 
     for (i = 0; i < mTracks.size(); i++)
         delete mTracks[i];
@@ -343,15 +350,21 @@ void WaveWriter::WriteSamples(uint32_t track_index, const unsigned char *data, u
         uint32_t segment_offset;
         if (track->mSampleCount == mSampleCount) {
             // create new segment
+            // the segment data is not zeroed because every track overwrites its channels, apart from
+            // tracks with a shorter duration that are handled in CompleteWrite
             BMX_CHECK(mBufferSize < MAX_BUFFER_SIZE);
-            mBufferSegments.push_back(new BufferSegment);
-            segment = mBufferSegments.back();
+            if (mFreeBufferSegments.empty()) {
+                segment = new BufferSegment;
+            } else {
+                segment = mFreeBufferSegments.back();
+                mFreeBufferSegments.pop_back();
+            }
+            mBufferSegments.push_back(segment);
             segment->start_sample_count = mSampleCount;
             segment->num_samples = num_samples;
             segment->channel_count = 0;
             segment->data.Allocate(mBlockAlign * num_samples);
             segment->data.SetSize(mBlockAlign * num_samples);
-            memset(segment->data.GetBytes(), 0, segment->data.GetSize());
 
             mBufferSize += mBlockAlign * num_samples;
             segment_index = 0;
@@ -373,15 +386,10 @@ void WaveWriter::WriteSamples(uint32_t track_index, const unsigned char *data, u
         }
 
         // copy samples to segment
-        unsigned char *output_ptr = segment->data.GetBytes() + segment_offset * mBlockAlign +
-                                    track->mStartChannel * mChannelBlockAlign;
-        const unsigned char *input_ptr = data;
-        uint32_t i;
-        for (i = 0; i < input_sample_count; i++) {
-            memcpy(output_ptr, input_ptr, track_block_align);
-            output_ptr += mBlockAlign;
-            input_ptr += track_block_align;
-        }
+        interleave_audio_inputs(&data, 1, track_block_align, input_sample_count,
+                                segment->data.GetBytes() + segment_offset * mBlockAlign +
+                                    track->mStartChannel * mChannelBlockAlign,
+                                mBlockAlign);
         if (segment_offset + input_sample_count == segment->num_samples)
             segment->channel_count += track->mChannelCount;
 
@@ -389,8 +397,8 @@ void WaveWriter::WriteSamples(uint32_t track_index, const unsigned char *data, u
         if (segment_index == 0 && segment->channel_count == mChannelCount) {
             mOutput->Write(segment->data.GetBytes(), segment->data.GetSize());
             mBufferSize -= segment->data.GetSize();
-            delete segment;
             mBufferSegments.pop_front();
+            mFreeBufferSegments.push_back(segment);
         }
     }
 
@@ -405,17 +413,80 @@ void WaveWriter::WriteSamples(uint32_t track_index, const unsigned char *data, u
     }
 }
 
+void WaveWriter::WriteSamples(const unsigned char * const *track_data, uint32_t num_samples)
+{
+    if (num_samples == 0)
+        return;
+
+    // every track is at mSampleCount when there are no buffered segments
+    BMX_CHECK_M(mBufferSegments.empty(),
+                ("Writing samples for all tracks is not supported whilst individual track samples are buffered"));
+
+    if (mTracks.size() == 1) {
+        mOutput->Write(track_data[0], num_samples * mBlockAlign);
+    } else {
+        mInterleaveTrackData.resize(mTracks.size());
+
+        uint32_t sample_offset = 0;
+        while (sample_offset < num_samples) {
+            uint32_t chunk_sample_count = num_samples - sample_offset;
+            if (chunk_sample_count > INTERLEAVE_SAMPLE_COUNT)
+                chunk_sample_count = INTERLEAVE_SAMPLE_COUNT;
+
+            // every byte in the output blocks is written and so the buffer is not zeroed
+            mInterleaveBuffer.Allocate(chunk_sample_count * mBlockAlign);
+            mInterleaveBuffer.SetSize(chunk_sample_count * mBlockAlign);
+
+            size_t i;
+            for (i = 0; i < mTracks.size(); i++) {
+                mInterleaveTrackData[i] = track_data[i] +
+                                          sample_offset * mTracks[i]->mChannelCount * mChannelBlockAlign;
+            }
+
+            // interleave runs of tracks with the same channel count together
+            size_t first_track = 0;
+            while (first_track < mTracks.size()) {
+                uint16_t track_channel_count = mTracks[first_track]->mChannelCount;
+                size_t track_count = 1;
+                while (first_track + track_count < mTracks.size() &&
+                       mTracks[first_track + track_count]->mChannelCount == track_channel_count)
+                {
+                    track_count++;
+                }
+
+                interleave_audio_inputs(&mInterleaveTrackData[first_track], (uint16_t)track_count,
+                                        track_channel_count * mChannelBlockAlign, chunk_sample_count,
+                                        mInterleaveBuffer.GetBytes() +
+                                            mTracks[first_track]->mStartChannel * mChannelBlockAlign,
+                                        mBlockAlign);
+
+                first_track += track_count;
+            }
+
+            mOutput->Write(mInterleaveBuffer.GetBytes(), mInterleaveBuffer.GetSize());
+            sample_offset += chunk_sample_count;
+        }
+    }
+
+    size_t i;
+    for (i = 0; i < mTracks.size(); i++)
+        mTracks[i]->mSampleCount += num_samples;
+    mSampleCount += num_samples;
+}
+
 void WaveWriter::CompleteWrite()
 {
     // write remaining buffered samples
     if (!mBufferSegments.empty()) {
         log_warn("Wave tracks with unequal duration\n");
 
+        ZeroUnwrittenSamples();
+
         size_t i;
         for (i = 0; i < mBufferSegments.size(); i++) {
             mOutput->Write(mBufferSegments[i]->data.GetBytes(), mBufferSegments[i]->data.GetSize());
             mBufferSize -= mBufferSegments[i]->data.GetSize();
-            delete mBufferSegments[i];
+            mFreeBufferSegments.push_back(mBufferSegments[i]);
         }
         mBufferSegments.clear();
     }
@@ -540,3 +611,27 @@ void WaveWriter::RemoveChunk(WaveChunkId id)
         }
     }
 }
+
+void WaveWriter::ZeroUnwrittenSamples()
+{
+    // tracks write their samples sequentially and so a track has written the samples in a segment
+    // up to its sample count
+    size_t i, j;
+    for (i = 0; i < mBufferSegments.size(); i++) {
+        BufferSegment *segment = mBufferSegments[i];
+        for (j = 0; j < mTracks.size(); j++) {
+            WaveTrackWriter *track = mTracks[j];
+            uint32_t track_block_align = track->mChannelCount * mChannelBlockAlign;
+            int64_t written_count = track->mSampleCount - segment->start_sample_count;
+            if (written_count < 0)
+                written_count = 0;
+            else if (written_count > segment->num_samples)
+                written_count = segment->num_samples;
+
+            unsigned char *output_ptr = segment->data.GetBytes() + track->mStartChannel * mChannelBlockAlign;
+            uint32_t k;
+            for (k = (uint32_t)written_count; k < segment->num_samples; k++)
+                memset(&output_ptr[k * mBlockAlign], 0, track_block_align);
+        }
+    }
+}
@@ -0,0 +1,553 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define __STDC_FORMAT_MACROS
+#define __STDC_LIMIT_MACROS
+#define __STDC_CONSTANT_MACROS
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/BitBuffer.h>
+#include <bmx/essence_parser/AVCEssenceParser.h>
+#include <bmx/essence_parser/VC2EssenceParser.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define BENCH_DATA_SIZE     (4 * 1024 * 1024)
+
+
+// reference implementations that load a byte at a time and read exp-Golomb codes a bit at a time, as used by
+// the bit buffers before the word load fast paths were added
+
+class RefGetBitBuffer
+{
+public:
+    RefGetBitBuffer(const unsigned char *data, uint32_t size)
+    {
+        mData = data;
+        mSize = size;
+        mPos = 0;
+        mBitSize = (uint64_t)size << 3;
+        mBitPos = 0;
+    }
+
+    uint64_t GetBitPos() const { return mBitPos; }
+
+    uint64_t GetRemBitSize() const
+    {
+        if (mBitSize > mBitPos)
+            return mBitSize - mBitPos;
+        else
+            return 0;
+    }
+
+    bool GetBits(uint8_t num_bits, uint64_t *value)
+    {
+        if (num_bits > mBitSize - mBitPos)
+            return false;
+
+        if (num_bits > 0) {
+            const unsigned char *data_ptr = &mData[mPos];
+            uint8_t min_consume_bits = (uint8_t)((mBitPos & 0x07) + num_bits);
+            int16_t consumed_bits = 0;
+            *value = 0;
+            while (consumed_bits < min_consume_bits) {
+                *value = ((*value) << 8) | (*data_ptr);
+                data_ptr++;
+                consumed_bits += 8;
+            }
+
+            *value >>= consumed_bits - min_consume_bits;
+            if (consumed_bits > 64)
+                *value |= ((uint64_t)mData[mPos]) << (64 - (consumed_bits - min_consume_bits));
+            *value &= UINT64_MAX >> (64 - num_bits);
+
+            mBitPos += num_bits;
+            mPos = (uint32_t)(mBitPos >> 3);
+        } else {
+            *value = 0;
+        }
+
+        return true;
+    }
+
+    void SetBitPos(uint64_t bit_pos)
+    {
+        mBitPos = bit_pos;
+        mPos = (uint32_t)(mBitPos >> 3);
+    }
+
+protected:
+    const unsigned char *mData;
+    uint32_t mSize;
+    uint32_t mPos;
+    uint64_t mBitSize;
+    uint64_t mBitPos;
+};
+
+class RefAVCGetBitBuffer : public RefGetBitBuffer
+{
+public:
+    RefAVCGetBitBuffer(const unsigned char *data, uint32_t size)
+    : RefGetBitBuffer(data, size)
+    {
+    }
+
+    void GetU(uint8_t num_bits, uint64_t *value)
+    {
+        GetRBSPBits(num_bits, value);
+    }
+
+    void GetUE(uint64_t *value)
+    {
+        uint64_t start_bit_pos = mBitPos;
+        try
+        {
+            int8_t leading_zero_bits = -1;
+            uint64_t b;
+            uint64_t temp;
+
+            for (b = 0; !b && leading_zero_bits < 63; leading_zero_bits++)
+                GetRBSPBits(1, &b);
+            if (!b)
+                throw false;
+
+            if (leading_zero_bits == 0) {
+                *value = 0;
+            } else {
+                GetRBSPBits(leading_zero_bits, &temp);
+                *value = (1ULL << leading_zero_bits) - 1 + temp;
+            }
+        }
+        catch (...)
+        {
+            SetBitPos(start_bit_pos);
+            throw;
+        }
+    }
+
+    // the original loop checked bit positions below 0 when the stop bit is missing; the bit position is
+    // signed here to stop at the start of the data
+    bool MoreRBSPData()
+    {
+        int64_t bit_pos = (int64_t)mBitSize - 1;
+        uint8_t b = 0;
+
+        while (!b && bit_pos >= (int64_t)mBitPos) {
+            b = mData[bit_pos / 8] & (0x80 >> (bit_pos % 8));
+            bit_pos--;
+        }
+
+        return (b && bit_pos >= (int64_t)mBitPos);
+    }
+
+private:
+    void GetRBSPBits(uint8_t num_bits, uint64_t *value)
+    {
+        if (num_bits > GetRemBitSize())
+            throw false;
+
+        uint8_t check_num_bytes = (uint8_t)(((uint64_t)num_bits + (mBitPos & 7) + 7) >> 3);
+        const unsigned char *bytes = &mData[mPos];
+
+        uint8_t prev_bytes = 0;
+        if (mPos >= 2 && (mBitPos & 7) == 0)
+            prev_bytes = 2;
+        else if (mPos >= 1)
+            prev_bytes = 1;
+        bytes -= prev_bytes;
+        check_num_bytes += prev_bytes;
+
+        uint32_t state = 0xffffff;
+        uint8_t i;
+        for (i = 0; i < check_num_bytes; i++) {
+            state = (state << 8) | bytes[i];
+            if ((state & 0xffffff) == 0x000003)
+                break;
+        }
+
+        uint64_t start_bit_pos = mBitPos;
+        try
+        {
+            if (i < check_num_bytes) {
+                uint8_t before_bits, after_bits;
+                uint64_t before_value = 0, after_value = 0;
+
+                before_bits = ((i - prev_bytes) << 3) - (uint8_t)(mBitPos & 7);
+                after_bits = num_bits - before_bits;
+
+                GetBits(before_bits, &before_value);
+                SetBitPos(mBitPos + 8);
+                GetRBSPBits(after_bits, &after_value);
+
+                *value = (before_value << after_bits) | after_value;
+            } else if (!GetBits(num_bits, value)) {
+                throw false;
+            }
+        }
+        catch (...)
+        {
+            SetBitPos(start_bit_pos);
+            throw;
+        }
+    }
+};
+
+class RefVC2GetBitBuffer : public RefGetBitBuffer
+{
+public:
+    RefVC2GetBitBuffer(const unsigned char *data, uint32_t size)
+    : RefGetBitBuffer(data, size)
+    {
+    }
+
+    uint8_t GetBit()
+    {
+        uint64_t bit;
+        if (!GetBits(1, &bit))
+            throw false;
+        return (uint8_t)bit;
+    }
+
+    uint64_t GetUInt()
+    {
+        uint64_t value = 1;
+        while (GetBit() == 0) {
+            value <<= 1;
+            if (GetBit() == 1)
+                value += 1;
+        }
+        return value - 1;
+    }
+};
+
+
+// exp-Golomb codes, with 0x00 bytes that result in 0x000003 emulation prevention sequences
+static void fill_exp_golomb(vector<unsigned char> *data, bool emulation_prevention)
+{
+    ByteArray bytes;
+    bytes.SetAllocBlockSize((uint32_t)data->size() + 8);
+    PutBitBuffer buffer(&bytes);
+    uint64_t bit_size = (uint64_t)data->size() << 3;
+    uint64_t bit_pos = 0;
+    while (true) {
+        int r = rand();
+        uint8_t value_bits = (uint8_t)(r % 20);
+        if (bit_pos + 2 * value_bits + 1 > bit_size)
+            break;
+        uint32_t value = (uint32_t)(rand() & ((1 << value_bits) - 1)) | (1 << value_bits);
+        if (value_bits > 0)
+            buffer.PutBits(value_bits, (uint32_t)0);
+        buffer.PutBits(value_bits + 1, value);
+        bit_pos += 2 * value_bits + 1;
+    }
+
+    memset(&(*data)[0], 0, data->size());
+    if (bytes.GetSize() > 0)
+        memcpy(&(*data)[0], bytes.GetBytes(), bytes.GetSize());
+
+    if (emulation_prevention) {
+        size_t i;
+        for (i = 0; i + 3 <= data->size(); i++) {
+            if ((rand() % 13) == 0) {
+                (*data)[i] = 0x00;
+                (*data)[i + 1] = 0x00;
+                (*data)[i + 2] = 0x03;
+                i += 2;
+            }
+        }
+    }
+}
+
+// exp-Golomb codes with the follow and data bits interleaved, as used in VC-2
+static void fill_interleaved_exp_golomb(vector<unsigned char> *data, uint8_t max_value_bits)
+{
+    ByteArray bytes;
+    bytes.SetAllocBlockSize((uint32_t)data->size() + 8);
+    PutBitBuffer buffer(&bytes);
+    uint64_t bit_size = (uint64_t)data->size() << 3;
+    uint64_t bit_pos = 0;
+    while (true) {
+        int r = rand();
+        uint8_t value_bits = (uint8_t)(r % (max_value_bits + 1));
+        if (bit_pos + 2 * value_bits + 1 > bit_size)
+            break;
+        uint8_t i;
+        for (i = 0; i < value_bits; i++) {
+            buffer.PutBits(1, (uint8_t)0);
+            buffer.PutBits(1, (uint8_t)((rand() >> 5) & 1));
+        }
+        buffer.PutBits(1, (uint8_t)1);
+        bit_pos += 2 * value_bits + 1;
+    }
+
+    memset(&(*data)[0], 0, data->size());
+    if (bytes.GetSize() > 0)
+        memcpy(&(*data)[0], bytes.GetBytes(), bytes.GetSize());
+}
+
+static bool check_get_bits(const vector<unsigned char> &data)
+{
+    const unsigned char *bytes = (data.empty() ? 0 : &data[0]);
+    GetBitBuffer buffer(bytes, (uint32_t)data.size());
+    RefGetBitBuffer ref_buffer(bytes, (uint32_t)data.size());
+
+    while (true) {
+        uint8_t num_bits = (uint8_t)(rand() % 65);
+        uint64_t value = 0, ref_value = 0;
+        bool result = buffer.GetBits(num_bits, &value);
+        bool ref_result = ref_buffer.GetBits(num_bits, &ref_value);
+        if (result != ref_result || value != ref_value || buffer.GetBitPos() != ref_buffer.GetBitPos()) {
+            fprintf(stderr, "GetBits(%u) result %d/%d, value 0x%" PRIx64 " != 0x%" PRIx64 " at bit position %" PRIu64 "\n",
+                    num_bits, result, ref_result, value, ref_value, ref_buffer.GetBitPos());
+            return false;
+        }
+        if (buffer.GetRemBitSize() == 0 || (!result && (rand() % 4) == 0))
+            break;
+    }
+
+    return true;
+}
+
+static bool check_avc(const vector<unsigned char> &data)
+{
+    const unsigned char *bytes = (data.empty() ? 0 : &data[0]);
+    AVCGetBitBuffer buffer(bytes, (uint32_t)data.size());
+    RefAVCGetBitBuffer ref_buffer(bytes, (uint32_t)data.size());
+
+    while (true) {
+        int op = rand() % 8;
+        uint64_t value = 0, ref_value = 0;
+        bool result = true, ref_result = true;
+        uint8_t num_bits = (uint8_t)(rand() % 33);
+        if (op == 0) {
+            result = buffer.MoreRBSPData();
+            ref_result = ref_buffer.MoreRBSPData();
+        } else if (op == 1) {
+            try { buffer.GetU(num_bits, &value); } catch (...) { result = false; }
+            try { ref_buffer.GetU(num_bits, &ref_value); } catch (...) { ref_result = false; }
+        } else {
+            try { buffer.GetUE(&value); } catch (...) { result = false; }
+            try { ref_buffer.GetUE(&ref_value); } catch (...) { ref_result = false; }
+        }
+        if (result != ref_result || value != ref_value || buffer.GetBitPos() != ref_buffer.GetBitPos()) {
+            fprintf(stderr, "AVC op %d result %d/%d, value %" PRIu64 " != %" PRIu64 " at bit position %" PRIu64 "\n",
+                    op, result, ref_result, value, ref_value, ref_buffer.GetBitPos());
+            return false;
+        }
+        if (buffer.GetRemBitSize() == 0 || (op != 0 && !result))
+            break;
+    }
+
+    return true;
+}
+
+static bool check_vc2(const vector<unsigned char> &data)
+{
+    const unsigned char *bytes = (data.empty() ? 0 : &data[0]);
+    VC2GetBitBuffer buffer(bytes, (uint32_t)data.size());
+    RefVC2GetBitBuffer ref_buffer(bytes, (uint32_t)data.size());
+
+    while (true) {
+        uint64_t value = 0, ref_value = 0;
+        bool result = true, ref_result = true;
+        try { value = buffer.GetUInt(); } catch (...) { result = false; }
+        try { ref_value = ref_buffer.GetUInt(); } catch (...) { ref_result = false; }
+        if (result != ref_result || value != ref_value) {
+            fprintf(stderr, "VC-2 result %d/%d, value %" PRIu64 " != %" PRIu64 " at bit position %" PRIu64 "\n",
+                    result, ref_result, value, ref_value, ref_buffer.GetBitPos());
+            return false;
+        }
+        // the position after a failure differs because the bits read so far are consumed
+        if (!result)
+            break;
+        if (buffer.GetBitPos() != ref_buffer.GetBitPos()) {
+            fprintf(stderr, "VC-2 bit position %" PRIu64 " != %" PRIu64 "\n",
+                    buffer.GetBitPos(), ref_buffer.GetBitPos());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool check_all()
+{
+    bool result = true;
+    uint32_t size;
+
+    for (size = 0; size < 200; size++) {
+        vector<unsigned char> data(size);
+        int i;
+        for (i = 0; i < 20; i++) {
+            fill_random(&data);
+            result &= check_get_bits(data);
+            result &= check_avc(data);
+            result &= check_vc2(data);
+
+            if (size > 0) {
+                fill_exp_golomb(&data, (i & 1) != 0);
+                result &= check_avc(data);
+                fill_interleaved_exp_golomb(&data, 40);
+                result &= check_vc2(data);
+            }
+        }
+    }
+
+    return result;
+}
+
+template <class T>
+static uint64_t read_bits(const vector<unsigned char> &data, const vector<uint8_t> &widths)
+{
+    T buffer(&data[0], (uint32_t)data.size());
+    uint64_t sum = 0;
+    uint64_t value;
+    size_t i = 0;
+    while (buffer.GetBits(widths[i], &value)) {
+        sum += value;
+        i = (i + 1) % widths.size();
+    }
+    return sum;
+}
+
+template <class T>
+static uint64_t read_ue(const vector<unsigned char> &data)
+{
+    T buffer(&data[0], (uint32_t)data.size());
+    uint64_t sum = 0;
+    uint64_t value;
+    try
+    {
+        while (true) {
+            buffer.GetUE(&value);
+            sum += value;
+        }
+    }
+    catch (...)
+    {
+    }
+    return sum;
+}
+
+template <class T>
+static uint64_t read_vc2_uint(const vector<unsigned char> &data)
+{
+    T buffer(&data[0], (uint32_t)data.size());
+    uint64_t sum = 0;
+    try
+    {
+        while (true)
+            sum += buffer.GetUInt();
+    }
+    catch (...)
+    {
+    }
+    return sum;
+}
+
+static void bench_all(uint32_t iterations)
+{
+    vector<unsigned char> data(BENCH_DATA_SIZE);
+    vector<uint8_t> widths(1000);
+    uint64_t sum = 0;
+    size_t i;
+
+    // fixed length fields
+    fill_random(&data);
+    for (i = 0; i < widths.size(); i++)
+        widths[i] = (uint8_t)(1 + rand() % 32);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        sum += read_bits<RefGetBitBuffer>(data, widths);
+    print_rate("bits (byte loop):", data.size(), iterations, get_elapsed_sec(start));
+
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        sum += read_bits<GetBitBuffer>(data, widths);
+    print_rate("bits (word load):", data.size(), iterations, get_elapsed_sec(start));
+
+    // AVC exp-Golomb codes
+    fill_exp_golomb(&data, false);
+
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        sum += read_ue<RefAVCGetBitBuffer>(data);
+    print_rate("avc ue (bit loop):", data.size(), iterations, get_elapsed_sec(start));
+
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        sum += read_ue<AVCGetBitBuffer>(data);
+    print_rate("avc ue (window):", data.size(), iterations, get_elapsed_sec(start));
+
+    // VC-2 interleaved exp-Golomb codes
+    fill_interleaved_exp_golomb(&data, 16);
+
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        sum += read_vc2_uint<RefVC2GetBitBuffer>(data);
+    print_rate("vc2 uint (bit loop):", data.size(), iterations, get_elapsed_sec(start));
+
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        sum += read_vc2_uint<VC2GetBitBuffer>(data);
+    print_rate("vc2 uint (window):", data.size(), iterations, get_elapsed_sec(start));
+
+    printf("(sum %" PRIu64 ")\n", sum);
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "Bit reader",
+    "Only check the bit reader results against a reference implementation",
+    10,
+    BENCH_DATA_SIZE,
+    0,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench_common.h"
+
+#include <bmx/CPUFeatures.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+static void usage(const char *cmd, const BenchInfo &info)
+{
+    fprintf(stderr, "Usage: %s [options]\n", cmd);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, " -h | --help       Show usage and exit\n");
+    fprintf(stderr, " --check           %s\n", info.check_description);
+    if (info.iteration_data_size > 0) {
+        fprintf(stderr, " --iter <count>    Number of iterations over %u MB. Default %u\n",
+                info.iteration_data_size / (1024 * 1024), info.default_iterations);
+    } else {
+        fprintf(stderr, " --iter <count>    Number of iterations. Default %u\n", info.default_iterations);
+    }
+    if (info.filename)
+        fprintf(stderr, " --file <name>     Temporary file. Default '%s'\n", info.filename->c_str());
+}
+
+
+
+double get_elapsed_sec(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double get_rate(size_t size, uint32_t iterations, double secs)
+{
+    return size * (double)iterations / secs / 1.0e6;
+}
+
+void print_rate(const string &name, size_t size, uint32_t iterations, double secs)
+{
+    printf("%-24s %8.1f MB/s\n", name.c_str(), get_rate(size, iterations, secs));
+}
+
+void fill_random(vector<unsigned char> *data)
+{
+    size_t i;
+    for (i = 0; i < data->size(); i++)
+        (*data)[i] = (unsigned char)(rand() >> 4);
+}
+
+bool check_with_and_without_cpu_features(bool (*check)())
+{
+    bool result = true;
+
+    disable_cpu_features(false);
+    result &= check();
+
+    disable_cpu_features(true);
+    result &= check();
+    disable_cpu_features(false);
+
+    return result;
+}
+
+int bench_main(int argc, const char **argv, const BenchInfo &info)
+{
+    uint32_t iterations = info.default_iterations;
+    bool check_only = false;
+    int cmdln_index;
+
+    for (cmdln_index = 1; cmdln_index < argc; cmdln_index++) {
+        if (strcmp(argv[cmdln_index], "-h") == 0 ||
+            strcmp(argv[cmdln_index], "--help") == 0)
+        {
+            usage(argv[0], info);
+            return 0;
+        }
+        else if (strcmp(argv[cmdln_index], "--check") == 0)
+        {
+            check_only = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--iter") == 0)
+        {
+            if (cmdln_index + 1 >= argc ||
+                sscanf(argv[cmdln_index + 1], "%u", &iterations) != 1 || iterations == 0)
+            {
+                usage(argv[0], info);
+                fprintf(stderr, "Invalid or missing value for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (info.filename && strcmp(argv[cmdln_index], "--file") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                usage(argv[0], info);
+                fprintf(stderr, "Missing value for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            *info.filename = argv[cmdln_index + 1];
+            cmdln_index++;
+        }
+        else
+        {
+            usage(argv[0], info);
+            fprintf(stderr, "Unknown option '%s'\n", argv[cmdln_index]);
+            return 1;
+        }
+    }
+
+    int result = 0;
+    try
+    {
+        if (!info.check_all()) {
+            fprintf(stderr, "%s check failed\n", info.name);
+            result = 1;
+        } else if (!check_only) {
+            info.bench_all(iterations);
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        log_error("BMX exception caught: %s\n", ex.what());
+        result = 1;
+    }
+
+    if (info.filename)
+        remove(info.filename->c_str());
+
+    return result;
+}
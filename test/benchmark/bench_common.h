@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BENCH_COMMON_H_
+#define BENCH_COMMON_H_
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <bmx/BMXTypes.h>
+
+
+// A benchmark program first checks the optimised code against a reference implementation and then, unless
+// the --check option is set, measures the performance.
+
+typedef struct
+{
+    const char *name;               // used in the check failure message
+    const char *check_description;  // usage description of the --check option
+    uint32_t default_iterations;
+    uint32_t iteration_data_size;   // data size processed per iteration in the --iter usage, or 0 if it varies
+    std::string *filename;          // if not NULL, a temporary file that is set by --file and removed at exit
+    bool (*check_all)();
+    void (*bench_all)(uint32_t iterations);
+} BenchInfo;
+
+
+double get_elapsed_sec(std::chrono::steady_clock::time_point start);
+double get_rate(size_t size, uint32_t iterations, double secs);  // MB/s
+void print_rate(const std::string &name, size_t size, uint32_t iterations, double secs);
+
+void fill_random(std::vector<unsigned char> *data);
+
+bool check_with_and_without_cpu_features(bool (*check)());
+
+int bench_main(int argc, const char **argv, const BenchInfo &info);
+
+
+#endif
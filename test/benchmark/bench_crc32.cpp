@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/CRC32.h>
+#include <bmx/CPUFeatures.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define BENCH_DATA_SIZE     (16 * 1024 * 1024)
+
+
+static uint32_t REF_CRC32_TABLE[256];
+
+
+static void init_ref_table()
+{
+    uint32_t c;
+    int n, k;
+
+    for (n = 0; n < 256; n++) {
+        c = (uint32_t)n;
+        for (k = 0; k < 8; k++) {
+            if (c & 1)
+                c = 0xedb88320 ^ (c >> 1);
+            else
+                c = c >> 1;
+        }
+        REF_CRC32_TABLE[n] = c;
+    }
+}
+
+// reference implementation that processes a byte at a time
+static uint32_t ref_crc32(const unsigned char *data, size_t size)
+{
+    uint32_t crc = 0xffffffff;
+    size_t i;
+    for (i = 0; i < size; i++)
+        crc = REF_CRC32_TABLE[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+
+    return crc ^ 0xffffffff;
+}
+
+static uint32_t calc_crc32(const unsigned char *data, size_t size, size_t split)
+{
+    uint32_t crc;
+    crc32_init(&crc);
+    crc32_update(&crc, data, split);
+    crc32_update(&crc, data + split, size - split);
+    crc32_final(&crc);
+
+    return crc;
+}
+
+static bool check_crc32()
+{
+    static const char check_str[] = "123456789";
+    vector<unsigned char> data(2 * 1024 * 1024 + 64);
+    bool result = true;
+
+    fill_random(&data);
+
+    if (calc_crc32((const unsigned char*)check_str, strlen(check_str), 0) != 0xcbf43926) {
+        fprintf(stderr, "CRC-32 check value failed\n");
+        result = false;
+    }
+
+    // all sizes around the block sizes, at different alignments and with split updates
+    size_t size, offset;
+    for (size = 0; size < 600; size++) {
+        for (offset = 0; offset < 16; offset += 5) {
+            uint32_t expected = ref_crc32(&data[offset], size);
+            if (calc_crc32(&data[offset], size, 0) != expected ||
+                calc_crc32(&data[offset], size, size / 3) != expected)
+            {
+                fprintf(stderr, "CRC-32 failed for size %u at offset %u\n", (unsigned)size, (unsigned)offset);
+                result = false;
+            }
+        }
+    }
+
+    size = data.size() - 17;
+    if (calc_crc32(&data[3], size, 0) != ref_crc32(&data[3], size) ||
+        calc_crc32(&data[3], size, 1000001) != ref_crc32(&data[3], size))
+    {
+        fprintf(stderr, "CRC-32 failed for size %u\n", (unsigned)size);
+        result = false;
+    }
+
+    return result;
+}
+
+static bool check_all()
+{
+    init_ref_table();
+
+    return check_with_and_without_cpu_features(check_crc32);
+}
+
+static void bench_all(uint32_t iterations)
+{
+    vector<unsigned char> data(BENCH_DATA_SIZE);
+    uint32_t crc = 0;
+    size_t i;
+
+    printf("cpu features: pclmul=%d sse4.1=%d\n", cpu_has_pclmul(), cpu_has_sse41());
+
+    fill_random(&data);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        crc += ref_crc32(&data[0], data.size());
+    double table_secs = get_elapsed_sec(start);
+
+    disable_cpu_features(true);
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        crc += calc_crc32(&data[0], data.size(), 0);
+    double slice_secs = get_elapsed_sec(start);
+
+    disable_cpu_features(false);
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        crc += calc_crc32(&data[0], data.size(), 0);
+    double default_secs = get_elapsed_sec(start);
+
+    print_rate("byte table:", data.size(), iterations, table_secs);
+    print_rate("slicing-by-16:", data.size(), iterations, slice_secs);
+    print_rate(cpu_has_pclmul() && cpu_has_sse41() ? "default (pclmul):" : "default (slice):",
+               data.size(), iterations, default_secs);
+    printf("(checksum sum %08x)\n", crc);
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "CRC-32",
+    "Only check the CRC-32 results against a reference implementation",
+    20,
+    BENCH_DATA_SIZE,
+    0,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/MD5.h>
+#include <bmx/SHA1.h>
+#include <bmx/CPUFeatures.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define BENCH_DATA_SIZE     (16 * 1024 * 1024)
+
+
+static string calc_md5(const unsigned char *data, size_t size, size_t split)
+{
+    MD5Context context;
+    unsigned char digest[16];
+    md5_init(&context);
+    md5_update(&context, data, (uint32_t)split);
+    md5_update(&context, data + split, (uint32_t)(size - split));
+    md5_final(digest, &context);
+
+    return md5_digest_str(digest);
+}
+
+static string calc_sha1(const unsigned char *data, size_t size, size_t split)
+{
+    SHA1Context context;
+    unsigned char digest[20];
+    sha1_init(&context);
+    sha1_update(&context, data, (uint32_t)split);
+    sha1_update(&context, data + split, (uint32_t)(size - split));
+    sha1_final(digest, &context);
+
+    return sha1_digest_str(digest);
+}
+
+static bool check_vectors()
+{
+    static const struct
+    {
+        const char *data;
+        const char *md5;
+        const char *sha1;
+    } vectors[] =
+    {
+        {"",    "d41d8cd98f00b204e9800998ecf8427e", "da39a3ee5e6b4b0d3255bfef95601890afd80709"},
+        {"abc", "900150983cd24fb0d6963f7d28e17f72", "a9993e364706816aba3e25717850c26c9cd0d89d"},
+        {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+                "8215ef0796a20bcaaae116d3876c664a", "84983e441c3bd26ebaae4aa1f95129e5e54670f1"},
+    };
+    bool result = true;
+    size_t i;
+
+    for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        const unsigned char *data = (const unsigned char*)vectors[i].data;
+        size_t size = strlen(vectors[i].data);
+        if (calc_md5(data, size, size / 2) != vectors[i].md5) {
+            fprintf(stderr, "MD5 test vector %u failed\n", (unsigned)i);
+            result = false;
+        }
+        if (calc_sha1(data, size, size / 2) != vectors[i].sha1) {
+            fprintf(stderr, "SHA-1 test vector %u failed\n", (unsigned)i);
+            result = false;
+        }
+    }
+
+    // one million 'a' characters
+    vector<unsigned char> a_data(1000000, 'a');
+    if (calc_md5(&a_data[0], a_data.size(), 100) != "7707d6ae4e027c70eea2a935c2296f21") {
+        fprintf(stderr, "MD5 million 'a' test vector failed\n");
+        result = false;
+    }
+    if (calc_sha1(&a_data[0], a_data.size(), 100) != "34aa973cd4c4daa4f61eeb2bdbad27316534016f") {
+        fprintf(stderr, "SHA-1 million 'a' test vector failed\n");
+        result = false;
+    }
+
+    return result;
+}
+
+// the SHA extensions result is checked against the portable implementation
+static bool check_sha1_paths()
+{
+    vector<unsigned char> data(1024 * 1024 + 64);
+    bool result = true;
+
+    fill_random(&data);
+
+    // all sizes around the block sizes, at different alignments and with split updates
+    size_t size, offset;
+    for (size = 0; size < 600; size++) {
+        for (offset = 0; offset < 16; offset += 5) {
+            disable_cpu_features(true);
+            string expected = calc_sha1(&data[offset], size, 0);
+            disable_cpu_features(false);
+            if (calc_sha1(&data[offset], size, 0) != expected ||
+                calc_sha1(&data[offset], size, size / 3) != expected)
+            {
+                fprintf(stderr, "SHA-1 failed for size %u at offset %u\n", (unsigned)size, (unsigned)offset);
+                result = false;
+            }
+        }
+    }
+
+    size = data.size() - 17;
+    disable_cpu_features(true);
+    string expected = calc_sha1(&data[3], size, 0);
+    disable_cpu_features(false);
+    if (calc_sha1(&data[3], size, 100001) != expected) {
+        fprintf(stderr, "SHA-1 failed for size %u\n", (unsigned)size);
+        result = false;
+    }
+
+    return result;
+}
+
+static bool check_all()
+{
+    bool result = true;
+
+    result &= check_with_and_without_cpu_features(check_vectors);
+    result &= check_sha1_paths();
+
+    return result;
+}
+
+static void bench_all(uint32_t iterations)
+{
+    vector<unsigned char> data(BENCH_DATA_SIZE);
+    size_t i;
+
+    printf("cpu features: sha=%d sse4.1=%d\n", cpu_has_sha(), cpu_has_sse41());
+
+    fill_random(&data);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        calc_md5(&data[0], data.size(), 0);
+    double md5_secs = get_elapsed_sec(start);
+
+    disable_cpu_features(true);
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        calc_sha1(&data[0], data.size(), 0);
+    double sha1_c_secs = get_elapsed_sec(start);
+
+    disable_cpu_features(false);
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        calc_sha1(&data[0], data.size(), 0);
+    double sha1_default_secs = get_elapsed_sec(start);
+
+    print_rate("md5:", data.size(), iterations, md5_secs);
+    print_rate("sha1 portable:", data.size(), iterations, sha1_c_secs);
+    print_rate(cpu_has_sha() && cpu_has_sse41() ? "sha1 default (sha):" : "sha1 default (portable):",
+               data.size(), iterations, sha1_default_secs);
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "Digest",
+    "Only check the MD5 and SHA-1 results against test vectors and the portable implementation",
+    10,
+    BENCH_DATA_SIZE,
+    0,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <memory>
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/frame/Frame.h>
+
+#include <mxf/mxf_utils.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define BENCH_FRAME_COUNT   1000
+#define BENCH_FRAME_SIZE    (100 * 1024)
+#define BENCH_QUEUE_SIZE    8
+
+
+static Frame* create_frame(FrameFactory *factory, uint32_t size)
+{
+    Frame *frame = factory->CreateFrame();
+    frame->Grow(size);
+    memset(frame->GetBytesAvailable(), (int)(size & 0xff), size);
+    frame->SetSize(size);
+
+    return frame;
+}
+
+static bool check_stats(const char *name, PooledFrameFactory *factory, uint64_t data_hits, uint64_t data_misses,
+                        size_t free_data_count, uint64_t free_data_size)
+{
+    FramePoolStats stats;
+    factory->GetStats(&stats);
+    if (stats.data_hits != data_hits || stats.data_misses != data_misses ||
+        stats.free_data_count != free_data_count || stats.free_data_size != free_data_size)
+    {
+        fprintf(stderr, "%s: unexpected data stats hits=%u misses=%u free_count=%u free_size=%u\n", name,
+                (unsigned)stats.data_hits, (unsigned)stats.data_misses,
+                (unsigned)stats.free_data_count, (unsigned)stats.free_data_size);
+        return false;
+    }
+
+    return true;
+}
+
+static bool check_buffer(const char *name, Frame *frame, uint32_t alloc_size, uint32_t alignment)
+{
+    if (frame->GetSize() + frame->GetSizeAvailable() != alloc_size ||
+        ((uintptr_t)frame->GetBytes() % alignment) != 0)
+    {
+        fprintf(stderr, "%s: unexpected buffer size %u or alignment\n", name,
+                frame->GetSize() + frame->GetSizeAvailable());
+        return false;
+    }
+
+    return true;
+}
+
+static bool check_pool()
+{
+    uint32_t page_size = mxf_get_system_page_size();
+    bool result = true;
+
+    // small buffers are cache line aligned and larger buffers are page aligned
+    PooledFrameFactory factory(0, 4, 1024 * 1024);
+    Frame *small_frame = create_frame(&factory, 100);
+    Frame *large_frame = create_frame(&factory, page_size + 1);
+    result &= check_buffer("small frame", small_frame, 128, 64);
+    result &= check_buffer("large frame", large_frame, 2 * page_size, page_size);
+    result &= check_stats("created", &factory, 0, 2, 0, 0);
+
+    // the clone has its own buffer with the same data
+    Frame *clone = small_frame->Clone();
+    if (clone->GetSize() != small_frame->GetSize() ||
+        memcmp(clone->GetBytes(), small_frame->GetBytes(), small_frame->GetSize()) != 0)
+    {
+        fprintf(stderr, "clone: data differs\n");
+        result = false;
+    }
+    delete clone;
+    result &= check_stats("clone", &factory, 0, 3, 1, 128);
+
+    // the buffers are reused from the smallest size class that is large enough
+    delete small_frame;
+    delete large_frame;
+    result &= check_stats("deleted", &factory, 0, 3, 3, 128 + 128 + 2 * page_size);
+    large_frame = create_frame(&factory, 2 * page_size);
+    small_frame = create_frame(&factory, 64);
+    result &= check_buffer("reused large frame", large_frame, 2 * page_size, page_size);
+    result &= check_buffer("reused small frame", small_frame, 128, 64);
+    result &= check_stats("reused", &factory, 2, 3, 1, 128);
+    delete small_frame;
+    delete large_frame;
+
+    // a small buffer that grows beyond the page size is not page aligned and is not returned to the pool
+    small_frame = create_frame(&factory, 100);
+    small_frame->Grow(2 * page_size);
+    delete small_frame;
+    result &= check_stats("grown", &factory, 3, 3, 2, 128 + 2 * page_size);
+
+    // the number of free buffers is limited. The second frame takes the large buffer because there are no
+    // free small buffers left
+    vector<Frame*> frames;
+    size_t i;
+    for (i = 0; i < 6; i++)
+        frames.push_back(create_frame(&factory, 100));
+    for (i = 0; i < frames.size(); i++)
+        delete frames[i];
+    frames.clear();
+    result &= check_stats("limited", &factory, 5, 7, 4, 3 * 128 + 2 * page_size);
+
+    // the frame objects are recycled
+    uint64_t frame_hits, frame_misses;
+    PooledFrame::GetObjectStats(&frame_hits, &frame_misses);
+    delete factory.CreateFrame();
+    FramePoolStats stats;
+    factory.GetStats(&stats);
+    if (stats.frame_hits != frame_hits + 1 || stats.frame_misses != frame_misses) {
+        fprintf(stderr, "frame objects: not recycled\n");
+        result = false;
+    }
+
+    return result;
+}
+
+static bool check_shared_pool()
+{
+    bool result = true;
+
+    // the shared pool limits are the sum of the limits of the shared factories
+    unique_ptr<PooledFrameFactory> factory_a(PooledFrameFactory::CreateShared(2, 1024 * 1024));
+    unique_ptr<PooledFrameFactory> factory_b(PooledFrameFactory::CreateShared(2, 1024 * 1024));
+    FramePoolStats start_stats;
+    factory_a->GetStats(&start_stats);
+
+    vector<Frame*> frames;
+    size_t i;
+    for (i = 0; i < 6; i++)
+        frames.push_back(create_frame(i < 3 ? factory_a.get() : factory_b.get(), 1000));
+    for (i = 0; i < frames.size(); i++)
+        delete frames[i];
+    frames.clear();
+    result &= check_stats("shared", factory_b.get(), start_stats.data_hits, start_stats.data_misses + 6,
+                          start_stats.free_data_count + 4, start_stats.free_data_size + 4 * 1024);
+
+    // buffers released by the frames of one factory are reused by the other
+    delete create_frame(factory_b.get(), 1000);
+    result &= check_stats("shared reused", factory_a.get(), start_stats.data_hits + 1, start_stats.data_misses + 6,
+                          start_stats.free_data_count + 4, start_stats.free_data_size + 4 * 1024);
+
+    // the free buffers are trimmed when a factory is deleted
+    factory_b.reset();
+    result &= check_stats("shared trimmed", factory_a.get(), start_stats.data_hits + 1, start_stats.data_misses + 6,
+                          start_stats.free_data_count + 2, start_stats.free_data_size + 2 * 1024);
+
+    return result;
+}
+
+static bool check_all()
+{
+    bool result = true;
+
+    result &= check_pool();
+    result &= check_shared_pool();
+
+    return result;
+}
+
+static double bench_frames(FrameFactory *factory, uint32_t iterations)
+{
+    vector<Frame*> queue;
+    uint32_t i, f;
+
+    // frames are created and deleted through a queue, as they are by a track reader and its consumer
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++) {
+        for (f = 0; f < BENCH_FRAME_COUNT; f++) {
+            if (queue.size() == BENCH_QUEUE_SIZE) {
+                delete queue.front();
+                queue.erase(queue.begin());
+            }
+            queue.push_back(create_frame(factory, BENCH_FRAME_SIZE - (f & 0xff)));
+        }
+    }
+    for (f = 0; f < queue.size(); f++)
+        delete queue[f];
+
+    return get_elapsed_sec(start);
+}
+
+static void bench_all(uint32_t iterations)
+{
+    DefaultFrameFactory default_factory;
+    unique_ptr<PooledFrameFactory> pooled_factory(PooledFrameFactory::CreateShared());
+
+    double default_secs = bench_frames(&default_factory, iterations);
+    double pooled_secs = bench_frames(pooled_factory.get(), iterations);
+
+    print_rate("default frames:", (size_t)BENCH_FRAME_COUNT * BENCH_FRAME_SIZE, iterations, default_secs);
+    print_rate("pooled frames:", (size_t)BENCH_FRAME_COUNT * BENCH_FRAME_SIZE, iterations, pooled_secs);
+
+    FramePoolStats stats;
+    pooled_factory->GetStats(&stats);
+    printf("(frame hits %u misses %u, data hits %u misses %u)\n",
+           (unsigned)stats.frame_hits, (unsigned)stats.frame_misses,
+           (unsigned)stats.data_hits, (unsigned)stats.data_misses);
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "Frame pool",
+    "Only check the frame pool buffers and statistics",
+    20,
+    0,
+    0,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/essence_parser/SoundConversion.h>
+#include <bmx/CPUFeatures.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define AES3_SAMPLE_COUNT   1920
+#define PCM_SAMPLE_COUNT    48000
+
+
+typedef struct
+{
+    uint32_t bits_per_sample;
+    uint16_t channel_count;
+} PCMFormat;
+
+static const PCMFormat PCM_FORMATS[] =
+{
+    {16, 1}, {16, 2}, {16, 4}, {16, 8}, {16, 16}, {16, 64},
+    {24, 2}, {24, 4}, {24, 8}, {24, 16}, {24, 64},
+    {32, 2}, {32, 4}, {32, 8},
+};
+
+
+// the data is followed by a 0xcc guard byte to check for overruns
+static bool check_data(const vector<unsigned char> &data, const vector<unsigned char> &expected_data)
+{
+    return data.size() == expected_data.size() + 1 &&
+           equal(expected_data.begin(), expected_data.end(), data.begin()) &&
+           data.back() == 0xcc;
+}
+
+static void create_aes3_data(uint16_t sample_count, uint8_t valid_flags, vector<unsigned char> &aes3_data)
+{
+    aes3_data.resize(4 + sample_count * 8 * 4);
+    fill_random(&aes3_data);
+    aes3_data[0] = 0;
+    aes3_data[1] = (unsigned char)(sample_count & 0xff);
+    aes3_data[2] = (unsigned char)(sample_count >> 8);
+    aes3_data[3] = valid_flags;
+}
+
+// reference implementations that process a byte at a time
+
+static void ref_convert_aes3_to_mc_pcm(const vector<unsigned char> &aes3_data, uint32_t bits_per_sample,
+                                       uint8_t channel_count, vector<unsigned char> &pcm_data)
+{
+    uint16_t sample_count = ((uint16_t)aes3_data[2] << 8) | aes3_data[1];
+    uint8_t valid_flags = aes3_data[3];
+    uint32_t bytes_per_sample = (bits_per_sample + 7) / 8;
+    uint32_t i, c, b;
+
+    pcm_data.assign(sample_count * channel_count * bytes_per_sample, 0);
+    for (i = 0; i < sample_count; i++) {
+        for (c = 0; c < channel_count; c++) {
+            if (!(valid_flags & (1 << c)))
+                continue;
+            const unsigned char *aes = &aes3_data[4 + (i * 8 + c) * 4];
+            unsigned char *pcm = &pcm_data[(i * channel_count + c) * bytes_per_sample];
+            for (b = 0; b < bytes_per_sample; b++)
+                pcm[b] = (aes[b + 3 - bytes_per_sample] >> 4) | (aes[b + 4 - bytes_per_sample] << 4);
+        }
+    }
+}
+
+static void ref_deinterleave_audio(const vector<unsigned char> &input_data, uint32_t bits_per_sample,
+                                   uint16_t channel_count, uint16_t channel_num, vector<unsigned char> &output_data)
+{
+    uint32_t block_align = (bits_per_sample + 7) / 8;
+    uint32_t sample_count = (uint32_t)input_data.size() / (block_align * channel_count);
+    uint32_t i, b;
+
+    output_data.resize(sample_count * block_align);
+    for (i = 0; i < sample_count; i++) {
+        for (b = 0; b < block_align; b++)
+            output_data[i * block_align + b] = input_data[(i * channel_count + channel_num) * block_align + b];
+    }
+}
+
+static bool check_aes3_conversion()
+{
+    static const uint16_t sample_counts[] = {0, 1, 2, 3, 5, 8, 1601, 1602, AES3_SAMPLE_COUNT};
+    static const uint8_t valid_flags[] = {0xff, 0x00, 0x5a, 0x81};
+    vector<unsigned char> aes3_data, pcm_data, ref_pcm_data;
+    size_t s, v;
+    uint32_t bits_per_sample;
+    uint8_t channel_count, channel_num;
+    bool result = true;
+
+    for (s = 0; s < sizeof(sample_counts) / sizeof(sample_counts[0]); s++) {
+        for (v = 0; v < sizeof(valid_flags) / sizeof(valid_flags[0]); v++) {
+            create_aes3_data(sample_counts[s], valid_flags[v], aes3_data);
+            for (bits_per_sample = 16; bits_per_sample <= 24; bits_per_sample += 8) {
+                uint32_t bytes_per_sample = bits_per_sample / 8;
+                for (channel_count = 1; channel_count <= 8; channel_count++) {
+                    ref_convert_aes3_to_mc_pcm(aes3_data, bits_per_sample, channel_count, ref_pcm_data);
+                    pcm_data.assign(ref_pcm_data.size() + 1, 0xcc);
+                    convert_aes3_to_mc_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), false, bits_per_sample,
+                                           channel_count, &pcm_data[0], (uint32_t)pcm_data.size());
+                    if (!check_data(pcm_data, ref_pcm_data)) {
+                        fprintf(stderr, "AES3 to %u-bit %u channel PCM failed for sample count %u\n",
+                                bits_per_sample, channel_count, sample_counts[s]);
+                        result = false;
+                    }
+                }
+
+                ref_convert_aes3_to_mc_pcm(aes3_data, bits_per_sample, 8, ref_pcm_data);
+                for (channel_num = 0; channel_num < 8; channel_num++) {
+                    pcm_data.assign(sample_counts[s] * bytes_per_sample + 1, 0xcc);
+                    convert_aes3_to_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), false, bits_per_sample,
+                                        channel_num, &pcm_data[0], (uint32_t)pcm_data.size());
+                    uint32_t i;
+                    for (i = 0; i < sample_counts[s]; i++) {
+                        if (memcmp(&pcm_data[i * bytes_per_sample],
+                                   &ref_pcm_data[(i * 8 + channel_num) * bytes_per_sample], bytes_per_sample) != 0)
+                        {
+                            break;
+                        }
+                    }
+                    if (i < sample_counts[s] || pcm_data.back() != 0xcc) {
+                        fprintf(stderr, "AES3 to %u-bit PCM channel %u failed for sample count %u\n",
+                                bits_per_sample, channel_num, sample_counts[s]);
+                        result = false;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static bool check_interleaving()
+{
+    static const uint32_t sample_counts[] = {0, 1, 7, 8, 9, 17, 33, 1601, 1602};
+    vector<unsigned char> input_data, channel_data, ref_channel_data, output_data;
+    size_t s, f;
+    uint16_t channel_num;
+    bool result = true;
+
+    for (s = 0; s < sizeof(sample_counts) / sizeof(sample_counts[0]); s++) {
+        for (f = 0; f < sizeof(PCM_FORMATS) / sizeof(PCM_FORMATS[0]); f++) {
+            uint32_t bits_per_sample = PCM_FORMATS[f].bits_per_sample;
+            uint16_t channel_count = PCM_FORMATS[f].channel_count;
+            uint32_t block_align = (bits_per_sample + 7) / 8;
+
+            input_data.resize(sample_counts[s] * block_align * channel_count);
+            fill_random(&input_data);
+            output_data.assign(input_data.size() + 1, 0xcc);
+
+            for (channel_num = 0; channel_num < channel_count; channel_num++) {
+                ref_deinterleave_audio(input_data, bits_per_sample, channel_count, channel_num, ref_channel_data);
+                channel_data.assign(ref_channel_data.size() + 1, 0xcc);
+                deinterleave_audio(input_data.empty() ? 0 : &input_data[0], (uint32_t)input_data.size(),
+                                   bits_per_sample, channel_count, channel_num,
+                                   &channel_data[0], (uint32_t)channel_data.size());
+                if (!check_data(channel_data, ref_channel_data)) {
+                    fprintf(stderr, "Deinterleave %u-bit channel %u of %u failed for sample count %u\n",
+                            bits_per_sample, channel_num, channel_count, sample_counts[s]);
+                    result = false;
+                }
+
+                interleave_audio(&channel_data[0], (uint32_t)ref_channel_data.size(),
+                                 bits_per_sample, channel_count, channel_num,
+                                 &output_data[0], (uint32_t)output_data.size());
+            }
+
+            if (!check_data(output_data, input_data)) {
+                fprintf(stderr, "Interleave %u-bit %u channels failed for sample count %u\n",
+                        bits_per_sample, channel_count, sample_counts[s]);
+                result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+// the inputs and outputs are either mono channels or pairs of channels
+static bool check_multi_interleaving()
+{
+    static const uint32_t sample_counts[] = {0, 1, 5, 6, 7, 8, 9, 17, 33, 1601, 1602};
+    vector<unsigned char> input_data, channel_data, output_data;
+    vector<vector<unsigned char> > inputs, outputs;
+    vector<const unsigned char*> input_ptrs;
+    vector<unsigned char*> output_ptrs;
+    size_t s, f;
+    uint16_t channels_per_input;
+    uint16_t i, c;
+    bool result = true;
+
+    for (s = 0; s < sizeof(sample_counts) / sizeof(sample_counts[0]); s++) {
+        for (f = 0; f < sizeof(PCM_FORMATS) / sizeof(PCM_FORMATS[0]); f++) {
+            uint32_t bits_per_sample = PCM_FORMATS[f].bits_per_sample;
+            uint16_t channel_count = PCM_FORMATS[f].channel_count;
+            uint32_t block_align = (bits_per_sample + 7) / 8;
+
+            input_data.resize(sample_counts[s] * block_align * channel_count);
+            fill_random(&input_data);
+
+            for (channels_per_input = 1; channels_per_input <= 2; channels_per_input++) {
+                if (channel_count % channels_per_input != 0)
+                    continue;
+                uint16_t input_count = channel_count / channels_per_input;
+                uint32_t input_block_align = channels_per_input * block_align;
+
+                // the inputs have an extra guard byte so that the buffers are never empty
+                inputs.assign(input_count, vector<unsigned char>(sample_counts[s] * input_block_align + 1, 0xcc));
+                input_ptrs.resize(input_count);
+                for (i = 0; i < input_count; i++) {
+                    for (c = 0; c < channels_per_input; c++) {
+                        ref_deinterleave_audio(input_data, bits_per_sample, channel_count,
+                                               i * channels_per_input + c, channel_data);
+                        interleave_audio(channel_data.empty() ? 0 : &channel_data[0], (uint32_t)channel_data.size(),
+                                         bits_per_sample, channels_per_input, c,
+                                         &inputs[i][0], (uint32_t)inputs[i].size());
+                    }
+                    input_ptrs[i] = &inputs[i][0];
+                }
+
+                output_data.assign(input_data.size() + 1, 0xcc);
+                interleave_audio_inputs(&input_ptrs[0], input_count, input_block_align, sample_counts[s],
+                                        &output_data[0], channel_count * block_align);
+                if (!check_data(output_data, input_data)) {
+                    fprintf(stderr, "Interleave %u-bit %u inputs with %u channels failed for sample count %u\n",
+                            bits_per_sample, input_count, channels_per_input, sample_counts[s]);
+                    result = false;
+                }
+
+                if (input_data.empty())
+                    continue;
+
+                outputs.assign(input_count, vector<unsigned char>(inputs[0].size(), 0xcc));
+                output_ptrs.resize(input_count);
+                for (i = 0; i < input_count; i++)
+                    output_ptrs[i] = &outputs[i][0];
+                deinterleave_audio_outputs(&input_data[0], channel_count * block_align, sample_counts[s],
+                                           input_block_align, &output_ptrs[0], input_count);
+                for (i = 0; i < input_count; i++) {
+                    if (outputs[i] != inputs[i]) {
+                        fprintf(stderr, "Deinterleave %u-bit %u outputs with %u channels failed for sample count %u\n",
+                                bits_per_sample, input_count, channels_per_input, sample_counts[s]);
+                        result = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static bool check_conversions()
+{
+    bool result = true;
+
+    result &= check_aes3_conversion();
+    result &= check_interleaving();
+    result &= check_multi_interleaving();
+
+    return result;
+}
+
+static bool check_all()
+{
+    return check_with_and_without_cpu_features(check_conversions);
+}
+
+static void bench_aes3_conversion(uint32_t iterations)
+{
+    vector<unsigned char> aes3_data, pcm_data;
+    uint32_t bits_per_sample;
+    uint8_t channel_count;
+    uint32_t i;
+    int scalar;
+
+    create_aes3_data(AES3_SAMPLE_COUNT, 0xff, aes3_data);
+    pcm_data.resize(AES3_SAMPLE_COUNT * 8 * 3);
+
+    for (bits_per_sample = 16; bits_per_sample <= 24; bits_per_sample += 8) {
+        for (channel_count = 4; channel_count <= 8; channel_count += 4) {
+            double secs[2];
+            for (scalar = 0; scalar < 2; scalar++) {
+                disable_cpu_features(scalar != 0);
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                for (i = 0; i < iterations; i++) {
+                    convert_aes3_to_mc_pcm(&aes3_data[0], (uint32_t)aes3_data.size(), false, bits_per_sample,
+                                           channel_count, &pcm_data[0], (uint32_t)pcm_data.size());
+                }
+                secs[scalar] = get_elapsed_sec(start);
+            }
+            printf("aes3 to %u-bit %u channel pcm: %8.1f MB/s (scalar %8.1f MB/s)\n",
+                   bits_per_sample, channel_count,
+                   get_rate(aes3_data.size(), iterations, secs[0]),
+                   get_rate(aes3_data.size(), iterations, secs[1]));
+        }
+    }
+
+    disable_cpu_features(false);
+}
+
+static void bench_interleaving(uint32_t iterations)
+{
+    vector<unsigned char> input_data, channel_data;
+    size_t f;
+    uint32_t i;
+    int scalar;
+
+    for (f = 0; f < sizeof(PCM_FORMATS) / sizeof(PCM_FORMATS[0]); f++) {
+        uint32_t bits_per_sample = PCM_FORMATS[f].bits_per_sample;
+        uint16_t channel_count = PCM_FORMATS[f].channel_count;
+        uint32_t block_align = (bits_per_sample + 7) / 8;
+        if (channel_count == 1)
+            continue;
+
+        input_data.resize(PCM_SAMPLE_COUNT * block_align * channel_count);
+        fill_random(&input_data);
+        channel_data.resize(PCM_SAMPLE_COUNT * block_align);
+
+        // the iterations are scaled so that the same amount of channel data is processed for each format
+        uint32_t format_iterations = iterations * 8 / channel_count + 1;
+        double deinterleave_secs[2];
+        double interleave_secs[2];
+        for (scalar = 0; scalar < 2; scalar++) {
+            disable_cpu_features(scalar != 0);
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (i = 0; i < format_iterations; i++) {
+                deinterleave_audio(&input_data[0], (uint32_t)input_data.size(), bits_per_sample, channel_count,
+                                   (uint16_t)(i % channel_count), &channel_data[0], (uint32_t)channel_data.size());
+            }
+            deinterleave_secs[scalar] = get_elapsed_sec(start);
+
+            start = chrono::steady_clock::now();
+            for (i = 0; i < format_iterations; i++) {
+                interleave_audio(&channel_data[0], (uint32_t)channel_data.size(), bits_per_sample, channel_count,
+                                 (uint16_t)(i % channel_count), &input_data[0], (uint32_t)input_data.size());
+            }
+            interleave_secs[scalar] = get_elapsed_sec(start);
+        }
+        vector<vector<unsigned char> > inputs(channel_count, vector<unsigned char>(channel_data.size()));
+        vector<const unsigned char*> input_ptrs(channel_count);
+        for (i = 0; i < channel_count; i++) {
+            fill_random(&inputs[i]);
+            input_ptrs[i] = &inputs[i][0];
+        }
+        double inputs_interleave_secs[2];
+        for (scalar = 0; scalar < 2; scalar++) {
+            disable_cpu_features(scalar != 0);
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (i = 0; i < format_iterations; i += channel_count) {
+                interleave_audio_inputs(&input_ptrs[0], channel_count, block_align, PCM_SAMPLE_COUNT,
+                                        &input_data[0], channel_count * block_align);
+            }
+            inputs_interleave_secs[scalar] = get_elapsed_sec(start);
+        }
+
+        uint32_t inputs_iterations = (format_iterations + channel_count - 1) / channel_count;
+        printf("deinterleave %2u-bit %2u channels: %8.1f MB/s (scalar %8.1f MB/s)\n",
+               bits_per_sample, channel_count,
+               get_rate(channel_data.size(), format_iterations, deinterleave_secs[0]),
+               get_rate(channel_data.size(), format_iterations, deinterleave_secs[1]));
+        printf("interleave   %2u-bit %2u channels: %8.1f MB/s (scalar %8.1f MB/s)\n",
+               bits_per_sample, channel_count,
+               get_rate(channel_data.size(), format_iterations, interleave_secs[0]),
+               get_rate(channel_data.size(), format_iterations, interleave_secs[1]));
+        printf("interleave   %2u-bit %2u inputs:   %8.1f MB/s (scalar %8.1f MB/s)\n",
+               bits_per_sample, channel_count,
+               get_rate(input_data.size(), inputs_iterations, inputs_interleave_secs[0]),
+               get_rate(input_data.size(), inputs_iterations, inputs_interleave_secs[1]));
+    }
+
+    disable_cpu_features(false);
+}
+
+static void bench_all(uint32_t iterations)
+{
+    printf("cpu features: sse2=%d ssse3=%d avx2=%d\n", cpu_has_sse2(), cpu_has_ssse3(), cpu_has_avx2());
+    bench_aes3_conversion(iterations);
+    bench_interleaving(iterations);
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "Sound conversion",
+    "Only check the conversion results against a reference implementation",
+    2000,
+    0,
+    0,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define __STDC_LIMIT_MACROS
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/essence_parser/MPEG2EssenceParser.h>
+#include <bmx/essence_parser/VC3EssenceParser.h>
+#include <bmx/CPUFeatures.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define BENCH_DATA_SIZE         (16 * 1024 * 1024)
+#define BENCH_FRAME_SIZE        (200 * 1024)
+
+#define PICTURE_START_CODE      0x00000100
+#define SEQUENCE_HEADER_CODE    0x000001b3
+#define GROUP_HEADER_CODE       0x000001b8
+
+
+// reference implementations that shift in a byte at a time, as used by the MPEG-2 and VC-3 parsers
+// before the start code prefix search was added
+
+static uint32_t ref_mpeg2_frame_start(const unsigned char *data, uint32_t data_size)
+{
+    uint32_t state = 0xffffffff;
+    uint32_t offset = 0;
+    while (offset < data_size) {
+        state = (state << 8) | data[offset];
+        if (state == SEQUENCE_HEADER_CODE ||
+            state == GROUP_HEADER_CODE ||
+            state == PICTURE_START_CODE)
+        {
+            return offset - 3;
+        }
+
+        offset++;
+    }
+
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+class RefMPEG2FrameSize
+{
+public:
+    RefMPEG2FrameSize()
+    {
+        Reset();
+    }
+
+    uint32_t ParseFrameSize(const unsigned char *data, uint32_t data_size)
+    {
+        if (data_size < 4)
+            return ESSENCE_PARSER_NULL_OFFSET;
+
+        while (mOffset < data_size) {
+            mState = (mState << 8) | data[mOffset];
+            if (mState == SEQUENCE_HEADER_CODE ||
+                mState == GROUP_HEADER_CODE ||
+                mState == PICTURE_START_CODE)
+            {
+                if ((mState == SEQUENCE_HEADER_CODE && (mSequenceHeader || mGroupHeader || mPictureStart)) ||
+                    (mState == GROUP_HEADER_CODE && (mGroupHeader || mPictureStart)) ||
+                    (mState == PICTURE_START_CODE && mPictureStart))
+                {
+                    uint32_t frame_size = mOffset - 3;
+                    Reset();
+                    return frame_size;
+                }
+
+                mSequenceHeader = mSequenceHeader || (mState == SEQUENCE_HEADER_CODE);
+                mGroupHeader = mGroupHeader || (mState == GROUP_HEADER_CODE);
+                mPictureStart = mPictureStart || (mState == PICTURE_START_CODE);
+            }
+            else if (mOffset == 3)
+            {
+                Reset();
+                return ESSENCE_PARSER_NULL_FRAME_SIZE;
+            }
+
+            mOffset++;
+        }
+
+        return ESSENCE_PARSER_NULL_OFFSET;
+    }
+
+private:
+    void Reset()
+    {
+        mOffset = 0;
+        mState = 0xffffffff;
+        mSequenceHeader = false;
+        mGroupHeader = false;
+        mPictureStart = false;
+    }
+
+private:
+    uint32_t mOffset;
+    uint32_t mState;
+    bool mSequenceHeader;
+    bool mGroupHeader;
+    bool mPictureStart;
+};
+
+// the state is initialised to all 1s rather than 0 as in the original parser, which wrongly matched a
+// partial prefix at the start of the data and returned an invalid offset
+static uint32_t ref_vc3_frame_start(const unsigned char *data, uint32_t data_size)
+{
+    uint64_t state = UINT64_MAX;
+    uint32_t i;
+    for (i = 0; i < data_size; i++) {
+        state = (state << 8) | data[i];
+        if ((state & 0xffffffff0000LL) == 0x000002800000LL &&
+            (state & 0x000000000003LL) < 3)
+        {
+            return i - 5;
+        }
+    }
+
+    return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+
+// random data with start codes and the bytes that occur in them inserted at random positions
+static void fill_data(vector<unsigned char> *data, uint32_t code_interval)
+{
+    static const unsigned char codes[] = {0xb3, 0xb8, 0x00, 0xb5, 0x01, 0x02};
+    size_t i;
+
+    for (i = 0; i < data->size(); i++) {
+        int r = rand();
+        if ((r % code_interval) == 0 && i + 6 <= data->size()) {
+            (*data)[i++] = 0x00;
+            (*data)[i++] = 0x00;
+            (*data)[i++] = ((r >> 12) & 1) ? 0x01 : 0x02;
+            (*data)[i]   = ((r >> 13) & 1) ? 0x80 : codes[(r >> 14) % sizeof(codes)];
+        } else if ((r % 7) == 1) {
+            (*data)[i] = (r >> 8) & 1;
+        } else {
+            (*data)[i] = (unsigned char)(r >> 4);
+        }
+    }
+}
+
+// check that the frame start and size results are identical when the data is made available in chunks
+static bool check_mpeg2_parse(const vector<unsigned char> &data, uint32_t max_chunk_size)
+{
+    MPEG2EssenceParser parser;
+    RefMPEG2FrameSize ref_parser;
+    uint32_t total_size = (uint32_t)data.size();
+    uint32_t pos = 0;
+
+    while (pos < total_size) {
+        uint32_t ref_start = ref_mpeg2_frame_start(&data[pos], total_size - pos);
+        uint32_t start = parser.ParseFrameStart(&data[pos], total_size - pos);
+        if (start != ref_start) {
+            fprintf(stderr, "MPEG-2 frame start %u != %u at position %u\n", start, ref_start, pos);
+            return false;
+        }
+        if (ref_start == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+        pos += ref_start;
+
+        uint32_t avail = 0;
+        while (true) {
+            avail += 1 + (uint32_t)rand() % max_chunk_size;
+            if (avail > total_size - pos)
+                avail = total_size - pos;
+
+            uint32_t ref_size = ref_parser.ParseFrameSize(&data[pos], avail);
+            uint32_t size = parser.ParseFrameSize(&data[pos], avail);
+            if (size != ref_size) {
+                fprintf(stderr, "MPEG-2 frame size %u != %u at position %u\n", size, ref_size, pos);
+                return false;
+            }
+            if (ref_size == ESSENCE_PARSER_NULL_FRAME_SIZE) {
+                pos++;
+                break;
+            } else if (ref_size != ESSENCE_PARSER_NULL_OFFSET) {
+                pos += ref_size;
+                break;
+            } else if (avail == total_size - pos) {
+                return true;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool check_vc3_parse(const vector<unsigned char> &data)
+{
+    VC3EssenceParser parser;
+    uint32_t total_size = (uint32_t)data.size();
+    uint32_t pos = 0;
+
+    while (pos < total_size) {
+        uint32_t ref_start = ref_vc3_frame_start(&data[pos], total_size - pos);
+        uint32_t start = parser.ParseFrameStart(&data[pos], total_size - pos);
+        if (start != ref_start) {
+            fprintf(stderr, "VC-3 frame start %u != %u at position %u\n", start, ref_start, pos);
+            return false;
+        }
+        if (ref_start == ESSENCE_PARSER_NULL_OFFSET)
+            break;
+        pos += ref_start + 1;
+    }
+
+    return true;
+}
+
+static bool check_parsers()
+{
+    bool result = true;
+    uint32_t code_interval;
+
+    for (code_interval = 7; code_interval < 5000; code_interval *= 3) {
+        vector<unsigned char> data(256 * 1024);
+        fill_data(&data, code_interval);
+        result &= check_mpeg2_parse(data, 1);
+        result &= check_mpeg2_parse(data, 100);
+        result &= check_mpeg2_parse(data, 10000);
+        result &= check_vc3_parse(data);
+    }
+
+    // all small sizes
+    uint32_t size;
+    for (size = 0; size < 100; size++) {
+        vector<unsigned char> data(size + 1);
+        fill_data(&data, 5);
+        data.resize(size);
+        result &= check_mpeg2_parse(data, 3);
+        result &= check_vc3_parse(data);
+    }
+
+    return result;
+}
+
+static bool check_all()
+{
+    return check_with_and_without_cpu_features(check_parsers);
+}
+
+// parse the sizes of frames that contain a sequence header and a picture start code
+static uint32_t parse_frames(const vector<unsigned char> &data, bool reference)
+{
+    MPEG2EssenceParser parser;
+    RefMPEG2FrameSize ref_parser;
+    uint32_t total_size = (uint32_t)data.size();
+    uint32_t pos = 0;
+    uint32_t count = 0;
+
+    while (pos < total_size) {
+        uint32_t frame_size;
+        if (reference)
+            frame_size = ref_parser.ParseFrameSize(&data[pos], total_size - pos);
+        else
+            frame_size = parser.ParseFrameSize(&data[pos], total_size - pos);
+        if (frame_size == ESSENCE_PARSER_NULL_OFFSET || frame_size == ESSENCE_PARSER_NULL_FRAME_SIZE)
+            break;
+        pos += frame_size;
+        count++;
+    }
+
+    return count;
+}
+
+static void bench_all(uint32_t iterations)
+{
+    vector<unsigned char> data(BENCH_DATA_SIZE);
+    uint32_t count = 0;
+    size_t i;
+
+    printf("cpu features: avx2=%d sse2=%d\n", cpu_has_avx2(), cpu_has_sse2());
+
+    fill_random(&data);
+    for (i = 0; i + BENCH_FRAME_SIZE <= data.size(); i += BENCH_FRAME_SIZE) {
+        data[i]      = 0x00;
+        data[i + 1]  = 0x00;
+        data[i + 2]  = 0x01;
+        data[i + 3]  = 0xb3;
+        data[i + 100] = 0x00;
+        data[i + 101] = 0x00;
+        data[i + 102] = 0x01;
+        data[i + 103] = 0x00;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        count += parse_frames(data, true);
+    double ref_secs = get_elapsed_sec(start);
+
+    disable_cpu_features(true);
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        count += parse_frames(data, false);
+    double scalar_secs = get_elapsed_sec(start);
+
+    disable_cpu_features(false);
+    start = chrono::steady_clock::now();
+    for (i = 0; i < iterations; i++)
+        count += parse_frames(data, false);
+    double default_secs = get_elapsed_sec(start);
+
+    print_rate("byte shift:", data.size(), iterations, ref_secs);
+    print_rate("prefix skip:", data.size(), iterations, scalar_secs);
+    print_rate(string("default (") + (cpu_has_avx2() ? "avx2" : (cpu_has_sse2() ? "sse2" : "skip")) + "):",
+               data.size(), iterations, default_secs);
+    printf("(frame count %u)\n", count);
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "Start code",
+    "Only check the parser results against a reference implementation",
+    20,
+    BENCH_DATA_SIZE,
+    0,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2026, British Broadcasting Corporation
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+
+#include <bmx/wave/WaveFileIO.h>
+#include <bmx/wave/WaveReader.h>
+#include <bmx/wave/WaveWriter.h>
+#include <bmx/CPUFeatures.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define READ_SAMPLE_COUNT       1920
+#define CHECK_SAMPLE_COUNT      4801
+#define BENCH_DATA_SIZE         (32 * 1000 * 1000)
+
+
+typedef struct
+{
+    uint16_t bits_per_sample;
+    uint16_t channel_count;
+} PCMFormat;
+
+static const PCMFormat CHECK_FORMATS[] =
+{
+    {16, 1}, {16, 2}, {16, 3}, {16, 8}, {16, 13}, {16, 64},
+    {24, 2}, {24, 5}, {24, 16}, {24, 64},
+    {32, 2}, {32, 7}, {32, 8},
+};
+
+static const PCMFormat BENCH_FORMATS[] =
+{
+    {16, 2}, {16, 8}, {16, 16}, {16, 64},
+    {24, 2}, {24, 8}, {24, 16}, {24, 64},
+};
+
+
+static string g_filename = "bench_wave_reader.wav";
+
+
+static void write_wave_file(const string &filename, const PCMFormat &format, const vector<unsigned char> &data)
+{
+    uint32_t block_align = format.channel_count * ((format.bits_per_sample + 7) / 8);
+
+    WaveWriter writer(WaveFileIO::OpenNew(filename), true);
+    WaveTrackWriter *track = writer.CreateTrack();
+    track->SetSamplingRate(SAMPLING_RATE_48K);
+    track->SetQuantizationBits(format.bits_per_sample);
+    track->SetChannelCount(format.channel_count);
+    writer.PrepareWrite();
+    writer.WriteSamples(0, &data[0], (uint32_t)data.size(), (uint32_t)(data.size() / block_align));
+    writer.CompleteWrite();
+}
+
+static WaveReader* open_wave_file(const string &filename, bool use_mmap_file)
+{
+    WaveFileIO *file = WaveFileIO::OpenRead(filename);
+    if (use_mmap_file && !file->MapFile())
+        log_warn("Failed to map file '%s'\n", filename.c_str());
+
+    WaveReader *reader = WaveReader::Open(file, true);
+    if (!reader)
+        BMX_EXCEPTION(("Failed to open wave file '%s'", filename.c_str()));
+
+    return reader;
+}
+
+// every third channel is disabled if disable_tracks is true
+static bool check_read(const string &filename, const PCMFormat &format, const vector<unsigned char> &data,
+                       bool use_mmap_file, bool disable_tracks)
+{
+    uint32_t channel_block_align = (format.bits_per_sample + 7) / 8;
+    uint32_t block_align = format.channel_count * channel_block_align;
+    bool result = true;
+
+    WaveReader *reader = open_wave_file(filename, use_mmap_file);
+    uint32_t i;
+    for (i = 0; i < reader->GetNumTracks(); i++)
+        reader->GetTrack(i)->SetEnable(!disable_tracks || (i % 3) != 1);
+
+    int64_t position = 0;
+    while (result && position < reader->GetDuration()) {
+        uint32_t num_read = reader->Read(READ_SAMPLE_COUNT);
+        for (i = 0; i < reader->GetNumTracks(); i++) {
+            WaveTrackReader *track = reader->GetTrack(i);
+            if (!track->IsEnabled()) {
+                if (track->GetFrameBuffer()->GetNumFrames() != 0)
+                    result = false;
+                continue;
+            }
+
+            Frame *frame = track->GetFrameBuffer()->GetLastFrame(true);
+            if (!frame || frame->num_samples != num_read || frame->GetSize() != num_read * channel_block_align) {
+                result = false;
+            } else {
+                uint32_t s;
+                for (s = 0; s < num_read; s++) {
+                    if (memcmp(&frame->GetBytes()[s * channel_block_align],
+                               &data[(position + s) * block_align + i * channel_block_align],
+                               channel_block_align) != 0)
+                    {
+                        result = false;
+                        break;
+                    }
+                }
+            }
+            delete frame;
+        }
+        position += num_read;
+    }
+    if (position != (int64_t)(data.size() / block_align))
+        result = false;
+
+    delete reader;
+
+    if (!result) {
+        fprintf(stderr, "Read %u-bit %u channels failed (mmap=%d, disabled tracks=%d)\n",
+                format.bits_per_sample, format.channel_count, use_mmap_file, disable_tracks);
+    }
+
+    return result;
+}
+
+static bool check_formats()
+{
+    vector<unsigned char> data;
+    bool result = true;
+    size_t f;
+
+    for (f = 0; f < sizeof(CHECK_FORMATS) / sizeof(CHECK_FORMATS[0]); f++) {
+        data.resize(CHECK_SAMPLE_COUNT * CHECK_FORMATS[f].channel_count *
+                    ((CHECK_FORMATS[f].bits_per_sample + 7) / 8));
+        fill_random(&data);
+        write_wave_file(g_filename, CHECK_FORMATS[f], data);
+
+        result &= check_read(g_filename, CHECK_FORMATS[f], data, false, false);
+        result &= check_read(g_filename, CHECK_FORMATS[f], data, false, true);
+        result &= check_read(g_filename, CHECK_FORMATS[f], data, true, false);
+        result &= check_read(g_filename, CHECK_FORMATS[f], data, true, true);
+    }
+
+    return result;
+}
+
+static bool check_all()
+{
+    return check_with_and_without_cpu_features(check_formats);
+}
+
+static double bench_read(const string &filename, bool use_mmap_file, uint32_t iterations)
+{
+    WaveReader *reader = open_wave_file(filename, use_mmap_file);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    uint32_t i, t;
+    for (i = 0; i < iterations; i++) {
+        reader->Seek(0);
+        while (reader->GetPosition() < reader->GetDuration()) {
+            reader->Read(READ_SAMPLE_COUNT);
+            for (t = 0; t < reader->GetNumTracks(); t++)
+                delete reader->GetTrack(t)->GetFrameBuffer()->GetLastFrame(true);
+        }
+    }
+    double secs = get_elapsed_sec(start);
+
+    delete reader;
+
+    return secs;
+}
+
+static void bench_all(uint32_t iterations)
+{
+    vector<unsigned char> data;
+    size_t f;
+
+    printf("cpu features: sse2=%d ssse3=%d avx2=%d\n", cpu_has_sse2(), cpu_has_ssse3(), cpu_has_avx2());
+
+    for (f = 0; f < sizeof(BENCH_FORMATS) / sizeof(BENCH_FORMATS[0]); f++) {
+        uint32_t block_align = BENCH_FORMATS[f].channel_count * ((BENCH_FORMATS[f].bits_per_sample + 7) / 8);
+        data.resize(BENCH_DATA_SIZE / block_align * block_align);
+        fill_random(&data);
+        write_wave_file(g_filename, BENCH_FORMATS[f], data);
+
+        double read_secs[2];
+        double mmap_secs;
+        int scalar;
+        for (scalar = 0; scalar < 2; scalar++) {
+            disable_cpu_features(scalar != 0);
+            read_secs[scalar] = bench_read(g_filename, false, iterations);
+        }
+        disable_cpu_features(false);
+        mmap_secs = bench_read(g_filename, true, iterations);
+
+        printf("read %2u-bit %2u channels: %8.1f MB/s (mmap %8.1f MB/s, scalar %8.1f MB/s)\n",
+               BENCH_FORMATS[f].bits_per_sample, BENCH_FORMATS[f].channel_count,
+               get_rate(data.size(), iterations, read_secs[0]),
+               get_rate(data.size(), iterations, mmap_secs),
+               get_rate(data.size(), iterations, read_secs[1]));
+    }
+}
+
+static const BenchInfo BENCH_INFO =
+{
+    "Wave reader",
+    "Only check the samples read against the samples written",
+    5,
+    0,
+    &g_filename,
+    check_all,
+    bench_all,
+};
+
+int main(int argc, const char **argv)
+{
+    return bench_main(argc, argv, BENCH_INFO);
+}
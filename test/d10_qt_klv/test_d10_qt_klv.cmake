@@ -2,8 +2,9 @@
 # Perform the following checks:
 # 1) wrapping from the raw essence extracted from sample.mxf containing the D-10 KL prefix
 # 2) wrapping from the raw essence extracted from 1) produces the same result as 1)
-# 3) transwrapping from the sample.mxf containing the D-10 KL prefix
-# 4) transwrapping from the MXF from 3) produces the same result as 3)
+# 3) wrapping from the raw essence extracted from 1) using track worker threads produces the same result as 1)
+# 4) transwrapping from the sample.mxf containing the D-10 KL prefix
+# 5) transwrapping from the MXF from 4) produces the same result as 4)
 
 include("${TEST_SOURCE_DIR}/../testing.cmake")
 
@@ -12,6 +13,7 @@ function(run_rewrap_test input_file output_file)
     execute_process(COMMAND ${MXF2RAW}
         -p input
         --deint
+        ${ARGN}
         ${input_file}
         OUTPUT_QUIET
         RESULT_VARIABLE ret
@@ -105,6 +107,17 @@ endif()
 run_rewrap_test(${output_file_rewrap} ${output_file_rewrap_again})
 
 
+if(TEST_MODE STREQUAL "check")
+    set(output_file_rewrap_threads test_rewrap_threads.mxf)
+elseif(TEST_MODE STREQUAL "samples")
+    set(output_file_rewrap_threads ${BMX_TEST_SAMPLES_DIR}/test_d10_qt_klv_rewrap_threads.mxf)
+else()
+    set(output_file_rewrap_threads test_rewrap_threads.mxf)
+endif()
+
+run_rewrap_test(${output_file_rewrap} ${output_file_rewrap_threads} --track-threads 2)
+
+
 if(TEST_MODE STREQUAL "check")
     set(output_file_transwrap test_transwrap.mxf)
 elseif(TEST_MODE STREQUAL "samples")
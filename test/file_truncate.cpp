@@ -44,6 +44,7 @@
 #include <fcntl.h>
 #if defined(_WIN32)
 #include <io.h>
+#include <windows.h>
 #else
 #include <unistd.h>
 #endif
@@ -51,14 +52,70 @@
 #if defined(_WIN32)
 #define open        _open
 #define close       _close
+#define read        _read
+#define write       _write
+#define lseek       _lseeki64
 #define ftruncate   _chsize_s
-#define O_WRONLY    _O_WRONLY
+#define O_RDONLY    (_O_RDONLY | _O_BINARY)
+#define O_WRONLY    (_O_WRONLY | _O_BINARY)
 #endif
 
 
 static void print_usage(const char *cmd)
 {
     fprintf(stderr, "Usage: %s <length> <filename>\n", cmd);
+    fprintf(stderr, "   or: %s --grow <delay msec> <source> <filename>\n", cmd);
+    fprintf(stderr, "  --grow: wait and then append the data in <source> that follows the end of <filename>\n");
+}
+
+static void sleep_msec(int msec)
+{
+#if defined(_WIN32)
+    Sleep(msec);
+#else
+    usleep(msec * 1000);
+#endif
+}
+
+static int grow_file(const char *source_filename, const char *filename)
+{
+    unsigned char buffer[65536];
+    int source_fd;
+    int fd;
+    int64_t length;
+    int num_read;
+    int res = 0;
+
+    source_fd = open(source_filename, O_RDONLY);
+    if (source_fd == -1) {
+        fprintf(stderr, "%s: failed to open file: %s\n", source_filename, strerror(errno));
+        return 1;
+    }
+    fd = open(filename, O_WRONLY);
+    if (fd == -1) {
+        fprintf(stderr, "%s: failed to open file: %s\n", filename, strerror(errno));
+        close(source_fd);
+        return 1;
+    }
+
+    length = lseek(fd, 0, SEEK_END);
+    if (length < 0 || lseek(source_fd, length, SEEK_SET) != length) {
+        fprintf(stderr, "%s: failed to seek: %s\n", filename, strerror(errno));
+        res = 1;
+    }
+
+    // append in blocks so that a reader sees the file grow in steps
+    while (res == 0 && (num_read = (int)read(source_fd, buffer, sizeof(buffer))) > 0) {
+        if ((int)write(fd, buffer, num_read) != num_read) {
+            fprintf(stderr, "%s: failed to write file: %s\n", filename, strerror(errno));
+            res = 1;
+        }
+    }
+
+    close(fd);
+    close(source_fd);
+
+    return res;
 }
 
 int main(int argc, const char **argv)
@@ -68,6 +125,18 @@ int main(int argc, const char **argv)
     int fd;
     int res;
 
+    if (argc == 5 && strcmp(argv[1], "--grow") == 0) {
+        int delay;
+        if (sscanf(argv[2], "%d", &delay) != 1 || delay < 0) {
+            print_usage(argv[0]);
+            fprintf(stderr, "Invalid <delay msec> %s\n", argv[2]);
+            return 1;
+        }
+
+        sleep_msec(delay);
+        return grow_file(argv[3], argv[4]);
+    }
+
     if (argc != 3) {
         print_usage(argv[0]);
         return 1;
@@ -6,14 +6,17 @@ include("${TEST_SOURCE_DIR}/../testing.cmake")
 if(TEST_MODE STREQUAL "check")
     set(output_file test.mxf)
     set(output_text test.txt)
+    set(output_follow_file test_follow.mxf)
 elseif(TEST_MODE STREQUAL "samples")
     file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
 
     set(output_file ${BMX_TEST_SAMPLES_DIR}/test_growing_file.mxf)
     set(output_text ${BMX_TEST_SAMPLES_DIR}/test_growing_file.txt)
+    set(output_follow_file ${BMX_TEST_SAMPLES_DIR}/test_growing_file_follow.mxf)
 else()
     set(output_file test.mxf)
     set(output_text test.txt)
+    set(output_follow_file test_follow.mxf)
 endif()
 
 execute_process(COMMAND ${CREATE_TEST_ESSENCE}
@@ -53,6 +56,14 @@ if(NOT ret EQUAL 0)
     message(FATAL_ERROR "Failed to create MXF file: ${ret}")
 endif()
 
+# Keep a copy of the complete file for the --gf-follow test below
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy ${output_file} ${output_follow_file}.complete
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to copy MXF file: ${ret}")
+endif()
+
 
 # Truncate lengths that results in a partial file to simulate a growing file in reverse.
 # First length is the full file and the last one should result in an error.
@@ -140,3 +151,64 @@ if(TEST_MODE STREQUAL "check" OR TEST_MODE STREQUAL "data")
         file(WRITE "${TEST_SOURCE_DIR}/growing_file.md5" "${checksum}")
     endif()
 endif()
+
+
+# Check that mxf2raw --gf-follow waits for a file that is growing and reads all the essence.
+# The file is truncated part way through the essence and the remainder is appended after a
+# delay while mxf2raw is reading it.
+
+execute_process(COMMAND ${MXF2RAW}
+    --regtest
+    --track-chksum md5
+    ${output_follow_file}.complete
+    OUTPUT_VARIABLE complete_output
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to read complete MXF file: ${ret}")
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy ${output_follow_file}.complete ${output_follow_file}
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to copy MXF file: ${ret}")
+endif()
+
+execute_process(COMMAND ${FILE_TRUNCATE}
+    2970790
+    ${output_follow_file}
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to truncate test file: ${ret}")
+endif()
+
+# The commands run concurrently
+execute_process(
+    COMMAND ${FILE_TRUNCATE}
+        --grow 500
+        ${output_follow_file}.complete
+        ${output_follow_file}
+    COMMAND ${MXF2RAW}
+        --regtest
+        --gf-follow
+        --gf-delay 10
+        --track-chksum md5
+        ${output_follow_file}
+    OUTPUT_VARIABLE follow_output
+    ERROR_QUIET
+    RESULTS_VARIABLE rets
+)
+foreach(ret ${rets})
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to read growing MXF file with --gf-follow: ${rets}")
+    endif()
+endforeach()
+
+string(REGEX MATCHALL "checksum[^\n]*" complete_checksums "${complete_output}")
+string(REGEX MATCHALL "checksum[^\n]*" follow_checksums "${follow_output}")
+if(NOT complete_checksums OR NOT follow_checksums STREQUAL complete_checksums)
+    message(FATAL_ERROR "Track checksums '${follow_checksums}' read with --gf-follow != '${complete_checksums}'")
+endif()
@@ -0,0 +1,71 @@
+# Test calculating file checksums, separately and together, against known digests.
+# The file is larger than the checksum engine buffers so that several buffers are used.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(TEST_MODE STREQUAL "samples")
+    file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
+
+    set(input_file ${BMX_TEST_SAMPLES_DIR}/test_file_checksums.raw)
+else()
+    set(input_file test_file_checksums.raw)
+endif()
+
+# 16-bit PCM, 11520000 bytes
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 1
+    -d 3000
+    ${input_file}
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio: ${ret}")
+endif()
+
+# The CRC-32 was calculated using zlib's crc32()
+set(expected_crc32 fb66c060)
+file(MD5 ${input_file} expected_md5)
+file(SHA1 ${input_file} expected_sha1)
+
+
+function(check_checksum output type expected)
+    if(NOT output MATCHES "${type}: ${expected}  ")
+        message(FATAL_ERROR "${type} checksum not found in '${output}', expected ${expected}")
+    endif()
+endfunction()
+
+# All types are calculated concurrently
+execute_process(COMMAND ${MXF2RAW}
+    --file-chksum-only crc32
+    --file-chksum-only md5
+    --file-chksum-only sha1
+    ${input_file}
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to calculate file checksums: ${ret}")
+endif()
+
+check_checksum("${output}" "CRC32" ${expected_crc32})
+check_checksum("${output}" "MD5" ${expected_md5})
+check_checksum("${output}" "SHA1" ${expected_sha1})
+
+# A single type is calculated in the caller's thread
+foreach(type crc32 md5 sha1)
+    execute_process(COMMAND ${MXF2RAW}
+        --file-chksum-only ${type}
+        ${input_file}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to calculate ${type} file checksum: ${ret}")
+    endif()
+
+    if(NOT output MATCHES "^${expected_${type}}  ")
+        message(FATAL_ERROR "${type} checksum output '${output}' != expected ${expected_${type}}")
+    endif()
+endforeach()
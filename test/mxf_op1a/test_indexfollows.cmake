@@ -1,5 +1,6 @@
 # Test creating an MXF OP1a file with index table segments following the essence.
 # Test with different partioning structures and index table segment repetition.
+# Test that spilling completed index table segments to a temporary file results in the same output.
 
 include("${TEST_SOURCE_DIR}/test_common.cmake")
 
@@ -11,6 +12,7 @@ if(TEST_MODE STREQUAL "check")
     set(output_file_5 test_index_follows_5.mxf)
     set(output_file_6 test_index_follows_6.mxf)
     set(output_file_7 test_index_follows_7.mxf)
+    set(spill_output_prefix test_index_follows_spill)
 elseif(TEST_MODE STREQUAL "samples")
     file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
 
@@ -21,6 +23,7 @@ elseif(TEST_MODE STREQUAL "samples")
     set(output_file_5 ${BMX_TEST_SAMPLES_DIR}/test_index_follows_5.mxf)
     set(output_file_6 ${BMX_TEST_SAMPLES_DIR}/test_index_follows_6.mxf)
     set(output_file_7 ${BMX_TEST_SAMPLES_DIR}/test_index_follows_7.mxf)
+    set(spill_output_prefix ${BMX_TEST_SAMPLES_DIR}/test_index_follows_spill)
 else()
     set(output_file_1 test_index_follows_1.mxf)
     set(output_file_2 test_index_follows_2.mxf)
@@ -29,6 +32,7 @@ else()
     set(output_file_5 test_index_follows_5.mxf)
     set(output_file_6 test_index_follows_6.mxf)
     set(output_file_7 test_index_follows_7.mxf)
+    set(spill_output_prefix test_index_follows_spill)
 endif()
 
 set(create_test_audio ${CREATE_TEST_ESSENCE}
@@ -103,4 +107,39 @@ foreach(index RANGE 1 ${max_index})
         ""
         ""
     )
+
+    set(spill_output_file ${spill_output_prefix}_${index}.mxf)
+
+    set(create_command ${RAW2BMX}
+        --regtest
+        -t op1a
+        -f 25
+        -o ${spill_output_file}
+        --index-follows
+        ${add_opt}
+        --spill-index
+        --mpeg2lg_422p_hl_1080i video_index_follows
+        -q 16 --pcm audio_index_follows
+    )
+
+    set(read_command ${MXF2RAW}
+        --read-ess
+        ${spill_output_file}
+    )
+
+    run_test_a(
+        "${TEST_MODE}"
+        "${BMX_TEST_WITH_VALGRIND}"
+        "${create_test_video}"
+        "${create_test_audio}"
+        ""
+        "${create_command}"
+        ""
+        ""
+        "${read_command}"
+        "${spill_output_file}"
+        "index_follows_${index}.md5"
+        ""
+        ""
+    )
 endforeach()
@@ -1,5 +1,7 @@
 # Test creating an MXF OP1a file containing sound only.
 # Create file using raw2bmx and then transwrap.
+# Check that reading the input in a separate thread results in the same file.
+# Check that writing the file in a separate I/O thread results in the same files.
 
 include("${TEST_SOURCE_DIR}/test_common.cmake")
 
@@ -7,14 +9,23 @@ include("${TEST_SOURCE_DIR}/test_common.cmake")
 if(TEST_MODE STREQUAL "check")
     set(output_file_1 test_sound_only_from_raw.mxf)
     set(output_file_2 test_sound_only_transwrap.mxf)
+    set(output_file_3 test_sound_only_from_raw_prefetch.mxf)
+    set(output_file_4 test_sound_only_from_raw_pipelined.mxf)
+    set(output_file_5 test_sound_only_transwrap_pipelined.mxf)
 elseif(TEST_MODE STREQUAL "samples")
     file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
 
     set(output_file_1 ${BMX_TEST_SAMPLES_DIR}/test_sound_only_from_raw.mxf)
     set(output_file_2 ${BMX_TEST_SAMPLES_DIR}/test_sound_only_transwrap.mxf)
+    set(output_file_3 ${BMX_TEST_SAMPLES_DIR}/test_sound_only_from_raw_prefetch.mxf)
+    set(output_file_4 ${BMX_TEST_SAMPLES_DIR}/test_sound_only_from_raw_pipelined.mxf)
+    set(output_file_5 ${BMX_TEST_SAMPLES_DIR}/test_sound_only_transwrap_pipelined.mxf)
 else()
     set(output_file_1 test_sound_only_from_raw.mxf)
     set(output_file_2 test_sound_only_transwrap.mxf)
+    set(output_file_3 test_sound_only_from_raw_prefetch.mxf)
+    set(output_file_4 test_sound_only_from_raw_pipelined.mxf)
+    set(output_file_5 test_sound_only_transwrap_pipelined.mxf)
 endif()
 
 set(create_test_audio ${CREATE_TEST_ESSENCE}
@@ -69,3 +80,75 @@ run_test_a(
     ""
     ""
 )
+
+set(create_command ${RAW2BMX}
+    --regtest
+    -t op1a
+    -o ${output_file_3}
+    --clip-wrap
+    --prefetch 4
+    -q 16 --pcm audio_sound_only
+)
+run_test_a(
+    "${TEST_MODE}"
+    "${BMX_TEST_WITH_VALGRIND}"
+    ""
+    ""
+    ""
+    "${create_command}"
+    ""
+    ""
+    ""
+    "${output_file_3}"
+    "sound_only_from_raw.md5"
+    ""
+    ""
+)
+
+set(create_command ${RAW2BMX}
+    --regtest
+    -t op1a
+    -o ${output_file_4}
+    --clip-wrap
+    --pipelined-write
+    -q 16 --pcm audio_sound_only
+)
+run_test_a(
+    "${TEST_MODE}"
+    "${BMX_TEST_WITH_VALGRIND}"
+    ""
+    ""
+    ""
+    "${create_command}"
+    ""
+    ""
+    ""
+    "${output_file_4}"
+    "sound_only_from_raw.md5"
+    ""
+    ""
+)
+
+set(create_command ${BMXTRANSWRAP}
+    --regtest
+    -t op1a
+    -o ${output_file_5}
+    --clip-wrap
+    --pipelined-write
+    ${output_file_1}
+)
+run_test_a(
+    "${TEST_MODE}"
+    "${BMX_TEST_WITH_VALGRIND}"
+    ""
+    ""
+    ""
+    "${create_command}"
+    ""
+    ""
+    ""
+    "${output_file_5}"
+    "sound_only_transwrap.md5"
+    ""
+    ""
+)
@@ -13,16 +13,19 @@ function(run_test test frame_rate duration)
         set(output_dir test_${test}${frame_rate})
         set(output_version_file test_${test}${frame_rate}/test_${test}${frame_rate}.mxf)
         set(output_info_file info_${test}${frame_rate}.xml)
+        set(output_arena_info_file info_${test}${frame_rate}_arena.xml)
     elseif(TEST_MODE STREQUAL "samples")
         file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
 
         set(output_dir ${BMX_TEST_SAMPLES_DIR}/test_${test}${frame_rate})
         set(output_version_file ${BMX_TEST_SAMPLES_DIR}/test_${test}${frame_rate}/test_${test}${frame_rate}.mxf)
         set(output_info_file ${BMX_TEST_SAMPLES_DIR}/info_${test}${frame_rate}.xml)
+        set(output_arena_info_file ${BMX_TEST_SAMPLES_DIR}/info_${test}${frame_rate}_arena.xml)
     else()
         set(output_dir test_${test}${frame_rate})
         set(output_version_file test_${test}${frame_rate}/test_${test}${frame_rate}.mxf)
         set(output_info_file info_${test}${frame_rate}.xml)
+        set(output_arena_info_file info_${test}${frame_rate}_arena.xml)
     endif()
 
     set(checksum_file ${test}${frame_rate}.md5)
@@ -68,6 +71,31 @@ function(run_test test frame_rate duration)
         "${output_info_file}"
         "${checksum_file}"
     )
+
+    # Check that reading the header metadata into an arena results in the same info
+    set(read_arena_command ${MXF2RAW}
+        --regtest
+        --header-arena
+        --info
+        --info-format xml
+        --info-file ${output_arena_info_file}
+        --track-chksum md5
+        ${output_version_file}
+    )
+
+    run_test_b(
+        "${TEST_MODE}"
+        "${BMX_TEST_WITH_VALGRIND}"
+        ""
+        ""
+        ""
+        ""
+        ""
+        ""
+        "${read_arena_command}"
+        "${output_arena_info_file}"
+        "${checksum_file}"
+    )
 endfunction()
 
 function(run_tests tests duration)
@@ -0,0 +1,178 @@
+# Test reading an MXF OP1a file with the --index-cache sidecar cache of the partitions and index tables.
+# The info and track checksums read with the cache must match those read without the cache. The cache
+# must be ignored and rewritten if the file size, modification time or Preface has changed, or if the
+# cache file is truncated or corrupt.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(TEST_MODE STREQUAL "samples")
+    file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
+
+    set(output_dir ${BMX_TEST_SAMPLES_DIR}/test_index_cache)
+else()
+    set(output_dir test_index_cache)
+endif()
+
+set(output_file ${output_dir}/test_index_cache.mxf)
+set(cache_file ${output_file}.bmxidx)
+
+file(REMOVE_RECURSE ${output_dir} ${output_dir}_a ${output_dir}_b)
+file(MAKE_DIRECTORY ${output_dir} ${output_dir}_a ${output_dir}_b)
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 1
+    -d 24
+    audio_index_cache
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio: ${ret}")
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 14
+    -d 24
+    video_index_cache
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test video: ${ret}")
+endif()
+
+
+function(create_file file regtest_opt duration)
+    execute_process(COMMAND ${RAW2BMX}
+        ${regtest_opt}
+        -t op1a
+        -f 25
+        -o ${file}
+        --dur ${duration}
+        --part 10
+        --mpeg2lg_422p_hl_1080i video_index_cache
+        -q 16 --pcm audio_index_cache
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to create MXF file: ${ret}")
+    endif()
+endfunction()
+
+# Reads the file with and without the cache and checks that the output is the same.
+# cache_state is the expected state of an existing cache file: "none", "valid" or "invalid".
+function(check_read cache_state)
+    execute_process(COMMAND ${MXF2RAW}
+        --regtest
+        --info
+        --track-chksum md5
+        ${output_file}
+        OUTPUT_VARIABLE expected_output
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to read MXF file without the index cache: ${ret}")
+    endif()
+
+    execute_process(COMMAND ${MXF2RAW}
+        --regtest
+        --log-level 0
+        --index-cache
+        --info
+        --track-chksum md5
+        ${output_file}
+        OUTPUT_VARIABLE cache_output
+        ERROR_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to read MXF file with the index cache: ${ret}")
+    endif()
+
+    # The index cache log messages are included in the info output and are removed before comparing
+    string(FIND "${cache_output}" "Using index cache file" used_index)
+    string(FIND "${cache_output}" "Ignoring index cache file" ignored_index)
+    string(REGEX REPLACE "  [a-z]+ *: [^\n]*index cache file[^\n]*\n" "" cache_output "${cache_output}")
+    string(REGEX REPLACE "LogMessages: \\([0-9]+\\)" "LogMessages:" cache_output "${cache_output}")
+    string(REGEX REPLACE "LogMessages: \\([0-9]+\\)" "LogMessages:" expected_output "${expected_output}")
+
+    if(NOT cache_output STREQUAL expected_output)
+        message(FATAL_ERROR "Output read with the '${cache_state}' index cache differs from the output read without it")
+    endif()
+    if(NOT EXISTS ${cache_file})
+        message(FATAL_ERROR "Index cache file was not written")
+    endif()
+
+    if(cache_state STREQUAL "valid")
+        if(used_index EQUAL -1 OR NOT ignored_index EQUAL -1)
+            message(FATAL_ERROR "Valid index cache file was not used")
+        endif()
+    elseif(cache_state STREQUAL "invalid")
+        if(NOT used_index EQUAL -1 OR ignored_index EQUAL -1)
+            message(FATAL_ERROR "Invalid index cache file was not ignored")
+        endif()
+    elseif(NOT used_index EQUAL -1 OR NOT ignored_index EQUAL -1)
+        message(FATAL_ERROR "Unexpected index cache file")
+    endif()
+endfunction()
+
+
+# Write the cache and then read it
+create_file(${output_file} --regtest 24)
+check_read("none")
+check_read("valid")
+
+# File size has changed
+create_file(${output_file} --regtest 20)
+check_read("invalid")
+check_read("valid")
+
+# Modification time has changed. The time has a resolution of 1 second
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 2)
+file(TOUCH ${output_file})
+check_read("invalid")
+check_read("valid")
+
+# Preface has changed. The files are created without --regtest so that they have different Preface
+# identifiers but the same size, and are created again until they have the same modification time.
+# Copying the files preserves the modification time
+foreach(attempt RANGE 4)
+    create_file(${output_dir}_a/test_index_cache.mxf "" 20)
+    create_file(${output_dir}_b/test_index_cache.mxf "" 20)
+    file(TIMESTAMP ${output_dir}_a/test_index_cache.mxf time_a "%s")
+    file(TIMESTAMP ${output_dir}_b/test_index_cache.mxf time_b "%s")
+    if(time_a STREQUAL time_b)
+        break()
+    endif()
+endforeach()
+if(NOT time_a STREQUAL time_b)
+    message(FATAL_ERROR "Failed to create files with the same modification time")
+endif()
+file(REMOVE ${output_file})
+file(COPY ${output_dir}_a/test_index_cache.mxf DESTINATION ${output_dir})
+check_read("invalid")
+check_read("valid")
+file(REMOVE ${output_file})
+file(COPY ${output_dir}_b/test_index_cache.mxf DESTINATION ${output_dir})
+check_read("invalid")
+check_read("valid")
+
+# Cache file is truncated
+execute_process(COMMAND ${FILE_TRUNCATE}
+    200
+    ${cache_file}
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to truncate index cache file: ${ret}")
+endif()
+check_read("invalid")
+check_read("valid")
+
+# Cache file is corrupt
+file(WRITE ${cache_file} "Not an index cache file")
+check_read("invalid")
+check_read("valid")
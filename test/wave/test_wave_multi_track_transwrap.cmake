@@ -0,0 +1,101 @@
+# Test that a multi-track Wave file transwrapped from MXF, which writes the samples for all tracks together,
+# is identical to the Wave file created from raw, which writes the samples per track.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(TEST_MODE STREQUAL "samples")
+    file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
+
+    set(output_dir ${BMX_TEST_SAMPLES_DIR}/test_wave_multi_track_transwrap)
+else()
+    set(output_dir test_wave_multi_track_transwrap)
+endif()
+
+file(REMOVE_RECURSE ${output_dir})
+file(MAKE_DIRECTORY ${output_dir})
+
+
+# Compares the Wave file created from raw with the Wave file transwrapped from the MXF file created from raw.
+# The raw input has 6 channels
+function(check_wave name qbits track_map wrap_opt)
+    set(raw_output ${output_dir}/${name}_raw.wav)
+    set(mxf_file ${output_dir}/${name}.mxf)
+    set(transwrap_output ${output_dir}/${name}_transwrap.wav)
+
+    execute_process(COMMAND ${RAW2BMX}
+        --regtest
+        -t wave
+        -o ${raw_output}
+        --track-map "${track_map}"
+        --audio-chan 6 -q ${qbits} --pcm audio_${name}
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to create Wave file from raw: ${ret}")
+    endif()
+
+    execute_process(COMMAND ${RAW2BMX}
+        --regtest
+        -t op1a
+        ${wrap_opt}
+        -o ${mxf_file}
+        --audio-chan 6 -q ${qbits} --pcm audio_${name}
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to create MXF file: ${ret}")
+    endif()
+
+    execute_process(COMMAND ${BMXTRANSWRAP}
+        --regtest
+        -t wave
+        -o ${transwrap_output}
+        --track-map "${track_map}"
+        ${mxf_file}
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to transwrap MXF file to Wave: ${ret}")
+    endif()
+
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+        ${raw_output} ${transwrap_output}
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Wave file '${transwrap_output}' differs from '${raw_output}'")
+    endif()
+endfunction()
+
+
+# 16-bit PCM, 24 frames at 25 Hz
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 1
+    -d 144
+    audio_16bit
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio: ${ret}")
+endif()
+
+# 24-bit PCM, 5123 samples
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 57
+    -d 46107
+    audio_24bit
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio: ${ret}")
+endif()
+
+# Output tracks with equal and unequal channel counts
+check_wave(16bit 16 "0-1\;2-3\;4\;5" "")
+check_wave(24bit 24 "0\;1\;2-4\;5" --clip-wrap)